@@ -880,11 +880,11 @@ static void AES_Encrypt(aes_context_t *ctx, uint8_t *out,
     dst[3] = cpu_to_le32(b0[3]);
 }
 
-static boolean prng_enabled = false;
-static aes_context_t prng_context;
-static uint32_t prng_input_counter;
-static uint32_t prng_values[4];
-static unsigned int prng_value_index = 0;
+static INSTANCE boolean prng_enabled = false;
+static INSTANCE aes_context_t prng_context;
+static INSTANCE uint32_t prng_input_counter;
+static INSTANCE uint32_t prng_values[4];
+static INSTANCE unsigned int prng_value_index = 0;
 
 // Initialize Pseudo-RNG using the specified 128-bit key.
 
@@ -24,9 +24,9 @@
 
 #define MAXEVENTS 64
 
-static event_t events[MAXEVENTS];
-static int eventhead;
-static int eventtail;
+static INSTANCE event_t events[MAXEVENTS];
+static INSTANCE int eventhead;
+static INSTANCE int eventtail;
 
 //
 // D_PostEvent
@@ -71,9 +71,9 @@ boolean D_IsIWADName(const char *name)
 
 #define MAX_IWAD_DIRS 128
 
-static boolean iwad_dirs_built = false;
-static char *iwad_dirs[MAX_IWAD_DIRS];
-static int num_iwad_dirs = 0;
+static INSTANCE boolean iwad_dirs_built = false;
+static INSTANCE char *iwad_dirs[MAX_IWAD_DIRS];
+static INSTANCE int num_iwad_dirs = 0;
 
 static void AddIWADDir(char *dir)
 {
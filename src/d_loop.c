@@ -33,6 +33,7 @@
 #include "net_client.h"
 #include "net_gui.h"
 #include "net_io.h"
+#include "net_metrics.h"
 #include "net_query.h"
 #include "net_server.h"
 #include "net_sdl.h"
@@ -61,61 +62,72 @@ typedef struct
 // from all players.
 //
 
-static ticcmd_set_t ticdata[BACKUPTICS];
+static INSTANCE ticcmd_set_t ticdata[BACKUPTICS];
 
 // The index of the next tic to be made (with a call to BuildTiccmd).
 
-static int maketic;
+static INSTANCE int maketic;
 
 // The number of complete tics received from the server so far.
 
-static int recvtic;
+static INSTANCE int recvtic;
 
 // The number of tics that have been run (using RunTic) so far.
 
-int gametic;
+INSTANCE int gametic;
 
 // When set to true, a single tic is run each time TryRunTics() is called.
 // This is used for -timedemo mode.
 
-boolean singletics = false;
+INSTANCE boolean singletics = false;
 
 // Index of the local player.
 
-static int localplayer;
+static INSTANCE int localplayer;
 
 // Used for original sync code.
 
-static int      skiptics = 0;
+static INSTANCE int      skiptics = 0;
 
 // Reduce the bandwidth needed by sampling game input less and transmitting
 // less.  If ticdup is 2, sample half normal, 3 = one third normal, etc.
 
-int		ticdup;
+INSTANCE int		ticdup;
 
 // Amount to offset the timer for game sync.
 
-fixed_t         offsetms;
+INSTANCE fixed_t         offsetms;
 
 // Use new client syncronisation code
 
-static boolean  new_sync = true;
+static INSTANCE boolean  new_sync = true;
 
 // Callback functions for loop code.
 
-static loop_interface_t *loop_interface = NULL;
+static INSTANCE loop_interface_t *loop_interface = NULL;
 
 // Current players in the multiplayer game.
 // This is distinct from playeringame[] used by the game code, which may
 // modify playeringame[] when playing back multiplayer demos.
 
-static boolean local_playeringame[NET_MAXPLAYERS];
+static INSTANCE boolean local_playeringame[NET_MAXPLAYERS];
+
+// If true, the server sends back our own ticcmds and they replace the
+// ones we made: it may have made up its own for tics where ours were
+// late.
+
+static INSTANCE boolean server_local_cmds = false;
+
+// If true, we have joined a game in progress and are waiting for the
+// snapshot of the game to arrive before we can run any tics.
+
+static INSTANCE boolean snapshot_pending = false;
 
 // Requested player class "sent" to the server on connect.
 // If we are only doing a single player game then this needs to be remembered
 // and saved in the game settings.
 
-static int player_class;
+static INSTANCE int player_class;
 
 
 // 35 fps clock adjusted by offsetms milliseconds
@@ -137,6 +149,49 @@ static int GetAdjustedTime(void)
     return (time_ms * TICRATE) / 1000;
 }
 
+// Time (from I_GetTimeNS) at which NetUpdate will next have a new tic
+// to build: when GetAdjustedTime() / ticdup next advances.
+
+static uint64_t NextTicTimeNS(void)
+{
+    int64_t tic, time_ms;
+
+    tic = (GetAdjustedTime() / ticdup + 1) * ticdup;
+    time_ms = (tic * 1000 + TICRATE - 1) / TICRATE;
+
+    if (new_sync)
+    {
+        time_ms -= offsetms / FRACUNIT;
+    }
+
+    if (time_ms < 0)
+    {
+        return 0;
+    }
+
+    return time_ms * 1000000;
+}
+
+// Wait for network data to arrive, or for it to be time to build the
+// next tic.  How late we wake up for the tic is recorded as jitter.
+
+static void WaitForTic(void)
+{
+    uint64_t deadline, now;
+
+    deadline = NextTicTimeNS();
+
+    if (!NET_WaitForPackets(deadline))
+    {
+        now = I_GetTimeNS();
+
+        if (now >= deadline)
+        {
+            NET_Metrics_TicJitter(now - deadline);
+        }
+    }
+}
+
 static boolean BuildNewTic(void)
 {
     int	gameticdiv;
@@ -186,20 +241,55 @@ static boolean BuildNewTic(void)
         NET_CL_SendTiccmd(&cmd, maketic);
     }
 
-    ticdata[maketic % BACKUPTICS].cmds[localplayer] = cmd;
-    ticdata[maketic % BACKUPTICS].ingame[localplayer] = true;
+    // Don't overwrite a ticcmd the server has already sent for this tic.
+
+    if (!server_local_cmds || maketic >= recvtic)
+    {
+        ticdata[maketic % BACKUPTICS].cmds[localplayer] = cmd;
+        ticdata[maketic % BACKUPTICS].ingame[localplayer] = true;
+    }
 
     ++maketic;
 
     return true;
 }
 
+//
+// If the server has asked for a snapshot of the game for a player who
+// is joining, take it once the game has reached the tic it was asked
+// for at.  If we are already past that tic, the request can't be met.
+//
+
+static void CheckSnapshotRequest(void)
+{
+    unsigned int tic;
+    byte *data;
+    size_t len;
+
+    if (!NET_CL_GetSnapshotRequest(&tic)
+     || gametic < (int) tic * ticdup)
+    {
+        return;
+    }
+
+    data = NULL;
+    len = 0;
+
+    if (gametic == (int) tic * ticdup && loop_interface->SaveSnapshot != NULL)
+    {
+        data = loop_interface->SaveSnapshot(&len);
+    }
+
+    NET_CL_SendSnapshot(tic, data, len);
+    free(data);
+}
+
 //
 // NetUpdate
 // Builds ticcmds for console player,
 // sends out a packet
 //
-int      lasttime;
+INSTANCE int      lasttime;
 
 void NetUpdate (void)
 {
@@ -218,6 +308,8 @@ void NetUpdate (void)
     NET_CL_Run();
     NET_SV_Run();
 
+    CheckSnapshotRequest();
+
     // check time
     nowtime = GetAdjustedTime() / ticdup;
     newtics = nowtime - lasttime;
@@ -277,9 +369,14 @@ void D_ReceiveTic(ticcmd_t *ticcmds, boolean *players_mask)
         return;
     }
 
+    if (!drone && players_mask[localplayer])
+    {
+        server_local_cmds = true;
+    }
+
     for (i = 0; i < NET_MAXPLAYERS; ++i)
     {
-        if (!drone && i == localplayer)
+        if (!drone && i == localplayer && !players_mask[i])
         {
             // This is us.  Don't overwrite it.
         }
@@ -334,10 +431,12 @@ static void BlockUntilStart(net_gamesettings_t *settings,
 void D_StartNetGame(net_gamesettings_t *settings,
                     netgame_startup_callback_t callback)
 {
+    unsigned int join_tic;
     int i;
 
     offsetms = 0;
     recvtic = 0;
+    server_local_cmds = false;
 
     settings->consoleplayer = 0;
     settings->num_players = 1;
@@ -392,6 +491,17 @@ void D_StartNetGame(net_gamesettings_t *settings,
         // Read the game settings that were received.
 
         NET_CL_GetSettings(settings);
+
+        // If we have joined a game already in progress, start counting
+        // tics from where the others are; the game itself arrives as
+        // a snapshot before the first tic is run.
+
+        if (NET_CL_GetJoinTic(&join_tic))
+        {
+            maketic = recvtic = join_tic;
+            gametic = join_tic * settings->ticdup;
+            snapshot_pending = true;
+        }
     }
 
     if (drone)
@@ -443,7 +553,7 @@ boolean D_InitNetGame(net_connect_data_t *connect_data)
     {
         NET_SV_Init();
         NET_SV_AddModule(&net_loop_server_module);
-        NET_SV_AddModule(&net_sdl_module);
+        NET_SV_AddModule(NET_SV_TransportModule());
         NET_SV_RegisterWithMaster();
 
         net_loop_client_module.InitClient();
@@ -548,9 +658,35 @@ static int GetLowTic(void)
     return lowtic;
 }
 
-static int frameon;
-static int frameskip[4];
-static int oldnettics;
+//
+// Get the local player's ticcmds that have been built and sent but
+// not yet run, oldest first.  Returns the number of ticcmds copied.
+//
+
+int D_GetPendingTiccmds(ticcmd_t *cmds, int max)
+{
+    int tic;
+    int count;
+
+    if (drone)
+    {
+        return 0;
+    }
+
+    count = 0;
+
+    for (tic = gametic / ticdup; tic < maketic && count < max; ++tic)
+    {
+        cmds[count] = ticdata[tic % BACKUPTICS].cmds[localplayer];
+        ++count;
+    }
+
+    return count;
+}
+
+static INSTANCE int frameon;
+static INSTANCE int frameskip[4];
+static INSTANCE int oldnettics;
 
 static void OldNetSync(void)
 {
@@ -663,6 +799,41 @@ static void SinglePlayerClear(ticcmd_set_t *set)
     }
 }
 
+//
+// Having joined a game in progress, wait for the snapshot of the game
+// to arrive and load it.
+//
+
+static void LoadJoinSnapshot(void)
+{
+    byte *data;
+    size_t len;
+
+    printf("Waiting for the game in progress to be sent...\n");
+
+    while (!NET_CL_GetSnapshot(&data, &len))
+    {
+        NET_CL_Run();
+        NET_SV_Run();
+
+        if (!net_client_connected)
+        {
+            I_Error("Lost connection to server while joining the game");
+        }
+
+        I_Sleep(10);
+    }
+
+    if (data == NULL || loop_interface->LoadSnapshot == NULL
+     || !loop_interface->LoadSnapshot(data, len))
+    {
+        I_Error("Failed to load the game in progress.");
+    }
+
+    free(data);
+    snapshot_pending = false;
+}
+
 //
 // TryRunTics
 //
@@ -672,10 +843,17 @@ void TryRunTics (void)
     int	i;
     int	lowtic;
     int	entertic;
-    static int oldentertics;
+    static INSTANCE int oldentertics;
     int realtics;
     int	availabletics;
     int	counts;
+    uint64_t tic_start;
+    uint64_t tic_end;
+
+    if (snapshot_pending)
+    {
+        LoadJoinSnapshot();
+    }
 
     // get real tics
     entertic = I_GetTime() / ticdup;
@@ -747,7 +925,7 @@ void TryRunTics (void)
                 return;
             }
 
-            I_Sleep(1);
+            WaitForTic();
         }
     }
 
@@ -775,7 +953,10 @@ void TryRunTics (void)
 
             memcpy(local_playeringame, set->ingame, sizeof(local_playeringame));
 
+            tic_start = I_GetTimeNS();
             loop_interface->RunTic(set->cmds, set->ingame);
+            tic_end = I_GetTimeNS();
+            NET_Metrics_TicTime(tic_end - tic_start);
 	    gametic++;
 
 	    // modify command for duplicated tics
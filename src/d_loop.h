@@ -46,6 +46,17 @@ typedef struct
     // Run the menu (runs independently of the game).
 
     void (*RunMenu)();
+
+    // Save the whole state of the game, for a player joining a game in
+    // progress.  Returns a buffer allocated with malloc(), or NULL if
+    // the game can't be saved right now.  May be NULL if the game does
+    // not support joining games in progress.
+
+    byte *(*SaveSnapshot)(size_t *len);
+
+    // Restore the game from a snapshot made with SaveSnapshot.
+
+    boolean (*LoadSnapshot)(byte *data, size_t len);
 } loop_interface_t;
 
 // Register callback functions for the main loop code to use.
@@ -61,6 +72,9 @@ void D_QuitNetGame (void);
 //? how many ticks to run?
 void TryRunTics (void);
 
+// Get the local ticcmds that are waiting to be run.
+int D_GetPendingTiccmds(ticcmd_t *cmds, int max);
+
 // Called at start of game loop to initialize timers
 void D_StartGameLoop(void);
 
@@ -74,8 +88,8 @@ boolean D_InitNetGame(net_connect_data_t *connect_data);
 void D_StartNetGame(net_gamesettings_t *settings,
                     netgame_startup_callback_t callback);
 
-extern boolean singletics;
-extern int gametic, ticdup;
+extern INSTANCE boolean singletics;
+extern INSTANCE int gametic, ticdup;
 
 // Check if it is permitted to record a demo with a non-vanilla feature.
 boolean D_NonVanillaRecord(boolean conditional, const char *feature);
@@ -34,23 +34,23 @@
 extern deh_section_t *deh_section_types[];
 extern const char *deh_signatures[];
 
-static boolean deh_initialized = false;
+static INSTANCE boolean deh_initialized = false;
 
 // If true, we can parse [STRINGS] sections in BEX format.
 
-boolean deh_allow_extended_strings = false;
+INSTANCE boolean deh_allow_extended_strings = false;
 
 // If true, we can do long string replacements.
 
-boolean deh_allow_long_strings = false;
+INSTANCE boolean deh_allow_long_strings = false;
 
 // If true, we can do cheat replacements longer than the originals.
 
-boolean deh_allow_long_cheats = false;
+INSTANCE boolean deh_allow_long_cheats = false;
 
 // If false, dehacked cheat replacements are ignored.
 
-boolean deh_apply_cheats = true;
+INSTANCE boolean deh_apply_cheats = true;
 
 void DEH_Checksum(sha1_digest_t digest)
 {
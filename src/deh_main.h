@@ -39,10 +39,10 @@ boolean DEH_ParseAssignment(char *line, char **variable_name, char **value);
 
 void DEH_Checksum(sha1_digest_t digest);
 
-extern boolean deh_allow_extended_strings;
-extern boolean deh_allow_long_strings;
-extern boolean deh_allow_long_cheats;
-extern boolean deh_apply_cheats;
+extern INSTANCE boolean deh_allow_extended_strings;
+extern INSTANCE boolean deh_allow_long_strings;
+extern INSTANCE boolean deh_allow_long_cheats;
+extern INSTANCE boolean deh_apply_cheats;
 
 #endif /* #ifndef DEH_MAIN_H */
 
@@ -32,9 +32,9 @@ typedef struct
     char *to_text;
 } deh_substitution_t;
 
-static deh_substitution_t **hash_table = NULL;
-static int hash_table_entries;
-static int hash_table_length = -1;
+static INSTANCE deh_substitution_t **hash_table = NULL;
+static INSTANCE int hash_table_entries;
+static INSTANCE int hash_table_length = -1;
 
 // This is the algorithm used by glib
 
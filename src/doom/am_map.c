@@ -194,80 +194,80 @@ mline_t thintriangle_guy[] = {
 
 
 
-static int 	cheating = 0;
-static int 	grid = 0;
+static INSTANCE int 	cheating = 0;
+static INSTANCE int 	grid = 0;
 
-static int 	leveljuststarted = 1; 	// kluge until AM_LevelInit() is called
+static INSTANCE int 	leveljuststarted = 1; 	// kluge until AM_LevelInit() is called
 
-boolean    	automapactive = false;
-static int 	finit_width = SCREENWIDTH;
-static int 	finit_height = SCREENHEIGHT - ST_HEIGHT;
+INSTANCE boolean    	automapactive = false;
+static INSTANCE int 	finit_width = SCREENWIDTH;
+static INSTANCE int 	finit_height = SCREENHEIGHT - ST_HEIGHT;
 
 // location of window on screen
-static int 	f_x;
-static int	f_y;
+static INSTANCE int 	f_x;
+static INSTANCE int	f_y;
 
 // size of window on screen
-static int 	f_w;
-static int	f_h;
+static INSTANCE int 	f_w;
+static INSTANCE int	f_h;
 
-static int 	lightlev; 		// used for funky strobing effect
-static pixel_t*	fb; 			// pseudo-frame buffer
-static int 	amclock;
+static INSTANCE int 	lightlev; 		// used for funky strobing effect
+static INSTANCE pixel_t*	fb; 			// pseudo-frame buffer
+static INSTANCE int 	amclock;
 
-static mpoint_t m_paninc; // how far the window pans each tic (map coords)
-static fixed_t 	mtof_zoommul; // how far the window zooms in each tic (map coords)
-static fixed_t 	ftom_zoommul; // how far the window zooms in each tic (fb coords)
+static INSTANCE mpoint_t m_paninc; // how far the window pans each tic (map coords)
+static INSTANCE fixed_t 	mtof_zoommul; // how far the window zooms in each tic (map coords)
+static INSTANCE fixed_t 	ftom_zoommul; // how far the window zooms in each tic (fb coords)
 
-static fixed_t 	m_x, m_y;   // LL x,y where the window is on the map (map coords)
-static fixed_t 	m_x2, m_y2; // UR x,y where the window is on the map (map coords)
+static INSTANCE fixed_t 	m_x, m_y;   // LL x,y where the window is on the map (map coords)
+static INSTANCE fixed_t 	m_x2, m_y2; // UR x,y where the window is on the map (map coords)
 
 //
 // width/height of window on map (map coords)
 //
-static fixed_t 	m_w;
-static fixed_t	m_h;
+static INSTANCE fixed_t 	m_w;
+static INSTANCE fixed_t	m_h;
 
 // based on level size
-static fixed_t 	min_x;
-static fixed_t	min_y; 
-static fixed_t 	max_x;
-static fixed_t  max_y;
+static INSTANCE fixed_t 	min_x;
+static INSTANCE fixed_t	min_y; 
+static INSTANCE fixed_t 	max_x;
+static INSTANCE fixed_t  max_y;
 
-static fixed_t 	max_w; // max_x-min_x,
-static fixed_t  max_h; // max_y-min_y
+static INSTANCE fixed_t 	max_w; // max_x-min_x,
+static INSTANCE fixed_t  max_h; // max_y-min_y
 
 // based on player size
-static fixed_t 	min_w;
-static fixed_t  min_h;
+static INSTANCE fixed_t 	min_w;
+static INSTANCE fixed_t  min_h;
 
 
-static fixed_t 	min_scale_mtof; // used to tell when to stop zooming out
-static fixed_t 	max_scale_mtof; // used to tell when to stop zooming in
+static INSTANCE fixed_t 	min_scale_mtof; // used to tell when to stop zooming out
+static INSTANCE fixed_t 	max_scale_mtof; // used to tell when to stop zooming in
 
 // old stuff for recovery later
-static fixed_t old_m_w, old_m_h;
-static fixed_t old_m_x, old_m_y;
+static INSTANCE fixed_t old_m_w, old_m_h;
+static INSTANCE fixed_t old_m_x, old_m_y;
 
 // old location used by the Follower routine
-static mpoint_t f_oldloc;
+static INSTANCE mpoint_t f_oldloc;
 
 // used by MTOF to scale from map-to-frame-buffer coords
-static fixed_t scale_mtof = (fixed_t)INITSCALEMTOF;
+static INSTANCE fixed_t scale_mtof = (fixed_t)INITSCALEMTOF;
 // used by FTOM to scale from frame-buffer-to-map coords (=1/scale_mtof)
-static fixed_t scale_ftom;
+static INSTANCE fixed_t scale_ftom;
 
-static player_t *plr; // the player represented by an arrow
+static INSTANCE player_t *plr; // the player represented by an arrow
 
-static patch_t *marknums[10]; // numbers used for marking by the automap
-static mpoint_t markpoints[AM_NUMMARKPOINTS]; // where the points are
-static int markpointnum = 0; // next point to be assigned
+static INSTANCE patch_t *marknums[10]; // numbers used for marking by the automap
+static INSTANCE mpoint_t markpoints[AM_NUMMARKPOINTS]; // where the points are
+static INSTANCE int markpointnum = 0; // next point to be assigned
 
-static int followplayer = 1; // specifies whether to follow the player around
+static INSTANCE int followplayer = 1; // specifies whether to follow the player around
 
-cheatseq_t cheat_amap = CHEAT("iddt", 0);
+INSTANCE cheatseq_t cheat_amap = CHEAT("iddt", 0);
 
-static boolean stopped = true;
+static INSTANCE boolean stopped = true;
 
 // Calculates the slope and slope according to the x-axis of a line
 // segment in map coordinates (with the upright y-axis n' all) so
@@ -426,7 +426,7 @@ void AM_changeWindowLoc(void)
 void AM_initVariables(void)
 {
     int pnum;
-    static event_t st_notify = { ev_keyup, AM_MSGENTERED, 0, 0 };
+    static INSTANCE event_t st_notify = { ev_keyup, AM_MSGENTERED, 0, 0 };
 
     automapactive = true;
     fb = I_VideoBuffer;
@@ -542,7 +542,7 @@ void AM_LevelInit(void)
 //
 void AM_Stop (void)
 {
-    static event_t st_notify = { 0, ev_keyup, AM_MSGEXITED, 0 };
+    static INSTANCE event_t st_notify = { 0, ev_keyup, AM_MSGEXITED, 0 };
 
     AM_unloadPics();
     automapactive = false;
@@ -555,7 +555,7 @@ void AM_Stop (void)
 //
 void AM_Start (void)
 {
-    static int lastlevel = -1, lastepisode = -1;
+    static INSTANCE int lastlevel = -1, lastepisode = -1;
 
     if (!stopped) AM_Stop();
     stopped = false;
@@ -599,8 +599,8 @@ AM_Responder
 {
 
     int rc;
-    static int bigstate=0;
-    static char buffer[20];
+    static INSTANCE int bigstate=0;
+    static INSTANCE char buffer[20];
     int key;
 
     rc = false;
@@ -807,10 +807,10 @@ void AM_doFollowPlayer(void)
 //
 void AM_updateLightLev(void)
 {
-    static int nexttic = 0;
+    static INSTANCE int nexttic = 0;
     //static int litelevels[] = { 0, 3, 5, 6, 6, 7, 7, 7 };
     static int litelevels[] = { 0, 4, 7, 10, 12, 14, 15, 15 };
-    static int litelevelscnt = 0;
+    static INSTANCE int litelevelscnt = 0;
    
     // Change light level
     if (amclock>nexttic)
@@ -1018,7 +1018,7 @@ AM_drawFline
     register int ay;
     register int d;
     
-    static int fuck = 0;
+    static INSTANCE int fuck = 0;
 
     // For debugging only
     if (      fl->a.x < 0 || fl->a.x >= f_w
@@ -1086,7 +1086,7 @@ AM_drawMline
 ( mline_t*	ml,
   int		color )
 {
-    static fline_t fl;
+    static INSTANCE fline_t fl;
 
     if (AM_clipMline(ml, &fl))
 	AM_drawFline(&fl, color); // draws it on frame buffer using fb coords
@@ -1146,7 +1146,7 @@ void AM_drawGrid(int color)
 void AM_drawWalls(void)
 {
     int i;
-    static mline_t l;
+    static INSTANCE mline_t l;
 
     for (i=0;i<numlines;i++)
     {
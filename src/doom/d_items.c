@@ -34,7 +34,7 @@
 // atkstate, i.e. attack/fire/hit frame
 // flashstate, muzzle flash
 //
-weaponinfo_t	weaponinfo[NUMWEAPONS] =
+INSTANCE weaponinfo_t	weaponinfo[NUMWEAPONS] =
 {
     {
 	// fist
@@ -36,6 +36,6 @@ typedef struct
 
 } weaponinfo_t;
 
-extern  weaponinfo_t    weaponinfo[NUMWEAPONS];
+extern INSTANCE  weaponinfo_t    weaponinfo[NUMWEAPONS];
 
 #endif
@@ -53,6 +53,7 @@
 #include "p_saveg.h"
 
 #include "i_endoom.h"
+#include "i_instance.h"
 #include "i_input.h"
 #include "i_joystick.h"
 #include "i_system.h"
@@ -71,6 +72,7 @@
 
 #include "p_setup.h"
 #include "r_local.h"
+#include "r_threads.h"
 #include "statdump.h"
 
 
@@ -89,43 +91,43 @@ void D_DoomLoop (void);
 
 // Location where savegames are stored
 
-char *          savegamedir;
+INSTANCE char *          savegamedir;
 
 // location of IWAD and WAD files
 
-char *          iwadfile;
+INSTANCE char *          iwadfile;
 
 
-boolean		devparm;	// started game with -devparm
-boolean         nomonsters;	// checkparm of -nomonsters
-boolean         respawnparm;	// checkparm of -respawn
-boolean         fastparm;	// checkparm of -fast
+INSTANCE boolean		devparm;	// started game with -devparm
+INSTANCE boolean         nomonsters;	// checkparm of -nomonsters
+INSTANCE boolean         respawnparm;	// checkparm of -respawn
+INSTANCE boolean         fastparm;	// checkparm of -fast
 
 //extern int soundVolume;
 //extern  int	sfxVolume;
 //extern  int	musicVolume;
 
-extern  boolean	inhelpscreens;
+extern INSTANCE  boolean	inhelpscreens;
 
-skill_t		startskill;
-int             startepisode;
-int		startmap;
-boolean		autostart;
-int             startloadgame;
+INSTANCE skill_t		startskill;
+INSTANCE int             startepisode;
+INSTANCE int		startmap;
+INSTANCE boolean		autostart;
+INSTANCE int             startloadgame;
 
-boolean		advancedemo;
+INSTANCE boolean		advancedemo;
 
 // Store demo, do not accept any inputs
-boolean         storedemo;
+INSTANCE boolean         storedemo;
 
 // If true, the main game loop has started.
-boolean         main_loop_started = false;
+INSTANCE boolean         main_loop_started = false;
 
-char		wadfile[1024];		// primary wad file
-char		mapdir[1024];           // directory of development maps
+INSTANCE char		wadfile[1024];		// primary wad file
+INSTANCE char		mapdir[1024];           // directory of development maps
 
-int             show_endoom = 1;
-int             show_diskicon = 1;
+INSTANCE int             show_endoom = 1;
+INSTANCE int             show_diskicon = 1;
 
 
 void D_ConnectNetGame(void);
@@ -161,19 +163,19 @@ void D_ProcessEvents (void)
 //
 
 // wipegamestate can be set to -1 to force a wipe on the next draw
-gamestate_t     wipegamestate = GS_DEMOSCREEN;
-extern  boolean setsizeneeded;
-extern  int             showMessages;
+INSTANCE gamestate_t     wipegamestate = GS_DEMOSCREEN;
+extern INSTANCE  boolean setsizeneeded;
+extern INSTANCE  int             showMessages;
 void R_ExecuteSetViewSize (void);
 
 boolean D_Display (void)
 {
-    static  boolean		viewactivestate = false;
-    static  boolean		menuactivestate = false;
-    static  boolean		inhelpscreensstate = false;
-    static  boolean		fullscreen = false;
-    static  gamestate_t		oldgamestate = -1;
-    static  int			borderdrawcount;
+    static INSTANCE  boolean		viewactivestate = false;
+    static INSTANCE  boolean		menuactivestate = false;
+    static INSTANCE  boolean		inhelpscreensstate = false;
+    static INSTANCE  boolean		fullscreen = false;
+    static INSTANCE  gamestate_t		oldgamestate = -1;
+    static INSTANCE  int			borderdrawcount;
     int				y;
     boolean			wipe;
     boolean			redrawsbar;
@@ -235,6 +237,8 @@ boolean D_Display (void)
     // draw the view directly
     if (gamestate == GS_LEVEL && !automapactive && gametic)
 	R_RenderPlayerView (&players[displayplayer]);
+    else
+	R_DropView ();
 
     if (gamestate == GS_LEVEL && gametic)
 	HU_Drawer ();
@@ -397,8 +401,16 @@ void D_RunFrame()
 {
     int nowtime;
     int tics;
-    static int wipestart;
-    static boolean wipe;
+    static INSTANCE int wipestart;
+    static INSTANCE boolean wipe;
+
+#ifdef SERVER
+    // Headless: there is nothing to draw and no sound to play, so
+    // only run the game.
+
+    TryRunTics();
+    return;
+#endif
 
     if (wipe)
     {
@@ -478,6 +490,8 @@ void D_DoomLoop (void)
         wipegamestate = gamestate;
     }
 
+    I_InstanceReady();
+
     while (1)
     {
         D_RunFrame();
@@ -489,9 +503,9 @@ void D_DoomLoop (void)
 //
 //  DEMO LOOP
 //
-int             demosequence;
-int             pagetic;
-const char                    *pagename;
+INSTANCE int             demosequence;
+INSTANCE int             pagetic;
+INSTANCE const char                    *pagename;
 
 
 //
@@ -892,7 +906,7 @@ void D_SetGameDescription(void)
 }
 
 //      print title for every printed line
-char            title[128];
+INSTANCE char            title[128];
 
 static boolean D_AddFile(char *filename)
 {
@@ -1128,6 +1142,10 @@ static void D_Endoom(void)
 {
     byte *endoom;
 
+#ifdef SERVER
+    return;
+#endif
+
     // Don't show ENDOOM if we have it disabled, or we're running
     // in screensaver or control test mode. Only show it once the
     // game has actually started.
@@ -1383,8 +1401,8 @@ void D_DoomMain (void)
     if ( (p=M_CheckParm ("-turbo")) )
     {
 	int     scale = 200;
-	extern int forwardmove[2];
-	extern int sidemove[2];
+	extern INSTANCE int forwardmove[2];
+	extern INSTANCE int sidemove[2];
 	
 	if (p<myargc-1)
 	    scale = atoi (myargv[p+1]);
@@ -1409,8 +1427,12 @@ void D_DoomMain (void)
     D_BindVariables();
     M_LoadDefaults();
 
-    // Save configuration at exit.
-    I_AtExit(M_SaveDefaults, false);
+    // Save configuration at exit.  Not when hosting several matches,
+    // as they would all write to the same file.
+    if (I_NumInstances() == 1)
+    {
+        I_AtExit(M_SaveDefaults, false);
+    }
 
     // Find main IWAD file and load it.
     iwadfile = D_FindIWAD(IWAD_MASK_DOOM, &gamemission);
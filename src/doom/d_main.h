@@ -43,7 +43,7 @@ void D_StartTitle (void);
 // GLOBAL VARIABLES
 //
 
-extern  gameaction_t    gameaction;
+extern INSTANCE  gameaction_t    gameaction;
 
 
 #endif
@@ -35,14 +35,19 @@
 #include "deh_main.h"
 
 #include "d_loop.h"
+#include "net_client.h"
 
-ticcmd_t *netcmds;
+INSTANCE ticcmd_t *netcmds;
+
+// The gametic at which a snapshot of the game was last loaded.
+
+static INSTANCE int snapshot_gametic = -1;
 
 // Called when a player leaves the game
 
 static void PlayerQuitGame(player_t *player)
 {
-    static char exitmsg[80];
+    static INSTANCE char exitmsg[80];
     unsigned int player_num;
 
     player_num = player - players;
@@ -66,11 +71,66 @@ static void PlayerQuitGame(player_t *player)
     }
 }
 
+// Called when a player joins a game in progress
+
+static void PlayerJoinGame(player_t *player)
+{
+    static INSTANCE char joinmsg[80];
+    unsigned int player_num;
+
+    player_num = player - players;
+
+    M_snprintf(joinmsg, sizeof(joinmsg), "Player %d joined the game",
+               player_num + 1);
+
+    playeringame[player_num] = true;
+    player->playerstate = PST_REBORN;
+    players[consoleplayer].message = joinmsg;
+}
+
+static boolean LoadSnapshot(byte *data, size_t len)
+{
+    snapshot_gametic = gametic;
+
+    return G_LoadSnapshot(data, len);
+}
+
 static void RunTic(ticcmd_t *cmds, boolean *ingame)
 {
-    extern boolean advancedemo;
+    extern INSTANCE boolean advancedemo;
+    boolean joining;
+    byte *snapshot;
+    size_t len;
     unsigned int i;
 
+    // Has anyone joined the game in progress?  They start from a
+    // snapshot of the game saved at this tic, so the rest of us throw
+    // away anything the snapshot did not keep, by saving and loading
+    // the same snapshot ourselves.  Otherwise the game would go out of
+    // sync.
+
+    joining = false;
+
+    for (i = 0; i < MAXPLAYERS; ++i)
+    {
+        if (!demoplayback && !playeringame[i] && ingame[i])
+        {
+            joining = true;
+        }
+    }
+
+    if (joining && gamestate == GS_LEVEL && snapshot_gametic != gametic)
+    {
+        snapshot = G_SaveSnapshot(&len);
+
+        if (snapshot == NULL || !LoadSnapshot(snapshot, len))
+        {
+            I_Error("RunTic: Failed to reload the game for a new player");
+        }
+
+        free(snapshot);
+    }
+
     // Check for player quits.
 
     for (i = 0; i < MAXPLAYERS; ++i)
@@ -81,6 +141,16 @@ static void RunTic(ticcmd_t *cmds, boolean *ingame)
         }
     }
 
+    // Check for player joins.
+
+    for (i = 0; i < MAXPLAYERS; ++i)
+    {
+        if (!demoplayback && !playeringame[i] && ingame[i])
+        {
+            PlayerJoinGame(&players[i]);
+        }
+    }
+
     netcmds = cmds;
 
     // check that there are players in the game.  if not, we cannot
@@ -92,11 +162,13 @@ static void RunTic(ticcmd_t *cmds, boolean *ingame)
     G_Ticker ();
 }
 
-static loop_interface_t doom_loop_interface = {
+static INSTANCE loop_interface_t doom_loop_interface = {
     D_ProcessEvents,
     G_BuildTiccmd,
     RunTic,
-    M_Ticker
+    M_Ticker,
+    G_SaveSnapshot,
+    LoadSnapshot,
 };
 
 
@@ -129,6 +201,18 @@ static void LoadGameSettings(net_gamesettings_t *settings)
     {
         playeringame[i] = i < settings->num_players;
     }
+
+    // If we are joining a game in progress, we are not in it until the
+    // server says so; who is playing comes with the snapshot of the
+    // game.
+
+    if (NET_CL_GetJoinTic(&i))
+    {
+        for (i = 0; i < MAXPLAYERS; ++i)
+        {
+            playeringame[i] = false;
+        }
+    }
 }
 
 // Save the game settings from global variables to the specified
@@ -32,35 +32,41 @@ typedef struct
     cheatseq_t *seq;
 } deh_cheat_t;
 
-static deh_cheat_t allcheats[] =
-{
-    {"Change music",        &cheat_mus },
-    {"Chainsaw",            &cheat_choppers },
-    {"God mode",            &cheat_god },
-    {"Ammo & Keys",         &cheat_ammo },
-    {"Ammo",                &cheat_ammonokey },
-    {"No Clipping 1",       &cheat_noclip },
-    {"No Clipping 2",       &cheat_commercial_noclip },
-    {"Invincibility",       &cheat_powerup[0] },
-    {"Berserk",             &cheat_powerup[1] },
-    {"Invisibility",        &cheat_powerup[2] },
-    {"Radiation Suit",      &cheat_powerup[3] },
-    {"Auto-map",            &cheat_powerup[4] },
-    {"Lite-Amp Goggles",    &cheat_powerup[5] },
-    {"BEHOLD menu",         &cheat_powerup[6] },
-    {"Level Warp",          &cheat_clev },
-    {"Player Position",     &cheat_mypos },
-    {"Map cheat",           &cheat_amap },
-};
+// The table is built where it is needed, as each match in the server
+// build has its own copy of the cheat sequences (see INSTANCE in
+// doomtype.h), whose addresses are only known at run time.
+
+#define DEH_ALL_CHEATS(name)                                  \
+    deh_cheat_t name[] =                                      \
+    {                                                         \
+        {"Change music",        &cheat_mus },                 \
+        {"Chainsaw",            &cheat_choppers },            \
+        {"God mode",            &cheat_god },                 \
+        {"Ammo & Keys",         &cheat_ammo },                \
+        {"Ammo",                &cheat_ammonokey },           \
+        {"No Clipping 1",       &cheat_noclip },              \
+        {"No Clipping 2",       &cheat_commercial_noclip },   \
+        {"Invincibility",       &cheat_powerup[0] },          \
+        {"Berserk",             &cheat_powerup[1] },          \
+        {"Invisibility",        &cheat_powerup[2] },          \
+        {"Radiation Suit",      &cheat_powerup[3] },          \
+        {"Auto-map",            &cheat_powerup[4] },          \
+        {"Lite-Amp Goggles",    &cheat_powerup[5] },          \
+        {"BEHOLD menu",         &cheat_powerup[6] },          \
+        {"Level Warp",          &cheat_clev },                \
+        {"Player Position",     &cheat_mypos },               \
+        {"Map cheat",           &cheat_amap },                \
+    }
 
-static deh_cheat_t *FindCheatByName(char *name)
+static cheatseq_t *FindCheatByName(char *name)
 {
+    DEH_ALL_CHEATS(allcheats);
     size_t i;
     
     for (i=0; i<arrlen(allcheats); ++i)
     {
         if (!strcasecmp(allcheats[i].name, name))
-            return &allcheats[i];
+            return allcheats[i].seq;
     }
 
     return NULL;
@@ -73,7 +79,7 @@ static void *DEH_CheatStart(deh_context_t *context, char *line)
 
 static void DEH_CheatParseLine(deh_context_t *context, char *line, void *tag)
 {
-    deh_cheat_t *cheat;
+    cheatseq_t *cheat;
     char *variable_name;
     char *value;
     unsigned char *unsvalue;
@@ -106,7 +112,7 @@ static void DEH_CheatParseLine(deh_context_t *context, char *line, void *tag)
         // If the cheat length exceeds the Vanilla limit, stop.  This
         // does not apply if we have the limit turned off.
 
-        if (!deh_allow_long_cheats && i >= cheat->seq->sequence_len)
+        if (!deh_allow_long_cheats && i >= cheat->sequence_len)
         {
             DEH_Warning(context, "Cheat sequence longer than supported by "
                                  "Vanilla dehacked");
@@ -115,13 +121,13 @@ static void DEH_CheatParseLine(deh_context_t *context, char *line, void *tag)
 
 	if (deh_apply_cheats)
 	{
-	    cheat->seq->sequence[i] = unsvalue[i];
+	    cheat->sequence[i] = unsvalue[i];
 	}
         ++i;
 
         // Absolute limit - don't exceed
 
-        if (i >= MAX_CHEAT_LEN - cheat->seq->parameter_chars)
+        if (i >= MAX_CHEAT_LEN - cheat->parameter_chars)
         {
             DEH_Error(context, "Cheat sequence too long!");
             return;
@@ -130,7 +136,7 @@ static void DEH_CheatParseLine(deh_context_t *context, char *line, void *tag)
 
     if (deh_apply_cheats)
     {
-        cheat->seq->sequence[i] = '\0';
+        cheat->sequence[i] = '\0';
     }
 }
 
@@ -28,25 +28,25 @@
 // This is the initial health a player has when starting anew.
 // See G_PlayerReborn in g_game.c
 
-int deh_initial_health = DEH_DEFAULT_INITIAL_HEALTH;
+INSTANCE int deh_initial_health = DEH_DEFAULT_INITIAL_HEALTH;
 
 // Dehacked: "Initial bullets"
 // This is the number of bullets the player has when starting anew.
 // See G_PlayerReborn in g_game.c
 
-int deh_initial_bullets = DEH_DEFAULT_INITIAL_BULLETS;
+INSTANCE int deh_initial_bullets = DEH_DEFAULT_INITIAL_BULLETS;
 
 // Dehacked: "Max Health"
 // This is the maximum health that can be reached using health
 // potions. See P_TouchSpecialThing in p_inter.c
 
-int deh_max_health = DEH_DEFAULT_MAX_HEALTH;
+INSTANCE int deh_max_health = DEH_DEFAULT_MAX_HEALTH;
 
 // Dehacked: "Max Armor"
 // This is the maximum armor which can be reached by picking up
 // armor helmets. See P_TouchSpecialThing in p_inter.c
 
-int deh_max_armor = DEH_DEFAULT_MAX_ARMOR;
+INSTANCE int deh_max_armor = DEH_DEFAULT_MAX_ARMOR;
 
 // Dehacked: "Green Armor Class"
 // This is the armor class that is given when picking up the green 
@@ -55,7 +55,7 @@ int deh_max_armor = DEH_DEFAULT_MAX_ARMOR;
 // DOS dehacked only modifies the behavior of the green armor shirt,
 // the armor class set by armor helmets is not affected.
 
-int deh_green_armor_class = DEH_DEFAULT_GREEN_ARMOR_CLASS;
+INSTANCE int deh_green_armor_class = DEH_DEFAULT_GREEN_ARMOR_CLASS;
 
 // Dehacked: "Blue Armor Class"
 // This is the armor class that is given when picking up the blue 
@@ -64,61 +64,61 @@ int deh_green_armor_class = DEH_DEFAULT_GREEN_ARMOR_CLASS;
 // DOS dehacked only modifies the MegaArmor behavior and not
 // the MegaSphere, which always gives armor type 2.
 
-int deh_blue_armor_class = DEH_DEFAULT_BLUE_ARMOR_CLASS;
+INSTANCE int deh_blue_armor_class = DEH_DEFAULT_BLUE_ARMOR_CLASS;
 
 // Dehacked: "Max soulsphere"
 // The maximum health which can be reached by picking up the
 // soulsphere.  See P_TouchSpecialThing in p_inter.c
 
-int deh_max_soulsphere = DEH_DEFAULT_MAX_SOULSPHERE;
+INSTANCE int deh_max_soulsphere = DEH_DEFAULT_MAX_SOULSPHERE;
 
 // Dehacked: "Soulsphere health"
 // The amount of health bonus that picking up a soulsphere
 // gives.  See P_TouchSpecialThing in p_inter.c
 
-int deh_soulsphere_health = DEH_DEFAULT_SOULSPHERE_HEALTH;
+INSTANCE int deh_soulsphere_health = DEH_DEFAULT_SOULSPHERE_HEALTH;
 
 // Dehacked: "Megasphere health"
 // This is what the health is set to after picking up a 
 // megasphere.  See P_TouchSpecialThing in p_inter.c
 
-int deh_megasphere_health = DEH_DEFAULT_MEGASPHERE_HEALTH;
+INSTANCE int deh_megasphere_health = DEH_DEFAULT_MEGASPHERE_HEALTH;
 
 // Dehacked: "God mode health"
 // This is what the health value is set to when cheating using
 // the IDDQD god mode cheat.  See ST_Responder in st_stuff.c
 
-int deh_god_mode_health = DEH_DEFAULT_GOD_MODE_HEALTH;
+INSTANCE int deh_god_mode_health = DEH_DEFAULT_GOD_MODE_HEALTH;
 
 // Dehacked: "IDFA Armor"
 // This is what the armor is set to when using the IDFA cheat.
 // See ST_Responder in st_stuff.c
 
-int deh_idfa_armor = DEH_DEFAULT_IDFA_ARMOR;
+INSTANCE int deh_idfa_armor = DEH_DEFAULT_IDFA_ARMOR;
 
 // Dehacked: "IDFA Armor Class"
 // This is what the armor class is set to when using the IDFA cheat.
 // See ST_Responder in st_stuff.c
 
-int deh_idfa_armor_class = DEH_DEFAULT_IDFA_ARMOR_CLASS;
+INSTANCE int deh_idfa_armor_class = DEH_DEFAULT_IDFA_ARMOR_CLASS;
 
 // Dehacked: "IDKFA Armor"
 // This is what the armor is set to when using the IDKFA cheat.
 // See ST_Responder in st_stuff.c
 
-int deh_idkfa_armor = DEH_DEFAULT_IDKFA_ARMOR;
+INSTANCE int deh_idkfa_armor = DEH_DEFAULT_IDKFA_ARMOR;
 
 // Dehacked: "IDKFA Armor Class"
 // This is what the armor class is set to when using the IDKFA cheat.
 // See ST_Responder in st_stuff.c
 
-int deh_idkfa_armor_class = DEH_DEFAULT_IDKFA_ARMOR_CLASS;
+INSTANCE int deh_idkfa_armor_class = DEH_DEFAULT_IDKFA_ARMOR_CLASS;
 
 // Dehacked: "BFG Cells/Shot"
 // This is the number of CELLs firing the BFG uses up.
 // See P_CheckAmmo and A_FireBFG in p_pspr.c
 
-int deh_bfg_cells_per_shot = DEH_DEFAULT_BFG_CELLS_PER_SHOT;
+INSTANCE int deh_bfg_cells_per_shot = DEH_DEFAULT_BFG_CELLS_PER_SHOT;
 
 // Dehacked: "Monsters infight"
 // This controls whether monsters can harm other monsters of the same 
@@ -128,29 +128,37 @@ int deh_bfg_cells_per_shot = DEH_DEFAULT_BFG_CELLS_PER_SHOT;
 //
 // See PIT_CheckThing in p_map.c
 
-int deh_species_infighting = DEH_DEFAULT_SPECIES_INFIGHTING;
+INSTANCE int deh_species_infighting = DEH_DEFAULT_SPECIES_INFIGHTING;
 
-static struct
+typedef struct
 {
     const char *deh_name;
     int *value;
-} misc_settings[] = {
-    {"Initial Health",      &deh_initial_health},
-    {"Initial Bullets",     &deh_initial_bullets},
-    {"Max Health",          &deh_max_health},
-    {"Max Armor",           &deh_max_armor},
-    {"Green Armor Class",   &deh_green_armor_class},
-    {"Blue Armor Class",    &deh_blue_armor_class},
-    {"Max Soulsphere",      &deh_max_soulsphere},
-    {"Soulsphere Health",   &deh_soulsphere_health},
-    {"Megasphere Health",   &deh_megasphere_health},
-    {"God Mode Health",     &deh_god_mode_health},
-    {"IDFA Armor",          &deh_idfa_armor},
-    {"IDFA Armor Class",    &deh_idfa_armor_class},
-    {"IDKFA Armor",         &deh_idkfa_armor},
-    {"IDKFA Armor Class",   &deh_idkfa_armor_class},
-    {"BFG Cells/Shot",      &deh_bfg_cells_per_shot},
-};
+} deh_misc_setting_t;
+
+// The table is built where it is needed, as each match in the server
+// build has its own copy of the variables above (see INSTANCE in
+// doomtype.h), whose addresses are only known at run time.
+
+#define DEH_MISC_SETTINGS(name)                               \
+    deh_misc_setting_t name[] =                               \
+    {                                                         \
+        {"Initial Health",      &deh_initial_health},         \
+        {"Initial Bullets",     &deh_initial_bullets},        \
+        {"Max Health",          &deh_max_health},             \
+        {"Max Armor",           &deh_max_armor},              \
+        {"Green Armor Class",   &deh_green_armor_class},      \
+        {"Blue Armor Class",    &deh_blue_armor_class},       \
+        {"Max Soulsphere",      &deh_max_soulsphere},         \
+        {"Soulsphere Health",   &deh_soulsphere_health},      \
+        {"Megasphere Health",   &deh_megasphere_health},      \
+        {"God Mode Health",     &deh_god_mode_health},        \
+        {"IDFA Armor",          &deh_idfa_armor},             \
+        {"IDFA Armor Class",    &deh_idfa_armor_class},       \
+        {"IDKFA Armor",         &deh_idkfa_armor},            \
+        {"IDKFA Armor Class",   &deh_idkfa_armor_class},      \
+        {"BFG Cells/Shot",      &deh_bfg_cells_per_shot},     \
+    }
 
 static void *DEH_MiscStart(deh_context_t *context, char *line)
 {
@@ -159,6 +167,7 @@ static void *DEH_MiscStart(deh_context_t *context, char *line)
 
 static void DEH_MiscParseLine(deh_context_t *context, char *line, void *tag)
 {
+    DEH_MISC_SETTINGS(misc_settings);
     char *variable_name, *value;
     int ivalue;
     size_t i;
@@ -208,6 +217,7 @@ static void DEH_MiscParseLine(deh_context_t *context, char *line, void *tag)
 
 static void DEH_MiscSHA1Sum(sha1_context_t *context)
 {
+    DEH_MISC_SETTINGS(misc_settings);
     unsigned int i;
 
     for (i=0; i<arrlen(misc_settings); ++i)
@@ -18,6 +18,8 @@
 #ifndef DEH_MISC_H
 #define DEH_MISC_H
 
+#include "doomtype.h"
+
 #define DEH_DEFAULT_INITIAL_HEALTH 100
 #define DEH_DEFAULT_INITIAL_BULLETS 50
 #define DEH_DEFAULT_MAX_HEALTH 200
@@ -35,22 +37,22 @@
 #define DEH_DEFAULT_BFG_CELLS_PER_SHOT 40
 #define DEH_DEFAULT_SPECIES_INFIGHTING 0
 
-extern int deh_initial_health;
-extern int deh_initial_bullets;
-extern int deh_max_health;
-extern int deh_max_armor;
-extern int deh_green_armor_class;
-extern int deh_blue_armor_class;
-extern int deh_max_soulsphere;
-extern int deh_soulsphere_health;
-extern int deh_megasphere_health;
-extern int deh_god_mode_health;
-extern int deh_idfa_armor;
-extern int deh_idfa_armor_class;
-extern int deh_idkfa_armor;
-extern int deh_idkfa_armor_class;
-extern int deh_bfg_cells_per_shot;
-extern int deh_species_infighting;
+extern INSTANCE int deh_initial_health;
+extern INSTANCE int deh_initial_bullets;
+extern INSTANCE int deh_max_health;
+extern INSTANCE int deh_max_armor;
+extern INSTANCE int deh_green_armor_class;
+extern INSTANCE int deh_blue_armor_class;
+extern INSTANCE int deh_max_soulsphere;
+extern INSTANCE int deh_soulsphere_health;
+extern INSTANCE int deh_megasphere_health;
+extern INSTANCE int deh_god_mode_health;
+extern INSTANCE int deh_idfa_armor;
+extern INSTANCE int deh_idfa_armor_class;
+extern INSTANCE int deh_idkfa_armor;
+extern INSTANCE int deh_idkfa_armor_class;
+extern INSTANCE int deh_bfg_cells_per_shot;
+extern INSTANCE int deh_species_infighting;
 
 #if 0
 
@@ -26,7 +26,7 @@
 #include "deh_io.h"
 #include "deh_main.h"
 
-static actionf_t codeptrs[NUMSTATES];
+static INSTANCE actionf_t codeptrs[NUMSTATES];
 
 static int CodePointerIndex(actionf_t *ptr)
 {
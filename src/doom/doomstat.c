@@ -22,14 +22,14 @@
 
 
 // Game Mode - identify IWAD as shareware, retail etc.
-GameMode_t gamemode = indetermined;
-GameMission_t	gamemission = doom;
-GameVersion_t   gameversion = exe_final2;
-GameVariant_t   gamevariant = vanilla;
-const char *gamedescription;
+INSTANCE GameMode_t gamemode = indetermined;
+INSTANCE GameMission_t	gamemission = doom;
+INSTANCE GameVersion_t   gameversion = exe_final2;
+INSTANCE GameVariant_t   gamevariant = vanilla;
+INSTANCE const char *gamedescription;
 
 // Set if homebrew PWAD stuff has been added.
-boolean	modifiedgame;
+INSTANCE boolean	modifiedgame;
 
 
 
@@ -43,21 +43,21 @@
 // ------------------------
 // Command line parameters.
 //
-extern  boolean	nomonsters;	// checkparm of -nomonsters
-extern  boolean	respawnparm;	// checkparm of -respawn
-extern  boolean	fastparm;	// checkparm of -fast
+extern INSTANCE  boolean	nomonsters;	// checkparm of -nomonsters
+extern INSTANCE  boolean	respawnparm;	// checkparm of -respawn
+extern INSTANCE  boolean	fastparm;	// checkparm of -fast
 
-extern  boolean	devparm;	// DEBUG: launched with -devparm
+extern INSTANCE  boolean	devparm;	// DEBUG: launched with -devparm
 
 
 // -----------------------------------------------------
 // Game Mode - identify IWAD as shareware, retail etc.
 //
-extern GameMode_t	gamemode;
-extern GameMission_t	gamemission;
-extern GameVersion_t    gameversion;
-extern GameVariant_t    gamevariant;
-extern const char       *gamedescription;
+extern INSTANCE GameMode_t	gamemode;
+extern INSTANCE GameMission_t	gamemission;
+extern INSTANCE GameVersion_t    gameversion;
+extern INSTANCE GameVariant_t    gamevariant;
+extern INSTANCE const char       *gamedescription;
 
 // Convenience macro.
 // 'gamemission' can be equal to pack_chex or pack_hacx, but these are
@@ -69,7 +69,7 @@ extern const char       *gamedescription;
      gamemission == pack_hacx ? doom2 : gamemission)
 
 // Set if homebrew PWAD stuff has been added.
-extern  boolean	modifiedgame;
+extern INSTANCE  boolean	modifiedgame;
 
 
 // -------------------------------------------
@@ -77,33 +77,33 @@ extern  boolean	modifiedgame;
 //
 
 // Defaults for menu, methinks.
-extern  skill_t		startskill;
-extern  int             startepisode;
-extern	int		startmap;
+extern INSTANCE  skill_t		startskill;
+extern INSTANCE  int             startepisode;
+extern INSTANCE	int		startmap;
 
 // Savegame slot to load on startup.  This is the value provided to
 // the -loadgame option.  If this has not been provided, this is -1.
 
-extern  int             startloadgame;
+extern INSTANCE  int             startloadgame;
 
-extern  boolean		autostart;
+extern INSTANCE  boolean		autostart;
 
 // Selected by user. 
-extern  skill_t         gameskill;
-extern  int		gameepisode;
-extern  int		gamemap;
+extern INSTANCE  skill_t         gameskill;
+extern INSTANCE  int		gameepisode;
+extern INSTANCE  int		gamemap;
 
 // If non-zero, exit the level after this number of minutes
-extern  int             timelimit;
+extern INSTANCE  int             timelimit;
 
 // Nightmare mode flag, single player.
-extern  boolean         respawnmonsters;
+extern INSTANCE  boolean         respawnmonsters;
 
 // Netgame? Only true if >1 player.
-extern  boolean	netgame;
+extern INSTANCE  boolean	netgame;
 
 // 0=Cooperative; 1=Deathmatch; 2=Altdeath
-extern int deathmatch;
+extern INSTANCE int deathmatch;
 
 // -------------------------
 // Internal parameters for sound rendering.
@@ -115,8 +115,8 @@ extern int deathmatch;
 //  Sound FX volume has default, 0 - 15
 //  Music volume has default, 0 - 15
 // These are multiplied by 8.
-extern int sfxVolume;
-extern int musicVolume;
+extern INSTANCE int sfxVolume;
+extern INSTANCE int musicVolume;
 
 // Current music/sfx card - index useless
 //  w/o a reference LUT in a sound module.
@@ -138,42 +138,42 @@ extern int snd_DesiredSfxDevice;
 //  status bar explicitely.
 extern  boolean statusbaractive;
 
-extern  boolean automapactive;	// In AutoMap mode?
-extern  boolean	menuactive;	// Menu overlayed?
-extern  boolean	paused;		// Game Pause?
+extern INSTANCE  boolean automapactive;	// In AutoMap mode?
+extern INSTANCE  boolean	menuactive;	// Menu overlayed?
+extern INSTANCE  boolean	paused;		// Game Pause?
 
 
-extern  boolean		viewactive;
+extern INSTANCE  boolean		viewactive;
 
-extern  boolean		nodrawers;
+extern INSTANCE  boolean		nodrawers;
 
 
-extern  boolean         testcontrols;
-extern  int             testcontrols_mousespeed;
+extern INSTANCE  boolean         testcontrols;
+extern INSTANCE  int             testcontrols_mousespeed;
 
 
 
 
 // This one is related to the 3-screen display mode.
 // ANG90 = left side, ANG270 = right
-extern  int	viewangleoffset;
+extern INSTANCE  int	viewangleoffset;
 
 // Player taking events, and displaying.
-extern  int	consoleplayer;	
-extern  int	displayplayer;
+extern INSTANCE  int	consoleplayer;	
+extern INSTANCE  int	displayplayer;
 
 
 // -------------------------------------
 // Scores, rating.
 // Statistics on a given map, for intermission.
 //
-extern  int	totalkills;
-extern	int	totalitems;
-extern	int	totalsecret;
+extern INSTANCE  int	totalkills;
+extern INSTANCE	int	totalitems;
+extern INSTANCE	int	totalsecret;
 
 // Timer, for scores.
-extern  int	levelstarttic;	// gametic at level start
-extern  int	leveltime;	// tics in game play for par
+extern INSTANCE  int	levelstarttic;	// gametic at level start
+extern INSTANCE  int	leveltime;	// tics in game play for par
 
 
 
@@ -181,25 +181,25 @@ extern  int	leveltime;	// tics in game play for par
 // DEMO playback/recording related stuff.
 // No demo, there is a human player in charge?
 // Disable save/end game?
-extern  boolean	usergame;
+extern INSTANCE  boolean	usergame;
 
 //?
-extern  boolean	demoplayback;
-extern  boolean	demorecording;
+extern INSTANCE  boolean	demoplayback;
+extern INSTANCE  boolean	demorecording;
 
 // Round angleturn in ticcmds to the nearest 256.  This is used when
 // recording Vanilla demos in netgames.
 
-extern boolean lowres_turn;
+extern INSTANCE boolean lowres_turn;
 
 // Quit after playing a demo from cmdline.
-extern  boolean		singledemo;	
+extern INSTANCE  boolean		singledemo;	
 
 
 
 
 //?
-extern  gamestate_t     gamestate;
+extern INSTANCE  gamestate_t     gamestate;
 
 
 
@@ -215,23 +215,23 @@ extern  gamestate_t     gamestate;
 
 
 // Bookkeeping on players - state.
-extern	player_t	players[MAXPLAYERS];
+extern INSTANCE	player_t	players[MAXPLAYERS];
 
 // Alive? Disconnected?
-extern  boolean		playeringame[MAXPLAYERS];
+extern INSTANCE  boolean		playeringame[MAXPLAYERS];
 
 
 // Player spawn spots for deathmatch.
 #define MAX_DM_STARTS   32
-extern  mapthing_t      deathmatchstarts[MAX_DM_STARTS];
-extern  mapthing_t*	deathmatch_p;
+extern INSTANCE  mapthing_t      deathmatchstarts[MAX_DM_STARTS];
+extern INSTANCE  mapthing_t*	deathmatch_p;
 
 // Player spawn spots.
-extern  mapthing_t      playerstarts[MAXPLAYERS];
-extern  boolean         playerstartsingame[MAXPLAYERS];
+extern INSTANCE  mapthing_t      playerstarts[MAXPLAYERS];
+extern INSTANCE  boolean         playerstartsingame[MAXPLAYERS];
 // Intermission stats.
 // Parameters for world map / intermission.
-extern  wbstartstruct_t		wminfo;	
+extern INSTANCE  wbstartstruct_t		wminfo;	
 
 
 
@@ -244,35 +244,36 @@ extern  wbstartstruct_t		wminfo;
 //
 
 // File handling stuff.
-extern  char        *savegamedir;
+extern INSTANCE  char        *savegamedir;
 
 // if true, load all graphics at level load
-extern  boolean         precache;
+extern INSTANCE  boolean         precache;
 
 
 // wipegamestate can be set to -1
 //  to force a wipe on the next draw
-extern  gamestate_t     wipegamestate;
+extern INSTANCE  gamestate_t     wipegamestate;
 
-extern  int             mouseSensitivity;
+extern INSTANCE  int             mouseSensitivity;
 
-extern  int             bodyqueslot;
+extern INSTANCE  int             bodyqueslot;
 
 
 
 // Needed to store the number of the dummy sky flat.
 // Used for rendering,
 //  as well as tracking projectiles etc.
-extern int		skyflatnum;
+extern INSTANCE int		skyflatnum;
 
 
 
 // Netgame stuff (buffers and pointers, i.e. indices).
 
 
-extern	int		rndindex;
+extern INSTANCE	int		rndindex;
+extern INSTANCE	int		prndindex;
 
-extern  ticcmd_t       *netcmds;
+extern INSTANCE  ticcmd_t       *netcmds;
 
 
 #endif
@@ -50,9 +50,9 @@ typedef enum
 //#include "f_finale.h"
 
 // Stage of animation:
-finalestage_t finalestage;
+INSTANCE finalestage_t finalestage;
 
-unsigned int finalecount;
+INSTANCE unsigned int finalecount;
 
 #define	TEXTSPEED	3
 #define	TEXTWAIT	250
@@ -94,8 +94,8 @@ static textscreen_t textscreens[] =
     { pack_plut, 1, 31, "RROCK19",   P6TEXT},
 };
 
-const char *finaletext;
-const char *finaleflat;
+INSTANCE const char *finaletext;
+INSTANCE const char *finaleflat;
 
 void	F_StartCast (void);
 void	F_CastTicker (void);
@@ -221,7 +221,7 @@ void F_Ticker (void)
 //
 
 #include "hu_stuff.h"
-extern	patch_t *hu_font[HU_FONTSIZE];
+extern INSTANCE	patch_t *hu_font[HU_FONTSIZE];
 
 
 void F_TextWrite (void)
@@ -325,13 +325,13 @@ castinfo_t	castorder[] = {
     {NULL,0}
 };
 
-int		castnum;
-int		casttics;
-state_t*	caststate;
-boolean		castdeath;
-int		castframes;
-int		castonmelee;
-boolean		castattacking;
+INSTANCE int		castnum;
+INSTANCE int		casttics;
+INSTANCE state_t*	caststate;
+INSTANCE boolean		castdeath;
+INSTANCE int		castframes;
+INSTANCE int		castonmelee;
+INSTANCE boolean		castattacking;
 
 
 //
@@ -611,7 +611,7 @@ void F_BunnyScroll (void)
     patch_t*	p2;
     char	name[10];
     int		stage;
-    static int	laststage;
+    static INSTANCE int	laststage;
 		
     p1 = W_CacheLumpName (DEH_String("PFUB2"), PU_LEVEL);
     p2 = W_CacheLumpName (DEH_String("PFUB1"), PU_LEVEL);
@@ -32,11 +32,11 @@
 //
 
 // when zero, stop the wipe
-static boolean	go = 0;
+static INSTANCE boolean	go = 0;
 
-static pixel_t*	wipe_scr_start;
-static pixel_t*	wipe_scr_end;
-static pixel_t*	wipe_scr;
+static INSTANCE pixel_t*	wipe_scr_start;
+static INSTANCE pixel_t*	wipe_scr_end;
+static INSTANCE pixel_t*	wipe_scr;
 
 
 void
@@ -127,7 +127,7 @@ wipe_exitColorXForm
 }
 
 
-static int*	y;
+static INSTANCE int*	y;
 
 int
 wipe_initMelt
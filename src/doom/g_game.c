@@ -92,86 +92,75 @@ void	G_DoSaveGame (void);
 
 // Gamestate the last time G_Ticker was called.
 
-gamestate_t     oldgamestate;
+INSTANCE gamestate_t     oldgamestate;
 
-gameaction_t    gameaction;
-gamestate_t     gamestate;
-skill_t         gameskill;
-boolean		respawnmonsters;
-int             gameepisode;
-int             gamemap;
+INSTANCE gameaction_t    gameaction;
+INSTANCE gamestate_t     gamestate;
+INSTANCE skill_t         gameskill;
+INSTANCE boolean		respawnmonsters;
+INSTANCE int             gameepisode;
+INSTANCE int             gamemap;
 
 // If non-zero, exit the level after this number of minutes.
 
-int             timelimit;
+INSTANCE int             timelimit;
 
-boolean         paused;
-boolean         sendpause;             	// send a pause event next tic
-boolean         sendsave;             	// send a save event next tic
-boolean         usergame;               // ok to save / end game
+INSTANCE boolean         paused;
+INSTANCE boolean         sendpause;             	// send a pause event next tic
+INSTANCE boolean         sendsave;             	// send a save event next tic
+INSTANCE boolean         usergame;               // ok to save / end game
 
-boolean         timingdemo;             // if true, exit with report on completion
-boolean         nodrawers;              // for comparative timing purposes
-int             starttime;          	// for comparative timing purposes
+INSTANCE boolean         timingdemo;             // if true, exit with report on completion
+INSTANCE boolean         nodrawers;              // for comparative timing purposes
+INSTANCE int             starttime;          	// for comparative timing purposes
 
-boolean         viewactive;
+INSTANCE boolean         viewactive;
 
-int             deathmatch;           	// only if started as net death
-boolean         netgame;                // only true if packets are broadcast
-boolean         playeringame[MAXPLAYERS];
-player_t        players[MAXPLAYERS];
+INSTANCE int             deathmatch;           	// only if started as net death
+INSTANCE boolean         netgame;                // only true if packets are broadcast
+INSTANCE boolean         playeringame[MAXPLAYERS];
+INSTANCE player_t        players[MAXPLAYERS];
 
-boolean         turbodetected[MAXPLAYERS];
+INSTANCE boolean         turbodetected[MAXPLAYERS];
 
-int             consoleplayer;          // player taking events and displaying
-int             displayplayer;          // view being displayed
-int             levelstarttic;          // gametic at level start
-int             totalkills, totalitems, totalsecret;    // for intermission
+INSTANCE int             consoleplayer;          // player taking events and displaying
+INSTANCE int             displayplayer;          // view being displayed
+INSTANCE int             levelstarttic;          // gametic at level start
+INSTANCE int             totalkills, totalitems, totalsecret;    // for intermission
 
-char           *demoname;
-boolean         demorecording;
-boolean         longtics;               // cph's doom 1.91 longtics hack
-boolean         lowres_turn;            // low resolution turning for longtics
-boolean         demoplayback;
-boolean		netdemo;
-byte*		demobuffer;
-byte*		demo_p;
-byte*		demoend;
-boolean         singledemo;            	// quit after playing a demo from cmdline
+INSTANCE char           *demoname;
+INSTANCE boolean         demorecording;
+INSTANCE boolean         longtics;               // cph's doom 1.91 longtics hack
+INSTANCE boolean         lowres_turn;            // low resolution turning for longtics
+INSTANCE boolean         demoplayback;
+INSTANCE boolean		netdemo;
+INSTANCE byte*		demobuffer;
+INSTANCE byte*		demo_p;
+INSTANCE byte*		demoend;
+INSTANCE boolean         singledemo;            	// quit after playing a demo from cmdline
 
-boolean         precache = true;        // if true, load all graphics at start
+INSTANCE boolean         precache = true;        // if true, load all graphics at start
 
-boolean         testcontrols = false;    // Invoked by setup to test controls
-int             testcontrols_mousespeed;
+INSTANCE boolean         testcontrols = false;    // Invoked by setup to test controls
+INSTANCE int             testcontrols_mousespeed;
 
 
 
-wbstartstruct_t wminfo;               	// parms for world map / intermission
+INSTANCE wbstartstruct_t wminfo;               	// parms for world map / intermission
 
-byte		consistancy[MAXPLAYERS][BACKUPTICS];
+INSTANCE byte		consistancy[MAXPLAYERS][BACKUPTICS];
 
 #define MAXPLMOVE		(forwardmove[1])
 
 #define TURBOTHRESHOLD	0x32
 
-fixed_t         forwardmove[2] = {0x19, 0x32};
-fixed_t         sidemove[2] = {0x18, 0x28};
-fixed_t         angleturn[3] = {640, 1280, 320};    // + slow turn
-
-static int *weapon_keys[] = {
-    &key_weapon1,
-    &key_weapon2,
-    &key_weapon3,
-    &key_weapon4,
-    &key_weapon5,
-    &key_weapon6,
-    &key_weapon7,
-    &key_weapon8
-};
+INSTANCE fixed_t         forwardmove[2] = {0x19, 0x32};
+INSTANCE fixed_t         sidemove[2] = {0x18, 0x28};
+INSTANCE fixed_t         angleturn[3] = {640, 1280, 320};    // + slow turn
 
 // Set to -1 or +1 to switch to the previous or next weapon.
 
-static int next_weapon = 0;
+static INSTANCE int next_weapon = 0;
 
 // Used for prev/next weapon keys.
 
@@ -196,40 +185,40 @@ static const struct
 #define NUMKEYS		256
 #define MAX_JOY_BUTTONS 20
 
-static boolean  gamekeydown[NUMKEYS];
-static int      turnheld;		// for accelerative turning
+static INSTANCE boolean  gamekeydown[NUMKEYS];
+static INSTANCE int      turnheld;		// for accelerative turning
 
-static boolean  mousearray[MAX_MOUSE_BUTTONS + 1];
-static boolean *mousebuttons = &mousearray[1];  // allow [-1]
+static INSTANCE boolean  mousearray[MAX_MOUSE_BUTTONS + 1];
+#define mousebuttons (&mousearray[1])                   // allow [-1]
 
 // mouse values are used once
-int             mousex;
-int             mousey;
+INSTANCE int             mousex;
+INSTANCE int             mousey;
 
-static int      dclicktime;
-static boolean  dclickstate;
-static int      dclicks;
-static int      dclicktime2;
-static boolean  dclickstate2;
-static int      dclicks2;
+static INSTANCE int      dclicktime;
+static INSTANCE boolean  dclickstate;
+static INSTANCE int      dclicks;
+static INSTANCE int      dclicktime2;
+static INSTANCE boolean  dclickstate2;
+static INSTANCE int      dclicks2;
 
 // joystick values are repeated
-static int      joyxmove;
-static int      joyymove;
-static int      joystrafemove;
-static boolean  joyarray[MAX_JOY_BUTTONS + 1];
-static boolean *joybuttons = &joyarray[1];		// allow [-1]
+static INSTANCE int      joyxmove;
+static INSTANCE int      joyymove;
+static INSTANCE int      joystrafemove;
+static INSTANCE boolean  joyarray[MAX_JOY_BUTTONS + 1];
+#define joybuttons (&joyarray[1])			// allow [-1]
 
-static int      savegameslot;
-static char     savedescription[32];
+static INSTANCE int      savegameslot;
+static INSTANCE char     savedescription[32];
 
 #define	BODYQUESIZE	32
 
-mobj_t*		bodyque[BODYQUESIZE];
-int		bodyqueslot;
+INSTANCE mobj_t*		bodyque[BODYQUESIZE];
+INSTANCE int		bodyqueslot;
 
-int             vanilla_savegame_limit = 1;
-int             vanilla_demo_limit = 1;
+INSTANCE int             vanilla_savegame_limit = 1;
+INSTANCE int             vanilla_demo_limit = 1;
 
 int G_CmdChecksum (ticcmd_t* cmd)
 {
@@ -315,7 +304,7 @@ static int G_NextWeapon(int direction)
 }
 
 
-int ooo_prevent_shooting = 1;
+INSTANCE int ooo_prevent_shooting = 1;
 
 //
 // G_BuildTiccmd
@@ -466,6 +455,17 @@ void G_BuildTiccmd (ticcmd_t* cmd, int maketic)
     }
     else
     {
+        int *weapon_keys[] = {
+            &key_weapon1,
+            &key_weapon2,
+            &key_weapon3,
+            &key_weapon4,
+            &key_weapon5,
+            &key_weapon6,
+            &key_weapon7,
+            &key_weapon8
+        };
+
         // Check weapon keys.
 
         for (i=0; i<arrlen(weapon_keys); ++i)
@@ -592,7 +592,7 @@ void G_BuildTiccmd (ticcmd_t* cmd, int maketic)
 
     if (lowres_turn)
     {
-        static signed short carry = 0;
+        static INSTANCE signed short carry = 0;
         signed short desired_angleturn;
 
         desired_angleturn = cmd->angleturn + carry;
@@ -948,7 +948,7 @@ void G_Ticker (void)
              && ((gametic >> 5) % MAXPLAYERS) == i
              && turbodetected[i])
             {
-                static char turbomessage[80];
+                static INSTANCE char turbomessage[80];
                 extern char *player_names[32];
                 M_snprintf(turbomessage, sizeof(turbomessage),
                            "%s is turbo!", player_names[i]);
@@ -1140,7 +1140,8 @@ G_CheckSpot
     {
 	// first spawn of level, before corpses
 	for (i=0 ; i<playernum ; i++)
-	    if (players[i].mo->x == mthing->x << FRACBITS
+	    if (players[i].mo != NULL
+		&& players[i].mo->x == mthing->x << FRACBITS
 		&& players[i].mo->y == mthing->y << FRACBITS)
 		return false;
 	return true;
@@ -1274,9 +1275,10 @@ void G_DoReborn (int playernum)
     {
 	// respawn at the start
 
-	// first dissasociate the corpse
-    assert(players[playernum].mo != NULL);
-	players[playernum].mo->player = NULL;
+	// first dissasociate the corpse (someone who has joined a
+	// game in progress may not have one)
+	if (players[playernum].mo != NULL)
+	    players[playernum].mo->player = NULL;
 
 	// spawn at random spot if in death match
 	if (deathmatch)
@@ -1285,7 +1287,8 @@ void G_DoReborn (int playernum)
 	    return;
 	}
 
-	if (G_CheckSpot (playernum, &playerstarts[playernum]) )
+	if (playerstarts[playernum].type != 0
+	 && G_CheckSpot (playernum, &playerstarts[playernum]) )
 	{
 	    P_SpawnPlayer (&playerstarts[playernum]);
 	    return;
@@ -1294,6 +1297,9 @@ void G_DoReborn (int playernum)
 	// try to spawn at one of the other players spots
 	for (i=0 ; i<MAXPLAYERS ; i++)
 	{
+	    if (playerstarts[i].type == 0)
+		continue;	// no such spot on this map
+
 	    if (G_CheckSpot (playernum, &playerstarts[i]) )
 	    {
 		playerstarts[i].type = playernum+1;	// fake as other player
@@ -1303,6 +1309,19 @@ void G_DoReborn (int playernum)
 	    }
 	    // he's going to be inside something.  Too bad.
 	}
+
+	// If there is no spot of his own on this map, any other will do.
+	for (i=0 ; playerstarts[playernum].type == 0 && i<MAXPLAYERS ; i++)
+	{
+	    if (playerstarts[i].type != 0)
+	    {
+		playerstarts[i].type = playernum+1;
+		P_SpawnPlayer (&playerstarts[i]);
+		playerstarts[i].type = i+1;
+		return;
+	    }
+	}
+
 	P_SpawnPlayer (&playerstarts[playernum]);
     }
 }
@@ -1337,8 +1356,8 @@ int cpars[32] =
 //
 // G_DoCompleted
 //
-boolean		secretexit;
-extern char*	pagename;
+INSTANCE boolean		secretexit;
+extern INSTANCE char*	pagename;
 
 void G_ExitLevel (void)
 {
@@ -1561,10 +1580,10 @@ void G_DoWorldDone (void)
 // G_InitFromSavegame
 // Can be called by the startup code or the menu task.
 //
-extern boolean setsizeneeded;
+extern INSTANCE boolean setsizeneeded;
 void R_ExecuteSetViewSize (void);
 
-char	savename[256];
+INSTANCE char	savename[256];
 
 void G_LoadGame (char* name)
 {
@@ -1619,6 +1638,152 @@ void G_DoLoadGame (void)
 }
 
 
+//
+// G_SaveSnapshot
+// Save the game in progress to memory, as a savegame with a few extra
+// globals.  Returns NULL if there is no level being played.
+//
+byte *G_SaveSnapshot (size_t *len)
+{
+    MEMFILE *stream;
+    void *buf;
+    size_t buf_len;
+    byte *result;
+
+    if (gamestate != GS_LEVEL)
+    {
+        return NULL;
+    }
+
+    stream = mem_fopen_write();
+    save_memstream = stream;
+    savegame_error = false;
+
+    P_WriteSaveGameHeader("snapshot");
+
+    P_ArchivePlayers ();
+    P_ArchiveWorld ();
+    P_ArchiveThinkers ();
+    P_ArchiveSpecials ();
+    P_ArchiveGlobals ();
+
+    P_WriteSaveGameEOF();
+
+    save_memstream = NULL;
+
+    mem_get_buf(stream, &buf, &buf_len);
+    result = malloc(buf_len);
+
+    if (result != NULL)
+    {
+        memcpy(result, buf, buf_len);
+        *len = buf_len;
+    }
+
+    mem_fclose(stream);
+
+    return result;
+}
+
+//
+// G_LoadSnapshot
+// Replace the game in progress with one saved by G_SaveSnapshot.
+// Everything that is only local to this player (keys held down,
+// which player is being watched) is kept as it was.
+//
+boolean G_LoadSnapshot (byte *data, size_t len)
+{
+    static INSTANCE boolean saved_gamekeydown[NUMKEYS];
+    static INSTANCE boolean saved_mousearray[MAX_MOUSE_BUTTONS + 1];
+    static INSTANCE boolean saved_joyarray[MAX_JOY_BUTTONS + 1];
+    boolean saved_playeringame[MAXPLAYERS];
+    boolean saved_sendpause, saved_sendsave;
+    gamestate_t saved_wipegamestate;
+    int saved_displayplayer;
+    int savedleveltime;
+    boolean result;
+    int i;
+
+    memcpy(saved_gamekeydown, gamekeydown, sizeof(gamekeydown));
+    memcpy(saved_mousearray, mousearray, sizeof(mousearray));
+    memcpy(saved_joyarray, joyarray, sizeof(joyarray));
+    saved_sendpause = sendpause;
+    saved_sendsave = sendsave;
+    saved_wipegamestate = wipegamestate;
+    saved_displayplayer = displayplayer;
+
+    save_memstream = mem_fopen_read(data, len);
+    savegame_error = false;
+
+    if (!P_ReadSaveGameHeader())
+    {
+        mem_fclose(save_memstream);
+        save_memstream = NULL;
+        return false;
+    }
+
+    savedleveltime = leveltime;
+
+    // Load the level with nobody in it: the players are all about to
+    // be unarchived anyway, and someone who joined the game since it
+    // started may have no start spot on this map.  Start spots left
+    // over from earlier levels are cleared, as a player who has just
+    // joined has never seen them.
+
+    memcpy(saved_playeringame, playeringame, sizeof(playeringame));
+    memset(playeringame, 0, sizeof(playeringame));
+    memset(playerstarts, 0, sizeof(playerstarts));
+
+    G_InitNew (gameskill, gameepisode, gamemap);
+
+    memcpy(playeringame, saved_playeringame, sizeof(playeringame));
+    leveltime = savedleveltime;
+
+    for (i=0 ; i<MAXPLAYERS ; i++)
+    {
+        if (!playeringame[i])
+        {
+            memset(&players[i], 0, sizeof(player_t));
+        }
+    }
+
+    P_UnArchivePlayers ();
+    P_UnArchiveWorld ();
+    P_UnArchiveThinkers ();
+    P_UnArchiveSpecials ();
+    P_UnArchiveGlobals ();
+
+    result = P_ReadSaveGameEOF() && !savegame_error;
+
+    mem_fclose(save_memstream);
+    save_memstream = NULL;
+
+    if (paused)
+    {
+        S_PauseSound ();
+    }
+
+    memcpy(gamekeydown, saved_gamekeydown, sizeof(gamekeydown));
+    memcpy(mousearray, saved_mousearray, sizeof(mousearray));
+    memcpy(joyarray, saved_joyarray, sizeof(joyarray));
+    sendpause = saved_sendpause;
+    sendsave = saved_sendsave;
+    wipegamestate = saved_wipegamestate;
+
+    if (playeringame[saved_displayplayer])
+    {
+        displayplayer = saved_displayplayer;
+    }
+
+    if (setsizeneeded)
+	R_ExecuteSetViewSize ();
+
+    R_FillBackScreen ();
+
+    return result;
+}
+
+
 //
 // G_SaveGame
 // Called by the menu task.
@@ -1717,9 +1882,9 @@ void G_DoSaveGame (void)
 // Can be called by the startup code or the menu task,
 // consoleplayer, displayplayer, playeringame[] should be set.
 //
-skill_t	d_skill;
-int     d_episode;
-int     d_map;
+INSTANCE skill_t	d_skill;
+INSTANCE int     d_episode;
+INSTANCE int     d_map;
 
 void
 G_DeferedInitNew
@@ -2126,7 +2291,7 @@ void G_BeginRecording (void)
 // G_PlayDemo
 //
 
-static const char *defdemoname;
+static INSTANCE const char *defdemoname;
 
 void G_DeferedPlayDemo(const char *name)
 {
@@ -2138,7 +2303,7 @@ void G_DeferedPlayDemo(const char *name)
 
 static const char *DemoVersionDescription(int version)
 {
-    static char resultbuf[16];
+    static INSTANCE char resultbuf[16];
 
     switch (version)
     {
@@ -45,6 +45,12 @@ void G_LoadGame (char* name);
 
 void G_DoLoadGame (void);
 
+// Capture or restore the whole game state in memory, so that a player
+// joining a netgame in progress can be brought up to date.
+
+byte *G_SaveSnapshot (size_t *len);
+boolean G_LoadSnapshot (byte *data, size_t len);
+
 // Called by M_Responder.
 void G_SaveGame (int slot, char* description);
 
@@ -74,7 +80,8 @@ void G_ScreenShot (void);
 void G_DrawMouseSpeedBox(void);
 int G_VanillaVersionCode(void);
 
-extern int vanilla_savegame_limit;
-extern int vanilla_demo_limit;
+extern INSTANCE boolean secretexit;
+extern INSTANCE int vanilla_savegame_limit;
+extern INSTANCE int vanilla_demo_limit;
 #endif
 
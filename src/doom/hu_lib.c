@@ -31,7 +31,7 @@
 // boolean : whether the screen is always erased
 #define noterased viewwindowx
 
-extern boolean	automapactive;	// in AM_map.c
+extern INSTANCE boolean	automapactive;	// in AM_map.c
 
 void HUlib_init(void)
 {
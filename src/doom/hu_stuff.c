@@ -62,7 +62,7 @@
 
 
 
-char *chat_macros[10] =
+INSTANCE char *chat_macros[10] =
 {
     HUSTR_CHATMACRO0,
     HUSTR_CHATMACRO1,
@@ -112,26 +112,26 @@ const char *player_names[] =
     HUSTR_PLRRED,
 };
 
-char			chat_char; // remove later.
-static player_t*	plr;
-patch_t*		hu_font[HU_FONTSIZE];
-static hu_textline_t	w_title;
-boolean			chat_on;
-static hu_itext_t	w_chat;
-static boolean		always_off = false;
-static char		chat_dest[MAXPLAYERS];
-static hu_itext_t w_inputbuffer[MAXPLAYERS];
+INSTANCE char			chat_char; // remove later.
+static INSTANCE player_t*	plr;
+INSTANCE patch_t*		hu_font[HU_FONTSIZE];
+static INSTANCE hu_textline_t	w_title;
+INSTANCE boolean			chat_on;
+static INSTANCE hu_itext_t	w_chat;
+static INSTANCE boolean		always_off = false;
+static INSTANCE char		chat_dest[MAXPLAYERS];
+static INSTANCE hu_itext_t w_inputbuffer[MAXPLAYERS];
 
-static boolean		message_on;
-boolean			message_dontfuckwithme;
-static boolean		message_nottobefuckedwith;
+static INSTANCE boolean		message_on;
+INSTANCE boolean			message_dontfuckwithme;
+static INSTANCE boolean		message_nottobefuckedwith;
 
-static hu_stext_t	w_message;
-static int		message_counter;
+static INSTANCE hu_stext_t	w_message;
+static INSTANCE int		message_counter;
 
-extern int		showMessages;
+extern INSTANCE int		showMessages;
 
-static boolean		headsupactive = false;
+static INSTANCE boolean		headsupactive = false;
 
 //
 // Builtin map names.
@@ -565,9 +565,9 @@ void HU_Ticker(void)
 
 #define QUEUESIZE		128
 
-static char	chatchars[QUEUESIZE];
-static int	head = 0;
-static int	tail = 0;
+static INSTANCE char	chatchars[QUEUESIZE];
+static INSTANCE int	head = 0;
+static INSTANCE int	tail = 0;
 
 
 void HU_queueChatChar(char c)
@@ -618,15 +618,15 @@ static void StopChatInput(void)
 boolean HU_Responder(event_t *ev)
 {
 
-    static char		lastmessage[HU_MAXLINELENGTH+1];
+    static INSTANCE char		lastmessage[HU_MAXLINELENGTH+1];
     const char		*macromessage;
     boolean		eatkey = false;
-    static boolean	altdown = false;
+    static INSTANCE boolean	altdown = false;
     unsigned char 	c;
     int			i;
     int			numplayers;
     
-    static int		num_nobrainers = 0;
+    static INSTANCE int		num_nobrainers = 0;
 
     numplayers = 0;
     for (i=0 ; i<MAXPLAYERS ; i++)
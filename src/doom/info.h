@@ -21,6 +21,8 @@
 #ifndef __INFO__
 #define __INFO__
 
+#include "doomtype.h"
+
 // Needed for action function pointer handling.
 #include "d_think.h"
 
@@ -1153,7 +1155,7 @@ typedef struct
     int misc2;
 } state_t;
 
-extern state_t	states[NUMSTATES];
+extern INSTANCE state_t	states[NUMSTATES];
 extern const char *sprnames[];
 
 typedef enum {
@@ -1326,6 +1328,6 @@ typedef struct
 
 } mobjinfo_t;
 
-extern mobjinfo_t mobjinfo[NUMMOBJTYPES];
+extern INSTANCE mobjinfo_t mobjinfo[NUMMOBJTYPES];
 
 #endif
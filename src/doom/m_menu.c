@@ -61,48 +61,48 @@
 #include "m_menu.h"
 
 
-extern patch_t*		hu_font[HU_FONTSIZE];
-extern boolean		message_dontfuckwithme;
+extern INSTANCE patch_t*		hu_font[HU_FONTSIZE];
+extern INSTANCE boolean		message_dontfuckwithme;
 
-extern boolean		chat_on;		// in heads-up code
+extern INSTANCE boolean		chat_on;		// in heads-up code
 
 //
 // defaulted values
 //
-int			mouseSensitivity = 5;
+INSTANCE int			mouseSensitivity = 5;
 
 // Show messages has default, 0 = off, 1 = on
-int			showMessages = 1;
+INSTANCE int			showMessages = 1;
 	
 
 // Blocky mode, has default, 0 = high, 1 = normal
-int			detailLevel = 0;
+INSTANCE int			detailLevel = 0;
 #ifdef XBOX
-int			screenblocks = 10;
+INSTANCE int			screenblocks = 10;
 #else
-int         screenblocks = 9;
+INSTANCE int         screenblocks = 9;
 #endif
 
 // temp for screenblocks (0-9)
-int			screenSize;
+INSTANCE int			screenSize;
 
 // -1 = no quicksave slot picked!
-int			quickSaveSlot;
+INSTANCE int			quickSaveSlot;
 
  // 1 = message to be printed
-int			messageToPrint;
+INSTANCE int			messageToPrint;
 // ...and here is the message string!
-const char		*messageString;
+INSTANCE const char		*messageString;
 
 // message x & y
-int			messx;
-int			messy;
-int			messageLastMenuActive;
+INSTANCE int			messx;
+INSTANCE int			messy;
+INSTANCE int			messageLastMenuActive;
 
 // timed message = no input from user
-boolean			messageNeedsInput;
+INSTANCE boolean			messageNeedsInput;
 
-void    (*messageRoutine)(int response);
+INSTANCE void    (*messageRoutine)(int response);
 
 char gammamsg[5][26] =
 {
@@ -114,25 +114,25 @@ char gammamsg[5][26] =
 };
 
 // we are going to be entering a savegame string
-int			saveStringEnter;              
-int             	saveSlot;	// which slot to save in
-int			saveCharIndex;	// which char we're editing
-static boolean          joypadSave = false; // was the save action initiated by joypad?
+INSTANCE int			saveStringEnter;              
+INSTANCE int             	saveSlot;	// which slot to save in
+INSTANCE int			saveCharIndex;	// which char we're editing
+static INSTANCE boolean          joypadSave = false; // was the save action initiated by joypad?
 // old save description before edit
-char			saveOldString[SAVESTRINGSIZE];  
+INSTANCE char			saveOldString[SAVESTRINGSIZE];  
 
-boolean			inhelpscreens;
-boolean			menuactive;
+INSTANCE boolean			inhelpscreens;
+INSTANCE boolean			menuactive;
 
 #define SKULLXOFF		-32
 #define LINEHEIGHT		16
 
-extern boolean		sendpause;
-char			savegamestrings[10][SAVESTRINGSIZE];
+extern INSTANCE boolean		sendpause;
+INSTANCE char			savegamestrings[10][SAVESTRINGSIZE];
 
-char	endstring[160];
+INSTANCE char	endstring[160];
 
-static boolean opldev;
+static INSTANCE boolean opldev;
 
 //
 // MENU TYPEDEFS
@@ -166,16 +166,16 @@ typedef struct menu_s
     short		lastOn;		// last item user was on in menu
 } menu_t;
 
-short		itemOn;			// menu item skull is on
-short		skullAnimCounter;	// skull animation counter
-short		whichSkull;		// which skull to draw
+INSTANCE short		itemOn;			// menu item skull is on
+INSTANCE short		skullAnimCounter;	// skull animation counter
+INSTANCE short		whichSkull;		// which skull to draw
 
 // graphic name of skulls
 // warning: initializer-string for array of chars is too long
 const char *skullName[2] = {"M_SKULL1","M_SKULL2"};
 
 // current menudef
-menu_t*	currentMenu;                          
+INSTANCE menu_t*	currentMenu;                          
 
 //
 // PROTOTYPES
@@ -242,7 +242,7 @@ enum
     main_end
 } main_e;
 
-menuitem_t MainMenu[]=
+INSTANCE menuitem_t MainMenu[]=
 {
     {1,"M_NGAME",M_NewGame,'n'},
     {1,"M_OPTION",M_Options,'o'},
@@ -253,11 +253,11 @@ menuitem_t MainMenu[]=
     {1,"M_QUITG",M_QuitDOOM,'q'}
 };
 
-menu_t  MainDef =
+INSTANCE menu_t  MainDef =
 {
     main_end,
     NULL,
-    MainMenu,
+    NULL,
     M_DrawMainMenu,
     97,64,
     0
@@ -276,7 +276,7 @@ enum
     ep_end
 } episodes_e;
 
-menuitem_t EpisodeMenu[]=
+INSTANCE menuitem_t EpisodeMenu[]=
 {
     {1,"M_EPI1", M_Episode,'k'},
     {1,"M_EPI2", M_Episode,'t'},
@@ -284,11 +284,11 @@ menuitem_t EpisodeMenu[]=
     {1,"M_EPI4", M_Episode,'t'}
 };
 
-menu_t  EpiDef =
+INSTANCE menu_t  EpiDef =
 {
     ep_end,		// # of menu items
-    &MainDef,		// previous menu
-    EpisodeMenu,	// menuitem_t ->
+    NULL,		// previous menu
+    NULL,		// menuitem_t ->
     M_DrawEpisode,	// drawing routine ->
     48,63,              // x,y
     ep1			// lastOn
@@ -307,7 +307,7 @@ enum
     newg_end
 } newgame_e;
 
-menuitem_t NewGameMenu[]=
+INSTANCE menuitem_t NewGameMenu[]=
 {
     {1,"M_JKILL",	M_ChooseSkill, 'i'},
     {1,"M_ROUGH",	M_ChooseSkill, 'h'},
@@ -316,11 +316,11 @@ menuitem_t NewGameMenu[]=
     {1,"M_NMARE",	M_ChooseSkill, 'n'}
 };
 
-menu_t  NewDef =
+INSTANCE menu_t  NewDef =
 {
     newg_end,		// # of menu items
-    &EpiDef,		// previous menu
-    NewGameMenu,	// menuitem_t ->
+    NULL,		// previous menu
+    NULL,		// menuitem_t ->
     M_DrawNewGame,	// drawing routine ->
     48,63,              // x,y
     hurtme		// lastOn
@@ -344,7 +344,7 @@ enum
     opt_end
 } options_e;
 
-menuitem_t OptionsMenu[]=
+INSTANCE menuitem_t OptionsMenu[]=
 {
     {1,"M_ENDGAM",	M_EndGame,'e'},
     {1,"M_MESSG",	M_ChangeMessages,'m'},
@@ -356,11 +356,11 @@ menuitem_t OptionsMenu[]=
     {1,"M_SVOL",	M_Sound,'s'}
 };
 
-menu_t  OptionsDef =
+INSTANCE menu_t  OptionsDef =
 {
     opt_end,
-    &MainDef,
-    OptionsMenu,
+    NULL,
+    NULL,
     M_DrawOptions,
     60,37,
     0
@@ -375,37 +375,37 @@ enum
     read1_end
 } read_e;
 
-menuitem_t ReadMenu1[] =
+INSTANCE menuitem_t ReadMenu1[] =
 {
     {1,"",M_ReadThis2,0}
 };
 
-menu_t  ReadDef1 =
+INSTANCE menu_t  ReadDef1 =
 {
     read1_end,
-    &MainDef,
-    ReadMenu1,
+    NULL,
+    NULL,
     M_DrawReadThis1,
     280,185,
     0
 };
 
-enum
+INSTANCE enum
 {
     rdthsempty2,
     read2_end
 } read_e2;
 
-menuitem_t ReadMenu2[]=
+INSTANCE menuitem_t ReadMenu2[]=
 {
     {1,"",M_FinishReadThis,0}
 };
 
-menu_t  ReadDef2 =
+INSTANCE menu_t  ReadDef2 =
 {
     read2_end,
-    &ReadDef1,
-    ReadMenu2,
+    NULL,
+    NULL,
     M_DrawReadThis2,
     330,175,
     0
@@ -423,7 +423,7 @@ enum
     sound_end
 } sound_e;
 
-menuitem_t SoundMenu[]=
+INSTANCE menuitem_t SoundMenu[]=
 {
     {2,"M_SFXVOL",M_SfxVol,'s'},
     {-1,"",0,'\0'},
@@ -431,11 +431,11 @@ menuitem_t SoundMenu[]=
     {-1,"",0,'\0'}
 };
 
-menu_t  SoundDef =
+INSTANCE menu_t  SoundDef =
 {
     sound_end,
-    &OptionsDef,
-    SoundMenu,
+    NULL,
+    NULL,
     M_DrawSound,
     80,64,
     0
@@ -455,7 +455,7 @@ enum
     load_end
 } load_e;
 
-menuitem_t LoadMenu[]=
+INSTANCE menuitem_t LoadMenu[]=
 {
     {1,"", M_LoadSelect,'1'},
     {1,"", M_LoadSelect,'2'},
@@ -465,11 +465,11 @@ menuitem_t LoadMenu[]=
     {1,"", M_LoadSelect,'6'}
 };
 
-menu_t  LoadDef =
+INSTANCE menu_t  LoadDef =
 {
     load_end,
-    &MainDef,
-    LoadMenu,
+    NULL,
+    NULL,
     M_DrawLoad,
     80,54,
     0
@@ -478,7 +478,7 @@ menu_t  LoadDef =
 //
 // SAVE GAME MENU
 //
-menuitem_t SaveMenu[]=
+INSTANCE menuitem_t SaveMenu[]=
 {
     {1,"", M_SaveSelect,'1'},
     {1,"", M_SaveSelect,'2'},
@@ -488,11 +488,11 @@ menuitem_t SaveMenu[]=
     {1,"", M_SaveSelect,'6'}
 };
 
-menu_t  SaveDef =
+INSTANCE menu_t  SaveDef =
 {
     load_end,
-    &MainDef,
-    SaveMenu,
+    NULL,
+    NULL,
     M_DrawSave,
     80,54,
     0
@@ -716,7 +716,7 @@ void M_SaveGame (int choice)
 //
 //      M_QuickSave
 //
-static char tempstring[90];
+static INSTANCE char tempstring[90];
 
 void M_QuickSaveResponse(int key)
 {
@@ -918,7 +918,7 @@ void M_NewGame(int choice)
 //
 //      M_Episode
 //
-int     epi;
+INSTANCE int     epi;
 
 void M_DrawEpisode(void)
 {
@@ -1362,11 +1362,11 @@ boolean M_Responder (event_t* ev)
     int             ch;
     int             key;
     int             i;
-    static  int     mousewait = 0;
-    static  int     mousey = 0;
-    static  int     lasty = 0;
-    static  int     mousex = 0;
-    static  int     lastx = 0;
+    static INSTANCE  int     mousewait = 0;
+    static INSTANCE  int     mousey = 0;
+    static INSTANCE  int     lasty = 0;
+    static INSTANCE  int     mousex = 0;
+    static INSTANCE  int     lastx = 0;
 
     // In testcontrols mode, none of the function keys should do anything
     // - the only key is escape to quit.
@@ -1942,8 +1942,8 @@ static void M_DrawOPLDev(void)
 //
 void M_Drawer (void)
 {
-    static short	x;
-    static short	y;
+    static INSTANCE short	x;
+    static INSTANCE short	y;
     unsigned int	i;
     unsigned int	max;
     char		string[80];
@@ -2066,8 +2066,35 @@ void M_Ticker (void)
 //
 // M_Init
 //
+// Link the menus together.  They can't be linked statically, as each
+// match in the server build has its own copy (see INSTANCE in
+// doomtype.h).
+
+static void M_LinkMenus(void)
+{
+    MainDef.menuitems = MainMenu;
+    EpiDef.prevMenu = &MainDef;
+    EpiDef.menuitems = EpisodeMenu;
+    NewDef.prevMenu = &EpiDef;
+    NewDef.menuitems = NewGameMenu;
+    OptionsDef.prevMenu = &MainDef;
+    OptionsDef.menuitems = OptionsMenu;
+    ReadDef1.prevMenu = &MainDef;
+    ReadDef1.menuitems = ReadMenu1;
+    ReadDef2.prevMenu = &ReadDef1;
+    ReadDef2.menuitems = ReadMenu2;
+    SoundDef.prevMenu = &OptionsDef;
+    SoundDef.menuitems = SoundMenu;
+    LoadDef.prevMenu = &MainDef;
+    LoadDef.menuitems = LoadMenu;
+    SaveDef.prevMenu = &MainDef;
+    SaveDef.menuitems = SaveMenu;
+}
+
 void M_Init (void)
 {
+    M_LinkMenus();
+
     currentMenu = &MainDef;
     menuactive = 0;
     itemOn = currentMenu->lastOn;
@@ -35,7 +35,7 @@
 //
 
 
-ceiling_t*	activeceilings[MAXCEILINGS];
+INSTANCE ceiling_t*	activeceilings[MAXCEILINGS];
 
 
 //
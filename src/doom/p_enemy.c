@@ -93,7 +93,7 @@ void A_Fall (mobj_t *actor);
 // sound blocking lines cut off traversal.
 //
 
-mobj_t*		soundtarget;
+INSTANCE mobj_t*		soundtarget;
 
 void
 P_RecursiveSound
@@ -1001,7 +1001,7 @@ void A_SkelMissile (mobj_t* actor)
     mo->tracer = actor->target;
 }
 
-int	TRACEANGLE = 0xc000000;
+INSTANCE int	TRACEANGLE = 0xc000000;
 
 void A_Tracer (mobj_t* actor)
 {
@@ -1106,10 +1106,10 @@ void A_SkelFist (mobj_t*	actor)
 // PIT_VileCheck
 // Detect a corpse that could be raised.
 //
-mobj_t*		corpsehit;
-mobj_t*		vileobj;
-fixed_t		viletryx;
-fixed_t		viletryy;
+INSTANCE mobj_t*		corpsehit;
+INSTANCE mobj_t*		vileobj;
+INSTANCE fixed_t		viletryx;
+INSTANCE fixed_t		viletryy;
 
 boolean PIT_VileCheck (mobj_t*	thing)
 {
@@ -1804,18 +1804,20 @@ A_CloseShotgun2
 
 
 
-mobj_t*		braintargets[32];
-int		numbraintargets;
-int		braintargeton = 0;
+INSTANCE mobj_t*		braintargets[32];
+INSTANCE int		numbraintargets;
+INSTANCE int		braintargeton = 0;
 
-void A_BrainAwake (mobj_t* mo)
+//
+// P_FindBrainTargets
+// Find all the spots the boss brain spawns monsters at.
+//
+void P_FindBrainTargets (void)
 {
     thinker_t*	thinker;
     mobj_t*	m;
 	
-    // find all the target spots
     numbraintargets = 0;
-    braintargeton = 0;
 	
     thinker = thinkercap.next;
     for (thinker = thinkercap.next ;
@@ -1833,6 +1835,13 @@ void A_BrainAwake (mobj_t* mo)
 	    numbraintargets++;
 	}
     }
+}
+
+void A_BrainAwake (mobj_t* mo)
+{
+    // find all the target spots
+    braintargeton = 0;
+    P_FindBrainTargets();
 	
     S_StartSound (NULL,sfx_bossit);
 }
@@ -1901,7 +1910,7 @@ void A_BrainSpit (mobj_t*	mo)
     mobj_t*	targ;
     mobj_t*	newmobj;
     
-    static int	easy = 0;
+    static INSTANCE int	easy = 0;
 	
     easy ^= 1;
     if (gameskill <= sk_easy && (!easy))
@@ -49,6 +49,8 @@
 
 #define GRAVITY		FRACUNIT
 #define MAXMOVE		(30*FRACUNIT)
+#define STOPSPEED		0x1000
+#define FRICTION		0xe800
 
 #define USERANGE		(64*FRACUNIT)
 #define MELEERANGE		(64*FRACUNIT)
@@ -64,7 +66,7 @@
 //
 
 // both the head and tail of the thinker list
-extern	thinker_t	thinkercap;	
+extern INSTANCE	thinker_t	thinkercap;	
 
 
 void P_InitThinkers (void);
@@ -83,6 +85,27 @@ void P_DropWeapon (player_t* player);
 //
 // P_USER
 //
+
+// The parts of a player and its mobj that moving changes,
+// copied out so that p_predict.c can run the same movement
+// code as the game on its own copy.
+typedef struct
+{
+    fixed_t	x, y, z;
+    fixed_t	momx, momy, momz;
+    fixed_t	floorz, ceilingz;
+    fixed_t	viewz;
+    fixed_t	viewheight;
+    fixed_t	deltaviewheight;
+    fixed_t	bob;
+} pmove_t;
+
+void	P_GetPlayerMove (player_t* player, mobj_t* mo, pmove_t* pm);
+void	P_SetPlayerMove (player_t* player, mobj_t* mo, pmove_t* pm);
+void	P_ThrustMomentum (fixed_t* momx, fixed_t* momy,
+			  angle_t angle, fixed_t move);
+void	P_CalcPlayerHeight (player_t* player, pmove_t* pm,
+			    boolean isonground, int time);
 void	P_PlayerThink (player_t* player);
 
 
@@ -95,10 +118,10 @@ void	P_PlayerThink (player_t* player);
 // Time interval for item respawning.
 #define ITEMQUESIZE		128
 
-extern mapthing_t	itemrespawnque[ITEMQUESIZE];
-extern int		itemrespawntime[ITEMQUESIZE];
-extern int		iquehead;
-extern int		iquetail;
+extern INSTANCE mapthing_t	itemrespawnque[ITEMQUESIZE];
+extern INSTANCE int		itemrespawntime[ITEMQUESIZE];
+extern INSTANCE int		iquehead;
+extern INSTANCE int		iquetail;
 
 
 void P_RespawnSpecials (void);
@@ -114,6 +137,7 @@ void 	P_RemoveMobj (mobj_t* th);
 mobj_t* P_SubstNullMobj (mobj_t* th);
 boolean	P_SetMobjState (mobj_t* mobj, statenum_t state);
 void 	P_MobjThinker (mobj_t* mobj);
+boolean	P_PlayerZMovement (mobj_t* mo, pmove_t* pm);
 
 void	P_SpawnPuff (fixed_t x, fixed_t y, fixed_t z);
 void 	P_SpawnBlood (fixed_t x, fixed_t y, fixed_t z, int damage);
@@ -125,6 +149,10 @@ void	P_SpawnPlayerMissile (mobj_t* source, mobjtype_t type);
 // P_ENEMY
 //
 void P_NoiseAlert (mobj_t* target, mobj_t* emmiter);
+void P_FindBrainTargets (void);
+
+extern INSTANCE int	numbraintargets;
+extern INSTANCE int	braintargeton;
 
 
 //
@@ -154,8 +182,8 @@ typedef struct
 #define MAXINTERCEPTS_ORIGINAL 128
 #define MAXINTERCEPTS          (MAXINTERCEPTS_ORIGINAL + 61)
 
-extern intercept_t	intercepts[MAXINTERCEPTS];
-extern intercept_t*	intercept_p;
+extern INSTANCE intercept_t	intercepts[MAXINTERCEPTS];
+extern INSTANCE intercept_t*	intercept_p;
 
 typedef boolean (*traverser_t) (intercept_t *in);
 
@@ -166,10 +194,10 @@ void 	P_MakeDivline (line_t* li, divline_t* dl);
 fixed_t P_InterceptVector (divline_t* v2, divline_t* v1);
 int 	P_BoxOnLineSide (fixed_t* tmbox, line_t* ld);
 
-extern fixed_t		opentop;
-extern fixed_t 		openbottom;
-extern fixed_t		openrange;
-extern fixed_t		lowfloor;
+extern INSTANCE fixed_t		opentop;
+extern INSTANCE fixed_t 		openbottom;
+extern INSTANCE fixed_t		openrange;
+extern INSTANCE fixed_t		lowfloor;
 
 void 	P_LineOpening (line_t* linedef);
 
@@ -180,7 +208,7 @@ boolean P_BlockThingsIterator (int x, int y, boolean(*func)(mobj_t*) );
 #define PT_ADDTHINGS	2
 #define PT_EARLYOUT		4
 
-extern divline_t	trace;
+extern INSTANCE divline_t	trace;
 
 boolean
 P_PathTraverse
@@ -201,12 +229,12 @@ void P_SetThingPosition (mobj_t* thing);
 
 // If "floatok" true, move would be ok
 // if within "tmfloorz - tmceilingz".
-extern boolean		floatok;
-extern fixed_t		tmfloorz;
-extern fixed_t		tmceilingz;
+extern INSTANCE boolean		floatok;
+extern INSTANCE fixed_t		tmfloorz;
+extern INSTANCE fixed_t		tmceilingz;
 
 
-extern	line_t*		ceilingline;
+extern INSTANCE	line_t*		ceilingline;
 
 // fraggle: I have increased the size of this buffer.  In the original Doom,
 // overrunning past this limit caused other bits of memory to be overwritten,
@@ -219,10 +247,11 @@ extern	line_t*		ceilingline;
 #define MAXSPECIALCROSS 		20
 #define MAXSPECIALCROSS_ORIGINAL	8
 
-extern	line_t*	spechit[MAXSPECIALCROSS];
-extern	int	numspechit;
+extern INSTANCE	line_t*	spechit[MAXSPECIALCROSS];
+extern INSTANCE	int	numspechit;
 
 boolean P_CheckPosition (mobj_t *thing, fixed_t x, fixed_t y);
+boolean P_CheckMove (mobj_t* thing, fixed_t x, fixed_t y, fixed_t z);
 boolean P_TryMove (mobj_t* thing, fixed_t x, fixed_t y);
 boolean P_TeleportMove (mobj_t* thing, fixed_t x, fixed_t y);
 void	P_SlideMove (mobj_t* mo);
@@ -231,7 +260,7 @@ void 	P_UseLines (player_t* player);
 
 boolean P_ChangeSector (sector_t* sector, boolean crunch);
 
-extern mobj_t*	linetarget;	// who got hit (or NULL)
+extern INSTANCE mobj_t*	linetarget;	// who got hit (or NULL)
 
 fixed_t
 P_AimLineAttack
@@ -258,22 +287,22 @@ P_RadiusAttack
 //
 // P_SETUP
 //
-extern byte*		rejectmatrix;	// for fast sight rejection
-extern short*		blockmaplump;	// offsets in blockmap are from here
-extern short*		blockmap;
-extern int		bmapwidth;
-extern int		bmapheight;	// in mapblocks
-extern fixed_t		bmaporgx;
-extern fixed_t		bmaporgy;	// origin of block map
-extern mobj_t**		blocklinks;	// for thing chains
+extern INSTANCE byte*		rejectmatrix;	// for fast sight rejection
+extern INSTANCE short*		blockmaplump;	// offsets in blockmap are from here
+extern INSTANCE short*		blockmap;
+extern INSTANCE int		bmapwidth;
+extern INSTANCE int		bmapheight;	// in mapblocks
+extern INSTANCE fixed_t		bmaporgx;
+extern INSTANCE fixed_t		bmaporgy;	// origin of block map
+extern INSTANCE mobj_t**		blocklinks;	// for thing chains
 
 
 
 //
 // P_INTER
 //
-extern int		maxammo[NUMAMMO];
-extern int		clipammo[NUMAMMO];
+extern INSTANCE int		maxammo[NUMAMMO];
+extern INSTANCE int		clipammo[NUMAMMO];
 
 void
 P_TouchSpecialThing
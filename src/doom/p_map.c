@@ -61,30 +61,30 @@
 //#define DEFAULT_SPECHIT_MAGIC 0x84f968e8
 
 
-fixed_t		tmbbox[4];
-mobj_t*		tmthing;
-int		tmflags;
-fixed_t		tmx;
-fixed_t		tmy;
+INSTANCE fixed_t		tmbbox[4];
+INSTANCE mobj_t*		tmthing;
+INSTANCE int		tmflags;
+INSTANCE fixed_t		tmx;
+INSTANCE fixed_t		tmy;
 
 
 // If "floatok" true, move would be ok
 // if within "tmfloorz - tmceilingz".
-boolean		floatok;
+INSTANCE boolean		floatok;
 
-fixed_t		tmfloorz;
-fixed_t		tmceilingz;
-fixed_t		tmdropoffz;
+INSTANCE fixed_t		tmfloorz;
+INSTANCE fixed_t		tmceilingz;
+INSTANCE fixed_t		tmdropoffz;
 
 // keep track of the line that lowers the ceiling,
 // so missiles don't explode against sky hack walls
-line_t*		ceilingline;
+INSTANCE line_t*		ceilingline;
 
 // keep track of special lines as they are hit,
 // but don't process them until the move is proven valid
 
-line_t*		spechit[MAXSPECIALCROSS];
-int		numspechit;
+INSTANCE line_t*		spechit[MAXSPECIALCROSS];
+INSTANCE int		numspechit;
 
 
 
@@ -471,23 +471,18 @@ P_CheckPosition
 
 
 //
-// P_TryMove
-// Attempt to move to a new position,
-// crossing special lines unless MF_TELEPORT is set.
+// P_CheckMove
+// Whether the thing could move to a new position with
+// its feet at z, leaving tmfloorz and tmceilingz set.
+// Nothing is moved, so p_predict.c uses this as well.
 //
 boolean
-P_TryMove
+P_CheckMove
 ( mobj_t*	thing,
   fixed_t	x,
-  fixed_t	y )
+  fixed_t	y,
+  fixed_t	z )
 {
-    fixed_t	oldx;
-    fixed_t	oldy;
-    int		side;
-    int		oldside;
-    line_t*	ld;
-    int i;
-
     // if (thing->player)
     	    // printf("%d\n", thing->player->cmd.angleturn);
 
@@ -504,11 +499,11 @@ P_TryMove
 	floatok = true;
 
 	if ( !(thing->flags&MF_TELEPORT)
-	     &&tmceilingz - thing->z < thing->height)
+	     &&tmceilingz - z < thing->height)
 	    return false;	// mobj must lower itself to fit
 
 	if ( !(thing->flags&MF_TELEPORT)
-	     && tmfloorz - thing->z > 24*FRACUNIT )
+	     && tmfloorz - z > 24*FRACUNIT )
 	    return false;	// too big a step up
 
 	if ( !(thing->flags&(MF_DROPOFF|MF_FLOAT))
@@ -516,6 +511,30 @@ P_TryMove
 	    return false;	// don't stand over a dropoff
     }
 
+    return true;
+}
+
+
+//
+// P_TryMove
+// Attempt to move to a new position,
+// crossing special lines unless MF_TELEPORT is set.
+//
+boolean
+P_TryMove
+( mobj_t*	thing,
+  fixed_t	x,
+  fixed_t	y )
+{
+    fixed_t	oldx;
+    fixed_t	oldy;
+    int		side;
+    int		oldside;
+    line_t*	ld;
+
+    if (!P_CheckMove (thing, x, y, thing->z))
+	return false;
+
     // the move is ok,
     // so link the thing into its new position
     P_UnsetThingPosition (thing);
@@ -596,16 +615,16 @@ boolean P_ThingHeightClip (mobj_t* thing)
 // SLIDE MOVE
 // Allows the player to slide along any angled walls.
 //
-fixed_t		bestslidefrac;
-fixed_t		secondslidefrac;
+INSTANCE fixed_t		bestslidefrac;
+INSTANCE fixed_t		secondslidefrac;
 
-line_t*		bestslideline;
-line_t*		secondslideline;
+INSTANCE line_t*		bestslideline;
+INSTANCE line_t*		secondslideline;
 
-mobj_t*		slidemo;
+INSTANCE mobj_t*		slidemo;
 
-fixed_t		tmxmove;
-fixed_t		tmymove;
+INSTANCE fixed_t		tmxmove;
+INSTANCE fixed_t		tmymove;
 
 
 
@@ -824,21 +843,21 @@ void P_SlideMove (mobj_t* mo)
 //
 // P_LineAttack
 //
-mobj_t*		linetarget;	// who got hit (or NULL)
-mobj_t*		shootthing;
+INSTANCE mobj_t*		linetarget;	// who got hit (or NULL)
+INSTANCE mobj_t*		shootthing;
 
 // Height if not aiming up or down
 // ???: use slope for monsters?
-fixed_t		shootz;
+INSTANCE fixed_t		shootz;
 
-int		la_damage;
-fixed_t		attackrange;
+INSTANCE int		la_damage;
+INSTANCE fixed_t		attackrange;
 
-fixed_t		aimslope;
+INSTANCE fixed_t		aimslope;
 
 // slopes to top and bottom of target
-extern fixed_t	topslope;
-extern fixed_t	bottomslope;
+extern INSTANCE fixed_t	topslope;
+extern INSTANCE fixed_t	bottomslope;
 
 
 //
@@ -1143,7 +1162,7 @@ P_LineAttack
 //
 // USE LINES
 //
-mobj_t*		usething;
+INSTANCE mobj_t*		usething;
 
 boolean	PTR_UseTraverse (intercept_t* in)
 {
@@ -1204,9 +1223,9 @@ void P_UseLines (player_t*	player)
 //
 // RADIUS ATTACK
 //
-mobj_t*		bombsource;
-mobj_t*		bombspot;
-int		bombdamage;
+INSTANCE mobj_t*		bombsource;
+INSTANCE mobj_t*		bombspot;
+INSTANCE int		bombdamage;
 
 
 //
@@ -1300,8 +1319,8 @@ P_RadiusAttack
 //  the way it was and call P_ChangeSector again
 //  to undo the changes.
 //
-boolean		crushchange;
-boolean		nofit;
+INSTANCE boolean		crushchange;
+INSTANCE boolean		nofit;
 
 
 //
@@ -1396,7 +1415,7 @@ P_ChangeSector
 
 static void SpechitOverrun(line_t *ld)
 {
-    static unsigned int baseaddr = 0;
+    static INSTANCE unsigned int baseaddr = 0;
     unsigned int addr;
 
     if (baseaddr == 0)
@@ -286,10 +286,10 @@ P_InterceptVector
 // through a two sided line.
 // OPTIMIZE: keep this precalculated
 //
-fixed_t opentop;
-fixed_t openbottom;
-fixed_t openrange;
-fixed_t	lowfloor;
+INSTANCE fixed_t opentop;
+INSTANCE fixed_t openbottom;
+INSTANCE fixed_t openrange;
+INSTANCE fixed_t	lowfloor;
 
 
 void P_LineOpening (line_t* linedef)
@@ -536,12 +536,12 @@ P_BlockThingsIterator
 //
 // INTERCEPT ROUTINES
 //
-intercept_t	intercepts[MAXINTERCEPTS];
-intercept_t*	intercept_p;
+INSTANCE intercept_t	intercepts[MAXINTERCEPTS];
+INSTANCE intercept_t*	intercept_p;
 
-divline_t 	trace;
-boolean 	earlyout;
-int		ptflags;
+INSTANCE divline_t 	trace;
+INSTANCE boolean 	earlyout;
+INSTANCE int		ptflags;
 
 static void InterceptsOverrun(int num_intercepts, intercept_t *intercept);
 
@@ -728,7 +728,7 @@ P_TraverseIntercepts
     return true;		// everything was traversed
 }
 
-extern fixed_t bulletslope;
+extern INSTANCE fixed_t bulletslope;
 
 // Intercepts Overrun emulation, from PrBoom-plus.
 // Thanks to Andrey Budko (entryway) for researching this and his 
@@ -742,45 +742,49 @@ typedef struct
     boolean int16_array;
 } intercepts_overrun_t;
 
-// Intercepts memory table.  This is where various variables are located
-// in memory in Vanilla Doom.  When the intercepts table overflows, we
-// need to write to them.
-//
-// Almost all of the values to overwrite are 32-bit integers, except for
-// playerstarts, which is effectively an array of 16-bit integers and
-// must be treated differently.
-
-static intercepts_overrun_t intercepts_overrun[] =
-{
-    {4,   NULL,                          false},
-    {4,   NULL, /* &earlyout, */         false},
-    {4,   NULL, /* &intercept_p, */      false},
-    {4,   &lowfloor,                     false},
-    {4,   &openbottom,                   false},
-    {4,   &opentop,                      false},
-    {4,   &openrange,                    false},
-    {4,   NULL,                          false},
-    {120, NULL, /* &activeplats, */      false},
-    {8,   NULL,                          false},
-    {4,   &bulletslope,                  false},
-    {4,   NULL, /* &swingx, */           false},
-    {4,   NULL, /* &swingy, */           false},
-    {4,   NULL,                          false},
-    {40,  &playerstarts,                 true},
-    {4,   NULL, /* &blocklinks, */       false},
-    {4,   &bmapwidth,                    false},
-    {4,   NULL, /* &blockmap, */         false},
-    {4,   &bmaporgx,                     false},
-    {4,   &bmaporgy,                     false},
-    {4,   NULL, /* &blockmaplump, */     false},
-    {4,   &bmapheight,                   false},
-    {0,   NULL,                          false},
-};
-
 // Overwrite a specific memory location with a value.
 
 static void InterceptsMemoryOverrun(int location, int value)
 {
+    // Intercepts memory table.  This is where various variables are located
+    // in memory in Vanilla Doom.  When the intercepts table overflows, we
+    // need to write to them.
+    //
+    // Almost all of the values to overwrite are 32-bit integers, except for
+    // playerstarts, which is effectively an array of 16-bit integers and
+    // must be treated differently.
+    //
+    // This is built on the stack rather than being static, because the
+    // addresses differ for each match in the server build (see INSTANCE in
+    // doomtype.h).
+
+    intercepts_overrun_t intercepts_overrun[] =
+    {
+        {4,   NULL,                          false},
+        {4,   NULL, /* &earlyout, */         false},
+        {4,   NULL, /* &intercept_p, */      false},
+        {4,   &lowfloor,                     false},
+        {4,   &openbottom,                   false},
+        {4,   &opentop,                      false},
+        {4,   &openrange,                    false},
+        {4,   NULL,                          false},
+        {120, NULL, /* &activeplats, */      false},
+        {8,   NULL,                          false},
+        {4,   &bulletslope,                  false},
+        {4,   NULL, /* &swingx, */           false},
+        {4,   NULL, /* &swingy, */           false},
+        {4,   NULL,                          false},
+        {40,  &playerstarts,                 true},
+        {4,   NULL, /* &blocklinks, */       false},
+        {4,   &bmapwidth,                    false},
+        {4,   NULL, /* &blockmap, */         false},
+        {4,   &bmaporgx,                     false},
+        {4,   &bmaporgy,                     false},
+        {4,   NULL, /* &blockmaplump, */     false},
+        {4,   &bmapheight,                   false},
+        {0,   NULL,                          false},
+    };
+
     int i, offset;
     int index;
     void *addr;
@@ -42,7 +42,7 @@ void P_SpawnMapThing (mapthing_t*	mthing);
 // P_SetMobjState
 // Returns true if the mobj is still present.
 //
-int test;
+INSTANCE int test;
 
 // Use a heuristic approach to detect infinite state cycles: Count the number
 // of times the loop in P_SetMobjState() executes and exit with an error once
@@ -114,9 +114,6 @@ void P_ExplodeMissile (mobj_t* mo)
 //
 // P_XYMovement  
 //
-#define STOPSPEED		0x1000
-#define FRICTION		0xe800
-
 void P_XYMovement (mobj_t* mo) 
 { 	
     fixed_t 	ptryx;
@@ -246,6 +243,67 @@ void P_XYMovement (mobj_t* mo)
     }
 }
 
+//
+// P_PlayerZMovement
+// P_ZMovement for a player's mobj that does not float,
+// charge or explode, on a copy of its movement.
+// Returns true if it landed hard enough to grunt.
+//
+boolean P_PlayerZMovement (mobj_t* mo, pmove_t* pm)
+{
+    boolean	oof = false;
+
+    // check for smooth step up
+    if (pm->z < pm->floorz)
+    {
+	pm->viewheight -= pm->floorz-pm->z;
+
+	pm->deltaviewheight
+	    = (VIEWHEIGHT - pm->viewheight)>>3;
+    }
+    
+    // adjust height
+    pm->z += pm->momz;
+
+    // clip movement
+    if (pm->z <= pm->floorz)
+    {
+	// hit the floor
+	if (pm->momz < 0)
+	{
+	    if (pm->momz < -GRAVITY*8)	
+	    {
+		// Squat down.
+		// Decrease viewheight for a moment
+		// after hitting the ground (hard),
+		// and utter appropriate sound.
+		pm->deltaviewheight = pm->momz>>3;
+		oof = true;
+	    }
+	    pm->momz = 0;
+	}
+	pm->z = pm->floorz;
+    }
+    else if (! (mo->flags & MF_NOGRAVITY) )
+    {
+	if (pm->momz == 0)
+	    pm->momz = -GRAVITY*2;
+	else
+	    pm->momz -= GRAVITY;
+    }
+	
+    if (pm->z + mo->height > pm->ceilingz)
+    {
+	// hit the ceiling
+	if (pm->momz > 0)
+	    pm->momz = 0;
+	pm->z = pm->ceilingz - mo->height;
+    }
+
+    return oof;
+}
+
+
 //
 // P_ZMovement
 //
@@ -253,6 +311,23 @@ void P_ZMovement (mobj_t* mo)
 {
     fixed_t	dist;
     fixed_t	delta;
+    pmove_t	pm;
+    boolean	oof;
+
+    // Players go through the same code as the prediction
+    //  in p_predict.c, unless a dehacked patch has made
+    //  them float or fly.
+    if (mo->player
+	&& !(mo->flags & (MF_FLOAT | MF_SKULLFLY | MF_MISSILE)))
+    {
+	P_GetPlayerMove (mo->player, mo, &pm);
+	oof = P_PlayerZMovement (mo, &pm);
+	P_SetPlayerMove (mo->player, mo, &pm);
+
+	if (oof)
+	    S_StartSound (mo, sfx_oof);
+	return;
+    }
     
     // check for smooth step up
     if (mo->player && mo->z < mo->floorz)
@@ -575,10 +650,10 @@ P_SpawnMobj
 //
 // P_RemoveMobj
 //
-mapthing_t	itemrespawnque[ITEMQUESIZE];
-int		itemrespawntime[ITEMQUESIZE];
-int		iquehead;
-int		iquetail;
+INSTANCE mapthing_t	itemrespawnque[ITEMQUESIZE];
+INSTANCE int		itemrespawntime[ITEMQUESIZE];
+INSTANCE int		iquehead;
+INSTANCE int		iquetail;
 
 
 void P_RemoveMobj (mobj_t* mobj)
@@ -865,7 +940,7 @@ void P_SpawnMapThing (mapthing_t* mthing)
 //
 // P_SpawnPuff
 //
-extern fixed_t attackrange;
+extern INSTANCE fixed_t attackrange;
 
 void
 P_SpawnPuff
@@ -950,7 +1025,7 @@ mobj_t *P_SubstNullMobj(mobj_t *mobj)
 {
     if (mobj == NULL)
     {
-        static mobj_t dummy_mobj;
+        static INSTANCE mobj_t dummy_mobj;
 
         dummy_mobj.x = 0;
         dummy_mobj.y = 0;
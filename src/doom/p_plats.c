@@ -35,7 +35,7 @@
 #include "sounds.h"
 
 
-plat_t*		activeplats[MAXPLATS];
+INSTANCE plat_t*		activeplats[MAXPLATS];
 
 
 
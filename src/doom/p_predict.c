@@ -0,0 +1,391 @@
+//
+// Copyright(C) 1993-1996 Id Software, Inc.
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	Client-side prediction of the local player's view.
+//
+//	In a netgame a tic cannot be run until ticcmds for it have
+//	arrived from every player, so the local player's input only
+//	shows on screen a full round trip after it was made.  To hide
+//	this, the local ticcmds that are waiting to be run are replayed
+//	against a copy of the player's position each frame, and the
+//	view is drawn from the result.
+//
+//	The copy is taken afresh from the real game state every time,
+//	so when authoritative tics arrive and are run the prediction is
+//	thrown away and replayed from the new position.  Nothing in the
+//	game state is ever changed, so demos and netgame sync are the
+//	same whether or not this is turned on.
+//
+
+#include <stdio.h>
+
+#include "doomdef.h"
+#include "doomstat.h"
+#include "d_loop.h"
+#include "i_system.h"
+#include "m_argv.h"
+#include "tables.h"
+
+#include "p_local.h"
+#include "p_predict.h"
+
+// Copy of the parts of the player and its mobj that movement changes.
+
+typedef struct
+{
+    pmove_t pm;
+    angle_t angle;
+    int reactiontime;
+} predict_t;
+
+// Where the prediction last put the player at the end of a tic,
+// kept so that -predictcheck can compare it with where the player
+// really was once the tic has been run.
+
+typedef struct
+{
+    int time;
+    fixed_t x, y, z;
+    fixed_t momx, momy;
+    fixed_t viewz;
+    angle_t angle;
+} predictcheck_t;
+
+static INSTANCE boolean predict_enabled = false;
+static INSTANCE boolean predict_check = false;
+
+static INSTANCE predictcheck_t predicted[BACKUPTICS];
+static INSTANCE int predict_matches, predict_misses;
+
+static void PrintPredictionCheck(void)
+{
+    printf("P_CheckPrediction: %d tics predicted correctly, %d not\n",
+           predict_matches, predict_misses);
+}
+
+void P_InitPrediction(void)
+{
+    int i;
+
+    //!
+    // @category net
+    //
+    // In a netgame, move the view straight away in response to
+    // local input, rather than waiting for the server.
+    //
+
+    predict_enabled = M_CheckParm("-predict") > 0;
+
+    //!
+    // @category net
+    //
+    // Implies -predict.  As each tic is run, compare where the
+    // local player ends up with where the prediction put them,
+    // and print any difference.
+    //
+
+    if (M_CheckParm("-predictcheck") > 0)
+    {
+        if (!predict_check)
+        {
+            I_AtExit(PrintPredictionCheck, true);
+        }
+
+        predict_enabled = true;
+        predict_check = true;
+    }
+
+    for (i = 0; i < BACKUPTICS; ++i)
+    {
+        predicted[i].time = -1;
+    }
+}
+
+// P_TryMove, but only updates the copy.  P_CheckMove is run against
+// the real mobj (so that it does not block itself) with the
+// predicted ticcmd in place, since it looks at the player's
+// angleturn.  MF_PICKUP is masked so that nothing is picked up.
+// Special lines are not crossed.
+
+static boolean TryMove(player_t *player, predict_t *p, ticcmd_t *cmd,
+                       fixed_t x, fixed_t y)
+{
+    mobj_t *mo = player->mo;
+    ticcmd_t realcmd;
+    boolean fits;
+    int flags;
+
+    realcmd = player->cmd;
+    flags = mo->flags;
+
+    player->cmd = *cmd;
+    mo->flags &= ~MF_PICKUP;
+    fits = P_CheckMove(mo, x, y, p->pm.z);
+    mo->flags = flags;
+    player->cmd = realcmd;
+
+    if (!fits)
+    {
+        return false;
+    }
+
+    p->pm.floorz = tmfloorz;
+    p->pm.ceilingz = tmceilingz;
+    p->pm.x = x;
+    p->pm.y = y;
+
+    return true;
+}
+
+// P_XYMovement, for a player.  P_SlideMove links the real mobj into
+// each position it tries and crosses lines on the way, so it cannot
+// be run on the copy; instead a blocked move falls back to moving
+// along one axis, which is what P_SlideMove does when it cannot find
+// a wall to slide along.  Sliding along a wall at an angle is
+// corrected when the real tic is run.
+
+static void XYMovement(player_t *player, predict_t *p, ticcmd_t *cmd)
+{
+    pmove_t *pm = &p->pm;
+    fixed_t ptryx, ptryy;
+    fixed_t xmove, ymove;
+
+    if (!pm->momx && !pm->momy)
+    {
+        return;
+    }
+
+    if (pm->momx > MAXMOVE)
+        pm->momx = MAXMOVE;
+    else if (pm->momx < -MAXMOVE)
+        pm->momx = -MAXMOVE;
+
+    if (pm->momy > MAXMOVE)
+        pm->momy = MAXMOVE;
+    else if (pm->momy < -MAXMOVE)
+        pm->momy = -MAXMOVE;
+
+    xmove = pm->momx;
+    ymove = pm->momy;
+
+    do
+    {
+        if (xmove > MAXMOVE/2 || ymove > MAXMOVE/2)
+        {
+            ptryx = pm->x + xmove/2;
+            ptryy = pm->y + ymove/2;
+            xmove >>= 1;
+            ymove >>= 1;
+        }
+        else
+        {
+            ptryx = pm->x + xmove;
+            ptryy = pm->y + ymove;
+            xmove = ymove = 0;
+        }
+
+        if (!TryMove(player, p, cmd, ptryx, ptryy))
+        {
+            if (!TryMove(player, p, cmd, pm->x, pm->y + pm->momy))
+            {
+                TryMove(player, p, cmd, pm->x + pm->momx, pm->y);
+            }
+        }
+    } while (xmove || ymove);
+
+    if (player->cheats & CF_NOMOMENTUM)
+    {
+        pm->momx = pm->momy = 0;
+        return;
+    }
+
+    if (pm->z > pm->floorz)
+    {
+        return;
+    }
+
+    if (pm->momx > -STOPSPEED && pm->momx < STOPSPEED
+     && pm->momy > -STOPSPEED && pm->momy < STOPSPEED
+     && cmd->forwardmove == 0 && cmd->sidemove == 0)
+    {
+        pm->momx = 0;
+        pm->momy = 0;
+    }
+    else
+    {
+        pm->momx = FixedMul(pm->momx, FRICTION);
+        pm->momy = FixedMul(pm->momy, FRICTION);
+    }
+}
+
+// Run one tic of movement for the copy, in the same order as
+// P_Ticker: P_PlayerThink first, then the mobj's thinker.  The
+// thrust, view height and vertical movement are done by the same
+// functions that the game itself uses.
+
+static void PredictTic(player_t *player, predict_t *p, ticcmd_t *cmd,
+                       int time)
+{
+    mobj_t *mo = player->mo;
+    pmove_t *pm = &p->pm;
+    boolean onground;
+
+    onground = pm->z <= pm->floorz;
+
+    if (p->reactiontime)
+    {
+        --p->reactiontime;
+    }
+    else
+    {
+        if (cmd->angleturn)
+        {
+            p->angle += (cmd->angleturn << FRACBITS) + 6;
+        }
+
+        if (cmd->forwardmove && onground)
+        {
+            P_ThrustMomentum(&pm->momx, &pm->momy, p->angle,
+                             cmd->forwardmove*2048 + 20);
+        }
+
+        if (cmd->sidemove && onground)
+        {
+            P_ThrustMomentum(&pm->momx, &pm->momy, p->angle - ANG90,
+                             cmd->sidemove*2048 + 20);
+        }
+    }
+
+    P_CalcPlayerHeight(player, pm, onground, time);
+
+    XYMovement(player, p, cmd);
+
+    if (pm->z != pm->floorz || pm->momz)
+    {
+        P_PlayerZMovement(mo, pm);
+    }
+}
+
+static void RecordPrediction(predict_t *p, int time)
+{
+    predictcheck_t *check = &predicted[time % BACKUPTICS];
+
+    check->time = time;
+    check->x = p->pm.x;
+    check->y = p->pm.y;
+    check->z = p->pm.z;
+    check->momx = p->pm.momx;
+    check->momy = p->pm.momy;
+    check->viewz = p->pm.viewz;
+    check->angle = p->angle;
+}
+
+void P_CheckPrediction(void)
+{
+    player_t *player = &players[consoleplayer];
+    predictcheck_t *check;
+    mobj_t *mo = player->mo;
+    int time;
+
+    if (!predict_check || mo == NULL)
+    {
+        return;
+    }
+
+    // The tic that has just been run.
+
+    time = leveltime - 1;
+    check = &predicted[time % BACKUPTICS];
+
+    if (time < 0 || check->time != time)
+    {
+        return;
+    }
+
+    check->time = -1;
+
+    if (check->x == mo->x && check->y == mo->y && check->z == mo->z
+     && check->momx == mo->momx && check->momy == mo->momy
+     && check->viewz == player->viewz && check->angle == mo->angle)
+    {
+        ++predict_matches;
+        return;
+    }
+
+    ++predict_misses;
+
+    printf("P_CheckPrediction: tic %d: predicted (%d, %d, %d) view %d, "
+           "was (%d, %d, %d) view %d\n", time,
+           check->x >> FRACBITS, check->y >> FRACBITS,
+           check->z >> FRACBITS, check->viewz >> FRACBITS,
+           mo->x >> FRACBITS, mo->y >> FRACBITS,
+           mo->z >> FRACBITS, player->viewz >> FRACBITS);
+}
+
+boolean P_PredictView(player_t *player, fixed_t *x, fixed_t *y,
+                      fixed_t *z, angle_t *angle)
+{
+    ticcmd_t cmds[BACKUPTICS];
+    predict_t p;
+    mobj_t *mo;
+    int numcmds;
+    int i, j;
+    int time;
+
+    if (!predict_enabled || !netgame || demoplayback || paused
+     || gamestate != GS_LEVEL
+     || player != &players[consoleplayer]
+     || player->playerstate != PST_LIVE || player->mo == NULL)
+    {
+        return false;
+    }
+
+    numcmds = D_GetPendingTiccmds(cmds, BACKUPTICS);
+
+    if (numcmds == 0)
+    {
+        return false;
+    }
+
+    mo = player->mo;
+
+    P_GetPlayerMove(player, mo, &p.pm);
+    p.angle = mo->angle;
+    p.reactiontime = mo->reactiontime;
+
+    time = leveltime;
+
+    for (i = 0; i < numcmds; ++i)
+    {
+        for (j = 0; j < ticdup; ++j)
+        {
+            PredictTic(player, &p, &cmds[i], time);
+
+            if (predict_check)
+            {
+                RecordPrediction(&p, time);
+            }
+
+            ++time;
+        }
+    }
+
+    *x = p.pm.x;
+    *y = p.pm.y;
+    *z = p.pm.viewz;
+    *angle = p.angle;
+
+    return true;
+}
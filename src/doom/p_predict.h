@@ -0,0 +1,37 @@
+//
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	Client-side prediction of the local player's view.
+//
+
+
+#ifndef __P_PREDICT__
+#define __P_PREDICT__
+
+#include "d_player.h"
+
+void P_InitPrediction(void);
+
+// Get the view position for the given player, with any local
+// ticcmds that have not been run yet applied.  Returns false if no
+// prediction is done, in which case the player's own position
+// should be used.
+boolean P_PredictView(player_t *player, fixed_t *x, fixed_t *y,
+                      fixed_t *z, angle_t *angle);
+
+// With -predictcheck, called after each tic is run to compare the
+// local player's position with the one predicted for that tic.
+void P_CheckPrediction(void);
+
+#endif
@@ -29,13 +29,15 @@
 
 // State.
 #include "doomstat.h"
+#include "d_main.h"
 #include "g_game.h"
 #include "m_misc.h"
 #include "r_state.h"
 
-FILE *save_stream;
-int savegamelength;
-boolean savegame_error;
+INSTANCE FILE *save_stream;
+INSTANCE MEMFILE *save_memstream;
+INSTANCE int savegamelength;
+INSTANCE boolean savegame_error;
 
 // Get the filename of a temporary file to write the savegame to.  After
 // the file has been successfully saved, it will be renamed to the 
@@ -43,7 +45,7 @@ boolean savegame_error;
 
 char *P_TempSaveGameFile(void)
 {
-    static char *filename = NULL;
+    static INSTANCE char *filename = NULL;
 
     if (filename == NULL)
     {
@@ -57,8 +59,8 @@ char *P_TempSaveGameFile(void)
 
 char *P_SaveGameFile(int slot)
 {
-    static char *filename = NULL;
-    static size_t filename_size = 0;
+    static INSTANCE char *filename = NULL;
+    static INSTANCE size_t filename_size = 0;
     char basename[32];
 
     if (filename == NULL)
@@ -78,8 +80,18 @@ char *P_SaveGameFile(int slot)
 static byte saveg_read8(void)
 {
     byte result = -1;
+    size_t count;
 
-    if (fread(&result, 1, 1, save_stream) < 1)
+    if (save_memstream != NULL)
+    {
+        count = mem_fread(&result, 1, 1, save_memstream);
+    }
+    else
+    {
+        count = fread(&result, 1, 1, save_stream);
+    }
+
+    if (count < 1)
     {
         if (!savegame_error)
         {
@@ -95,7 +107,18 @@ static byte saveg_read8(void)
 
 static void saveg_write8(byte value)
 {
-    if (fwrite(&value, 1, 1, save_stream) < 1)
+    size_t count;
+
+    if (save_memstream != NULL)
+    {
+        count = mem_fwrite(&value, 1, 1, save_memstream);
+    }
+    else
+    {
+        count = fwrite(&value, 1, 1, save_stream);
+    }
+
+    if (count < 1)
     {
         if (!savegame_error)
         {
@@ -142,6 +165,16 @@ static void saveg_write32(int value)
     saveg_write8((value >> 24) & 0xff);
 }
 
+static long saveg_tell(void)
+{
+    if (save_memstream != NULL)
+    {
+        return mem_ftell(save_memstream);
+    }
+
+    return ftell(save_stream);
+}
+
 // Pad to 4-byte boundaries
 
 static void saveg_read_pad(void)
@@ -150,7 +183,7 @@ static void saveg_read_pad(void)
     int padding;
     int i;
 
-    pos = ftell(save_stream);
+    pos = saveg_tell();
 
     padding = (4 - (pos & 3)) & 3;
 
@@ -166,7 +199,7 @@ static void saveg_write_pad(void)
     int padding;
     int i;
 
-    pos = ftell(save_stream);
+    pos = saveg_tell();
 
     padding = (4 - (pos & 3)) & 3;
 
@@ -1886,3 +1919,58 @@ void P_UnArchiveSpecials (void)
 
 }
 
+
+//
+// P_ArchiveGlobals
+// State outside the level that a savegame can do without, but that
+// a snapshot of a game in progress needs to carry on exactly where
+// the game it was taken from left off.
+//
+void P_ArchiveGlobals (void)
+{
+    saveg_write32(prndindex);
+    saveg_write8(paused);
+    saveg_write32(gameaction);
+    saveg_write8(secretexit);
+    saveg_write32(levelstarttic);
+    saveg_write32(levelTimeCount);
+    saveg_write8(numbraintargets > 0);
+    saveg_write32(braintargeton);
+}
+
+
+//
+// P_UnArchiveGlobals
+//
+void P_UnArchiveGlobals (void)
+{
+    boolean brainawake;
+
+    prndindex = saveg_read32() & 0xff;
+    paused = saveg_read8();
+    gameaction = saveg_read32();
+    secretexit = saveg_read8();
+    levelstarttic = saveg_read32();
+    levelTimeCount = saveg_read32();
+    brainawake = saveg_read8();
+    braintargeton = saveg_read32();
+
+    // The brain's spawn targets are pointers into the thinker list,
+    // so find them again in the thinkers just unarchived.
+
+    numbraintargets = 0;
+
+    if (brainawake)
+    {
+        P_FindBrainTargets();
+    }
+
+    if (numbraintargets > 0)
+    {
+        braintargeton %= numbraintargets;
+    }
+    else
+    {
+        braintargeton = 0;
+    }
+}
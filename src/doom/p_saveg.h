@@ -22,6 +22,8 @@
 
 #include <stdio.h>
 
+#include "memio.h"
+
 #define SAVEGAME_EOF 0x1d
 #define VERSIONSIZE 16
 
@@ -57,9 +59,16 @@ void P_ArchiveThinkers (void);
 void P_UnArchiveThinkers (void);
 void P_ArchiveSpecials (void);
 void P_UnArchiveSpecials (void);
+void P_ArchiveGlobals (void);
+void P_UnArchiveGlobals (void);
+
+extern INSTANCE FILE *save_stream;
+
+// If set, the routines above read and write this memory stream
+// instead of save_stream.
 
-extern FILE *save_stream;
-extern boolean savegame_error;
+extern INSTANCE MEMFILE *save_memstream;
+extern INSTANCE boolean savegame_error;
 
 
 #endif
@@ -35,6 +35,8 @@
 
 #include "doomdef.h"
 #include "p_local.h"
+#include "p_predict.h"
+#include "r_stats.h"
 
 #include "s_sound.h"
 
@@ -48,28 +50,28 @@ void	P_SpawnMapThing (mapthing_t*	mthing);
 // MAP related Lookup tables.
 // Store VERTEXES, LINEDEFS, SIDEDEFS, etc.
 //
-int		numvertexes;
-vertex_t*	vertexes;
+INSTANCE int		numvertexes;
+INSTANCE vertex_t*	vertexes;
 
-int		numsegs;
-seg_t*		segs;
+INSTANCE int		numsegs;
+INSTANCE seg_t*		segs;
 
-int		numsectors;
-sector_t*	sectors;
+INSTANCE int		numsectors;
+INSTANCE sector_t*	sectors;
 
-int		numsubsectors;
-subsector_t*	subsectors;
+INSTANCE int		numsubsectors;
+INSTANCE subsector_t*	subsectors;
 
-int		numnodes;
-node_t*		nodes;
+INSTANCE int		numnodes;
+INSTANCE node_t*		nodes;
 
-int		numlines;
-line_t*		lines;
+INSTANCE int		numlines;
+INSTANCE line_t*		lines;
 
-int		numsides;
-side_t*		sides;
+INSTANCE int		numsides;
+INSTANCE side_t*		sides;
 
-static int      totallines;
+static INSTANCE int      totallines;
 
 // BLOCKMAP
 // Created from axis aligned bounding box
@@ -79,16 +81,16 @@ static int      totallines;
 // by spatial subdivision in 2D.
 //
 // Blockmap size.
-int		bmapwidth;
-int		bmapheight;	// size in mapblocks
-short*		blockmap;	// int for larger maps
+INSTANCE int		bmapwidth;
+INSTANCE int		bmapheight;	// size in mapblocks
+INSTANCE short*		blockmap;	// int for larger maps
 // offsets in blockmap are from here
-short*		blockmaplump;		
+INSTANCE short*		blockmaplump;		
 // origin of block map
-fixed_t		bmaporgx;
-fixed_t		bmaporgy;
+INSTANCE fixed_t		bmaporgx;
+INSTANCE fixed_t		bmaporgy;
 // for thing chains
-mobj_t**	blocklinks;		
+INSTANCE mobj_t**	blocklinks;		
 
 
 // REJECT
@@ -98,16 +100,16 @@ mobj_t**	blocklinks;
 // Without special effect, this could be
 //  used as a PVS lookup as well.
 //
-byte*		rejectmatrix;
+INSTANCE byte*		rejectmatrix;
 
 
 // Maintain single and multi player starting spots.
 #define MAX_DEATHMATCH_STARTS	32
 
-mapthing_t	deathmatchstarts[MAX_DEATHMATCH_STARTS];
-mapthing_t*	deathmatch_p;
-mapthing_t	playerstarts[MAXPLAYERS];
-boolean     playerstartsingame[MAXPLAYERS];
+INSTANCE mapthing_t	deathmatchstarts[MAX_DEATHMATCH_STARTS];
+INSTANCE mapthing_t*	deathmatch_p;
+INSTANCE mapthing_t	playerstarts[MAXPLAYERS];
+INSTANCE boolean     playerstartsingame[MAXPLAYERS];
 
 
 
@@ -153,8 +155,8 @@ void P_LoadVertexes (int lump)
 //
 sector_t* GetSectorAtNullAddress(void)
 {
-    static boolean null_sector_is_initialized = false;
-    static sector_t null_sector;
+    static INSTANCE boolean null_sector_is_initialized = false;
+    static INSTANCE sector_t null_sector;
 
     if (!null_sector_is_initialized)
     {
@@ -761,7 +763,7 @@ static void P_LoadReject(int lumpnum)
 }
 
 // pointer to the current map lump info struct
-lumpinfo_t *maplumpinfo;
+INSTANCE lumpinfo_t *maplumpinfo;
 
 //
 // P_SetupLevel
@@ -794,6 +796,8 @@ P_SetupLevel
 
     Z_FreeTags (PU_LEVEL, PU_PURGELEVEL-1);
 
+    R_ClearRenderStats ();
+
     // UNUSED W_Profile ();
     P_InitThinkers ();
 
@@ -879,6 +883,7 @@ void P_Init (void)
 {
     P_InitSwitchList ();
     P_InitPicAnims ();
+    P_InitPrediction ();
     R_InitSprites (sprnames);
 }
 
@@ -23,7 +23,7 @@
 #include "w_wad.h"
 
 
-extern lumpinfo_t *maplumpinfo;
+extern INSTANCE lumpinfo_t *maplumpinfo;
 
 // NOT called by W_Ticker. Fixme.
 void
@@ -29,15 +29,15 @@
 //
 // P_CheckSight
 //
-fixed_t		sightzstart;		// eye z of looker
-fixed_t		topslope;
-fixed_t		bottomslope;		// slopes to top and bottom of target
+INSTANCE fixed_t		sightzstart;		// eye z of looker
+INSTANCE fixed_t		topslope;
+INSTANCE fixed_t		bottomslope;		// slopes to top and bottom of target
 
-divline_t	strace;			// from t1 to t2
-fixed_t		t2x;
-fixed_t		t2y;
+INSTANCE divline_t	strace;			// from t1 to t2
+INSTANCE fixed_t		t2x;
+INSTANCE fixed_t		t2y;
 
-int		sightcounts[2];
+INSTANCE int		sightcounts[2];
 
 
 //
@@ -77,8 +77,8 @@ typedef struct
 
 #define MAXANIMS                32
 
-extern anim_t	anims[MAXANIMS];
-extern anim_t*	lastanim;
+extern INSTANCE anim_t	anims[MAXANIMS];
+extern INSTANCE anim_t*	lastanim;
 
 //
 // P_InitPicAnims
@@ -126,8 +126,8 @@ animdef_t		animdefs[] =
     {-1,        "",             "",             0},
 };
 
-anim_t		anims[MAXANIMS];
-anim_t*		lastanim;
+INSTANCE anim_t		anims[MAXANIMS];
+INSTANCE anim_t*		lastanim;
 
 
 //
@@ -135,8 +135,8 @@ anim_t*		lastanim;
 //
 #define MAXLINEANIMS            64
 
-extern  short	numlinespecials;
-extern  line_t*	linespeciallist[MAXLINEANIMS];
+extern INSTANCE  short	numlinespecials;
+extern INSTANCE  line_t*	linespeciallist[MAXLINEANIMS];
 
 
 
@@ -1087,8 +1087,8 @@ void P_PlayerInSpecialSector (player_t* player)
 // P_UpdateSpecials
 // Animate planes, scroll walls, etc.
 //
-boolean		levelTimer;
-int		levelTimeCount;
+INSTANCE boolean		levelTimer;
+INSTANCE int		levelTimeCount;
 
 void P_UpdateSpecials (void)
 {
@@ -1178,11 +1178,11 @@ void P_UpdateSpecials (void)
 static void DonutOverrun(fixed_t *s3_floorheight, short *s3_floorpic,
                          line_t *line, sector_t *pillar_sector)
 {
-    static int first = 1;
-    static int tmp_s3_floorheight;
-    static int tmp_s3_floorpic;
+    static INSTANCE int first = 1;
+    static INSTANCE int tmp_s3_floorheight;
+    static INSTANCE int tmp_s3_floorpic;
 
-    extern int numflats;
+    extern INSTANCE int numflats;
 
     if (first)
     {
@@ -1366,8 +1366,8 @@ int EV_DoDonut(line_t*	line)
 // After the map has been loaded, scan for specials
 //  that spawn thinkers
 //
-short		numlinespecials;
-line_t*		linespeciallist[MAXLINEANIMS];
+INSTANCE short		numlinespecials;
+INSTANCE line_t*		linespeciallist[MAXLINEANIMS];
 
 static unsigned int NumScrollers()
 {
@@ -27,8 +27,8 @@
 //
 // End-level timer (-TIMER option)
 //
-extern	boolean levelTimer;
-extern	int	levelTimeCount;
+extern INSTANCE	boolean levelTimer;
+extern INSTANCE	int	levelTimeCount;
 
 
 //      Define values for map objects
@@ -243,7 +243,7 @@ typedef struct
  // 1 second, in ticks. 
 #define BUTTONTIME      35             
 
-extern button_t	buttonlist[MAXBUTTONS]; 
+extern INSTANCE button_t	buttonlist[MAXBUTTONS]; 
 
 void
 P_ChangeSwitchTexture
@@ -303,7 +303,7 @@ typedef struct
 #define MAXPLATS		30
 
 
-extern plat_t*	activeplats[MAXPLATS];
+extern INSTANCE plat_t*	activeplats[MAXPLATS];
 
 void    T_PlatRaise(plat_t*	plat);
 
@@ -514,7 +514,7 @@ typedef struct
 #define CEILWAIT		150
 #define MAXCEILINGS		30
 
-extern ceiling_t*	activeceilings[MAXCEILINGS];
+extern INSTANCE ceiling_t*	activeceilings[MAXCEILINGS];
 
 int
 EV_DoCeiling
@@ -88,9 +88,9 @@ switchlist_t alphSwitchList[] =
     {"SW1SKULL",	"SW2SKULL",	3},
 };
 
-int		switchlist[MAXSWITCHES * 2];
-int		numswitches;
-button_t        buttonlist[MAXBUTTONS];
+INSTANCE int		switchlist[MAXSWITCHES * 2];
+INSTANCE int		numswitches;
+INSTANCE button_t        buttonlist[MAXBUTTONS];
 
 //
 // P_InitSwitchList
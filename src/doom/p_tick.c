@@ -20,13 +20,15 @@
 
 #include "z_zone.h"
 #include "p_local.h"
+#include "p_predict.h"
+#include "../net_eventlog.h"
 #include "../net_server.h"
 
 #include "doomstat.h"
 
 #include <stdlib.h>
 
-int	leveltime;
+INSTANCE int	leveltime;
 
 //
 // THINKERS
@@ -39,7 +41,7 @@ int	leveltime;
 
 
 // Both the head and tail of the thinker list.
-thinker_t	thinkercap;
+INSTANCE thinker_t	thinkercap;
 
 
 //
@@ -134,7 +136,7 @@ short player_sector_tag(player_t *player) {
 // P_Ticker
 //
 
-char taunt_buf[300];
+INSTANCE char taunt_buf[300];
 
 
 #ifdef XBOX
@@ -213,8 +215,8 @@ void P_Ticker (void)
             short sector_tag = player_sector_tag(&players[i]);
             if (is_ooo_sector_tag(sector_tag) && !(leveltime % 35) && players[i].playerstate == PST_LIVE) {
 #if SERVER == 1
-                printf("SCORING %s %hd\n", sv_player_names[i], sector_tag);
-                fflush(stdout);
+                NET_EventLog_Score(gametic, i, sv_player_names[i],
+                                   sector_tag);
 #else
                 snprintf(taunt_buf, sizeof(taunt_buf), "someone is scoring in %hd!", sector_tag);
                 players[consoleplayer].message = taunt_buf;
@@ -234,4 +236,6 @@ void P_Ticker (void)
 
     // for par times
     leveltime++;
+
+    P_CheckPrediction ();
 }
@@ -42,7 +42,77 @@
 // 16 pixels of bob
 #define MAXBOB	0x100000	
 
-boolean		onground;
+INSTANCE boolean		onground;
+
+
+//
+// P_GetPlayerMove
+// Copies the parts of a player and its mobj that
+// moving changes.  mo is usually player->mo, but
+// not for voodoo dolls.
+//
+void
+P_GetPlayerMove
+( player_t*	player,
+  mobj_t*	mo,
+  pmove_t*	pm )
+{
+    pm->x = mo->x;
+    pm->y = mo->y;
+    pm->z = mo->z;
+    pm->momx = mo->momx;
+    pm->momy = mo->momy;
+    pm->momz = mo->momz;
+    pm->floorz = mo->floorz;
+    pm->ceilingz = mo->ceilingz;
+    pm->viewz = player->viewz;
+    pm->viewheight = player->viewheight;
+    pm->deltaviewheight = player->deltaviewheight;
+    pm->bob = player->bob;
+}
+
+
+//
+// P_SetPlayerMove
+// Puts back what P_GetPlayerMove copied.
+//
+void
+P_SetPlayerMove
+( player_t*	player,
+  mobj_t*	mo,
+  pmove_t*	pm )
+{
+    mo->x = pm->x;
+    mo->y = pm->y;
+    mo->z = pm->z;
+    mo->momx = pm->momx;
+    mo->momy = pm->momy;
+    mo->momz = pm->momz;
+    mo->floorz = pm->floorz;
+    mo->ceilingz = pm->ceilingz;
+    player->viewz = pm->viewz;
+    player->viewheight = pm->viewheight;
+    player->deltaviewheight = pm->deltaviewheight;
+    player->bob = pm->bob;
+}
+
+
+//
+// P_ThrustMomentum
+// Adds momentum along a given angle.
+//
+void
+P_ThrustMomentum
+( fixed_t*	momx,
+  fixed_t*	momy,
+  angle_t	angle,
+  fixed_t	move )
+{
+    angle >>= ANGLETOFINESHIFT;
+    
+    *momx += FixedMul(move,finecosine[angle]); 
+    *momy += FixedMul(move,finesine[angle]);
+}
 
 
 //
@@ -55,20 +125,22 @@ P_Thrust
   angle_t	angle,
   fixed_t	move ) 
 {
-    angle >>= ANGLETOFINESHIFT;
-    
-    player->mo->momx += FixedMul(move,finecosine[angle]); 
-    player->mo->momy += FixedMul(move,finesine[angle]);
+    P_ThrustMomentum (&player->mo->momx, &player->mo->momy, angle, move);
 }
 
 
 
 
 //
-// P_CalcHeight
-// Calculate the walking / running height adjustment
+// P_CalcPlayerHeight
+// P_CalcHeight, on a copy of the player's movement.
 //
-void P_CalcHeight (player_t* player) 
+void
+P_CalcPlayerHeight
+( player_t*	player,
+  pmove_t*	pm,
+  boolean	isonground,
+  int		time )
 {
     int		angle;
     fixed_t	bob;
@@ -79,59 +151,73 @@ void P_CalcHeight (player_t* player)
     // OPTIMIZE: tablify angle
     // Note: a LUT allows for effects
     //  like a ramp with low health.
-    player->bob =
-	FixedMul (player->mo->momx, player->mo->momx)
-	+ FixedMul (player->mo->momy,player->mo->momy);
+    pm->bob =
+	FixedMul (pm->momx, pm->momx)
+	+ FixedMul (pm->momy,pm->momy);
     
-    player->bob >>= 2;
+    pm->bob >>= 2;
 
-    if (player->bob>MAXBOB)
-	player->bob = MAXBOB;
+    if (pm->bob>MAXBOB)
+	pm->bob = MAXBOB;
 
-    if ((player->cheats & CF_NOMOMENTUM) || !onground)
+    if ((player->cheats & CF_NOMOMENTUM) || !isonground)
     {
-	player->viewz = player->mo->z + VIEWHEIGHT;
+	pm->viewz = pm->z + VIEWHEIGHT;
 
-	if (player->viewz > player->mo->ceilingz-4*FRACUNIT)
-	    player->viewz = player->mo->ceilingz-4*FRACUNIT;
+	if (pm->viewz > pm->ceilingz-4*FRACUNIT)
+	    pm->viewz = pm->ceilingz-4*FRACUNIT;
 
-	player->viewz = player->mo->z + player->viewheight;
+	pm->viewz = pm->z + pm->viewheight;
 	return;
     }
 		
-    angle = (FINEANGLES/20*leveltime)&FINEMASK;
-    bob = FixedMul ( player->bob/2, finesine[angle]);
+    angle = (FINEANGLES/20*time)&FINEMASK;
+    bob = FixedMul ( pm->bob/2, finesine[angle]);
 
     
     // move viewheight
     if (player->playerstate == PST_LIVE)
     {
-	player->viewheight += player->deltaviewheight;
+	pm->viewheight += pm->deltaviewheight;
 
-	if (player->viewheight > VIEWHEIGHT)
+	if (pm->viewheight > VIEWHEIGHT)
 	{
-	    player->viewheight = VIEWHEIGHT;
-	    player->deltaviewheight = 0;
+	    pm->viewheight = VIEWHEIGHT;
+	    pm->deltaviewheight = 0;
 	}
 
-	if (player->viewheight < VIEWHEIGHT/2)
+	if (pm->viewheight < VIEWHEIGHT/2)
 	{
-	    player->viewheight = VIEWHEIGHT/2;
-	    if (player->deltaviewheight <= 0)
-		player->deltaviewheight = 1;
+	    pm->viewheight = VIEWHEIGHT/2;
+	    if (pm->deltaviewheight <= 0)
+		pm->deltaviewheight = 1;
 	}
 	
-	if (player->deltaviewheight)	
+	if (pm->deltaviewheight)	
 	{
-	    player->deltaviewheight += FRACUNIT/4;
-	    if (!player->deltaviewheight)
-		player->deltaviewheight = 1;
+	    pm->deltaviewheight += FRACUNIT/4;
+	    if (!pm->deltaviewheight)
+		pm->deltaviewheight = 1;
 	}
     }
-    player->viewz = player->mo->z + player->viewheight + bob;
+    pm->viewz = pm->z + pm->viewheight + bob;
+
+    if (pm->viewz > pm->ceilingz-4*FRACUNIT)
+	pm->viewz = pm->ceilingz-4*FRACUNIT;
+}
+
+
+//
+// P_CalcHeight
+// Calculate the walking / running height adjustment
+//
+void P_CalcHeight (player_t* player) 
+{
+    pmove_t	pm;
 
-    if (player->viewz > player->mo->ceilingz-4*FRACUNIT)
-	player->viewz = player->mo->ceilingz-4*FRACUNIT;
+    P_GetPlayerMove (player, player->mo, &pm);
+    P_CalcPlayerHeight (player, &pm, onground, leveltime);
+    P_SetPlayerMove (player, player->mo, &pm);
 }
 
 #ifdef XBOX
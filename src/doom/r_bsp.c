@@ -28,6 +28,7 @@
 #include "r_main.h"
 #include "r_plane.h"
 #include "r_things.h"
+#include "r_stats.h"
 
 // State.
 #include "doomstat.h"
@@ -37,14 +38,16 @@
 
 
 
-seg_t*		curline;
-side_t*		sidedef;
-line_t*		linedef;
-sector_t*	frontsector;
-sector_t*	backsector;
+INSTANCE seg_t*		curline;
+INSTANCE side_t*		sidedef;
+INSTANCE line_t*		linedef;
+INSTANCE sector_t*	frontsector;
+INSTANCE sector_t*	backsector;
 
-drawseg_t	drawsegs[MAXDRAWSEGS];
-drawseg_t*	ds_p;
+// Grown as needed, and kept for later frames.
+INSTANCE drawseg_t*	drawsegs;
+INSTANCE drawseg_t*	ds_p;
+INSTANCE int		maxdrawsegs;
 
 
 void
@@ -55,11 +58,29 @@ R_StoreWallRange
 
 
 
+//
+// R_GrowDrawSegs
+// Doubles the number of drawsegs, keeping those in use.
+//
+void R_GrowDrawSegs (void)
+{
+    int		used;
+
+    used = ds_p - drawsegs;
+    maxdrawsegs = maxdrawsegs ? maxdrawsegs * 2 : MAXDRAWSEGS;
+    drawsegs = I_Realloc (drawsegs, maxdrawsegs * sizeof(*drawsegs));
+    ds_p = drawsegs + used;
+}
+
+
 //
 // R_ClearDrawSegs
 //
 void R_ClearDrawSegs (void)
 {
+    if (drawsegs == NULL)
+	R_GrowDrawSegs ();
+
     ds_p = drawsegs;
 }
 
@@ -87,8 +108,8 @@ typedef	struct
 #define MAXSEGS (SCREENWIDTH / 2 + 1)
 
 // newend is one past the last valid seg
-cliprange_t*	newend;
-cliprange_t	solidsegs[MAXSEGS];
+INSTANCE cliprange_t*	newend;
+INSTANCE cliprange_t	solidsegs[MAXSEGS];
 
 
 
@@ -539,9 +560,9 @@ void R_Subsector (int num)
 	line++;
     }
 
-    // check for solidsegs overflow - extremely unsatisfactory!
-    if(newend > &solidsegs[32])
-        I_Error("R_Subsector: solidsegs overflow (vanilla may crash here)\n");
+    // solidsegs is big enough for any view, but the original
+    //  only had room for 32.
+    R_CountRenderList (rl_solidsegs, newend - solidsegs);
 }
 
 
@@ -22,25 +22,26 @@
 
 
 
-extern seg_t*		curline;
-extern side_t*		sidedef;
-extern line_t*		linedef;
-extern sector_t*	frontsector;
-extern sector_t*	backsector;
+extern INSTANCE seg_t*		curline;
+extern INSTANCE side_t*		sidedef;
+extern INSTANCE line_t*		linedef;
+extern INSTANCE sector_t*	frontsector;
+extern INSTANCE sector_t*	backsector;
 
-extern int		rw_x;
-extern int		rw_stopx;
+extern INSTANCE int		rw_x;
+extern INSTANCE int		rw_stopx;
 
-extern boolean		segtextured;
+extern INSTANCE boolean		segtextured;
 
 // false if the back side is the same plane
-extern boolean		markfloor;		
-extern boolean		markceiling;
+extern INSTANCE boolean		markfloor;		
+extern INSTANCE boolean		markceiling;
 
 extern boolean		skymap;
 
-extern drawseg_t	drawsegs[MAXDRAWSEGS];
-extern drawseg_t*	ds_p;
+extern INSTANCE drawseg_t*	drawsegs;
+extern INSTANCE drawseg_t*	ds_p;
+extern INSTANCE int		maxdrawsegs;
 
 extern lighttable_t**	hscalelight;
 extern lighttable_t**	vscalelight;
@@ -53,6 +54,7 @@ typedef void (*drawfunc_t) (int start, int stop);
 // BSP?
 void R_ClearClipSegs (void);
 void R_ClearDrawSegs (void);
+void R_GrowDrawSegs (void);
 
 
 void R_RenderBSPNode (int bspnum);
@@ -126,41 +126,41 @@ struct texture_s
 
 
 
-int		firstflat;
-int		lastflat;
-int		numflats;
+INSTANCE int		firstflat;
+INSTANCE int		lastflat;
+INSTANCE int		numflats;
 
-int		firstpatch;
-int		lastpatch;
-int		numpatches;
+INSTANCE int		firstpatch;
+INSTANCE int		lastpatch;
+INSTANCE int		numpatches;
 
-int		firstspritelump;
-int		lastspritelump;
-int		numspritelumps;
+INSTANCE int		firstspritelump;
+INSTANCE int		lastspritelump;
+INSTANCE int		numspritelumps;
 
-int		numtextures;
-texture_t**	textures;
-texture_t**     textures_hashtable;
+INSTANCE int		numtextures;
+INSTANCE texture_t**	textures;
+INSTANCE texture_t**     textures_hashtable;
 
 
-int*			texturewidthmask;
+INSTANCE int*			texturewidthmask;
 // needed for texture pegging
-fixed_t*		textureheight;		
-int*			texturecompositesize;
-short**			texturecolumnlump;
-unsigned short**	texturecolumnofs;
-byte**			texturecomposite;
+INSTANCE fixed_t*		textureheight;		
+INSTANCE int*			texturecompositesize;
+INSTANCE short**			texturecolumnlump;
+INSTANCE unsigned short**	texturecolumnofs;
+INSTANCE byte**			texturecomposite;
 
 // for global animation
-int*		flattranslation;
-int*		texturetranslation;
+INSTANCE int*		flattranslation;
+INSTANCE int*		texturetranslation;
 
 // needed for pre rendering
-fixed_t*	spritewidth;	
-fixed_t*	spriteoffset;
-fixed_t*	spritetopoffset;
+INSTANCE fixed_t*	spritewidth;	
+INSTANCE fixed_t*	spriteoffset;
+INSTANCE fixed_t*	spritetopoffset;
 
-lighttable_t	*colormaps;
+INSTANCE lighttable_t	*colormaps;
 
 
 //
@@ -793,9 +793,9 @@ int R_TextureNumForName(const char *name)
 // R_PrecacheLevel
 // Preloads all relevant graphics for the level.
 //
-int		flatmemory;
-int		texturememory;
-int		spritememory;
+INSTANCE int		flatmemory;
+INSTANCE int		texturememory;
+INSTANCE int		spritememory;
 
 void R_PrecacheLevel (void)
 {
@@ -29,6 +29,8 @@
 #include "w_wad.h"
 
 #include "r_local.h"
+#include "r_span.h"
+#include "r_threads.h"
 
 // Needs access to LFB (guess what).
 #include "v_video.h"
@@ -54,43 +56,45 @@
 //
 
 
-byte*		viewimage; 
-int		viewwidth;
-int		scaledviewwidth;
-int		viewheight;
-int		viewwindowx;
-int		viewwindowy; 
-pixel_t*		ylookup[MAXHEIGHT];
-int		columnofs[MAXWIDTH]; 
+INSTANCE byte*		viewimage; 
+INSTANCE int		viewwidth;
+INSTANCE int		scaledviewwidth;
+INSTANCE int		viewheight;
+INSTANCE int		viewwindowx;
+INSTANCE int		viewwindowy; 
+INSTANCE pixel_t*		ylookup[MAXHEIGHT];
+INSTANCE int		columnofs[MAXWIDTH]; 
 
 // Color tables for different players,
 //  translate a limited part to another
 //  (color ramps used for  suit colors).
 //
-byte		translations[3][256];	
+INSTANCE byte		translations[3][256];	
  
 // Backing buffer containing the bezel drawn around the screen and 
 // surrounding background.
 
-static pixel_t *background_buffer = NULL;
+static INSTANCE pixel_t *background_buffer = NULL;
 
 
 //
 // R_DrawColumn
 // Source is the top of the column to scale.
 //
-lighttable_t*		dc_colormap; 
-int			dc_x; 
-int			dc_yl; 
-int			dc_yh; 
-fixed_t			dc_iscale; 
-fixed_t			dc_texturemid;
+// The drawer inputs are per thread, so that render threads
+//  (see r_threads.c) can draw columns side by side.
+THREADLOCAL lighttable_t*	dc_colormap; 
+THREADLOCAL int		dc_x; 
+THREADLOCAL int		dc_yl; 
+THREADLOCAL int		dc_yh; 
+THREADLOCAL fixed_t		dc_iscale; 
+THREADLOCAL fixed_t		dc_texturemid;
 
 // first pixel in a column (possibly virtual) 
-byte*			dc_source;		
+THREADLOCAL byte*		dc_source;		
 
 // just for profiling 
-int			dccount;
+INSTANCE int			dccount;
 
 //
 // A column is a vertical slice/span from a wall texture that,
@@ -258,7 +262,7 @@ void R_DrawColumnLow (void)
 #define FUZZOFF	(SCREENWIDTH)
 
 
-int	fuzzoffset[FUZZTABLE] =
+INSTANCE int	fuzzoffset[FUZZTABLE] =
 {
     FUZZOFF,-FUZZOFF,FUZZOFF,-FUZZOFF,FUZZOFF,FUZZOFF,-FUZZOFF,
     FUZZOFF,FUZZOFF,-FUZZOFF,FUZZOFF,FUZZOFF,FUZZOFF,-FUZZOFF,
@@ -269,7 +273,7 @@ int	fuzzoffset[FUZZTABLE] =
     FUZZOFF,FUZZOFF,-FUZZOFF,FUZZOFF,FUZZOFF,-FUZZOFF,FUZZOFF 
 }; 
 
-int	fuzzpos = 0; 
+THREADLOCAL int	fuzzpos = 0; 
 
 
 //
@@ -409,6 +413,26 @@ void R_DrawFuzzColumnLow (void)
   
  
 
+//
+// R_SkipFuzzColumn
+// Advances the fuzz table position as R_DrawFuzzColumn
+//  would, without drawing anything.
+//
+void R_SkipFuzzColumn (void)
+{
+    int			yl;
+    int			yh;
+
+    yl = dc_yl ? dc_yl : 1;
+    yh = dc_yh == viewheight-1 ? viewheight-2 : dc_yh;
+
+    if (yh < yl)
+	return;
+
+    fuzzpos = (fuzzpos + yh - yl + 1) % FUZZTABLE;
+}
+ 
+ 
 //
 // R_DrawTranslatedColumn
 // Used to draw player sprites
@@ -418,8 +442,8 @@ void R_DrawFuzzColumnLow (void)
 //  of the BaronOfHell, the HellKnight, uses
 //  identical sprites, kinda brightened up.
 //
-byte*	dc_translation;
-byte*	translationtables;
+THREADLOCAL byte*	dc_translation;
+INSTANCE byte*	translationtables;
 
 void R_DrawTranslatedColumn (void) 
 { 
@@ -567,22 +591,22 @@ void R_InitTranslationTables (void)
 // In consequence, flats are not stored by column (like walls),
 //  and the inner loop has to step in texture space u and v.
 //
-int			ds_y; 
-int			ds_x1; 
-int			ds_x2;
+THREADLOCAL int		ds_y; 
+THREADLOCAL int		ds_x1; 
+THREADLOCAL int		ds_x2;
 
-lighttable_t*		ds_colormap; 
+THREADLOCAL lighttable_t*	ds_colormap; 
 
-fixed_t			ds_xfrac; 
-fixed_t			ds_yfrac; 
-fixed_t			ds_xstep; 
-fixed_t			ds_ystep;
+THREADLOCAL fixed_t		ds_xfrac; 
+THREADLOCAL fixed_t		ds_yfrac; 
+THREADLOCAL fixed_t		ds_xstep; 
+THREADLOCAL fixed_t		ds_ystep;
 
 // start of a 64*64 tile image 
-byte*			ds_source;	
+THREADLOCAL byte*		ds_source;	
 
 // just for profiling
-int			dscount;
+INSTANCE int			dscount;
 
 
 //
@@ -592,8 +616,6 @@ void R_DrawSpan (void)
     unsigned int position, step;
     pixel_t *dest;
     int count;
-    int spot;
-    unsigned int xtemp, ytemp;
 
 #ifdef RANGECHECK
     if (ds_x2 < ds_x1
@@ -620,22 +642,10 @@ void R_DrawSpan (void)
     dest = ylookup[ds_y] + columnofs[ds_x1];
 
     // We do not check for zero spans here?
-    count = ds_x2 - ds_x1;
+    count = ds_x2 - ds_x1 + 1;
 
-    do
-    {
-	// Calculate current texture index in u,v.
-        ytemp = (position >> 4) & 0x0fc0;
-        xtemp = (position >> 26);
-        spot = xtemp | ytemp;
-
-	// Lookup pixel from flat texture tile,
-	//  re-index using light/colormap.
-	*dest++ = ds_colormap[ds_source[spot]];
-
-        position += step;
-
-    } while (count--);
+    // The inner loop is chosen for the CPU; see r_span.c.
+    r_spankernel (dest, ds_source, ds_colormap, position, step, count);
 }
 
 
@@ -766,6 +776,448 @@ void R_DrawSpanLow (void)
     } while (count--);
 }
 
+
+//
+// R_SkipSpan
+// Moves the start of the span right by count pixels.
+// The span drawers step u and v packed into one word,
+//  where a carry out of v spills into u, so the new
+//  start is found the same way to give identical pixels.
+//
+void R_SkipSpan (int count)
+{
+    unsigned int position, step;
+
+    position = ((ds_xfrac << 10) & 0xffff0000)
+             | ((ds_yfrac >> 6)  & 0x0000ffff);
+    step = ((ds_xstep << 10) & 0xffff0000)
+         | ((ds_ystep >> 6)  & 0x0000ffff);
+
+    position += step * count;
+
+    ds_xfrac = (position & 0xffff0000) >> 10;
+    ds_yfrac = (position & 0x0000ffff) << 6;
+    ds_x1 += count;
+}
+
+
+//
+// Column-major view buffer.
+// With -colmajor the view is drawn into a separate buffer
+//  where each column is contiguous, so that the column
+//  drawers (walls, sprites) walk memory one byte at a time
+//  instead of a whole screen row per pixel.  Spans pay the
+//  stride instead.  The view is transposed into the screen
+//  buffer once it is complete; see R_TransposeView.
+//
+#define COLPITCH		(SCREENHEIGHT)
+
+INSTANCE boolean			r_colmajor;
+
+static INSTANCE pixel_t*		colbuffer = NULL;
+
+// With -pipeline, a view is still being drawn while the
+//  next frame is put together, so it needs a buffer of
+//  its own.  It is laid out the same as the screen.
+static INSTANCE pixel_t*		pipebuffer = NULL;
+
+
+void R_DrawColumnColMajor (void) 
+{ 
+    int			count; 
+    pixel_t*		dest;
+    fixed_t		frac;
+    fixed_t		fracstep;	 
+ 
+    count = dc_yh - dc_yl; 
+
+    if (count < 0) 
+	return; 
+				 
+#ifdef RANGECHECK 
+    if ((unsigned)dc_x >= SCREENWIDTH
+	|| dc_yl < 0
+	|| dc_yh >= SCREENHEIGHT) 
+	I_Error ("R_DrawColumn: %i to %i at %i", dc_yl, dc_yh, dc_x); 
+#endif 
+
+    dest = ylookup[dc_yl] + columnofs[dc_x];  
+
+    fracstep = dc_iscale; 
+    frac = dc_texturemid + (dc_yl-centery)*fracstep; 
+
+    do 
+    {
+	*dest++ = dc_colormap[dc_source[(frac>>FRACBITS)&127]];
+	frac += fracstep;
+    } while (count--); 
+} 
+
+
+void R_DrawColumnLowColMajor (void) 
+{ 
+    int			count; 
+    pixel_t*		dest;
+    pixel_t*		dest2;
+    fixed_t		frac;
+    fixed_t		fracstep;	 
+    int                 x;
+ 
+    count = dc_yh - dc_yl; 
+
+    if (count < 0) 
+	return; 
+
+    x = dc_x << 1;
+
+#ifdef RANGECHECK 
+    if ((unsigned)x >= SCREENWIDTH
+	|| dc_yl < 0
+	|| dc_yh >= SCREENHEIGHT)
+    {
+	I_Error ("R_DrawColumn: %i to %i at %i", dc_yl, dc_yh, dc_x);
+    }
+#endif 
+    
+    dest = ylookup[dc_yl] + columnofs[x];
+    dest2 = ylookup[dc_yl] + columnofs[x+1];
+    
+    fracstep = dc_iscale; 
+    frac = dc_texturemid + (dc_yl-centery)*fracstep;
+    
+    do 
+    {
+	*dest2++ = *dest++ = dc_colormap[dc_source[(frac>>FRACBITS)&127]];
+	frac += fracstep; 
+    } while (count--);
+}
+
+
+// The fuzz table offsets are set up by R_InitBuffer
+//  to step one pixel up or down the column.
+
+void R_DrawFuzzColumnColMajor (void) 
+{ 
+    int			count; 
+    pixel_t*		dest;
+
+    if (!dc_yl) 
+	dc_yl = 1;
+
+    if (dc_yh == viewheight-1) 
+	dc_yh = viewheight - 2; 
+		 
+    count = dc_yh - dc_yl; 
+
+    if (count < 0) 
+	return; 
+
+#ifdef RANGECHECK 
+    if ((unsigned)dc_x >= SCREENWIDTH
+	|| dc_yl < 0 || dc_yh >= SCREENHEIGHT)
+    {
+	I_Error ("R_DrawFuzzColumn: %i to %i at %i",
+		 dc_yl, dc_yh, dc_x);
+    }
+#endif
+    
+    dest = ylookup[dc_yl] + columnofs[dc_x];
+
+    do 
+    {
+	*dest = colormaps[6*256+dest[fuzzoffset[fuzzpos]]]; 
+
+	if (++fuzzpos == FUZZTABLE) 
+	    fuzzpos = 0;
+	
+	dest++;
+    } while (count--); 
+} 
+
+
+void R_DrawFuzzColumnLowColMajor (void) 
+{ 
+    int			count; 
+    pixel_t*		dest;
+    pixel_t*		dest2;
+    int x;
+
+    if (!dc_yl) 
+	dc_yl = 1;
+
+    if (dc_yh == viewheight-1) 
+	dc_yh = viewheight - 2; 
+		 
+    count = dc_yh - dc_yl; 
+
+    if (count < 0) 
+	return; 
+
+    x = dc_x << 1;
+    
+#ifdef RANGECHECK 
+    if ((unsigned)x >= SCREENWIDTH
+	|| dc_yl < 0 || dc_yh >= SCREENHEIGHT)
+    {
+	I_Error ("R_DrawFuzzColumn: %i to %i at %i",
+		 dc_yl, dc_yh, dc_x);
+    }
+#endif
+    
+    dest = ylookup[dc_yl] + columnofs[x];
+    dest2 = ylookup[dc_yl] + columnofs[x+1];
+
+    do 
+    {
+	*dest = colormaps[6*256+dest[fuzzoffset[fuzzpos]]]; 
+	*dest2 = colormaps[6*256+dest2[fuzzoffset[fuzzpos]]]; 
+
+	if (++fuzzpos == FUZZTABLE) 
+	    fuzzpos = 0;
+	
+	dest++;
+	dest2++;
+    } while (count--); 
+} 
+
+
+void R_DrawTranslatedColumnColMajor (void) 
+{ 
+    int			count; 
+    pixel_t*		dest;
+    fixed_t		frac;
+    fixed_t		fracstep;	 
+ 
+    count = dc_yh - dc_yl; 
+    if (count < 0) 
+	return; 
+				 
+#ifdef RANGECHECK 
+    if ((unsigned)dc_x >= SCREENWIDTH
+	|| dc_yl < 0
+	|| dc_yh >= SCREENHEIGHT)
+    {
+	I_Error ( "R_DrawColumn: %i to %i at %i",
+		  dc_yl, dc_yh, dc_x);
+    }
+#endif 
+
+    dest = ylookup[dc_yl] + columnofs[dc_x]; 
+
+    fracstep = dc_iscale; 
+    frac = dc_texturemid + (dc_yl-centery)*fracstep; 
+
+    do 
+    {
+	*dest++ = dc_colormap[dc_translation[dc_source[frac>>FRACBITS]]];
+	frac += fracstep; 
+    } while (count--); 
+} 
+
+
+void R_DrawTranslatedColumnLowColMajor (void) 
+{ 
+    int			count; 
+    pixel_t*		dest;
+    pixel_t*		dest2;
+    fixed_t		frac;
+    fixed_t		fracstep;	 
+    int                 x;
+ 
+    count = dc_yh - dc_yl; 
+    if (count < 0) 
+	return; 
+
+    x = dc_x << 1;
+				 
+#ifdef RANGECHECK 
+    if ((unsigned)x >= SCREENWIDTH
+	|| dc_yl < 0
+	|| dc_yh >= SCREENHEIGHT)
+    {
+	I_Error ( "R_DrawColumn: %i to %i at %i",
+		  dc_yl, dc_yh, x);
+    }
+#endif 
+
+    dest = ylookup[dc_yl] + columnofs[x]; 
+    dest2 = ylookup[dc_yl] + columnofs[x+1]; 
+
+    fracstep = dc_iscale; 
+    frac = dc_texturemid + (dc_yl-centery)*fracstep; 
+
+    do 
+    {
+	*dest2++ = *dest++ =
+	    dc_colormap[dc_translation[dc_source[frac>>FRACBITS]]];
+	frac += fracstep; 
+    } while (count--); 
+} 
+
+
+void R_DrawSpanColMajor (void) 
+{ 
+    unsigned int position, step;
+    pixel_t *dest;
+    int count;
+    int spot;
+    unsigned int xtemp, ytemp;
+
+#ifdef RANGECHECK
+    if (ds_x2 < ds_x1
+	|| ds_x1<0
+	|| ds_x2>=SCREENWIDTH
+	|| (unsigned)ds_y>SCREENHEIGHT)
+    {
+	I_Error( "R_DrawSpan: %i to %i at %i",
+		 ds_x1,ds_x2,ds_y);
+    }
+#endif
+
+    position = ((ds_xfrac << 10) & 0xffff0000)
+             | ((ds_yfrac >> 6)  & 0x0000ffff);
+    step = ((ds_xstep << 10) & 0xffff0000)
+         | ((ds_ystep >> 6)  & 0x0000ffff);
+
+    dest = ylookup[ds_y] + columnofs[ds_x1];
+
+    count = ds_x2 - ds_x1;
+
+    do
+    {
+        ytemp = (position >> 4) & 0x0fc0;
+        xtemp = (position >> 26);
+        spot = xtemp | ytemp;
+
+	*dest = ds_colormap[ds_source[spot]];
+	dest += COLPITCH;
+
+        position += step;
+
+    } while (count--);
+}
+
+
+void R_DrawSpanLowColMajor (void)
+{
+    unsigned int position, step;
+    unsigned int xtemp, ytemp;
+    pixel_t *dest;
+    int count;
+    int spot;
+
+#ifdef RANGECHECK
+    if (ds_x2 < ds_x1
+	|| ds_x1<0
+	|| ds_x2>=SCREENWIDTH
+	|| (unsigned)ds_y>SCREENHEIGHT)
+    {
+	I_Error( "R_DrawSpan: %i to %i at %i",
+		 ds_x1,ds_x2,ds_y);
+    }
+#endif
+
+    position = ((ds_xfrac << 10) & 0xffff0000)
+             | ((ds_yfrac >> 6)  & 0x0000ffff);
+    step = ((ds_xstep << 10) & 0xffff0000)
+         | ((ds_ystep >> 6)  & 0x0000ffff);
+
+    count = (ds_x2 - ds_x1);
+
+    ds_x1 <<= 1;
+    ds_x2 <<= 1;
+
+    dest = ylookup[ds_y] + columnofs[ds_x1];
+
+    do
+    {
+        ytemp = (position >> 4) & 0x0fc0;
+        xtemp = (position >> 26);
+        spot = xtemp | ytemp;
+
+	dest[0] = dest[COLPITCH] = ds_colormap[ds_source[spot]];
+	dest += COLPITCH*2;
+
+	position += step;
+
+    } while (count--);
+}
+
+
+//
+// R_TransposeView
+// Copies the finished view from the column-major buffer
+//  into the screen buffer.  Done in square tiles so that
+//  both the reads and the writes stay within a few
+//  cache lines at a time.
+//
+#define TRANSPOSETILE		16
+
+void R_TransposeView (void)
+{
+    pixel_t*	src;
+    pixel_t*	dest;
+    int		x, y;
+    int		x1, y1;
+    int		x2, y2;
+
+    for (y1=0 ; y1<viewheight ; y1+=TRANSPOSETILE)
+    {
+	y2 = y1 + TRANSPOSETILE;
+	if (y2 > viewheight)
+	    y2 = viewheight;
+
+	for (x1=0 ; x1<scaledviewwidth ; x1+=TRANSPOSETILE)
+	{
+	    x2 = x1 + TRANSPOSETILE;
+	    if (x2 > scaledviewwidth)
+		x2 = scaledviewwidth;
+
+	    for (y=y1 ; y<y2 ; y++)
+	    {
+		src = colbuffer + x1*COLPITCH + y;
+		dest = I_VideoBuffer + (viewwindowy+y)*SCREENWIDTH
+		     + viewwindowx + x1;
+
+		for (x=x1 ; x<x2 ; x++)
+		{
+		    *dest++ = *src;
+		    src += COLPITCH;
+		}
+	    }
+	}
+    }
+}
+
+
+//
+// R_CopyView
+// Puts the finished view on the screen, if it was
+//  not drawn there to begin with.
+//
+void R_CopyView (void)
+{
+    int		y;
+    int		ofs;
+
+    if (r_colmajor)
+    {
+	R_TransposeView ();
+	return;
+    }
+
+    if (pipebuffer == NULL)
+	return;
+
+    for (y=viewwindowy ; y<viewwindowy+viewheight ; y++)
+    {
+	ofs = y*SCREENWIDTH + viewwindowx;
+	memcpy (I_VideoBuffer + ofs, pipebuffer + ofs,
+		scaledviewwidth * sizeof(*pipebuffer));
+    }
+}
+
+
 //
 // R_InitBuffer 
 // Creats lookup tables that avoid
@@ -798,6 +1250,42 @@ R_InitBuffer
     // Preclaculate all row offsets.
     for (i=0 ; i<height ; i++) 
 	ylookup[i] = I_VideoBuffer + (i+viewwindowy)*SCREENWIDTH; 
+
+    if (r_pipeline && !r_colmajor)
+    {
+	if (pipebuffer == NULL)
+	{
+	    pipebuffer = Z_Malloc (SCREENWIDTH * SCREENHEIGHT
+				   * sizeof(*pipebuffer), PU_STATIC, NULL);
+	}
+
+	for (i=0 ; i<height ; i++) 
+	    ylookup[i] = pipebuffer + (i+viewwindowy)*SCREENWIDTH; 
+    }
+
+    // The fuzz effect samples the pixel above or below.
+    for (i=0 ; i<FUZZTABLE ; i++)
+	fuzzoffset[i] = fuzzoffset[i] > 0 ? FUZZOFF : -FUZZOFF;
+
+    if (!r_colmajor)
+	return;
+
+    // Column-major: the view gets a buffer of its own,
+    //  with the window offset applied when it is transposed.
+    if (colbuffer == NULL)
+    {
+	colbuffer = Z_Malloc (COLPITCH * SCREENWIDTH * sizeof(*colbuffer),
+			      PU_STATIC, NULL);
+    }
+
+    for (i=0 ; i<width ; i++) 
+	columnofs[i] = i*COLPITCH;
+
+    for (i=0 ; i<height ; i++) 
+	ylookup[i] = colbuffer + i; 
+
+    for (i=0 ; i<FUZZTABLE ; i++)
+	fuzzoffset[i] = fuzzoffset[i] > 0 ? 1 : -1;
 } 
  
  
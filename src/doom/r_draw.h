@@ -23,15 +23,15 @@
 
 
 
-extern lighttable_t*	dc_colormap;
-extern int		dc_x;
-extern int		dc_yl;
-extern int		dc_yh;
-extern fixed_t		dc_iscale;
-extern fixed_t		dc_texturemid;
+extern THREADLOCAL lighttable_t*	dc_colormap;
+extern THREADLOCAL int		dc_x;
+extern THREADLOCAL int		dc_yl;
+extern THREADLOCAL int		dc_yh;
+extern THREADLOCAL fixed_t		dc_iscale;
+extern THREADLOCAL fixed_t		dc_texturemid;
 
 // first pixel in a column
-extern byte*		dc_source;		
+extern THREADLOCAL byte*		dc_source;		
 
 
 // The span blitting interface.
@@ -44,6 +44,11 @@ void 	R_DrawColumnLow (void);
 void 	R_DrawFuzzColumn (void);
 void 	R_DrawFuzzColumnLow (void);
 
+// Position in the fuzz table, and a way to move it on
+//  past a column without drawing.
+extern THREADLOCAL int		fuzzpos;
+void	R_SkipFuzzColumn (void);
+
 // Draw with color translation tables,
 //  for player sprite rendering,
 //  Green/Red/Blue/Indigo shirts.
@@ -55,22 +60,22 @@ R_VideoErase
 ( unsigned	ofs,
   int		count );
 
-extern int		ds_y;
-extern int		ds_x1;
-extern int		ds_x2;
+extern THREADLOCAL int		ds_y;
+extern THREADLOCAL int		ds_x1;
+extern THREADLOCAL int		ds_x2;
 
-extern lighttable_t*	ds_colormap;
+extern THREADLOCAL lighttable_t*	ds_colormap;
 
-extern fixed_t		ds_xfrac;
-extern fixed_t		ds_yfrac;
-extern fixed_t		ds_xstep;
-extern fixed_t		ds_ystep;
+extern THREADLOCAL fixed_t		ds_xfrac;
+extern THREADLOCAL fixed_t		ds_yfrac;
+extern THREADLOCAL fixed_t		ds_xstep;
+extern THREADLOCAL fixed_t		ds_ystep;
 
 // start of a 64*64 tile image
-extern byte*		ds_source;		
+extern THREADLOCAL byte*		ds_source;		
 
-extern byte*		translationtables;
-extern byte*		dc_translation;
+extern INSTANCE byte*		translationtables;
+extern THREADLOCAL byte*		dc_translation;
 
 
 // Span blitting for rows, floor/ceiling.
@@ -80,12 +85,34 @@ void 	R_DrawSpan (void);
 // Low resolution mode, 160x200?
 void 	R_DrawSpanLow (void);
 
+// Moves the start of the span right, stepping as the drawers do.
+void	R_SkipSpan (int count);
+
 
 void
 R_InitBuffer
 ( int		width,
   int		height );
 
+// Column-major view buffer, see R_InitBuffer.
+extern INSTANCE boolean		r_colmajor;
+
+void	R_DrawColumnColMajor (void);
+void	R_DrawColumnLowColMajor (void);
+void	R_DrawFuzzColumnColMajor (void);
+void	R_DrawFuzzColumnLowColMajor (void);
+void	R_DrawTranslatedColumnColMajor (void);
+void	R_DrawTranslatedColumnLowColMajor (void);
+void	R_DrawSpanColMajor (void);
+void	R_DrawSpanLowColMajor (void);
+
+// Copies the column-major view into the screen buffer.
+void	R_TransposeView (void);
+
+// Puts the finished view on the screen, from wherever
+//  it was drawn.
+void	R_CopyView (void);
+
 
 // Initialize color translation tables,
 //  for player rendering etc.
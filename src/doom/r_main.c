@@ -29,11 +29,16 @@
 #include "doomdef.h"
 #include "d_loop.h"
 
+#include "m_argv.h"
 #include "m_bbox.h"
 #include "m_menu.h"
+#include "p_predict.h"
 
 #include "r_local.h"
 #include "r_sky.h"
+#include "r_span.h"
+#include "r_stats.h"
+#include "r_threads.h"
 
 
 
@@ -44,73 +49,73 @@
 
 
 
-int			viewangleoffset;
+INSTANCE int			viewangleoffset;
 
 // increment every time a check is made
-int			validcount = 1;		
+INSTANCE int			validcount = 1;		
 
 
-lighttable_t*		fixedcolormap;
-extern lighttable_t**	walllights;
+INSTANCE lighttable_t*		fixedcolormap;
+extern INSTANCE lighttable_t**	walllights;
 
-int			centerx;
-int			centery;
+INSTANCE int			centerx;
+INSTANCE int			centery;
 
-fixed_t			centerxfrac;
-fixed_t			centeryfrac;
-fixed_t			projection;
+INSTANCE fixed_t			centerxfrac;
+INSTANCE fixed_t			centeryfrac;
+INSTANCE fixed_t			projection;
 
 // just for profiling purposes
-int			framecount;	
+INSTANCE int			framecount;	
 
-int			sscount;
-int			linecount;
-int			loopcount;
+INSTANCE int			sscount;
+INSTANCE int			linecount;
+INSTANCE int			loopcount;
 
-fixed_t			viewx;
-fixed_t			viewy;
-fixed_t			viewz;
+INSTANCE fixed_t			viewx;
+INSTANCE fixed_t			viewy;
+INSTANCE fixed_t			viewz;
 
-angle_t			viewangle;
+INSTANCE angle_t			viewangle;
 
-fixed_t			viewcos;
-fixed_t			viewsin;
+INSTANCE fixed_t			viewcos;
+INSTANCE fixed_t			viewsin;
 
-player_t*		viewplayer;
+INSTANCE player_t*		viewplayer;
 
 // 0 = high, 1 = low
-int			detailshift;	
+INSTANCE int			detailshift;	
 
 //
 // precalculated math tables
 //
-angle_t			clipangle;
+INSTANCE angle_t			clipangle;
 
 // The viewangletox[viewangle + FINEANGLES/4] lookup
 // maps the visible view angles to screen X coordinates,
 // flattening the arc to a flat projection plane.
 // There will be many angles mapped to the same X. 
-int			viewangletox[FINEANGLES/2];
+INSTANCE int			viewangletox[FINEANGLES/2];
 
 // The xtoviewangleangle[] table maps a screen pixel
 // to the lowest viewangle that maps back to x ranges
 // from clipangle to -clipangle.
-angle_t			xtoviewangle[SCREENWIDTH+1];
+INSTANCE angle_t			xtoviewangle[SCREENWIDTH+1];
 
-lighttable_t*		scalelight[LIGHTLEVELS][MAXLIGHTSCALE];
-lighttable_t*		scalelightfixed[MAXLIGHTSCALE];
-lighttable_t*		zlight[LIGHTLEVELS][MAXLIGHTZ];
+INSTANCE lighttable_t*		scalelight[LIGHTLEVELS][MAXLIGHTSCALE];
+INSTANCE lighttable_t*		scalelightfixed[MAXLIGHTSCALE];
+INSTANCE lighttable_t*		zlight[LIGHTLEVELS][MAXLIGHTZ];
 
 // bumped light from gun blasts
-int			extralight;			
+INSTANCE int			extralight;			
 
 
 
-void (*colfunc) (void);
-void (*basecolfunc) (void);
-void (*fuzzcolfunc) (void);
-void (*transcolfunc) (void);
-void (*spanfunc) (void);
+INSTANCE void (*colfunc) (void);
+INSTANCE void (*basecolfunc) (void);
+INSTANCE void (*fuzzcolfunc) (void);
+INSTANCE void (*transcolfunc) (void);
+INSTANCE void (*spanfunc) (void);
 
 
 
@@ -645,9 +650,9 @@ void R_InitLightTables (void)
 //  because it might be in the middle of a refresh.
 // The change will take effect next refresh.
 //
-boolean		setsizeneeded;
-int		setblocks;
-int		setdetail;
+INSTANCE boolean		setsizeneeded;
+INSTANCE int		setblocks;
+INSTANCE int		setdetail;
 
 
 void
@@ -710,6 +715,26 @@ void R_ExecuteSetViewSize (void)
 	spanfunc = R_DrawSpanLow;
     }
 
+    if (r_colmajor)
+    {
+	if (!detailshift)
+	{
+	    colfunc = basecolfunc = R_DrawColumnColMajor;
+	    fuzzcolfunc = R_DrawFuzzColumnColMajor;
+	    transcolfunc = R_DrawTranslatedColumnColMajor;
+	    spanfunc = R_DrawSpanColMajor;
+	}
+	else
+	{
+	    colfunc = basecolfunc = R_DrawColumnLowColMajor;
+	    fuzzcolfunc = R_DrawFuzzColumnLowColMajor;
+	    transcolfunc = R_DrawTranslatedColumnLowColMajor;
+	    spanfunc = R_DrawSpanLowColMajor;
+	}
+    }
+
+    R_SetRenderSlices ();
+
     R_InitBuffer (scaledviewwidth, viewheight);
 	
     R_InitTextureMapping ();
@@ -766,6 +791,21 @@ void R_ExecuteSetViewSize (void)
 
 void R_Init (void)
 {
+    //!
+    // @category video
+    //
+    // Draw the 3D view into a column-major buffer and transpose it
+    // to the screen at the end of each frame.  Walls and sprites
+    // are then drawn with sequential writes, at the cost of
+    // strided writes for floors and ceilings.
+    //
+
+    r_colmajor = M_ParmExists("-colmajor");
+
+    R_InitSpanKernel ();
+    R_InitRenderThreads ();
+    R_InitRenderStats ();
+
     R_InitData ();
     printf (".");
     R_InitPointToAngle ();
@@ -825,12 +865,17 @@ void R_SetupFrame (player_t* player)
     int		i;
     
     viewplayer = player;
-    viewx = player->mo->x;
-    viewy = player->mo->y;
-    viewangle = player->mo->angle + viewangleoffset;
-    extralight = player->extralight;
 
-    viewz = player->viewz;
+    if (!P_PredictView(player, &viewx, &viewy, &viewz, &viewangle))
+    {
+        viewx = player->mo->x;
+        viewy = player->mo->y;
+        viewz = player->viewz;
+        viewangle = player->mo->angle;
+    }
+
+    viewangle += viewangleoffset;
+    extralight = player->extralight;
     
     viewsin = finesine[viewangle>>ANGLETOFINESHIFT];
     viewcos = finecosine[viewangle>>ANGLETOFINESHIFT];
@@ -886,6 +931,11 @@ void R_RenderPlayerView (player_t* player)
     
     R_DrawMasked ();
 
+    // Finish drawing, and put the view on the screen.
+    R_FinishView ();
+
+    R_CheckSpans ();
+
     // Check for new console commands.
     NetUpdate ();				
 }
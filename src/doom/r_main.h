@@ -29,25 +29,25 @@
 //
 // POV related.
 //
-extern fixed_t		viewcos;
-extern fixed_t		viewsin;
+extern INSTANCE fixed_t		viewcos;
+extern INSTANCE fixed_t		viewsin;
 
-extern int		viewwindowx;
-extern int		viewwindowy;
+extern INSTANCE int		viewwindowx;
+extern INSTANCE int		viewwindowy;
 
 
 
-extern int		centerx;
-extern int		centery;
+extern INSTANCE int		centerx;
+extern INSTANCE int		centery;
 
-extern fixed_t		centerxfrac;
-extern fixed_t		centeryfrac;
-extern fixed_t		projection;
+extern INSTANCE fixed_t		centerxfrac;
+extern INSTANCE fixed_t		centeryfrac;
+extern INSTANCE fixed_t		projection;
 
-extern int		validcount;
+extern INSTANCE int		validcount;
 
-extern int		linecount;
-extern int		loopcount;
+extern INSTANCE int		linecount;
+extern INSTANCE int		loopcount;
 
 
 //
@@ -66,12 +66,12 @@ extern int		loopcount;
 #define MAXLIGHTZ	       128
 #define LIGHTZSHIFT		20
 
-extern lighttable_t*	scalelight[LIGHTLEVELS][MAXLIGHTSCALE];
-extern lighttable_t*	scalelightfixed[MAXLIGHTSCALE];
-extern lighttable_t*	zlight[LIGHTLEVELS][MAXLIGHTZ];
+extern INSTANCE lighttable_t*	scalelight[LIGHTLEVELS][MAXLIGHTSCALE];
+extern INSTANCE lighttable_t*	scalelightfixed[MAXLIGHTSCALE];
+extern INSTANCE lighttable_t*	zlight[LIGHTLEVELS][MAXLIGHTZ];
 
-extern int		extralight;
-extern lighttable_t*	fixedcolormap;
+extern INSTANCE int		extralight;
+extern INSTANCE lighttable_t*	fixedcolormap;
 
 
 // Number of diminishing brightness levels.
@@ -82,19 +82,19 @@ extern lighttable_t*	fixedcolormap;
 // Blocky/low detail mode.
 //B remove this?
 //  0 = high, 1 = low
-extern	int		detailshift;	
+extern INSTANCE	int		detailshift;	
 
 
 //
 // Function pointers to switch refresh/drawing functions.
 // Used to select shadow mode etc.
 //
-extern void		(*colfunc) (void);
-extern void		(*transcolfunc) (void);
-extern void		(*basecolfunc) (void);
-extern void		(*fuzzcolfunc) (void);
+extern INSTANCE void		(*colfunc) (void);
+extern INSTANCE void		(*transcolfunc) (void);
+extern INSTANCE void		(*basecolfunc) (void);
+extern INSTANCE void		(*fuzzcolfunc) (void);
 // No shadow effects on floors.
-extern void		(*spanfunc) (void);
+extern INSTANCE void		(*spanfunc) (void);
 
 
 //
@@ -31,27 +31,36 @@
 
 #include "r_local.h"
 #include "r_sky.h"
+#include "r_stats.h"
 
 
 
-planefunction_t		floorfunc;
-planefunction_t		ceilingfunc;
+INSTANCE planefunction_t		floorfunc;
+INSTANCE planefunction_t		ceilingfunc;
 
 //
 // opening
 //
 
 // Here comes the obnoxious "visplane".
-#define MAXVISPLANES	128
-visplane_t		visplanes[MAXVISPLANES];
-visplane_t*		lastvisplane;
-visplane_t*		floorplane;
-visplane_t*		ceilingplane;
-
-// ?
-#define MAXOPENINGS	SCREENWIDTH*64
-short			openings[MAXOPENINGS];
-short*			lastopening;
+// They are allocated as more are needed and kept for later
+//  frames; a visplane never moves once it has been handed out,
+//  as floorplane and ceilingplane point into them.
+static INSTANCE visplane_t**	visplanes;
+static INSTANCE int		numvisplanes;
+static INSTANCE int		maxvisplanes;
+INSTANCE visplane_t*		floorplane;
+INSTANCE visplane_t*		ceilingplane;
+
+// Openings are handed out from a list of blocks, kept for
+//  later frames, so the clips stored in drawsegs stay put
+//  when another block is needed.
+static INSTANCE short**		openblocks;
+static INSTANCE int		numopenblocks;
+static INSTANCE int		openblock;
+static INSTANCE short*		lastopening;
+static INSTANCE short*		openingsend;
+static INSTANCE int		numopenings;
 
 
 //
@@ -59,32 +68,105 @@ short*			lastopening;
 //  floorclip starts out SCREENHEIGHT
 //  ceilingclip starts out -1
 //
-short			floorclip[SCREENWIDTH];
-short			ceilingclip[SCREENWIDTH];
+INSTANCE short			floorclip[SCREENWIDTH];
+INSTANCE short			ceilingclip[SCREENWIDTH];
 
 //
 // spanstart holds the start of a plane span
 // initialized to 0 at start
 //
-int			spanstart[SCREENHEIGHT];
-int			spanstop[SCREENHEIGHT];
+INSTANCE int			spanstart[SCREENHEIGHT];
+INSTANCE int			spanstop[SCREENHEIGHT];
 
 //
 // texture mapping
 //
-lighttable_t**		planezlight;
-fixed_t			planeheight;
+INSTANCE lighttable_t**		planezlight;
+INSTANCE fixed_t			planeheight;
+
+INSTANCE fixed_t			yslope[SCREENHEIGHT];
+INSTANCE fixed_t			distscale[SCREENWIDTH];
+INSTANCE fixed_t			basexscale;
+INSTANCE fixed_t			baseyscale;
+
+INSTANCE fixed_t			cachedheight[SCREENHEIGHT];
+INSTANCE fixed_t			cacheddistance[SCREENHEIGHT];
+INSTANCE fixed_t			cachedxstep[SCREENHEIGHT];
+INSTANCE fixed_t			cachedystep[SCREENHEIGHT];
+
+
+
+//
+// R_GrowVisplanes
+// Doubles the number of visplanes.
+//
+static void R_GrowVisplanes (void)
+{
+    visplane_t*	block;
+    int		newmax;
+    int		i;
+
+    newmax = maxvisplanes ? maxvisplanes * 2 : MAXVISPLANES;
+
+    visplanes = I_Realloc (visplanes, newmax * sizeof(*visplanes));
+    block = I_Realloc (NULL, (newmax - maxvisplanes) * sizeof(*block));
+
+    for (i=maxvisplanes ; i<newmax ; i++)
+	visplanes[i] = &block[i - maxvisplanes];
+
+    maxvisplanes = newmax;
+}
+
+
+//
+// R_NewVisplane
+//
+static visplane_t* R_NewVisplane (void)
+{
+    if (numvisplanes == maxvisplanes)
+	R_GrowVisplanes ();
+
+    return visplanes[numvisplanes++];
+}
+
+
+//
+// R_NextOpeningBlock
+// Moves on to the next block of openings,
+//  allocating it the first time.
+//
+static void R_NextOpeningBlock (void)
+{
+    if (openblock == numopenblocks)
+    {
+	openblocks = I_Realloc (openblocks,
+				(numopenblocks + 1) * sizeof(*openblocks));
+	openblocks[numopenblocks++] =
+	    I_Realloc (NULL, MAXOPENINGS * sizeof(**openblocks));
+    }
+
+    lastopening = openblocks[openblock++];
+    openingsend = lastopening + MAXOPENINGS;
+}
+
+
+//
+// R_NewOpenings
+// Room for count clip values, count at most SCREENWIDTH.
+//
+short* R_NewOpenings (int count)
+{
+    short*	result;
 
-fixed_t			yslope[SCREENHEIGHT];
-fixed_t			distscale[SCREENWIDTH];
-fixed_t			basexscale;
-fixed_t			baseyscale;
+    if (openingsend - lastopening < count)
+	R_NextOpeningBlock ();
 
-fixed_t			cachedheight[SCREENHEIGHT];
-fixed_t			cacheddistance[SCREENHEIGHT];
-fixed_t			cachedxstep[SCREENHEIGHT];
-fixed_t			cachedystep[SCREENHEIGHT];
+    result = lastopening;
+    lastopening += count;
+    numopenings += count;
 
+    return result;
+}
 
 
 //
@@ -93,7 +175,10 @@ fixed_t			cachedystep[SCREENHEIGHT];
 //
 void R_InitPlanes (void)
 {
-  // Doh!
+    // Enough for the original limits before the first frame.
+    R_GrowVisplanes ();
+    R_NextOpeningBlock ();
+    openblock = 0;
 }
 
 
@@ -187,8 +272,10 @@ void R_ClearPlanes (void)
 	ceilingclip[i] = -1;
     }
 
-    lastvisplane = visplanes;
-    lastopening = openings;
+    numvisplanes = 0;
+    openblock = 0;
+    numopenings = 0;
+    R_NextOpeningBlock ();
     
     // texture calculation
     memset (cachedheight, 0, sizeof(cachedheight));
@@ -214,6 +301,7 @@ R_FindPlane
   int		lightlevel )
 {
     visplane_t*	check;
+    int		i;
 	
     if (picnum == skyflatnum)
     {
@@ -221,24 +309,19 @@ R_FindPlane
 	lightlevel = 0;
     }
 	
-    for (check=visplanes; check<lastvisplane; check++)
+    for (i=0 ; i<numvisplanes ; i++)
     {
+	check = visplanes[i];
+
 	if (height == check->height
 	    && picnum == check->picnum
 	    && lightlevel == check->lightlevel)
 	{
-	    break;
+	    return check;
 	}
     }
     
-			
-    if (check < lastvisplane)
-	return check;
-		
-    if (lastvisplane - visplanes == MAXVISPLANES)
-	I_Error ("R_FindPlane: no more visplanes");
-		
-    lastvisplane++;
+    check = R_NewVisplane ();
 
     check->height = height;
     check->picnum = picnum;
@@ -261,6 +344,7 @@ R_CheckPlane
   int		start,
   int		stop )
 {
+    visplane_t*	newpl;
     int		intrl;
     int		intrh;
     int		unionl;
@@ -303,14 +387,12 @@ R_CheckPlane
     }
 	
     // make a new visplane
-    lastvisplane->height = pl->height;
-    lastvisplane->picnum = pl->picnum;
-    lastvisplane->lightlevel = pl->lightlevel;
-    
-    if (lastvisplane - visplanes == MAXVISPLANES)
-	I_Error ("R_CheckPlane: no more visplanes");
+    newpl = R_NewVisplane ();
+    newpl->height = pl->height;
+    newpl->picnum = pl->picnum;
+    newpl->lightlevel = pl->lightlevel;
 
-    pl = lastvisplane++;
+    pl = newpl;
     pl->minx = start;
     pl->maxx = stop;
 
@@ -368,23 +450,15 @@ void R_DrawPlanes (void)
     int			stop;
     int			angle;
     int                 lumpnum;
+    int			i;
 				
-#ifdef RANGECHECK
-    if (ds_p - drawsegs > MAXDRAWSEGS)
-	I_Error ("R_DrawPlanes: drawsegs overflow (%" PRIiPTR ")",
-		 ds_p - drawsegs);
-    
-    if (lastvisplane - visplanes > MAXVISPLANES)
-	I_Error ("R_DrawPlanes: visplane overflow (%" PRIiPTR ")",
-		 lastvisplane - visplanes);
-    
-    if (lastopening - openings > MAXOPENINGS)
-	I_Error ("R_DrawPlanes: opening overflow (%" PRIiPTR ")",
-		 lastopening - openings);
-#endif
+    R_CountRenderList (rl_visplanes, numvisplanes);
+    R_CountRenderList (rl_openings, numopenings);
 
-    for (pl = visplanes ; pl < lastvisplane ; pl++)
+    for (i = 0 ; i < numvisplanes ; i++)
     {
+	pl = visplanes[i];
+
 	if (pl->minx > pl->maxx)
 	    continue;
 
@@ -26,23 +26,28 @@
 
 
 // Visplane related.
-extern  short*		lastopening;
+// The limits of the original executable; more
+//  are allocated when these run out.
+#define MAXVISPLANES	128
+#define MAXOPENINGS	(SCREENWIDTH*64)
 
 
 typedef void (*planefunction_t) (int top, int bottom);
 
-extern planefunction_t	floorfunc;
+extern INSTANCE planefunction_t	floorfunc;
 extern planefunction_t	ceilingfunc_t;
 
-extern short		floorclip[SCREENWIDTH];
-extern short		ceilingclip[SCREENWIDTH];
+extern INSTANCE short		floorclip[SCREENWIDTH];
+extern INSTANCE short		ceilingclip[SCREENWIDTH];
 
-extern fixed_t		yslope[SCREENHEIGHT];
-extern fixed_t		distscale[SCREENWIDTH];
+extern INSTANCE fixed_t		yslope[SCREENHEIGHT];
+extern INSTANCE fixed_t		distscale[SCREENWIDTH];
 
 void R_InitPlanes (void);
 void R_ClearPlanes (void);
 
+short* R_NewOpenings (int count);
+
 void
 R_MapPlane
 ( int		y,
@@ -36,56 +36,56 @@
 // OPTIMIZE: closed two sided lines as single sided
 
 // True if any of the segs textures might be visible.
-boolean		segtextured;	
+INSTANCE boolean		segtextured;	
 
 // False if the back side is the same plane.
-boolean		markfloor;	
-boolean		markceiling;
+INSTANCE boolean		markfloor;	
+INSTANCE boolean		markceiling;
 
-boolean		maskedtexture;
-int		toptexture;
-int		bottomtexture;
-int		midtexture;
+INSTANCE boolean		maskedtexture;
+INSTANCE int		toptexture;
+INSTANCE int		bottomtexture;
+INSTANCE int		midtexture;
 
 
-angle_t		rw_normalangle;
+INSTANCE angle_t		rw_normalangle;
 // angle to line origin
-int		rw_angle1;	
+INSTANCE int		rw_angle1;	
 
 //
 // regular wall
 //
-int		rw_x;
-int		rw_stopx;
-angle_t		rw_centerangle;
-fixed_t		rw_offset;
-fixed_t		rw_distance;
-fixed_t		rw_scale;
-fixed_t		rw_scalestep;
-fixed_t		rw_midtexturemid;
-fixed_t		rw_toptexturemid;
-fixed_t		rw_bottomtexturemid;
+INSTANCE int		rw_x;
+INSTANCE int		rw_stopx;
+INSTANCE angle_t		rw_centerangle;
+INSTANCE fixed_t		rw_offset;
+INSTANCE fixed_t		rw_distance;
+INSTANCE fixed_t		rw_scale;
+INSTANCE fixed_t		rw_scalestep;
+INSTANCE fixed_t		rw_midtexturemid;
+INSTANCE fixed_t		rw_toptexturemid;
+INSTANCE fixed_t		rw_bottomtexturemid;
 
-int		worldtop;
-int		worldbottom;
-int		worldhigh;
-int		worldlow;
+INSTANCE int		worldtop;
+INSTANCE int		worldbottom;
+INSTANCE int		worldhigh;
+INSTANCE int		worldlow;
 
-fixed_t		pixhigh;
-fixed_t		pixlow;
-fixed_t		pixhighstep;
-fixed_t		pixlowstep;
+INSTANCE fixed_t		pixhigh;
+INSTANCE fixed_t		pixlow;
+INSTANCE fixed_t		pixhighstep;
+INSTANCE fixed_t		pixlowstep;
 
-fixed_t		topfrac;
-fixed_t		topstep;
+INSTANCE fixed_t		topfrac;
+INSTANCE fixed_t		topstep;
 
-fixed_t		bottomfrac;
-fixed_t		bottomstep;
+INSTANCE fixed_t		bottomfrac;
+INSTANCE fixed_t		bottomstep;
 
 
-lighttable_t**	walllights;
+INSTANCE lighttable_t**	walllights;
 
-short*		maskedtexturecol;
+INSTANCE short*		maskedtexturecol;
 
 
 
@@ -378,10 +378,11 @@ R_StoreWallRange
     angle_t		distangle, offsetangle;
     fixed_t		vtop;
     int			lightnum;
+    short*		clip;
 
-    // don't overflow and crash
-    if (ds_p == &drawsegs[MAXDRAWSEGS])
-	return;		
+    // make room for one more
+    if (ds_p == drawsegs + maxdrawsegs)
+	R_GrowDrawSegs ();
 		
 #ifdef RANGECHECK
     if (start >=viewwidth || start > stop)
@@ -605,8 +606,8 @@ R_StoreWallRange
 	{
 	    // masked midtexture
 	    maskedtexture = true;
-	    ds_p->maskedtexturecol = maskedtexturecol = lastopening - rw_x;
-	    lastopening += rw_stopx - rw_x;
+	    ds_p->maskedtexturecol = maskedtexturecol =
+		R_NewOpenings (rw_stopx - rw_x) - rw_x;
 	}
     }
     
@@ -715,17 +716,17 @@ R_StoreWallRange
     if ( ((ds_p->silhouette & SIL_TOP) || maskedtexture)
 	 && !ds_p->sprtopclip)
     {
-	memcpy (lastopening, ceilingclip+start, sizeof(*lastopening)*(rw_stopx-start));
-	ds_p->sprtopclip = lastopening - start;
-	lastopening += rw_stopx - start;
+	clip = R_NewOpenings (rw_stopx - start);
+	memcpy (clip, ceilingclip+start, sizeof(*clip)*(rw_stopx-start));
+	ds_p->sprtopclip = clip - start;
     }
     
     if ( ((ds_p->silhouette & SIL_BOTTOM) || maskedtexture)
 	 && !ds_p->sprbottomclip)
     {
-	memcpy (lastopening, floorclip+start, sizeof(*lastopening)*(rw_stopx-start));
-	ds_p->sprbottomclip = lastopening - start;
-	lastopening += rw_stopx - start;	
+	clip = R_NewOpenings (rw_stopx - start);
+	memcpy (clip, floorclip+start, sizeof(*clip)*(rw_stopx-start));
+	ds_p->sprbottomclip = clip - start;
     }
 
     if (maskedtexture && !(ds_p->silhouette&SIL_TOP))
@@ -34,9 +34,9 @@
 //
 // sky mapping
 //
-int			skyflatnum;
-int			skytexture;
-int			skytexturemid;
+INSTANCE int			skyflatnum;
+INSTANCE int			skytexture;
+INSTANCE int			skytexturemid;
 
 
 
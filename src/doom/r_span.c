@@ -0,0 +1,416 @@
+//
+// Copyright(C) 1993-1996 Id Software, Inc.
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	Inner loops for drawing floor and ceiling spans.
+//
+//	Each pixel of a span steps a packed u/v position on, takes
+//	the texel at that position in the 64x64 flat, and maps it
+//	through the colormap.  Working out the texel offsets does
+//	not depend on the texels, so they can be done several at a
+//	time; the two table lookups have to be done one by one.
+//	There is a portable version which works eight pixels at a
+//	time, and an SSE2 version which works out eight offsets with
+//	a few vector instructions.  The best one is chosen at startup.
+//
+//	-spancheck records the spans drawn in one frame of the game,
+//	then runs them through every kernel, checking that each one
+//	draws exactly the same pixels as the original loop and timing
+//	them.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SDL.h"
+
+#if defined(__SSE2__) || defined(_M_X64) \
+ || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HAVE_SSE2_KERNEL
+#endif
+
+#include "doomdef.h"
+#include "i_system.h"
+#include "i_timer.h"
+#include "m_argv.h"
+
+#include "r_local.h"
+#include "r_span.h"
+#include "r_threads.h"
+
+// Most spans recorded by -spancheck.
+
+#define SPAN_TRACE_LEN 16384
+
+// Most different flats in the recorded spans.
+
+#define SPAN_TRACE_FLATS 256
+
+#define FLAT_SIZE (64 * 64)
+
+// Times the recorded spans are drawn when timing a kernel.
+
+#define SPAN_TRACE_PASSES 50
+
+#define SPOT(position) \
+    ((((position) >> 4) & 0x0fc0) | ((position) >> 26))
+
+typedef struct
+{
+    const byte *source;
+    const lighttable_t *colormap;
+    unsigned int position;
+    unsigned int step;
+    int count;
+} spantrace_t;
+
+typedef struct
+{
+    const char *name;
+    spankernel_t kernel;
+} spankernel_info_t;
+
+INSTANCE spankernel_t r_spankernel;
+
+static INSTANCE spankernel_t selected_kernel;
+
+static INSTANCE spantrace_t *span_trace;
+static INSTANCE int span_trace_len;
+
+// The flats may be purged once drawn, so the trace keeps its own
+// copy of each one.
+
+static INSTANCE byte *trace_flats[SPAN_TRACE_FLATS];
+static INSTANCE const byte *trace_flat_sources[SPAN_TRACE_FLATS];
+static INSTANCE int num_trace_flats;
+
+static INSTANCE SDL_mutex *span_trace_lock;
+
+//
+// The original loop, from R_DrawSpan.
+//
+static void SpanKernelC(pixel_t *dest, const byte *source,
+                        const lighttable_t *colormap,
+                        unsigned int position, unsigned int step, int count)
+{
+    while (count-- > 0)
+    {
+        *dest++ = colormap[source[SPOT(position)]];
+        position += step;
+    }
+}
+
+//
+// Portable: the offsets for eight pixels, then the lookups.
+//
+static void SpanKernelBatched(pixel_t *dest, const byte *source,
+                              const lighttable_t *colormap,
+                              unsigned int position, unsigned int step,
+                              int count)
+{
+    unsigned int spot[8];
+    int i;
+
+    while (count >= 8)
+    {
+        for (i = 0; i < 8; ++i)
+        {
+            spot[i] = SPOT(position);
+            position += step;
+        }
+
+        for (i = 0; i < 8; ++i)
+        {
+            dest[i] = colormap[source[spot[i]]];
+        }
+
+        dest += 8;
+        count -= 8;
+    }
+
+    SpanKernelC(dest, source, colormap, position, step, count);
+}
+
+#ifdef HAVE_SSE2_KERNEL
+
+//
+// SSE2: the positions of eight pixels are kept in two vectors.  The
+// offsets are all below 4096, so they are packed down to 16 bits to
+// be read out.  SSE2 has no gather or byte shuffle, so the texel and
+// colormap lookups are still one at a time.
+//
+static void SpanKernelSSE2(pixel_t *dest, const byte *source,
+                           const lighttable_t *colormap,
+                           unsigned int position, unsigned int step,
+                           int count)
+{
+    __m128i pos0, pos1, step8, vmask;
+    __m128i spot0, spot1, spots;
+
+    if (count >= 8)
+    {
+        pos0 = _mm_set_epi32(position + 3 * step, position + 2 * step,
+                             position + step, position);
+        pos1 = _mm_add_epi32(pos0, _mm_set1_epi32(4 * step));
+        step8 = _mm_set1_epi32(8 * step);
+        vmask = _mm_set1_epi32(0x0fc0);
+
+        while (count >= 8)
+        {
+            spot0 = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(pos0, 4), vmask),
+                                 _mm_srli_epi32(pos0, 26));
+            spot1 = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(pos1, 4), vmask),
+                                 _mm_srli_epi32(pos1, 26));
+            spots = _mm_packs_epi32(spot0, spot1);
+
+            dest[0] = colormap[source[_mm_extract_epi16(spots, 0)]];
+            dest[1] = colormap[source[_mm_extract_epi16(spots, 1)]];
+            dest[2] = colormap[source[_mm_extract_epi16(spots, 2)]];
+            dest[3] = colormap[source[_mm_extract_epi16(spots, 3)]];
+            dest[4] = colormap[source[_mm_extract_epi16(spots, 4)]];
+            dest[5] = colormap[source[_mm_extract_epi16(spots, 5)]];
+            dest[6] = colormap[source[_mm_extract_epi16(spots, 6)]];
+            dest[7] = colormap[source[_mm_extract_epi16(spots, 7)]];
+
+            pos0 = _mm_add_epi32(pos0, step8);
+            pos1 = _mm_add_epi32(pos1, step8);
+            dest += 8;
+            count -= 8;
+        }
+
+        position = (unsigned int) _mm_cvtsi128_si32(pos0);
+    }
+
+    SpanKernelC(dest, source, colormap, position, step, count);
+}
+
+#endif
+
+static const spankernel_info_t span_kernels[] =
+{
+    { "c",       SpanKernelC },
+    { "batched", SpanKernelBatched },
+#ifdef HAVE_SSE2_KERNEL
+    { "sse2",    SpanKernelSSE2 },
+#endif
+};
+
+//
+// Finds the trace's copy of a flat, making one if needed.  A flat
+// may be released and another one cached at the same address
+// during the frame, so the contents are compared too.
+//
+static const byte *TraceFlat(const byte *source)
+{
+    int i;
+
+    for (i = 0; i < num_trace_flats; ++i)
+    {
+        if (trace_flat_sources[i] == source
+         && memcmp(trace_flats[i], source, FLAT_SIZE) == 0)
+        {
+            return trace_flats[i];
+        }
+    }
+
+    if (num_trace_flats == SPAN_TRACE_FLATS)
+    {
+        return NULL;
+    }
+
+    trace_flats[i] = malloc(FLAT_SIZE);
+
+    if (trace_flats[i] == NULL)
+    {
+        return NULL;
+    }
+
+    memcpy(trace_flats[i], source, FLAT_SIZE);
+    trace_flat_sources[i] = source;
+    ++num_trace_flats;
+
+    return trace_flats[i];
+}
+
+//
+// With -spancheck, spans are recorded on their way to the kernel.
+// Render threads may be drawing spans at the same time, so the
+// trace is locked while each one is added.  The colormaps are
+// never freed, so only the flat is copied.
+//
+static void SpanKernelRecord(pixel_t *dest, const byte *source,
+                             const lighttable_t *colormap,
+                             unsigned int position, unsigned int step,
+                             int count)
+{
+    spantrace_t *span;
+    const byte *flat;
+
+    SDL_LockMutex(span_trace_lock);
+
+    if (span_trace_len < SPAN_TRACE_LEN)
+    {
+        flat = TraceFlat(source);
+
+        if (flat != NULL)
+        {
+            span = &span_trace[span_trace_len++];
+            span->source = flat;
+            span->colormap = colormap;
+            span->position = position;
+            span->step = step;
+            span->count = count;
+        }
+    }
+
+    SDL_UnlockMutex(span_trace_lock);
+
+    selected_kernel(dest, source, colormap, position, step, count);
+}
+
+static void DrawTrace(spankernel_t kernel, pixel_t *buf)
+{
+    spantrace_t *span;
+    int i;
+
+    for (i = 0; i < span_trace_len; ++i)
+    {
+        span = &span_trace[i];
+        kernel(buf, span->source, span->colormap,
+               span->position, span->step, span->count);
+        buf += span->count;
+    }
+}
+
+void R_CheckSpans(void)
+{
+    const spankernel_info_t *info;
+    pixel_t *expected, *buf;
+    size_t pixels;
+    int i, pass, start, ms;
+
+    if (span_trace == NULL)
+    {
+        return;
+    }
+
+    // Wait for this frame's spans to be drawn.  Until a frame has
+    // drawn some, keep recording; otherwise stop, so that only the
+    // spans of this one frame are checked.
+
+    R_DropView();
+
+    if (span_trace_len == 0)
+    {
+        return;
+    }
+
+    r_spankernel = selected_kernel;
+
+    pixels = 0;
+
+    for (i = 0; i < span_trace_len; ++i)
+    {
+        pixels += span_trace[i].count;
+    }
+
+    expected = malloc(pixels * sizeof(*expected));
+    buf = malloc(pixels * sizeof(*buf));
+
+    if (expected == NULL || buf == NULL)
+    {
+        I_Error("R_CheckSpans: Failed to allocate %d pixels", (int) pixels);
+    }
+
+    DrawTrace(SpanKernelC, expected);
+
+    for (i = 0; i < arrlen(span_kernels); ++i)
+    {
+        info = &span_kernels[i];
+
+        memset(buf, 0, pixels * sizeof(*buf));
+        DrawTrace(info->kernel, buf);
+
+        if (memcmp(buf, expected, pixels * sizeof(*buf)) != 0)
+        {
+            I_Error("R_CheckSpans: The %s kernel does not match", info->name);
+        }
+
+        start = I_GetTimeMS();
+
+        for (pass = 0; pass < SPAN_TRACE_PASSES; ++pass)
+        {
+            DrawTrace(info->kernel, buf);
+        }
+
+        ms = I_GetTimeMS() - start;
+
+        printf("R_CheckSpans: %-8s %d spans, %d pixels, %d passes: %d ms%s\n",
+               info->name, span_trace_len, (int) pixels, SPAN_TRACE_PASSES,
+               ms, info->kernel == selected_kernel ? " (in use)" : "");
+    }
+
+    free(expected);
+    free(buf);
+    free(span_trace);
+    span_trace = NULL;
+
+    for (i = 0; i < num_trace_flats; ++i)
+    {
+        free(trace_flats[i]);
+    }
+
+    num_trace_flats = 0;
+    SDL_DestroyMutex(span_trace_lock);
+}
+
+void R_InitSpanKernel(void)
+{
+    selected_kernel = SpanKernelBatched;
+
+#ifdef HAVE_SSE2_KERNEL
+    if (SDL_HasSSE2())
+    {
+        selected_kernel = SpanKernelSSE2;
+    }
+#endif
+
+    r_spankernel = selected_kernel;
+
+    //!
+    // @category video
+    //
+    // Record the floor and ceiling spans drawn in the first frame
+    // of play, then check that every span drawing loop draws them
+    // identically, and print how long each one takes.
+    //
+
+    if (M_ParmExists("-spancheck"))
+    {
+        span_trace = malloc(SPAN_TRACE_LEN * sizeof(*span_trace));
+        span_trace_lock = SDL_CreateMutex();
+
+        if (span_trace == NULL || span_trace_lock == NULL)
+        {
+            I_Error("R_InitSpanKernel: Failed to allocate span trace");
+        }
+
+        span_trace_len = 0;
+        num_trace_flats = 0;
+        r_spankernel = SpanKernelRecord;
+    }
+}
+
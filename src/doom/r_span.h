@@ -0,0 +1,39 @@
+//
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	Inner loops for drawing floor and ceiling spans.
+//
+
+
+#ifndef __R_SPAN__
+#define __R_SPAN__
+
+// Draws count pixels of a span to dest.  position and step
+//  hold u and v packed as in R_DrawSpan.
+typedef void (*spankernel_t) (pixel_t *dest, const byte *source,
+			      const lighttable_t *colormap,
+			      unsigned int position, unsigned int step,
+			      int count);
+
+// The kernel used by R_DrawSpan, chosen for this CPU.
+extern INSTANCE spankernel_t	r_spankernel;
+
+void R_InitSpanKernel (void);
+
+// With -spancheck, called at the end of each frame: once a
+//  frame has drawn spans, checks and times every kernel
+//  against them.
+void R_CheckSpans (void);
+
+#endif
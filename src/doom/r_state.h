@@ -35,93 +35,93 @@
 //
 
 // needed for texture pegging
-extern fixed_t*		textureheight;
+extern INSTANCE fixed_t*		textureheight;
 
 // needed for pre rendering (fracs)
-extern fixed_t*		spritewidth;
+extern INSTANCE fixed_t*		spritewidth;
 
-extern fixed_t*		spriteoffset;
-extern fixed_t*		spritetopoffset;
+extern INSTANCE fixed_t*		spriteoffset;
+extern INSTANCE fixed_t*		spritetopoffset;
 
-extern lighttable_t*	colormaps;
+extern INSTANCE lighttable_t*	colormaps;
 
-extern int		viewwidth;
-extern int		scaledviewwidth;
-extern int		viewheight;
+extern INSTANCE int		viewwidth;
+extern INSTANCE int		scaledviewwidth;
+extern INSTANCE int		viewheight;
 
-extern int		firstflat;
+extern INSTANCE int		firstflat;
 
 // for global animation
-extern int*		flattranslation;	
-extern int*		texturetranslation;	
+extern INSTANCE int*		flattranslation;	
+extern INSTANCE int*		texturetranslation;	
 
 
 // Sprite....
-extern int		firstspritelump;
-extern int		lastspritelump;
-extern int		numspritelumps;
+extern INSTANCE int		firstspritelump;
+extern INSTANCE int		lastspritelump;
+extern INSTANCE int		numspritelumps;
 
 
 
 //
 // Lookup tables for map data.
 //
-extern int		numsprites;
-extern spritedef_t*	sprites;
+extern INSTANCE int		numsprites;
+extern INSTANCE spritedef_t*	sprites;
 
-extern int		numvertexes;
-extern vertex_t*	vertexes;
+extern INSTANCE int		numvertexes;
+extern INSTANCE vertex_t*	vertexes;
 
-extern int		numsegs;
-extern seg_t*		segs;
+extern INSTANCE int		numsegs;
+extern INSTANCE seg_t*		segs;
 
-extern int		numsectors;
-extern sector_t*	sectors;
+extern INSTANCE int		numsectors;
+extern INSTANCE sector_t*	sectors;
 
-extern int		numsubsectors;
-extern subsector_t*	subsectors;
+extern INSTANCE int		numsubsectors;
+extern INSTANCE subsector_t*	subsectors;
 
-extern int		numnodes;
-extern node_t*		nodes;
+extern INSTANCE int		numnodes;
+extern INSTANCE node_t*		nodes;
 
-extern int		numlines;
-extern line_t*		lines;
+extern INSTANCE int		numlines;
+extern INSTANCE line_t*		lines;
 
-extern int		numsides;
-extern side_t*		sides;
+extern INSTANCE int		numsides;
+extern INSTANCE side_t*		sides;
 
 
 //
 // POV data.
 //
-extern fixed_t		viewx;
-extern fixed_t		viewy;
-extern fixed_t		viewz;
+extern INSTANCE fixed_t		viewx;
+extern INSTANCE fixed_t		viewy;
+extern INSTANCE fixed_t		viewz;
 
-extern angle_t		viewangle;
-extern player_t*	viewplayer;
+extern INSTANCE angle_t		viewangle;
+extern INSTANCE player_t*	viewplayer;
 
 
 // ?
-extern angle_t		clipangle;
+extern INSTANCE angle_t		clipangle;
 
-extern int		viewangletox[FINEANGLES/2];
-extern angle_t		xtoviewangle[SCREENWIDTH+1];
+extern INSTANCE int		viewangletox[FINEANGLES/2];
+extern INSTANCE angle_t		xtoviewangle[SCREENWIDTH+1];
 //extern fixed_t		finetangent[FINEANGLES/2];
 
-extern fixed_t		rw_distance;
-extern angle_t		rw_normalangle;
+extern INSTANCE fixed_t		rw_distance;
+extern INSTANCE angle_t		rw_normalangle;
 
 
 
 // angle to line origin
-extern int		rw_angle1;
+extern INSTANCE int		rw_angle1;
 
 // Segs count?
-extern int		sscount;
+extern INSTANCE int		sscount;
 
-extern visplane_t*	floorplane;
-extern visplane_t*	ceilingplane;
+extern INSTANCE visplane_t*	floorplane;
+extern INSTANCE visplane_t*	ceilingplane;
 
 
 #endif
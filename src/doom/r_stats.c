@@ -0,0 +1,149 @@
+//
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	Counts of the lists built while rendering each frame.
+//
+//	The visplane, drawseg, vissprite and opening lists grow as
+//	needed, so a scene which overflowed them in the original
+//	executable is drawn here without complaint.  Each frame the
+//	renderer reports how much of each list it used, and the
+//	largest counts are kept for the level.  With -renderstats,
+//	they are printed at the end of each level against the limits
+//	of the original executable, along with where the view was
+//	when a limit was first passed, so that map authors can see
+//	how close they are to them.
+//
+
+#include <stdio.h>
+
+#include "doomdef.h"
+#include "doomstat.h"
+#include "i_system.h"
+#include "m_argv.h"
+#include "m_misc.h"
+
+#include "r_local.h"
+#include "r_state.h"
+#include "r_stats.h"
+
+// Entries in the solidsegs list of the original executable.
+
+#define VANILLA_SOLIDSEGS 32
+
+typedef struct
+{
+    const char *name;
+    int vanilla;
+    int peak;
+    boolean passed;
+} renderstat_t;
+
+INSTANCE boolean r_renderstats;
+
+static INSTANCE renderstat_t renderstats[NUMRENDERLISTS] =
+{
+    { "visplanes",  MAXVISPLANES },
+    { "drawsegs",   MAXDRAWSEGS },
+    { "vissprites", MAXVISSPRITES },
+    { "solidsegs",  VANILLA_SOLIDSEGS },
+    { "openings",   MAXOPENINGS },
+};
+
+// Level the counts are for.
+
+static INSTANCE char levelname[9];
+
+void R_CountRenderList(renderlist_t list, int count)
+{
+    renderstat_t *stat = &renderstats[list];
+
+    if (count <= stat->peak)
+    {
+        return;
+    }
+
+    stat->peak = count;
+
+    if (r_renderstats && count > stat->vanilla && !stat->passed)
+    {
+        stat->passed = true;
+        printf("R_CountRenderList: %s: %s limit of %d passed "
+               "at (%d, %d)\n", levelname, stat->name, stat->vanilla,
+               viewx >> FRACBITS, viewy >> FRACBITS);
+    }
+}
+
+static void PrintRenderStats(void)
+{
+    renderstat_t *stat;
+    int i;
+
+    if (!r_renderstats || levelname[0] == '\0')
+    {
+        return;
+    }
+
+    printf("R_RenderStats: %s:\n", levelname);
+
+    for (i = 0; i < NUMRENDERLISTS; ++i)
+    {
+        stat = &renderstats[i];
+        printf("    %-10s %6d of %6d (%3d%%)%s\n",
+               stat->name, stat->peak, stat->vanilla,
+               stat->peak * 100 / stat->vanilla,
+               stat->passed ? "  over the limit" : "");
+    }
+}
+
+void R_ClearRenderStats(void)
+{
+    int i;
+
+    PrintRenderStats();
+
+    for (i = 0; i < NUMRENDERLISTS; ++i)
+    {
+        renderstats[i].peak = 0;
+        renderstats[i].passed = false;
+    }
+
+    if (gamemode == commercial)
+    {
+        M_snprintf(levelname, sizeof(levelname), "MAP%02d", gamemap);
+    }
+    else
+    {
+        M_snprintf(levelname, sizeof(levelname), "E%dM%d",
+                   gameepisode, gamemap);
+    }
+}
+
+void R_InitRenderStats(void)
+{
+    //!
+    // @category video
+    //
+    // Print the most visplanes, drawsegs, sprites, solid segs and
+    // clipping openings used in any one frame of each level,
+    // compared with the limits of the original executable.
+    //
+
+    r_renderstats = M_ParmExists("-renderstats");
+
+    if (r_renderstats)
+    {
+        I_AtExit(PrintRenderStats, true);
+    }
+}
+
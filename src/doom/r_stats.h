@@ -0,0 +1,46 @@
+//
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	Counts of the lists built while rendering each frame,
+//	compared with the fixed limits of the original executable.
+//
+
+
+#ifndef __R_STATS__
+#define __R_STATS__
+
+typedef enum
+{
+    rl_visplanes,
+    rl_drawsegs,
+    rl_vissprites,
+    rl_solidsegs,
+    rl_openings,
+    NUMRENDERLISTS
+} renderlist_t;
+
+// Prints the largest counts with -renderstats.
+extern INSTANCE boolean	r_renderstats;
+
+void R_InitRenderStats (void);
+
+// Called as a list is filled in each frame, with the
+//  number of entries used.
+void R_CountRenderList (renderlist_t list, int count);
+
+// At the start of each level: reports the level before
+//  and starts counting again.
+void R_ClearRenderStats (void);
+
+#endif
@@ -32,6 +32,7 @@
 #include "w_wad.h"
 
 #include "r_local.h"
+#include "r_stats.h"
 
 #include "doomstat.h"
 
@@ -65,15 +66,15 @@ typedef struct
 //  which increases counter clockwise (protractor).
 // There was a lot of stuff grabbed wrong, so I changed it...
 //
-fixed_t		pspritescale;
-fixed_t		pspriteiscale;
+INSTANCE fixed_t		pspritescale;
+INSTANCE fixed_t		pspriteiscale;
 
-lighttable_t**	spritelights;
+INSTANCE lighttable_t**	spritelights;
 
 // constant arrays
 //  used for psprite clipping and initializing clipping
-short		negonearray[SCREENWIDTH];
-short		screenheightarray[SCREENWIDTH];
+INSTANCE short		negonearray[SCREENWIDTH];
+INSTANCE short		screenheightarray[SCREENWIDTH];
 
 
 //
@@ -82,12 +83,12 @@ short		screenheightarray[SCREENWIDTH];
 
 // variables used to look up
 //  and range check thing_t sprites patches
-spritedef_t*	sprites;
-int		numsprites;
+INSTANCE spritedef_t*	sprites;
+INSTANCE int		numsprites;
 
-spriteframe_t	sprtemp[29];
-int		maxframe;
-const char	*spritename;
+INSTANCE spriteframe_t	sprtemp[29];
+INSTANCE int		maxframe;
+INSTANCE const char	*spritename;
 
 
 
@@ -278,9 +279,12 @@ void R_InitSpriteDefs(const char **namelist)
 //
 // GAME FUNCTIONS
 //
-vissprite_t	vissprites[MAXVISSPRITES];
-vissprite_t*	vissprite_p;
-int		newvissprite;
+// No longer limited to MAXVISSPRITES; the array is
+//  doubled whenever a frame fills it.
+INSTANCE vissprite_t*	vissprites;
+INSTANCE vissprite_t*	vissprite_p;
+static INSTANCE int	maxvissprites;
+INSTANCE int		newvissprite;
 
 
 
@@ -302,12 +306,30 @@ void R_InitSprites(const char **namelist)
 
 
 
+//
+// R_GrowVisSprites
+// Doubles the number of vissprites, keeping those in use.
+//
+static void R_GrowVisSprites (void)
+{
+    int		used;
+
+    used = vissprite_p - vissprites;
+    maxvissprites = maxvissprites ? maxvissprites * 2 : MAXVISSPRITES;
+    vissprites = I_Realloc (vissprites, maxvissprites * sizeof(*vissprites));
+    vissprite_p = vissprites + used;
+}
+
+
 //
 // R_ClearSprites
 // Called at frame start.
 //
 void R_ClearSprites (void)
 {
+    if (vissprites == NULL)
+	R_GrowVisSprites ();
+
     vissprite_p = vissprites;
 }
 
@@ -315,12 +337,10 @@ void R_ClearSprites (void)
 //
 // R_NewVisSprite
 //
-vissprite_t	overflowsprite;
-
 vissprite_t* R_NewVisSprite (void)
 {
-    if (vissprite_p == &vissprites[MAXVISSPRITES])
-	return &overflowsprite;
+    if (vissprite_p == vissprites + maxvissprites)
+	R_GrowVisSprites ();
     
     vissprite_p++;
     return vissprite_p-1;
@@ -334,11 +354,11 @@ vissprite_t* R_NewVisSprite (void)
 // Masked means: partly transparent, i.e. stored
 //  in posts/runs of opaque pixels.
 //
-short*		mfloorclip;
-short*		mceilingclip;
+INSTANCE short*		mfloorclip;
+INSTANCE short*		mceilingclip;
 
-fixed_t		spryscale;
-fixed_t		sprtopscreen;
+INSTANCE fixed_t		spryscale;
+INSTANCE fixed_t		sprtopscreen;
 
 void R_DrawMaskedColumn (column_t* column)
 {
@@ -773,7 +793,7 @@ void R_DrawPlayerSprites (void)
 //
 // R_SortVisSprites
 //
-vissprite_t	vsprsortedhead;
+INSTANCE vissprite_t	vsprsortedhead;
 
 
 void R_SortVisSprites (void)
@@ -955,6 +975,9 @@ void R_DrawMasked (void)
 	
     R_SortVisSprites ();
 
+    R_CountRenderList (rl_vissprites, vissprite_p - vissprites);
+    R_CountRenderList (rl_drawsegs, ds_p - drawsegs);
+
     if (vissprite_p > vissprites)
     {
 	// draw all vissprites back to front
@@ -22,25 +22,26 @@
 
 
 
+// As many as the original had room for.
 #define MAXVISSPRITES  	128
 
-extern vissprite_t	vissprites[MAXVISSPRITES];
-extern vissprite_t*	vissprite_p;
-extern vissprite_t	vsprsortedhead;
+extern INSTANCE vissprite_t*	vissprites;
+extern INSTANCE vissprite_t*	vissprite_p;
+extern INSTANCE vissprite_t	vsprsortedhead;
 
 // Constant arrays used for psprite clipping
 //  and initializing clipping.
-extern short		negonearray[SCREENWIDTH];
-extern short		screenheightarray[SCREENWIDTH];
+extern INSTANCE short		negonearray[SCREENWIDTH];
+extern INSTANCE short		screenheightarray[SCREENWIDTH];
 
 // vars for R_DrawMaskedColumn
-extern short*		mfloorclip;
-extern short*		mceilingclip;
-extern fixed_t		spryscale;
-extern fixed_t		sprtopscreen;
+extern INSTANCE short*		mfloorclip;
+extern INSTANCE short*		mceilingclip;
+extern INSTANCE fixed_t		spryscale;
+extern INSTANCE fixed_t		sprtopscreen;
 
-extern fixed_t		pspritescale;
-extern fixed_t		pspriteiscale;
+extern INSTANCE fixed_t		pspritescale;
+extern INSTANCE fixed_t		pspriteiscale;
 
 
 void R_DrawMaskedColumn (column_t* column);
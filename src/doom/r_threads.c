@@ -0,0 +1,634 @@
+//
+// Copyright(C) 1993-1996 Id Software, Inc.
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	Drawing the 3D view with several threads, each one
+//	filling in a vertical slice of the screen.
+//
+//	The BSP walk, clipping, visplanes and sprite sorting still
+//	run once, on the main thread, exactly as they do without
+//	threads.  They cannot be split by screen column without
+//	changing the picture: where a wall or a span starts affects
+//	how its texture steps across the screen.  Instead, every call
+//	to a column or span drawer is queued, and each thread draws
+//	the queue clipped to its own range of columns.  Within a
+//	column the draws happen in the same order as before, and a
+//	span clipped on the left is stepped on to its new start with
+//	R_SkipSpan, so the result is the same pixel for pixel.
+//
+//	Worker threads start drawing while the main thread is still
+//	walking the BSP; the main thread draws its own slice once the
+//	whole view has been queued.
+//
+//	With -pipeline, the main thread draws nothing itself.  Once a
+//	view has been queued it is left to the workers, and the game
+//	goes on to run the next tics while it is drawn; the view is
+//	put on the screen on the following frame.  The queue holds
+//	everything the drawers need by value, so it is a snapshot of
+//	the view that the game can safely change underneath.  There
+//	are two queues, so that the next view can be queued while the
+//	last one is still being drawn.
+//
+
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#include "doomdef.h"
+#include "i_system.h"
+#include "m_argv.h"
+#include "m_misc.h"
+#include "z_zone.h"
+
+#include "r_local.h"
+#include "r_threads.h"
+
+// Number of draws to queue before waking the workers.
+
+#define DRAW_BATCH 64
+
+// Draws that can be queued at once.  A full queue is flushed.
+
+#define MAX_DRAWS 16384
+
+// Slices start on a multiple of this many columns, so that
+// fewer cache lines are written to by two threads.
+
+#define SLICE_ALIGN 16
+
+typedef struct
+{
+    void (*func)(void);
+    boolean span;
+
+    // Columns covered.  A column draw covers just one.
+
+    int x1, x2;
+    lighttable_t *colormap;
+    byte *source;
+
+    // Columns:
+
+    int yl, yh;
+    fixed_t iscale;
+    fixed_t texturemid;
+    byte *translation;
+    int fuzzpos;
+
+    // Spans:
+
+    int y;
+    fixed_t xfrac, yfrac;
+    fixed_t xstep, ystep;
+} drawcmd_t;
+
+typedef struct
+{
+    // Not used for thread 0 unless pipelined.
+
+    SDL_Thread *thread;
+    SDL_sem *wake;
+
+    // Range of view columns drawn by this thread.
+
+    int x1, x2;
+
+    // Next queued draw to do, and whether everything in the
+    // current queue has been done.  Workers reset these
+    // themselves when they see that a new queue has started.
+
+    int round;
+    int next;
+    boolean idle;
+} render_thread_t;
+
+INSTANCE int r_numthreads = 1;
+INSTANCE boolean r_pipeline = false;
+
+// Thread 0 is the main thread, unless pipelined; the others are
+// workers.
+
+static INSTANCE render_thread_t threads[MAXRENDERTHREADS];
+static INSTANCE int first_worker;
+
+// Draws are queued in one queue and drawn from another.  They are
+// the same queue unless pipelined.
+
+static INSTANCE drawcmd_t *draws[2];
+static INSTANCE drawcmd_t *replay_draws;
+static INSTANCE int record_queue;
+static INSTANCE int num_draws;
+
+// Main thread only: whether the workers have been started on a
+// queue that has not been waited for yet.
+
+static INSTANCE boolean draws_running;
+
+// Pipelined: whether a view that has not been shown yet has been
+// drawn or is being drawn, and whether the view was drawn last
+// frame.
+
+static INSTANCE boolean view_pending;
+static INSTANCE boolean view_primed;
+
+static INSTANCE SDL_atomic_t draws_published;
+static INSTANCE SDL_atomic_t draws_finished;
+static INSTANCE SDL_atomic_t draws_round;
+static INSTANCE SDL_atomic_t threads_quit;
+static INSTANCE SDL_sem *threads_done;
+
+// The drawers chosen by R_ExecuteSetViewSize, which the queue
+// functions stand in for.
+
+static INSTANCE void (*drawcolumn)(void);
+static INSTANCE void (*drawfuzzcolumn)(void);
+static INSTANCE void (*drawtranscolumn)(void);
+static INSTANCE void (*drawspan)(void);
+
+static void RunDraws(render_thread_t *thread, int end)
+{
+    drawcmd_t *cmd;
+
+    for (; thread->next < end; ++thread->next)
+    {
+        cmd = &replay_draws[thread->next];
+
+        if (cmd->x2 < thread->x1 || cmd->x1 >= thread->x2)
+        {
+            continue;
+        }
+
+        if (cmd->span)
+        {
+            ds_y = cmd->y;
+            ds_x1 = cmd->x1;
+            ds_x2 = cmd->x2;
+            ds_colormap = cmd->colormap;
+            ds_source = cmd->source;
+            ds_xfrac = cmd->xfrac;
+            ds_yfrac = cmd->yfrac;
+            ds_xstep = cmd->xstep;
+            ds_ystep = cmd->ystep;
+
+            if (ds_x1 < thread->x1)
+            {
+                R_SkipSpan(thread->x1 - ds_x1);
+            }
+
+            if (ds_x2 >= thread->x2)
+            {
+                ds_x2 = thread->x2 - 1;
+            }
+        }
+        else
+        {
+            dc_x = cmd->x1;
+            dc_yl = cmd->yl;
+            dc_yh = cmd->yh;
+            dc_colormap = cmd->colormap;
+            dc_source = cmd->source;
+            dc_iscale = cmd->iscale;
+            dc_texturemid = cmd->texturemid;
+            dc_translation = cmd->translation;
+            fuzzpos = cmd->fuzzpos;
+        }
+
+        cmd->func();
+    }
+}
+
+static int RenderThread(void *arg)
+{
+    render_thread_t *thread = arg;
+    int round;
+    int finished;
+
+    for (;;)
+    {
+        SDL_SemWait(thread->wake);
+
+        if (SDL_AtomicGet(&threads_quit))
+        {
+            break;
+        }
+
+        round = SDL_AtomicGet(&draws_round);
+
+        if (round != thread->round)
+        {
+            thread->round = round;
+            thread->next = 0;
+            thread->idle = false;
+        }
+
+        // Woken again after finishing: nothing new yet.
+
+        if (thread->idle)
+        {
+            continue;
+        }
+
+        // Read the finished flag first: once it is set, no more
+        // draws will be published.
+
+        finished = SDL_AtomicGet(&draws_finished);
+        RunDraws(thread, SDL_AtomicGet(&draws_published));
+
+        if (finished)
+        {
+            thread->idle = true;
+            SDL_SemPost(threads_done);
+        }
+    }
+
+    return 0;
+}
+
+static void WakeThreads(void)
+{
+    int i;
+
+    for (i = first_worker; i < r_numthreads; ++i)
+    {
+        SDL_SemPost(threads[i].wake);
+    }
+}
+
+// Set the workers going on the whole of a queue.
+
+static void StartDraws(drawcmd_t *queue, int count)
+{
+    replay_draws = queue;
+    SDL_AtomicSet(&draws_published, count);
+    SDL_AtomicSet(&draws_finished, 1);
+    draws_running = true;
+    WakeThreads();
+}
+
+static void WaitDraws(void)
+{
+    int i;
+
+    if (!draws_running)
+    {
+        return;
+    }
+
+    for (i = first_worker; i < r_numthreads; ++i)
+    {
+        SDL_SemWait(threads_done);
+    }
+
+    // Every worker is done, so the queue can start again.  The
+    // round is moved on last, so a worker that sees the new round
+    // also sees the queue empty.
+
+    if (first_worker > 0)
+    {
+        threads[0].next = 0;
+    }
+
+    SDL_AtomicSet(&draws_published, 0);
+    SDL_AtomicSet(&draws_finished, 0);
+    SDL_AtomicAdd(&draws_round, 1);
+    draws_running = false;
+}
+
+// Pipelined: hand the queue to the workers and start another.
+
+static void KickView(void)
+{
+    StartDraws(draws[record_queue], num_draws);
+    record_queue ^= 1;
+    num_draws = 0;
+}
+
+// Draw everything queued so far before going on.  This is also
+// called by the zone before it throws out any cached texture that
+// a queued draw could still be reading.
+
+static void FlushDraws(void)
+{
+    if (r_pipeline)
+    {
+        WaitDraws();
+
+        if (num_draws == 0)
+        {
+            return;
+        }
+
+        // The view buffer is about to be drawn to, so the last view
+        // has to go to the screen now.  The rest of the screen is
+        // drawn on top of it later this frame, as usual.
+
+        if (view_pending)
+        {
+            R_CopyView();
+            view_pending = false;
+        }
+
+        KickView();
+        WaitDraws();
+    }
+    else if (num_draws > 0)
+    {
+        StartDraws(draws[0], num_draws);
+        RunDraws(&threads[0], num_draws);
+        WaitDraws();
+        num_draws = 0;
+    }
+}
+
+void R_FinishView(void)
+{
+    if (!r_pipeline)
+    {
+        FlushDraws();
+        R_CopyView();
+        return;
+    }
+
+    // Show the last view, and start drawing this one.
+
+    WaitDraws();
+
+    if (view_pending)
+    {
+        R_CopyView();
+    }
+
+    KickView();
+    view_pending = true;
+
+    // If no view was drawn last frame, there is nothing to show
+    // yet, so wait for this one.  What is on the screen is then
+    // right for next frame, too.
+
+    if (!view_primed)
+    {
+        WaitDraws();
+        R_CopyView();
+        view_pending = false;
+        view_primed = true;
+    }
+}
+
+void R_DropView(void)
+{
+    WaitDraws();
+    view_pending = false;
+    view_primed = false;
+}
+
+static drawcmd_t *QueueDraw(void (*func)(void))
+{
+    drawcmd_t *cmd;
+
+    if (num_draws == MAX_DRAWS)
+    {
+        FlushDraws();
+    }
+
+    cmd = &draws[record_queue][num_draws];
+    cmd->func = func;
+
+    return cmd;
+}
+
+static void PublishDraw(void)
+{
+    ++num_draws;
+
+    // When pipelined, the workers are busy with the other queue.
+
+    if (!r_pipeline && (num_draws % DRAW_BATCH) == 0)
+    {
+        SDL_AtomicSet(&draws_published, num_draws);
+        WakeThreads();
+    }
+}
+
+static void QueueColumn(void (*func)(void))
+{
+    drawcmd_t *cmd;
+
+    cmd = QueueDraw(func);
+    cmd->span = false;
+    cmd->x1 = dc_x;
+    cmd->x2 = dc_x;
+    cmd->yl = dc_yl;
+    cmd->yh = dc_yh;
+    cmd->colormap = dc_colormap;
+    cmd->source = dc_source;
+    cmd->iscale = dc_iscale;
+    cmd->texturemid = dc_texturemid;
+    cmd->translation = dc_translation;
+    cmd->fuzzpos = fuzzpos;
+    PublishDraw();
+}
+
+static void QueueBaseColumn(void)
+{
+    QueueColumn(drawcolumn);
+}
+
+static void QueueTranslatedColumn(void)
+{
+    QueueColumn(drawtranscolumn);
+}
+
+// The fuzz effect carries on through the table from one column
+// to the next, so move the position on as if it had been drawn.
+
+static void QueueFuzzColumn(void)
+{
+    QueueColumn(drawfuzzcolumn);
+    R_SkipFuzzColumn();
+}
+
+static void QueueSpan(void)
+{
+    drawcmd_t *cmd;
+
+    cmd = QueueDraw(drawspan);
+    cmd->span = true;
+    cmd->x1 = ds_x1;
+    cmd->x2 = ds_x2;
+    cmd->y = ds_y;
+    cmd->colormap = ds_colormap;
+    cmd->source = ds_source;
+    cmd->xfrac = ds_xfrac;
+    cmd->yfrac = ds_yfrac;
+    cmd->xstep = ds_xstep;
+    cmd->ystep = ds_ystep;
+    PublishDraw();
+}
+
+void R_SetRenderSlices(void)
+{
+    int i;
+
+    if (r_numthreads < 2 && !r_pipeline)
+    {
+        return;
+    }
+
+    // A view drawn at the old size cannot be shown.
+
+    R_DropView();
+
+    drawcolumn = basecolfunc;
+    drawfuzzcolumn = fuzzcolfunc;
+    drawtranscolumn = transcolfunc;
+    drawspan = spanfunc;
+
+    colfunc = basecolfunc = QueueBaseColumn;
+    fuzzcolfunc = QueueFuzzColumn;
+    transcolfunc = QueueTranslatedColumn;
+    spanfunc = QueueSpan;
+
+    for (i = 0; i < r_numthreads; ++i)
+    {
+        threads[i].x1 = (i * viewwidth / r_numthreads) & ~(SLICE_ALIGN - 1);
+    }
+
+    for (i = 0; i < r_numthreads - 1; ++i)
+    {
+        threads[i].x2 = threads[i + 1].x1;
+    }
+
+    threads[r_numthreads - 1].x2 = viewwidth;
+}
+
+static void R_ShutdownRenderThreads(void)
+{
+    int i;
+
+    WaitDraws();
+
+    SDL_AtomicSet(&threads_quit, 1);
+
+    for (i = first_worker; i < r_numthreads; ++i)
+    {
+        SDL_SemPost(threads[i].wake);
+        SDL_WaitThread(threads[i].thread, NULL);
+    }
+}
+
+void R_InitRenderThreads(void)
+{
+    char name[16];
+    int i, p;
+
+#ifdef SERVER
+    // Headless: the view is never drawn, and render thread state is not
+    // kept per match (see INSTANCE in doomtype.h).
+
+    return;
+#endif
+
+    //!
+    // @category video
+    // @arg <n>
+    //
+    // Draw the 3D view with n threads, each drawing a vertical
+    // slice of the screen.  The default is 1.
+    //
+
+    p = M_CheckParmWithArgs("-renderthreads", 1);
+
+    if (p > 0)
+    {
+        r_numthreads = atoi(myargv[p + 1]);
+
+        if (r_numthreads < 1 || r_numthreads > MAXRENDERTHREADS)
+        {
+            I_Error("R_InitRenderThreads: -renderthreads must be between "
+                    "1 and %d", MAXRENDERTHREADS);
+        }
+    }
+
+    //!
+    // @category video
+    //
+    // Draw the 3D view in the background while the game runs the
+    // next tics, and show it one frame later.  The view is drawn
+    // by the threads given with -renderthreads.
+    //
+
+    r_pipeline = M_ParmExists("-pipeline");
+
+    if (r_numthreads == 1 && !r_pipeline)
+    {
+        return;
+    }
+
+    first_worker = r_pipeline ? 0 : 1;
+
+    draws[0] = Z_Malloc(MAX_DRAWS * sizeof(**draws), PU_STATIC, NULL);
+
+    if (r_pipeline)
+    {
+        draws[1] = Z_Malloc(MAX_DRAWS * sizeof(**draws), PU_STATIC, NULL);
+    }
+    else
+    {
+        draws[1] = draws[0];
+    }
+
+    replay_draws = draws[0];
+    record_queue = 0;
+    num_draws = 0;
+    draws_running = false;
+    view_pending = false;
+    view_primed = false;
+
+    SDL_AtomicSet(&draws_published, 0);
+    SDL_AtomicSet(&draws_finished, 0);
+    SDL_AtomicSet(&draws_round, 0);
+    SDL_AtomicSet(&threads_quit, 0);
+
+    threads_done = SDL_CreateSemaphore(0);
+
+    if (threads_done == NULL)
+    {
+        I_Error("R_InitRenderThreads: %s", SDL_GetError());
+    }
+
+    for (i = first_worker; i < r_numthreads; ++i)
+    {
+        threads[i].round = 0;
+        threads[i].next = 0;
+        threads[i].idle = false;
+        threads[i].wake = SDL_CreateSemaphore(0);
+
+        M_snprintf(name, sizeof(name), "render%d", i);
+        threads[i].thread = SDL_CreateThread(RenderThread, name, &threads[i]);
+
+        if (threads[i].wake == NULL || threads[i].thread == NULL)
+        {
+            I_Error("R_InitRenderThreads: Failed to start thread: %s",
+                    SDL_GetError());
+        }
+    }
+
+    // Anything drawn must be finished before the zone can throw
+    // out the textures it was drawn from.
+
+    Z_SetPurgeHook(FlushDraws);
+
+    I_AtExit(R_ShutdownRenderThreads, false);
+}
+
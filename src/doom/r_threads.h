@@ -0,0 +1,47 @@
+//
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	Drawing the 3D view with several threads, each one
+//	filling in a vertical slice of the screen.
+//
+
+
+#ifndef __R_THREADS__
+#define __R_THREADS__
+
+// Most threads that can be used to draw the view.
+#define MAXRENDERTHREADS	16
+
+// Number of threads drawing the view; 1 draws it directly.
+extern INSTANCE int	r_numthreads;
+
+// Draw the view in the background, and show it a frame later.
+extern INSTANCE boolean	r_pipeline;
+
+void R_InitRenderThreads (void);
+
+// Called when the view size or detail changes, once the
+//  drawers have been chosen.
+void R_SetRenderSlices (void);
+
+// Called once the view has been queued: puts the view
+//  on the screen.  When pipelined, this is the view from
+//  the frame before, and this one is left drawing.
+void R_FinishView (void);
+
+// Forgets any view still to be shown, for frames where
+//  the view is not drawn.
+void R_DropView (void);
+
+#endif
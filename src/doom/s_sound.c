@@ -78,32 +78,32 @@ typedef struct
 
 // The set of channels available
 
-static channel_t *channels;
+static INSTANCE channel_t *channels;
 
 // Maximum volume of a sound effect.
 // Internal default is max out of 0-15.
 
-int sfxVolume = 8;
+INSTANCE int sfxVolume = 8;
 
 // Maximum volume of music.
 
-int musicVolume = 8;
+INSTANCE int musicVolume = 8;
 
 // Internal volume level, ranging from 0-127
 
-static int snd_SfxVolume;
+static INSTANCE int snd_SfxVolume;
 
 // Whether songs are mus_paused
 
-static boolean mus_paused;
+static INSTANCE boolean mus_paused;
 
 // Music currently being played
 
-static musicinfo_t *mus_playing = NULL;
+static INSTANCE musicinfo_t *mus_playing = NULL;
 
 // Number of channels to use
 
-int snd_channels = 8;
+INSTANCE int snd_channels = 8;
 
 //
 // Initializes sound stuff, including volume
@@ -133,6 +133,10 @@ void S_Init(int sfxVolume, int musicVolume)
     }
 #endif
 
+    // The chaingun plays the pistol sound (see SOUND_LINK in sounds.c).
+
+    S_sfx[sfx_chgun].link = &S_sfx[sfx_pistol];
+
     I_PrecacheSounds(S_sfx, NUMSFX);
 
     S_SetSfxVolume(sfxVolume);
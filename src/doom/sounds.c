@@ -31,7 +31,7 @@
 #define MUSIC(name) \
     { name, 0, NULL, NULL }
 
-musicinfo_t S_music[] =
+INSTANCE musicinfo_t S_music[] =
 {
     MUSIC(NULL),
     MUSIC("e1m1"),
@@ -110,10 +110,12 @@ musicinfo_t S_music[] =
 
 #define SOUND(name, priority) \
   { NULL, name, priority, NULL, -1, -1, 0, 0, -1, NULL }
-#define SOUND_LINK(name, priority, link_id, pitch, volume) \
-  { NULL, name, priority, &S_sfx[link_id], pitch, volume, 0, 0, -1, NULL }
+// The link itself is set up by S_Init, since each match in the server
+// build has its own copy of this table (see INSTANCE in doomtype.h).
+#define SOUND_LINK(name, priority, pitch, volume) \
+  { NULL, name, priority, NULL, pitch, volume, 0, 0, -1, NULL }
 
-sfxinfo_t S_sfx[] =
+INSTANCE sfxinfo_t S_sfx[] =
 {
   // S_sfx[0] needs to be a dummy for odd reasons.
   SOUND("none",   0),
@@ -202,7 +204,7 @@ sfxinfo_t S_sfx[] =
   SOUND("punch",  64),
   SOUND("hoof",   70),
   SOUND("metal",  70),
-  SOUND_LINK("chgun", 64, sfx_pistol, 150, 0),
+  SOUND_LINK("chgun", 64, 150, 0),
   SOUND("tink",   60),
   SOUND("bdopn",  100),
   SOUND("bdcls",  100),
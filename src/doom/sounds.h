@@ -23,10 +23,10 @@
 #include "i_sound.h"
 
 // the complete set of sound effects
-extern sfxinfo_t	S_sfx[];
+extern INSTANCE sfxinfo_t	S_sfx[];
 
 // the complete set of music
-extern musicinfo_t	S_music[];
+extern INSTANCE musicinfo_t	S_music[];
 
 //
 // Identifiers for all music in game.
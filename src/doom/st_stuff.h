@@ -73,17 +73,17 @@ typedef enum
 
 
 
-extern pixel_t *st_backing_screen;
-extern cheatseq_t cheat_mus;
-extern cheatseq_t cheat_god;
-extern cheatseq_t cheat_ammo;
-extern cheatseq_t cheat_ammonokey;
-extern cheatseq_t cheat_noclip;
-extern cheatseq_t cheat_commercial_noclip;
-extern cheatseq_t cheat_powerup[7];
-extern cheatseq_t cheat_choppers;
-extern cheatseq_t cheat_clev;
-extern cheatseq_t cheat_mypos;
+extern INSTANCE pixel_t *st_backing_screen;
+extern INSTANCE cheatseq_t cheat_mus;
+extern INSTANCE cheatseq_t cheat_god;
+extern INSTANCE cheatseq_t cheat_ammo;
+extern INSTANCE cheatseq_t cheat_ammonokey;
+extern INSTANCE cheatseq_t cheat_noclip;
+extern INSTANCE cheatseq_t cheat_commercial_noclip;
+extern INSTANCE cheatseq_t cheat_powerup[7];
+extern INSTANCE cheatseq_t cheat_choppers;
+extern INSTANCE cheatseq_t cheat_clev;
+extern INSTANCE cheatseq_t cheat_mypos;
 
 
 #endif
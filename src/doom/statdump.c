@@ -42,7 +42,7 @@ static const int doom2_par_times[] =
 };
 
 /* Player colors. */
-static const char *player_colors[] =
+static INSTANCE const char *player_colors[] =
 {
     "Green", "Indigo", "Brown", "Red"
 };
@@ -50,10 +50,10 @@ static const char *player_colors[] =
 // Array of end-of-level statistics that have been captured.
 
 #define MAX_CAPTURES 32
-static wbstartstruct_t captured_stats[MAX_CAPTURES];
-static int num_captured_stats = 0;
+static INSTANCE wbstartstruct_t captured_stats[MAX_CAPTURES];
+static INSTANCE int num_captured_stats = 0;
 
-static GameMission_t discovered_gamemission = none;
+static INSTANCE GameMission_t discovered_gamemission = none;
 
 /* Try to work out whether this is a Doom 1 or Doom 2 game, by looking
  * at the episode and map, and the par times.  This is used to decide
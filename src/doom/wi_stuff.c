@@ -224,7 +224,7 @@ static point_t lnodes[NUMEPISODES][NUMMAPS] =
      0, { NULL, NULL, NULL }, 0, 0, 0, 0 }
 
 
-static anim_t epsd0animinfo[] =
+static INSTANCE anim_t epsd0animinfo[] =
 {
     ANIM(ANIM_ALWAYS, TICRATE/3, 3, 224, 104, 0),
     ANIM(ANIM_ALWAYS, TICRATE/3, 3, 184, 160, 0),
@@ -238,7 +238,7 @@ static anim_t epsd0animinfo[] =
     ANIM(ANIM_ALWAYS, TICRATE/3, 3, 64, 24, 0),
 };
 
-static anim_t epsd1animinfo[] =
+static INSTANCE anim_t epsd1animinfo[] =
 {
     ANIM(ANIM_LEVEL, TICRATE/3, 1, 128, 136, 1),
     ANIM(ANIM_LEVEL, TICRATE/3, 1, 128, 136, 2),
@@ -251,7 +251,7 @@ static anim_t epsd1animinfo[] =
     ANIM(ANIM_LEVEL, TICRATE/3, 1, 128, 136, 8),
 };
 
-static anim_t epsd2animinfo[] =
+static INSTANCE anim_t epsd2animinfo[] =
 {
     ANIM(ANIM_ALWAYS, TICRATE/3, 3, 104, 168, 0),
     ANIM(ANIM_ALWAYS, TICRATE/3, 3, 40, 136, 0),
@@ -268,12 +268,10 @@ static int NUMANIMS[NUMEPISODES] =
     arrlen(epsd2animinfo),
 };
 
-static anim_t *anims[NUMEPISODES] =
-{
-    epsd0animinfo,
-    epsd1animinfo,
-    epsd2animinfo
-};
+// Filled in by WI_initVariables, as the animation tables above are
+// part of the state of a game (see INSTANCE in doomtype.h).
+
+static INSTANCE anim_t *anims[NUMEPISODES];
 
 
 //
@@ -300,37 +298,37 @@ static anim_t *anims[NUMEPISODES] =
 
 
 // used to accelerate or skip a stage
-static int		acceleratestage;
+static INSTANCE int		acceleratestage;
 
 // wbs->pnum
-static int		me;
+static INSTANCE int		me;
 
  // specifies current state
-static stateenum_t	state;
+static INSTANCE stateenum_t	state;
 
 // contains information passed into intermission
-static wbstartstruct_t*	wbs;
+static INSTANCE wbstartstruct_t*	wbs;
 
-static wbplayerstruct_t* plrs;  // wbs->plyr[]
+static INSTANCE wbplayerstruct_t* plrs;  // wbs->plyr[]
 
 // used for general timing
-static int 		cnt;  
+static INSTANCE int 		cnt;  
 
 // used for timing of background animation
-static int 		bcnt;
+static INSTANCE int 		bcnt;
 
 // signals to refresh everything for one frame
-static int 		firstrefresh; 
+static INSTANCE int 		firstrefresh; 
 
-static int		cnt_kills[MAXPLAYERS];
-static int		cnt_items[MAXPLAYERS];
-static int		cnt_secret[MAXPLAYERS];
-static int		cnt_time;
-static int		cnt_par;
-static int		cnt_pause;
+static INSTANCE int		cnt_kills[MAXPLAYERS];
+static INSTANCE int		cnt_items[MAXPLAYERS];
+static INSTANCE int		cnt_secret[MAXPLAYERS];
+static INSTANCE int		cnt_time;
+static INSTANCE int		cnt_par;
+static INSTANCE int		cnt_pause;
 
 // # of commercial levels
-static int		NUMCMAPS; 
+static INSTANCE int		NUMCMAPS; 
 
 
 //
@@ -338,61 +336,61 @@ static int		NUMCMAPS;
 //
 
 // You Are Here graphic
-static patch_t*		yah[3] = { NULL, NULL, NULL }; 
+static INSTANCE patch_t*		yah[3] = { NULL, NULL, NULL }; 
 
 // splat
-static patch_t*		splat[2] = { NULL, NULL };
+static INSTANCE patch_t*		splat[2] = { NULL, NULL };
 
 // %, : graphics
-static patch_t*		percent;
-static patch_t*		colon;
+static INSTANCE patch_t*		percent;
+static INSTANCE patch_t*		colon;
 
 // 0-9 graphic
-static patch_t*		num[10];
+static INSTANCE patch_t*		num[10];
 
 // minus sign
-static patch_t*		wiminus;
+static INSTANCE patch_t*		wiminus;
 
 // "Finished!" graphics
-static patch_t*		finished;
+static INSTANCE patch_t*		finished;
 
 // "Entering" graphic
-static patch_t*		entering; 
+static INSTANCE patch_t*		entering; 
 
 // "secret"
-static patch_t*		sp_secret;
+static INSTANCE patch_t*		sp_secret;
 
  // "Kills", "Scrt", "Items", "Frags"
-static patch_t*		kills;
-static patch_t*		secret;
-static patch_t*		items;
-static patch_t*		frags;
+static INSTANCE patch_t*		kills;
+static INSTANCE patch_t*		secret;
+static INSTANCE patch_t*		items;
+static INSTANCE patch_t*		frags;
 
 // Time sucks.
-static patch_t*		timepatch;
-static patch_t*		par;
-static patch_t*		sucks;
+static INSTANCE patch_t*		timepatch;
+static INSTANCE patch_t*		par;
+static INSTANCE patch_t*		sucks;
 
 // "killers", "victims"
-static patch_t*		killers;
-static patch_t*		victims; 
+static INSTANCE patch_t*		killers;
+static INSTANCE patch_t*		victims; 
 
 // "Total", your face, your dead face
-static patch_t*		total;
-static patch_t*		star;
-static patch_t*		bstar;
+static INSTANCE patch_t*		total;
+static INSTANCE patch_t*		star;
+static INSTANCE patch_t*		bstar;
 
 // "red P[1..MAXPLAYERS]"
-static patch_t*		p[MAXPLAYERS];
+static INSTANCE patch_t*		p[MAXPLAYERS];
 
 // "gray P[1..MAXPLAYERS]"
-static patch_t*		bp[MAXPLAYERS];
+static INSTANCE patch_t*		bp[MAXPLAYERS];
 
  // Name graphics of each level (centered)
-static patch_t**	lnames;
+static INSTANCE patch_t**	lnames;
 
 // Buffer storing the backdrop
-static patch_t *background;
+static INSTANCE patch_t *background;
 
 //
 // CODE
@@ -767,7 +765,7 @@ void WI_updateNoState(void) {
 
 }
 
-static boolean		snl_pointeron = false;
+static INSTANCE boolean		snl_pointeron = false;
 
 
 void WI_initShowNextLoc(void)
@@ -861,9 +859,9 @@ int WI_fragSum(int playernum)
 
 
 
-static int		dm_state;
-static int		dm_frags[MAXPLAYERS][MAXPLAYERS];
-static int		dm_totals[MAXPLAYERS];
+static INSTANCE int		dm_state;
+static INSTANCE int		dm_frags[MAXPLAYERS][MAXPLAYERS];
+static INSTANCE int		dm_totals[MAXPLAYERS];
 
 
 
@@ -1083,9 +1081,9 @@ void WI_drawDeathmatchStats(void)
     }
 }
 
-static int	cnt_frags[MAXPLAYERS];
-static int	dofrags;
-static int	ng_state;
+static INSTANCE int	cnt_frags[MAXPLAYERS];
+static INSTANCE int	dofrags;
+static INSTANCE int	ng_state;
 
 void WI_initNetgameStats(void)
 {
@@ -1325,7 +1323,7 @@ void WI_drawNetgameStats(void)
 
 }
 
-static int	sp_state;
+static INSTANCE int	sp_state;
 
 void WI_initStats(void)
 {
@@ -1784,6 +1782,10 @@ void WI_initVariables(wbstartstruct_t* wbstartstruct)
 
     wbs = wbstartstruct;
 
+    anims[0] = epsd0animinfo;
+    anims[1] = epsd1animinfo;
+    anims[2] = epsd2animinfo;
+
 #ifdef RANGECHECKING
     if (gamemode != commercial)
     {
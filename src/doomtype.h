@@ -76,6 +76,26 @@
 #define NORETURN
 #endif
 
+// Storage class for variables that each thread keeps its own copy of.
+
+#if defined(_MSC_VER)
+#define THREADLOCAL __declspec(thread)
+#elif defined(__GNUC__)
+#define THREADLOCAL __thread
+#else
+#define THREADLOCAL _Thread_local
+#endif
+
+// Storage class for the state of a game.  The server build can host
+// several matches in one process, each on its own thread (see
+// i_instance.c), so there each thread has its own copy of the game.
+
+#ifdef SERVER
+#define INSTANCE THREADLOCAL
+#else
+#define INSTANCE
+#endif
+
 #ifdef __WATCOMC__
 #define PACKEDPREFIX _Packed
 #else
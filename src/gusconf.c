@@ -40,8 +40,8 @@ typedef struct
     unsigned int count;
 } gus_config_t;
 
-char *gus_patch_path = "";
-int gus_ram_kb = 1024;
+INSTANCE char *gus_patch_path = "";
+INSTANCE int gus_ram_kb = 1024;
 
 static unsigned int MappingIndex(void)
 {
@@ -20,8 +20,8 @@
 
 #include "doomtype.h"
 
-extern char *gus_patch_path;
-extern int gus_ram_kb;
+extern INSTANCE char *gus_patch_path;
+extern INSTANCE int gus_ram_kb;
 
 boolean GUS_WriteConfig(char *path);
 
@@ -24,7 +24,7 @@
 
 #include "i_cdmus.h"
 
-int cd_Error;
+INSTANCE int cd_Error;
 
 int I_CDMusInit(void)
 {
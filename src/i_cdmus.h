@@ -26,7 +26,7 @@
 #define CDERR_IOCTLBUFFMEM   22 // Not enough low memory for IOCTL
 #define CDERR_DEVREQBASE     100        // DevReq errors
 
-extern int cd_Error;
+extern INSTANCE int cd_Error;
 
 int I_CDMusInit(void);
 void I_CDMusPrintStartup(void);
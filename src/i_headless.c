@@ -0,0 +1,182 @@
+//
+// Copyright(C) 1993-1996 Id Software, Inc.
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	Headless video and input, used instead of i_video.c by the
+//	server build.  No window is opened and the SDL video subsystem
+//	is never initialized; the screen is never drawn and no input
+//	events are read.
+//
+
+#ifdef SERVER
+
+#include <limits.h>
+#include <string.h>
+
+#include "doomtype.h"
+#include "i_system.h"
+#include "i_video.h"
+#include "m_config.h"
+#include "v_video.h"
+#include "z_zone.h"
+
+// These are all kept so that a shared configuration file loads and
+// saves the same as it does with the normal build.
+
+INSTANCE int usemouse = 0;
+INSTANCE int png_screenshots = 0;
+INSTANCE char *video_driver = "";
+INSTANCE char *window_position = "center";
+INSTANCE int fullscreen = false;
+INSTANCE int aspect_ratio_correct = true;
+INSTANCE int integer_scaling = false;
+INSTANCE int vga_porch_flash = false;
+INSTANCE int force_software_renderer = false;
+INSTANCE int usegamma = 0;
+
+// Nothing is ever displayed.
+
+INSTANCE pixel_t *I_VideoBuffer = NULL;
+INSTANCE boolean screensaver_mode = false;
+INSTANCE boolean screenvisible = false;
+
+INSTANCE unsigned int joywait = 0;
+
+// Last palette set, for I_GetPaletteIndex.
+
+static INSTANCE byte palette[256 * 3];
+
+void I_SetGrabMouseCallback(grabmouse_callback_t func)
+{
+}
+
+void I_DisplayFPSDots(boolean dots_on)
+{
+}
+
+void I_ShutdownGraphics(void)
+{
+}
+
+void I_StartFrame(void)
+{
+}
+
+// There is no input to read.
+
+void I_StartTic(void)
+{
+}
+
+void I_UpdateNoBlit(void)
+{
+}
+
+void I_FinishUpdate(void)
+{
+}
+
+void I_ReadScreen(pixel_t *scr)
+{
+    memcpy(scr, I_VideoBuffer, SCREENWIDTH*SCREENHEIGHT*sizeof(*scr));
+}
+
+void I_SetPalette(byte *doompalette)
+{
+    memcpy(palette, doompalette, sizeof(palette));
+}
+
+int I_GetPaletteIndex(int r, int g, int b)
+{
+    int best, best_diff, diff;
+    int i;
+
+    best = 0; best_diff = INT_MAX;
+
+    for (i = 0; i < 256; ++i)
+    {
+        diff = (r - palette[i * 3]) * (r - palette[i * 3])
+             + (g - palette[i * 3 + 1]) * (g - palette[i * 3 + 1])
+             + (b - palette[i * 3 + 2]) * (b - palette[i * 3 + 2]);
+
+        if (diff < best_diff)
+        {
+            best = i;
+            best_diff = diff;
+        }
+
+        if (diff == 0)
+        {
+            break;
+        }
+    }
+
+    return best;
+}
+
+void I_SetWindowTitle(const char *title)
+{
+}
+
+void I_InitWindowTitle(void)
+{
+}
+
+void I_InitWindowIcon(void)
+{
+}
+
+void I_GraphicsCheckCommandLine(void)
+{
+}
+
+void I_CheckIsScreensaver(void)
+{
+}
+
+void I_GetWindowPosition(int *x, int *y, int w, int h)
+{
+    *x = 0;
+    *y = 0;
+}
+
+// Anything that still draws (eg. the status bar widgets) needs a
+// buffer to draw into, even though it is never shown.
+
+void I_InitGraphics(void)
+{
+    I_VideoBuffer = Z_Malloc(SCREENWIDTH * SCREENHEIGHT
+                               * sizeof(*I_VideoBuffer),
+                             PU_STATIC, NULL);
+    memset(I_VideoBuffer, 0,
+           SCREENWIDTH * SCREENHEIGHT * sizeof(*I_VideoBuffer));
+    V_RestoreBuffer();
+}
+
+void I_BindVideoVariables(void)
+{
+    M_BindIntVariable("use_mouse",                 &usemouse);
+    M_BindIntVariable("fullscreen",                &fullscreen);
+    M_BindIntVariable("aspect_ratio_correct",      &aspect_ratio_correct);
+    M_BindIntVariable("integer_scaling",           &integer_scaling);
+    M_BindIntVariable("vga_porch_flash",           &vga_porch_flash);
+    M_BindIntVariable("force_software_renderer",   &force_software_renderer);
+    M_BindStringVariable("video_driver",           &video_driver);
+    M_BindStringVariable("window_position",        &window_position);
+    M_BindIntVariable("usegamma",                  &usegamma);
+    M_BindIntVariable("png_screenshots",           &png_screenshots);
+}
+
+#endif /* #ifdef SERVER */
+
@@ -73,21 +73,21 @@ static const char shiftxform[] =
 
 // If true, I_StartTextInput() has been called, and we are populating
 // the data3 field of ev_keydown events.
-static boolean text_input_enabled = true;
+static INSTANCE boolean text_input_enabled = true;
 
 // Bit mask of mouse button state.
-static unsigned int mouse_button_state = 0;
+static INSTANCE unsigned int mouse_button_state = 0;
 
 // Disallow mouse and joystick movement to cause forward/backward
 // motion.  Specified with the '-novert' command line parameter.
 // This is an int to allow saving to config file
-int novert = 0;
+INSTANCE int novert = 0;
 
 // If true, keyboard mapping is ignored, like in Vanilla Doom.
 // The sensible thing to do is to disable this if you have a non-US
 // keyboard.
 
-int vanilla_keyboard_mapping = true;
+INSTANCE int vanilla_keyboard_mapping = true;
 
 // Mouse acceleration
 //
@@ -97,8 +97,8 @@ int vanilla_keyboard_mapping = true;
 // The mouse input values are input directly to the game, but when
 // the values exceed the value of mouse_threshold, they are multiplied
 // by mouse_acceleration to increase the speed.
-float mouse_acceleration = 2.0;
-int mouse_threshold = 10;
+INSTANCE float mouse_acceleration = 2.0;
+INSTANCE int mouse_threshold = 10;
 
 // Translates the SDL key to a value of the type found in doomkeys.h
 static int TranslateKey(SDL_Keysym *sym)
@@ -307,7 +307,7 @@ void I_StopTextInput(void)
 
 static void UpdateMouseButtonState(unsigned int button, boolean on)
 {
-    static event_t event;
+    static INSTANCE event_t event;
 
     if (button < SDL_BUTTON_LEFT || button > MAX_MOUSE_BUTTONS)
     {
@@ -362,7 +362,7 @@ static void MapMouseWheelToButtons(SDL_MouseWheelEvent *wheel)
     // SDL2 distinguishes button events from mouse wheel events.
     // We want to treat the mouse wheel as two buttons, as per
     // SDL1
-    static event_t up, down;
+    static INSTANCE event_t up, down;
     int button;
 
     if (wheel->y <= 0)
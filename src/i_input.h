@@ -24,8 +24,8 @@
 
 #define MAX_MOUSE_BUTTONS 8
 
-extern float mouse_acceleration;
-extern int mouse_threshold;
+extern INSTANCE float mouse_acceleration;
+extern INSTANCE int mouse_threshold;
 
 void I_BindInputVariables(void);
 void I_ReadMouse(void);
@@ -0,0 +1,262 @@
+//
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//     Hosting several matches in one process.  In the server build,
+//     all of the state of a game is thread-local (see INSTANCE in
+//     doomtype.h), so with -matches the game is simply run once on
+//     each of several threads.  Each match gets its own copy of the
+//     command line, with its own port and its own log files.
+//
+
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SDL.h"
+
+#include "doomtype.h"
+#include "i_instance.h"
+#include "i_system.h"
+#include "i_timer.h"
+#include "m_argv.h"
+#include "m_misc.h"
+
+static int num_instances = 1;
+
+#ifdef SERVER
+
+#define DEFAULT_PORT 2342
+#define MAX_INSTANCES 64
+
+typedef struct
+{
+    int number;
+    int argc;
+    char **argv;
+    instance_main_t main_func;
+    SDL_Thread *thread;
+    boolean ready;
+} instance_t;
+
+static instance_t instances[MAX_INSTANCES];
+static SDL_sem *ready_sem;
+
+// The match run by this thread, and where to go when it ends.  NULL
+// when there is only the one match.
+
+static INSTANCE instance_t *this_instance;
+static INSTANCE jmp_buf exit_jump;
+
+// Point the given option's argument at a copy with the match number
+// added to the end, so that matches do not write to the same file.
+
+static void SuffixFileArg(char **argv, const char *name, int number)
+{
+    char suffix[16];
+    int p;
+
+    p = M_CheckParmWithArgs(name, 1);
+
+    if (p > 0)
+    {
+        M_snprintf(suffix, sizeof(suffix), ".%d", number);
+        argv[p + 1] = M_StringJoin(myargv[p + 1], suffix, NULL);
+    }
+}
+
+// Build the command line for a match.  Each match listens on the port
+// after the one before it, starting from -port (or the default).
+
+static void InstanceArgs(instance_t *instance)
+{
+    char portbuf[16];
+    char **argv;
+    int argc;
+    int p, port;
+
+    argv = malloc((myargc + 3) * sizeof(*argv));
+
+    if (argv == NULL)
+    {
+        I_Error("I_RunInstances: Failed to allocate command line");
+    }
+
+    memcpy(argv, myargv, myargc * sizeof(*argv));
+    argc = myargc;
+
+    p = M_CheckParmWithArgs("-port", 1);
+
+    if (p > 0)
+    {
+        port = atoi(myargv[p + 1]);
+    }
+    else
+    {
+        port = DEFAULT_PORT;
+        p = argc;
+        argv[argc++] = "-port";
+        ++argc;
+    }
+
+    M_snprintf(portbuf, sizeof(portbuf), "%d", port + instance->number);
+    argv[p + 1] = M_StringDuplicate(portbuf);
+
+    SuffixFileArg(argv, "-metrics", instance->number);
+    SuffixFileArg(argv, "-netlog", instance->number);
+
+    argv[argc] = NULL;
+
+    instance->argc = argc;
+    instance->argv = argv;
+}
+
+static int InstanceThread(void *data)
+{
+    instance_t *instance = data;
+
+    this_instance = instance;
+    myargc = instance->argc;
+    myargv = instance->argv;
+
+    if (setjmp(exit_jump) == 0)
+    {
+        instance->main_func();
+    }
+
+    // If it never got going, do not hold up the next one.
+
+    I_InstanceReady();
+
+    return 0;
+}
+
+#endif /* #ifdef SERVER */
+
+void I_RunInstances(instance_main_t main_func)
+{
+#ifdef SERVER
+    char name[16];
+    int i, p;
+
+    //!
+    // @category net
+    // @arg <n>
+    //
+    // Run n matches in one server process, each on its own thread.
+    // Match k (counting from zero) listens on the port given by -port,
+    // plus k.  Files given to -metrics and -netlog get ".k" added to
+    // their names.
+    //
+
+    p = M_CheckParmWithArgs("-matches", 1);
+
+    if (p > 0)
+    {
+        num_instances = atoi(myargv[p + 1]);
+
+        if (num_instances < 1 || num_instances > MAX_INSTANCES)
+        {
+            I_Error("I_RunInstances: -matches must be between 1 and %d",
+                    MAX_INSTANCES);
+        }
+    }
+
+    if (num_instances > 1)
+    {
+        // All of the matches share one clock, so start it before any
+        // of them can read it.
+
+        I_GetTimeNS();
+
+        ready_sem = SDL_CreateSemaphore(0);
+
+        if (ready_sem == NULL)
+        {
+            I_Error("I_RunInstances: %s", SDL_GetError());
+        }
+
+        // Matches are started one at a time, each once the one before
+        // has finished starting up, so that their start-up messages
+        // are not mixed together.
+
+        for (i = 0; i < num_instances; ++i)
+        {
+            instances[i].number = i;
+            instances[i].main_func = main_func;
+            InstanceArgs(&instances[i]);
+
+            M_snprintf(name, sizeof(name), "match%d", i);
+            instances[i].thread = SDL_CreateThread(InstanceThread, name,
+                                                   &instances[i]);
+
+            if (instances[i].thread == NULL)
+            {
+                I_Error("I_RunInstances: Failed to start thread: %s",
+                        SDL_GetError());
+            }
+
+            SDL_SemWait(ready_sem);
+        }
+
+        for (i = 0; i < num_instances; ++i)
+        {
+            SDL_WaitThread(instances[i].thread, NULL);
+        }
+
+        return;
+    }
+#endif
+
+    main_func();
+}
+
+int I_InstanceNumber(void)
+{
+#ifdef SERVER
+    if (this_instance != NULL)
+    {
+        return this_instance->number;
+    }
+#endif
+
+    return 0;
+}
+
+int I_NumInstances(void)
+{
+    return num_instances;
+}
+
+void I_InstanceReady(void)
+{
+#ifdef SERVER
+    if (this_instance != NULL && !this_instance->ready)
+    {
+        this_instance->ready = true;
+        SDL_SemPost(ready_sem);
+    }
+#endif
+}
+
+void I_ExitInstance(void)
+{
+#ifdef SERVER
+    if (this_instance != NULL)
+    {
+        longjmp(exit_jump, 1);
+    }
+#endif
+}
+
@@ -0,0 +1,49 @@
+//
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//     Hosting several matches in one process.
+//
+
+#ifndef __I_INSTANCE__
+#define __I_INSTANCE__
+
+#include "doomtype.h"
+
+typedef void (*instance_main_t)(void);
+
+// Run the game: once, or with -matches, once for each match, each on
+// its own thread.  Returns when every match has ended.
+
+void I_RunInstances(instance_main_t main_func);
+
+// Number of the match run by the calling thread, counting from zero.
+
+int I_InstanceNumber(void);
+
+// Number of matches being run by this process.
+
+int I_NumInstances(void);
+
+// Called by a match once it has started up and entered its main
+// loop, so that the next one can be started.
+
+void I_InstanceReady(void);
+
+// Called by I_Quit and I_Error.  If the calling thread is running one
+// of several matches, end just that match and do not return.
+
+void I_ExitInstance(void);
+
+#endif
+
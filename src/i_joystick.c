@@ -36,57 +36,57 @@
 
 #define DEAD_ZONE (32768 / 3)
 
-static SDL_Joystick *joystick = NULL;
+static INSTANCE SDL_Joystick *joystick = NULL;
 
 // Configuration variables:
 
 // Standard default.cfg Joystick enable/disable
 #ifdef XBOX
-static int usejoystick = 1;
+static INSTANCE int usejoystick = 1;
 
 // SDL GUID and index of the joystick to use.
-static char *joystick_guid = "000000000";
-static int joystick_index = 0;
+static INSTANCE char *joystick_guid = "000000000";
+static INSTANCE int joystick_index = 0;
 
 #else
-static int usejoystick = 0;
+static INSTANCE int usejoystick = 0;
 
 // SDL GUID and index of the joystick to use.
-static char *joystick_guid = "";
-static int joystick_index = -1;
+static INSTANCE char *joystick_guid = "";
+static INSTANCE int joystick_index = -1;
 #endif
 
 // Which joystick axis to use for horizontal movement, and whether to
 // invert the direction:
 
-static int joystick_x_axis = 0;
-static int joystick_x_invert = 0;
+static INSTANCE int joystick_x_axis = 0;
+static INSTANCE int joystick_x_invert = 0;
 
 // look side to side
 
 // Which joystick axis to use for vertical movement, and whether to
 // invert the direction:
 
-static int joystick_y_axis = 1;
+static INSTANCE int joystick_y_axis = 1;
 #ifdef XBOX
-static int joystick_y_invert = 1;
+static INSTANCE int joystick_y_invert = 1;
 #else
-static int joystick_y_invert = 0;
+static INSTANCE int joystick_y_invert = 0;
 #endif
 
 // Which joystick axis to use for strafing?
 
-static int joystick_strafe_axis = -1;
-static int joystick_strafe_invert = 0;
+static INSTANCE int joystick_strafe_axis = -1;
+static INSTANCE int joystick_strafe_invert = 0;
 
 // Which joystick axis to use for looking?
 
-static int joystick_look_axis = -1;
-static int joystick_look_invert = 0;
+static INSTANCE int joystick_look_axis = -1;
+static INSTANCE int joystick_look_invert = 0;
 
 // Virtual to physical button joystick button mapping. By default this
 // is a straight mapping.
-static int joystick_physical_buttons[NUM_VIRTUAL_BUTTONS] = {
+static INSTANCE int joystick_physical_buttons[NUM_VIRTUAL_BUTTONS] = {
 #ifdef XBOX
     0, 3, 2, 1, 4, 5, 6, 7, 8, 9, 10
 #else
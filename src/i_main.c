@@ -23,6 +23,7 @@
 #include "SDL.h"
 
 #include "doomtype.h"
+#include "i_instance.h"
 #include "i_system.h"
 #include "m_argv.h"
 
@@ -63,7 +64,7 @@ int main(int argc, char **argv)
 
     // start doom
 
-    D_DoomMain ();
+    I_RunInstances(D_DoomMain);
 
     return 0;
 }
@@ -92,35 +92,35 @@ typedef struct
     int start_time, end_time;
 } file_metadata_t;
 
-static subst_music_t *subst_music = NULL;
-static unsigned int subst_music_len = 0;
+static INSTANCE subst_music_t *subst_music = NULL;
+static INSTANCE unsigned int subst_music_len = 0;
 
-static boolean music_initialized = false;
+static INSTANCE boolean music_initialized = false;
 
 // If this is true, this module initialized SDL sound and has the 
 // responsibility to shut it down
 
-static boolean sdl_was_initialized = false;
+static INSTANCE boolean sdl_was_initialized = false;
 
-char *music_pack_path = "";
+INSTANCE char *music_pack_path = "";
 
 // If true, we are playing a substitute digital track rather than in-WAD
 // MIDI/MUS track, and file_metadata contains loop metadata.
-static file_metadata_t file_metadata;
+static INSTANCE file_metadata_t file_metadata;
 
 // Position (in samples) that we have reached in the current track.
 // This is updated by the TrackPositionCallback function.
-static unsigned int current_track_pos;
+static INSTANCE unsigned int current_track_pos;
 
 #ifdef XBOX
 typedef int Mix_Music;
 #endif
 
 // Currently playing music track.
-static Mix_Music *current_track_music = NULL;
+static INSTANCE Mix_Music *current_track_music = NULL;
 
 // If true, the currently playing track is being played on loop.
-static boolean current_track_loop;
+static INSTANCE boolean current_track_loop;
 
 // Table of known hashes and filenames to look up for them. This allows
 // users to drop in a set of files without having to also provide a
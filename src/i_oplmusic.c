@@ -303,62 +303,62 @@ static const unsigned int volume_mapping_table[] = {
     124, 124, 125, 125, 126, 126, 127, 127
 };
 
-static opl_driver_ver_t opl_drv_ver = opl_doom_1_9;
-static boolean music_initialized = false;
+static INSTANCE opl_driver_ver_t opl_drv_ver = opl_doom_1_9;
+static INSTANCE boolean music_initialized = false;
 
 //static boolean musicpaused = false;
-static int start_music_volume;
-static int current_music_volume;
+static INSTANCE int start_music_volume;
+static INSTANCE int current_music_volume;
 
 // GENMIDI lump instrument data:
 
-static genmidi_instr_t *main_instrs;
-static genmidi_instr_t *percussion_instrs;
-static char (*main_instr_names)[32];
-static char (*percussion_names)[32];
+static INSTANCE genmidi_instr_t *main_instrs;
+static INSTANCE genmidi_instr_t *percussion_instrs;
+static INSTANCE char (*main_instr_names)[32];
+static INSTANCE char (*percussion_names)[32];
 
 // Voices:
 
-static opl_voice_t voices[OPL_NUM_VOICES * 2];
-static opl_voice_t *voice_free_list[OPL_NUM_VOICES * 2];
-static opl_voice_t *voice_alloced_list[OPL_NUM_VOICES * 2];
-static int voice_free_num;
-static int voice_alloced_num;
-static int opl_opl3mode;
-static int num_opl_voices;
+static INSTANCE opl_voice_t voices[OPL_NUM_VOICES * 2];
+static INSTANCE opl_voice_t *voice_free_list[OPL_NUM_VOICES * 2];
+static INSTANCE opl_voice_t *voice_alloced_list[OPL_NUM_VOICES * 2];
+static INSTANCE int voice_free_num;
+static INSTANCE int voice_alloced_num;
+static INSTANCE int opl_opl3mode;
+static INSTANCE int num_opl_voices;
 
 // Data for each channel.
 
-static opl_channel_data_t channels[MIDI_CHANNELS_PER_TRACK];
+static INSTANCE opl_channel_data_t channels[MIDI_CHANNELS_PER_TRACK];
 
 // Track data for playing tracks:
 
-static opl_track_data_t *tracks;
-static unsigned int num_tracks = 0;
-static unsigned int running_tracks = 0;
-static boolean song_looping;
+static INSTANCE opl_track_data_t *tracks;
+static INSTANCE unsigned int num_tracks = 0;
+static INSTANCE unsigned int running_tracks = 0;
+static INSTANCE boolean song_looping;
 
 // Tempo control variables
 
-static unsigned int ticks_per_beat;
-static unsigned int us_per_beat;
+static INSTANCE unsigned int ticks_per_beat;
+static INSTANCE unsigned int us_per_beat;
 
 // Mini-log of recently played percussion instruments:
 
-static uint8_t last_perc[PERCUSSION_LOG_LEN];
-static unsigned int last_perc_count;
+static INSTANCE uint8_t last_perc[PERCUSSION_LOG_LEN];
+static INSTANCE unsigned int last_perc_count;
 
 // Configuration file variable, containing the port number for the
 // adlib chip.
 
-char *snd_dmxoption = "";
-int opl_io_port = 0x388;
+INSTANCE char *snd_dmxoption = "";
+INSTANCE int opl_io_port = 0x388;
 
 // If true, OPL sound channels are reversed to their correct arrangement
 // (as intended by the MIDI standard) rather than the backwards one
 // used by DMX due to a bug.
 
-static boolean opl_stereo_correct = false;
+static INSTANCE boolean opl_stereo_correct = false;
 
 // Load instrument table from GENMIDI lump:
 
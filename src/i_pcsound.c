@@ -30,16 +30,16 @@
 
 #define TIMER_FREQ 1193181 /* hz */
 
-static boolean pcs_initialized = false;
+static INSTANCE boolean pcs_initialized = false;
 
-static SDL_mutex *sound_lock;
-static boolean use_sfx_prefix;
+static INSTANCE SDL_mutex *sound_lock;
+static INSTANCE boolean use_sfx_prefix;
 
-static uint8_t *current_sound_lump = NULL;
-static uint8_t *current_sound_pos = NULL;
-static unsigned int current_sound_remaining = 0;
-static int current_sound_handle = 0;
-static int current_sound_lump_num = -1;
+static INSTANCE uint8_t *current_sound_lump = NULL;
+static INSTANCE uint8_t *current_sound_pos = NULL;
+static INSTANCE unsigned int current_sound_remaining = 0;
+static INSTANCE int current_sound_handle = 0;
+static INSTANCE int current_sound_lump_num = -1;
 
 static const uint16_t divisors[] = {
     0,
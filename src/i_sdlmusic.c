@@ -48,19 +48,19 @@
 
 #define MAXMIDLENGTH (96 * 1024)
 
-static boolean music_initialized = false;
+static INSTANCE boolean music_initialized = false;
 
 // If this is true, this module initialized SDL sound and has the 
 // responsibility to shut it down
 
-static boolean sdl_was_initialized = false;
+static INSTANCE boolean sdl_was_initialized = false;
 
-static boolean musicpaused = false;
-static int current_music_volume;
+static INSTANCE boolean musicpaused = false;
+static INSTANCE int current_music_volume;
 
-char *timidity_cfg_path = "";
+INSTANCE char *timidity_cfg_path = "";
 
-static char *temp_timidity_cfg = NULL;
+static INSTANCE char *temp_timidity_cfg = NULL;
 
 // If the temp_timidity_cfg config variable is set, generate a "wrapper"
 // config file for Timidity to point to the actual config file. This
@@ -58,14 +58,14 @@ struct allocated_sound_s
     allocated_sound_t *prev, *next;
 };
 
-static boolean sound_initialized = false;
+static INSTANCE boolean sound_initialized = false;
 
-static allocated_sound_t *channels_playing[NUM_CHANNELS];
+static INSTANCE allocated_sound_t *channels_playing[NUM_CHANNELS];
 
-static int mixer_freq;
-static Uint16 mixer_format;
-static int mixer_channels;
-static boolean use_sfx_prefix;
+static INSTANCE int mixer_freq;
+static INSTANCE Uint16 mixer_format;
+static INSTANCE int mixer_channels;
+static INSTANCE boolean use_sfx_prefix;
 static boolean (*ExpandSoundData)(sfxinfo_t *sfxinfo,
                                   byte *data,
                                   int samplerate,
@@ -75,11 +75,11 @@ static boolean (*ExpandSoundData)(sfxinfo_t *sfxinfo,
 // When a sound is played, it is moved to the head, so that the oldest
 // sounds not used recently are at the tail.
 
-static allocated_sound_t *allocated_sounds_head = NULL;
-static allocated_sound_t *allocated_sounds_tail = NULL;
-static int allocated_sounds_size = 0;
+static INSTANCE allocated_sound_t *allocated_sounds_head = NULL;
+static INSTANCE allocated_sound_t *allocated_sounds_tail = NULL;
+static INSTANCE int allocated_sounds_size = 0;
 
-int use_libsamplerate = 0;
+INSTANCE int use_libsamplerate = 0;
 
 // Scale factor used when converting libsamplerate floating point numbers
 // to integers. Too high means the sounds can clip; too low means they
@@ -87,7 +87,7 @@ int use_libsamplerate = 0;
 // of the time: with all the Doom IWAD sound effects, at least. If a PWAD
 // is used, clipping might occur.
 
-float libsamplerate_scale = 0.65f;
+INSTANCE float libsamplerate_scale = 0.65f;
 
 // Hook a sound into the linked list at the head.
 
@@ -33,40 +33,40 @@
 
 // Sound sample rate to use for digital output (Hz)
 
-int snd_samplerate = 44100;
+INSTANCE int snd_samplerate = 44100;
 
 // Maximum number of bytes to dedicate to allocated sound effects.
 // (Default: 64MB)
 
-int snd_cachesize = 64 * 1024 * 1024;
+INSTANCE int snd_cachesize = 64 * 1024 * 1024;
 
 // Config variable that controls the sound buffer size.
 // We default to 28ms (1000 / 35fps = 1 buffer per tic).
 
-int snd_maxslicetime_ms = 28;
+INSTANCE int snd_maxslicetime_ms = 28;
 
 // External command to invoke to play back music.
 
-char *snd_musiccmd = "";
+INSTANCE char *snd_musiccmd = "";
 
 // Whether to vary the pitch of sound effects
 // Each game will set the default differently
 
-int snd_pitchshift = -1;
+INSTANCE int snd_pitchshift = -1;
 
-int snd_musicdevice = SNDDEVICE_SB;
-int snd_sfxdevice = SNDDEVICE_SB;
+INSTANCE int snd_musicdevice = SNDDEVICE_SB;
+INSTANCE int snd_sfxdevice = SNDDEVICE_SB;
 
 // Low-level sound and music modules we are using
-static sound_module_t *sound_module;
-static music_module_t *music_module;
+static INSTANCE sound_module_t *sound_module;
+static INSTANCE music_module_t *music_module;
 
 // If true, the music pack module was successfully initialized.
-static boolean music_packs_active = false;
+static INSTANCE boolean music_packs_active = false;
 
 // This is either equal to music_module or &music_pack_module,
 // depending on whether the current track is substituted.
-static music_module_t *active_music_module;
+static INSTANCE music_module_t *active_music_module;
 
 // Sound modules
 
@@ -80,21 +80,21 @@ extern music_module_t music_pack_module;
 // For OPL module:
 
 extern opl_driver_ver_t opl_drv_ver;
-extern int opl_io_port;
+extern INSTANCE int opl_io_port;
 
 // For native music module:
 
-extern char *music_pack_path;
-extern char *timidity_cfg_path;
+extern INSTANCE char *music_pack_path;
+extern INSTANCE char *timidity_cfg_path;
 
 // DOS-specific options: These are unused but should be maintained
 // so that the config file can be shared between chocolate
 // doom and doom.exe
 
-static int snd_sbport = 0;
-static int snd_sbirq = 0;
-static int snd_sbdma = 0;
-static int snd_mport = 0;
+static INSTANCE int snd_sbport = 0;
+static INSTANCE int snd_sbirq = 0;
+static INSTANCE int snd_sbdma = 0;
+static INSTANCE int snd_mport = 0;
 
 // Compiled-in sound modules:
 
@@ -210,7 +210,7 @@ void I_InitSound(boolean use_sfx_prefix)
     //
 
     nosound = M_CheckParm("-nosound") > 0;
-#ifdef XBOX
+#if defined(XBOX) || defined(SERVER)
     nosound = 1;
 #endif
 
@@ -496,20 +496,20 @@ boolean I_MusicIsPlaying(void)
 }
 
 #ifdef XBOX
-char *snd_dmxoption;
-int use_libsamplerate;
-float libsamplerate_scale;
-float libsamplerate_scale;
-int opl_io_port;
-char *timidity_cfg_path;
+INSTANCE char *snd_dmxoption;
+INSTANCE int use_libsamplerate;
+INSTANCE float libsamplerate_scale;
+INSTANCE float libsamplerate_scale;
+INSTANCE int opl_io_port;
+INSTANCE char *timidity_cfg_path;
 #endif
 
 void I_BindSoundVariables(void)
 {
 #ifndef XBOX
-    extern char *snd_dmxoption;
-    extern int use_libsamplerate;
-    extern float libsamplerate_scale;
+    extern INSTANCE char *snd_dmxoption;
+    extern INSTANCE int use_libsamplerate;
+    extern INSTANCE float libsamplerate_scale;
 #endif
 
     M_BindIntVariable("snd_musicdevice",         &snd_musicdevice);
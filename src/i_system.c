@@ -39,6 +39,7 @@
 #include "m_argv.h"
 #include "m_config.h"
 #include "m_misc.h"
+#include "i_instance.h"
 #include "i_joystick.h"
 #include "i_sound.h"
 #include "i_timer.h"
@@ -62,7 +63,7 @@ struct atexit_listentry_s
     atexit_listentry_t *next;
 };
 
-static atexit_listentry_t *exit_funcs = NULL;
+static INSTANCE atexit_listentry_t *exit_funcs = NULL;
 
 void I_AtExit(atexit_func_t func, boolean run_on_error)
 {
@@ -252,6 +253,10 @@ void I_Quit (void)
         entry = entry->next;
     }
 
+    // When hosting several matches, only this one ends.
+
+    I_ExitInstance();
+
     SDL_Quit();
 
     exit(0);
@@ -264,7 +269,7 @@ void I_Quit (void)
 // I_Error
 //
 
-static boolean already_quitting = false;
+static INSTANCE boolean already_quitting = false;
 
 void I_Error (const char *error, ...)
 {
@@ -335,6 +340,8 @@ void I_Error (const char *error, ...)
 
     // while(1);
 
+    I_ExitInstance();
+
     SDL_Quit();
 
     exit(-1);
@@ -385,13 +392,13 @@ static const unsigned char mem_dump_win98[DOS_MEM_DUMP_SIZE] = {
   0x9E, 0x0F, 0xC9, 0x00, 0x65, 0x04, 0x70, 0x00, 0x16, 0x00};
 static const unsigned char mem_dump_dosbox[DOS_MEM_DUMP_SIZE] = {
   0x00, 0x00, 0x00, 0xF1, 0x00, 0x00, 0x00, 0x00, 0x07, 0x00};
-static unsigned char mem_dump_custom[DOS_MEM_DUMP_SIZE];
+static INSTANCE unsigned char mem_dump_custom[DOS_MEM_DUMP_SIZE];
 
-static const unsigned char *dos_mem_dump = mem_dump_dos622;
+static INSTANCE const unsigned char *dos_mem_dump = mem_dump_dos622;
 
 boolean I_GetMemoryValue(unsigned int offset, void *value, int size)
 {
-    static boolean firsttime = true;
+    static INSTANCE boolean firsttime = true;
 
     if (firsttime)
     {
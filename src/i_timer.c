@@ -18,28 +18,65 @@
 
 #include "SDL.h"
 
+#include "config.h"
+
+#ifdef HAVE_CLOCK_NANOSLEEP
+#include <errno.h>
+#include <time.h>
+#endif
+
 #include "i_timer.h"
 #include "doomtype.h"
 
+// Reading of the monotonic clock when the timer was first used.  All
+// of the times returned below count from here.
+
+static uint64_t basetime = 0;
+
+static uint64_t ReadClockNS(void)
+{
+#ifdef HAVE_CLOCK_NANOSLEEP
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+#else
+    uint64_t counter, freq;
+
+    counter = SDL_GetPerformanceCounter();
+    freq = SDL_GetPerformanceFrequency();
+
+    return (counter / freq) * 1000000000
+         + (counter % freq) * 1000000000 / freq;
+#endif
+}
+
 //
-// I_GetTime
-// returns time in 1/35th second tics
+// I_GetTimeNS
+// returns time in nanoseconds
 //
 
-static Uint32 basetime = 0;
-
-int  I_GetTime (void)
+uint64_t I_GetTimeNS(void)
 {
-    Uint32 ticks;
+    uint64_t now;
 
-    ticks = SDL_GetTicks();
+    now = ReadClockNS();
 
     if (basetime == 0)
-        basetime = ticks;
+        basetime = now;
 
-    ticks -= basetime;
+    return now - basetime;
+}
+
+//
+// I_GetTime
+// returns time in 1/35th second tics
+//
 
-    return (ticks * TICRATE) / 1000;    
+int  I_GetTime (void)
+{
+    return (I_GetTimeNS() * TICRATE) / 1000000000;
 }
 
 //
@@ -48,14 +85,34 @@ int  I_GetTime (void)
 
 int I_GetTimeMS(void)
 {
-    Uint32 ticks;
+    return I_GetTimeNS() / 1000000;
+}
 
-    ticks = SDL_GetTicks();
+// Sleep until I_GetTimeNS() reaches the given time.
 
-    if (basetime == 0)
-        basetime = ticks;
+void I_SleepUntilNS(uint64_t deadline)
+{
+#ifdef HAVE_CLOCK_NANOSLEEP
+    struct timespec ts;
+
+    I_GetTimeNS();
+    deadline += basetime;
 
-    return ticks - basetime;
+    ts.tv_sec = deadline / 1000000000;
+    ts.tv_nsec = deadline % 1000000000;
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL)
+           == EINTR);
+#else
+    uint64_t now;
+
+    now = I_GetTimeNS();
+
+    if (deadline > now)
+    {
+        SDL_Delay((deadline - now + 999999) / 1000000);
+    }
+#endif
 }
 
 // Sleep for a specified number of ms
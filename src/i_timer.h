@@ -20,6 +20,8 @@
 #ifndef __I_TIMER__
 #define __I_TIMER__
 
+#include "doomtype.h"
+
 #define TICRATE 35
 
 // Called by D_DoomLoop,
@@ -29,9 +31,15 @@ int I_GetTime (void);
 // returns current time in ms
 int I_GetTimeMS (void);
 
+// returns current time in ns, from a monotonic clock
+uint64_t I_GetTimeNS(void);
+
 // Pause for a specified number of ms
 void I_Sleep(int ms);
 
+// Pause until I_GetTimeNS() reaches the given time
+void I_SleepUntilNS(uint64_t deadline);
+
 // Initialize timer
 void I_InitTimer(void);
 
@@ -16,6 +16,10 @@
 //	DOOM graphics stuff for SDL.
 //
 
+// The server build is headless; see i_headless.c.
+
+#ifndef SERVER
+
 
 #include "SDL.h"
 #include "SDL_opengl.h"
@@ -103,11 +107,11 @@ int png_screenshots = 0;
 
 // SDL video driver name
 
-char *video_driver = "";
+INSTANCE char *video_driver = "";
 
 // Window position:
 
-char *window_position = "center";
+INSTANCE char *window_position = "center";
 
 // SDL display number on which to run.
 
@@ -132,27 +136,27 @@ static int max_scaling_buffer_pixels = 16000000;
 
 // Run in full screen mode?  (int type for config code)
 
-int fullscreen = true;
+INSTANCE int fullscreen = true;
 
 // Aspect ratio correction mode
 
-int aspect_ratio_correct = true;
+INSTANCE int aspect_ratio_correct = true;
 static int actualheight;
 
 // Force integer scales for resolution-independent rendering
 
-int integer_scaling = false;
+INSTANCE int integer_scaling = false;
 
 // VGA Porch palette change emulation
 
-int vga_porch_flash = false;
+INSTANCE int vga_porch_flash = false;
 
 // Force software rendering, for systems which lack effective hardware
 // acceleration
 #ifdef XBOX
-int force_software_renderer = true;
+INSTANCE int force_software_renderer = true;
 #else
-int force_software_renderer = false;
+INSTANCE int force_software_renderer = false;
 #endif
 
 // Time to wait for the screen to settle on startup before starting the
@@ -168,16 +172,16 @@ static boolean nograbmouse_override = false;
 
 // The screen buffer; this is modified to draw things to the screen
 
-pixel_t *I_VideoBuffer = NULL;
+INSTANCE pixel_t *I_VideoBuffer = NULL;
 
 // If true, game is running as a screensaver
 
-boolean screensaver_mode = false;
+INSTANCE boolean screensaver_mode = false;
 
 // Flag indicating whether the screen is currently visible:
 // when the screen isnt visible, don't render the screen
 
-boolean screenvisible = true;
+INSTANCE boolean screenvisible = true;
 
 // If true, we display dots at the bottom of the screen to 
 // indicate FPS.
@@ -206,10 +210,10 @@ static unsigned int last_resize_time;
 
 // Gamma correction level to use
 
-int usegamma = 0;
+INSTANCE int usegamma = 0;
 
 // Joystick/gamepad hysteresis
-unsigned int joywait = 0;
+INSTANCE unsigned int joywait = 0;
 
 static boolean MouseShouldBeGrabbed()
 {
@@ -620,11 +624,6 @@ static void LimitTextureSize(int *w_upscale, int *h_upscale)
 
 static void CreateUpscaledTexture(boolean force)
 {
-#ifdef SERVER
-#warning Disabling textures for server.
-	return;
-#endif
-
     int w, h;
     int h_upscale, w_upscale;
     static int h_upscale_old, w_upscale_old;
@@ -1498,3 +1497,6 @@ void I_BindVideoVariables(void)
     M_BindIntVariable("usegamma",                  &usegamma);
     M_BindIntVariable("png_screenshots",           &png_screenshots);
 }
+
+#endif /* #ifndef SERVER */
+
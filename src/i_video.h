@@ -78,26 +78,26 @@ void I_StartTic (void);
 
 void I_EnableLoadingDisk(int xoffs, int yoffs);
 
-extern char *video_driver;
-extern boolean screenvisible;
+extern INSTANCE char *video_driver;
+extern INSTANCE boolean screenvisible;
 
-extern int vanilla_keyboard_mapping;
-extern boolean screensaver_mode;
-extern int usegamma;
-extern pixel_t *I_VideoBuffer;
+extern INSTANCE int vanilla_keyboard_mapping;
+extern INSTANCE boolean screensaver_mode;
+extern INSTANCE int usegamma;
+extern INSTANCE pixel_t *I_VideoBuffer;
 
 extern int screen_width;
 extern int screen_height;
-extern int fullscreen;
-extern int aspect_ratio_correct;
-extern int integer_scaling;
-extern int vga_porch_flash;
-extern int force_software_renderer;
+extern INSTANCE int fullscreen;
+extern INSTANCE int aspect_ratio_correct;
+extern INSTANCE int integer_scaling;
+extern INSTANCE int vga_porch_flash;
+extern INSTANCE int force_software_renderer;
 
-extern char *window_position;
+extern INSTANCE char *window_position;
 void I_GetWindowPosition(int *x, int *y, int w, int h);
 
 // Joystic/gamepad hysteresis
-extern unsigned int joywait;
+extern INSTANCE unsigned int joywait;
 
 #endif
@@ -30,9 +30,9 @@
 #define HR_SCREENWIDTH 640
 #define HR_SCREENHEIGHT 480
 
-static SDL_Window *hr_screen = NULL;
-static SDL_Surface *hr_surface = NULL;
-static const char *window_title = "";
+static INSTANCE SDL_Window *hr_screen = NULL;
+static INSTANCE SDL_Surface *hr_surface = NULL;
+static INSTANCE const char *window_title = "";
 
 boolean I_SetVideoModeHR(void)
 {
@@ -29,8 +29,8 @@
 #include "m_misc.h"
 #include "m_argv.h"  // haleyjd 20110212: warning fix
 
-int		myargc;
-char**		myargv;
+INSTANCE int		myargc;
+INSTANCE char**		myargv;
 
 
 
@@ -25,8 +25,8 @@
 //
 // MISC
 //
-extern  int	myargc;
-extern  char**	myargv;
+extern INSTANCE  int	myargc;
+extern INSTANCE  char**	myargv;
 
 // Returns the position of the given parameter
 // in the arg list (0 if not found).
@@ -45,14 +45,14 @@
 // Location where all configuration data is stored - 
 // default.cfg, savegames, etc.
 
-const char *configdir;
+INSTANCE const char *configdir;
 
-static char *autoload_path = "";
+static INSTANCE char *autoload_path = "";
 
 // Default filenames for configuration files.
 
-static const char *default_main_config;
-static const char *default_extra_config;
+static INSTANCE const char *default_main_config;
+static INSTANCE const char *default_extra_config;
 
 typedef enum 
 {
@@ -117,7 +117,7 @@ typedef struct
 
 //! @begin_config_file default
 
-static default_t	doom_defaults_list[] =
+static INSTANCE default_t	doom_defaults_list[] =
 {
     //!
     // Mouse sensitivity.  This value is used to multiply input mouse
@@ -681,16 +681,11 @@ static default_t	doom_defaults_list[] =
     CONFIG_VARIABLE_INT(comport),
 };
 
-static default_collection_t doom_defaults =
-{
-    doom_defaults_list,
-    arrlen(doom_defaults_list),
-    NULL,
-};
+static INSTANCE default_collection_t doom_defaults;
 
 //! @begin_config_file extended
 
-static default_t extra_defaults_list[] =
+static INSTANCE default_t extra_defaults_list[] =
 {
     //!
     // Name of the SDL video driver to use.  If this is an empty string,
@@ -988,6 +983,22 @@ static default_t extra_defaults_list[] =
 
     CONFIG_VARIABLE_STRING(player_name),
 
+    //!
+    // If non-zero, a Linux server disables Nagle's algorithm
+    // (TCP_NODELAY) on client connections, so that tics are sent as
+    // soon as they are flushed.
+    //
+
+    CONFIG_VARIABLE_INT(net_tcp_nodelay),
+
+    //!
+    // If non-zero, a Linux server corks client connections
+    // (TCP_CORK), so that all the packets sent to a client in one
+    // server pass go out in as few TCP segments as possible.
+    //
+
+    CONFIG_VARIABLE_INT(net_tcp_cork),
+
     //!
     // If this is non-zero, the mouse will be "grabbed" when running
     // in windowed mode so that it can be used as an input device.
@@ -1689,12 +1700,7 @@ static default_t extra_defaults_list[] =
 
 };
 
-static default_collection_t extra_defaults =
-{
-    extra_defaults_list,
-    arrlen(extra_defaults_list),
-    NULL,
-};
+static INSTANCE default_collection_t extra_defaults;
 
 // Search a collection for a variable
 
@@ -1971,6 +1977,14 @@ void M_SetConfigFilenames(const char *main_config, const char *extra_config)
 {
     default_main_config = main_config;
     default_extra_config = extra_config;
+
+    // Not set up statically, as each match in the server build has
+    // its own copy of the lists (see INSTANCE in doomtype.h).
+
+    doom_defaults.defaults = doom_defaults_list;
+    doom_defaults.numdefaults = arrlen(doom_defaults_list);
+    extra_defaults.defaults = extra_defaults_list;
+    extra_defaults.numdefaults = arrlen(extra_defaults_list);
 }
 
 //
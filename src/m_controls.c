@@ -26,48 +26,48 @@
 // Keyboard controls
 //
 
-int key_right = KEY_RIGHTARROW;
-int key_left = KEY_LEFTARROW;
-
-int key_up = KEY_UPARROW;
-int key_down = KEY_DOWNARROW; 
-int key_strafeleft = ',';
-int key_straferight = '.';
-int key_fire = KEY_RCTRL;
-int key_use = ' ';
-int key_strafe = KEY_RALT;
-int key_speed = KEY_RSHIFT; 
+INSTANCE int key_right = KEY_RIGHTARROW;
+INSTANCE int key_left = KEY_LEFTARROW;
+
+INSTANCE int key_up = KEY_UPARROW;
+INSTANCE int key_down = KEY_DOWNARROW; 
+INSTANCE int key_strafeleft = ',';
+INSTANCE int key_straferight = '.';
+INSTANCE int key_fire = KEY_RCTRL;
+INSTANCE int key_use = ' ';
+INSTANCE int key_strafe = KEY_RALT;
+INSTANCE int key_speed = KEY_RSHIFT; 
 
 // 
 // Heretic keyboard controls
 //
  
-int key_flyup = KEY_PGUP;
-int key_flydown = KEY_INS;
-int key_flycenter = KEY_HOME;
+INSTANCE int key_flyup = KEY_PGUP;
+INSTANCE int key_flydown = KEY_INS;
+INSTANCE int key_flycenter = KEY_HOME;
 
-int key_lookup = KEY_PGDN;
-int key_lookdown = KEY_DEL;
-int key_lookcenter = KEY_END;
+INSTANCE int key_lookup = KEY_PGDN;
+INSTANCE int key_lookdown = KEY_DEL;
+INSTANCE int key_lookcenter = KEY_END;
 
-int key_invleft = '[';
-int key_invright = ']';
-int key_useartifact = KEY_ENTER;
+INSTANCE int key_invleft = '[';
+INSTANCE int key_invright = ']';
+INSTANCE int key_useartifact = KEY_ENTER;
 
 //
 // Hexen key controls
 //
 
-int key_jump = '/';
+INSTANCE int key_jump = '/';
 
-int key_arti_all             = KEY_BACKSPACE;
-int key_arti_health          = '\\';
-int key_arti_poisonbag       = '0';
-int key_arti_blastradius     = '9';
-int key_arti_teleport        = '8';
-int key_arti_teleportother   = '7';
-int key_arti_egg             = '6';
-int key_arti_invulnerability = '5';
+INSTANCE int key_arti_all             = KEY_BACKSPACE;
+INSTANCE int key_arti_health          = '\\';
+INSTANCE int key_arti_poisonbag       = '0';
+INSTANCE int key_arti_blastradius     = '9';
+INSTANCE int key_arti_teleport        = '8';
+INSTANCE int key_arti_teleportother   = '7';
+INSTANCE int key_arti_egg             = '6';
+INSTANCE int key_arti_invulnerability = '5';
 
 //
 // Strife key controls
@@ -78,126 +78,126 @@ int key_arti_invulnerability = '5';
 // Note: Strife also uses key_invleft, key_invright, key_jump, key_lookup, and
 // key_lookdown, but with different default values.
 
-int key_usehealth = 'h';
-int key_invquery  = 'q';
-int key_mission   = 'w';
-int key_invpop    = 'z';
-int key_invkey    = 'k';
-int key_invhome   = KEY_HOME;
-int key_invend    = KEY_END;
-int key_invuse    = KEY_ENTER;
-int key_invdrop   = KEY_BACKSPACE;
+INSTANCE int key_usehealth = 'h';
+INSTANCE int key_invquery  = 'q';
+INSTANCE int key_mission   = 'w';
+INSTANCE int key_invpop    = 'z';
+INSTANCE int key_invkey    = 'k';
+INSTANCE int key_invhome   = KEY_HOME;
+INSTANCE int key_invend    = KEY_END;
+INSTANCE int key_invuse    = KEY_ENTER;
+INSTANCE int key_invdrop   = KEY_BACKSPACE;
 
 
 //
 // Mouse controls
 //
 
-int mousebfire = 0;
-int mousebstrafe = 1;
-int mousebforward = 2;
+INSTANCE int mousebfire = 0;
+INSTANCE int mousebstrafe = 1;
+INSTANCE int mousebforward = 2;
 
-int mousebjump = -1;
+INSTANCE int mousebjump = -1;
 
-int mousebstrafeleft = -1;
-int mousebstraferight = -1;
-int mousebbackward = -1;
-int mousebuse = -1;
+INSTANCE int mousebstrafeleft = -1;
+INSTANCE int mousebstraferight = -1;
+INSTANCE int mousebbackward = -1;
+INSTANCE int mousebuse = -1;
 
-int mousebprevweapon = -1;
-int mousebnextweapon = -1;
+INSTANCE int mousebprevweapon = -1;
+INSTANCE int mousebnextweapon = -1;
 
 
-int key_message_refresh = KEY_ENTER;
-int key_pause = KEY_PAUSE;
-int key_demo_quit = 'q';
-int key_spy = KEY_F12;
+INSTANCE int key_message_refresh = KEY_ENTER;
+INSTANCE int key_pause = KEY_PAUSE;
+INSTANCE int key_demo_quit = 'q';
+INSTANCE int key_spy = KEY_F12;
 
 // Multiplayer chat keys:
 
-int key_multi_msg = 't';
-int key_multi_msgplayer[32]; // MAXPLAYERS!!!
+INSTANCE int key_multi_msg = 't';
+INSTANCE int key_multi_msgplayer[32]; // MAXPLAYERS!!!
 
 // Weapon selection keys:
 
-int key_weapon1 = '1';
-int key_weapon2 = '2';
-int key_weapon3 = '3';
-int key_weapon4 = '4';
-int key_weapon5 = '5';
-int key_weapon6 = '6';
-int key_weapon7 = '7';
-int key_weapon8 = '8';
-int key_prevweapon = 0;
-int key_nextweapon = 0;
+INSTANCE int key_weapon1 = '1';
+INSTANCE int key_weapon2 = '2';
+INSTANCE int key_weapon3 = '3';
+INSTANCE int key_weapon4 = '4';
+INSTANCE int key_weapon5 = '5';
+INSTANCE int key_weapon6 = '6';
+INSTANCE int key_weapon7 = '7';
+INSTANCE int key_weapon8 = '8';
+INSTANCE int key_prevweapon = 0;
+INSTANCE int key_nextweapon = 0;
 
 // Map control keys:
 
-int key_map_north     = KEY_UPARROW;
-int key_map_south     = KEY_DOWNARROW;
-int key_map_east      = KEY_RIGHTARROW;
-int key_map_west      = KEY_LEFTARROW;
-int key_map_zoomin    = '=';
-int key_map_zoomout   = '-';
-int key_map_toggle    = KEY_TAB;
-int key_map_maxzoom   = '0';
-int key_map_follow    = 'f';
-int key_map_grid      = 'g';
-int key_map_mark      = 'm';
-int key_map_clearmark = 'c';
+INSTANCE int key_map_north     = KEY_UPARROW;
+INSTANCE int key_map_south     = KEY_DOWNARROW;
+INSTANCE int key_map_east      = KEY_RIGHTARROW;
+INSTANCE int key_map_west      = KEY_LEFTARROW;
+INSTANCE int key_map_zoomin    = '=';
+INSTANCE int key_map_zoomout   = '-';
+INSTANCE int key_map_toggle    = KEY_TAB;
+INSTANCE int key_map_maxzoom   = '0';
+INSTANCE int key_map_follow    = 'f';
+INSTANCE int key_map_grid      = 'g';
+INSTANCE int key_map_mark      = 'm';
+INSTANCE int key_map_clearmark = 'c';
 
 // menu keys:
 
-int key_menu_activate  = KEY_ESCAPE;
-int key_menu_up        = KEY_UPARROW;
-int key_menu_down      = KEY_DOWNARROW;
-int key_menu_left      = KEY_LEFTARROW;
-int key_menu_right     = KEY_RIGHTARROW;
-int key_menu_back      = KEY_BACKSPACE;
-int key_menu_forward   = KEY_ENTER;
-int key_menu_confirm   = 'y';
-int key_menu_abort     = 'n';
-
-int key_menu_help      = KEY_F1;
-int key_menu_save      = KEY_F2;
-int key_menu_load      = KEY_F3;
-int key_menu_volume    = KEY_F4;
-int key_menu_detail    = KEY_F5;
-int key_menu_qsave     = KEY_F6;
-int key_menu_endgame   = KEY_F7;
-int key_menu_messages  = KEY_F8;
-int key_menu_qload     = KEY_F9;
-int key_menu_quit      = KEY_F10;
-int key_menu_gamma     = KEY_F11;
-
-int key_menu_incscreen = KEY_EQUALS;
-int key_menu_decscreen = KEY_MINUS;
-int key_menu_screenshot = 0;
+INSTANCE int key_menu_activate  = KEY_ESCAPE;
+INSTANCE int key_menu_up        = KEY_UPARROW;
+INSTANCE int key_menu_down      = KEY_DOWNARROW;
+INSTANCE int key_menu_left      = KEY_LEFTARROW;
+INSTANCE int key_menu_right     = KEY_RIGHTARROW;
+INSTANCE int key_menu_back      = KEY_BACKSPACE;
+INSTANCE int key_menu_forward   = KEY_ENTER;
+INSTANCE int key_menu_confirm   = 'y';
+INSTANCE int key_menu_abort     = 'n';
+
+INSTANCE int key_menu_help      = KEY_F1;
+INSTANCE int key_menu_save      = KEY_F2;
+INSTANCE int key_menu_load      = KEY_F3;
+INSTANCE int key_menu_volume    = KEY_F4;
+INSTANCE int key_menu_detail    = KEY_F5;
+INSTANCE int key_menu_qsave     = KEY_F6;
+INSTANCE int key_menu_endgame   = KEY_F7;
+INSTANCE int key_menu_messages  = KEY_F8;
+INSTANCE int key_menu_qload     = KEY_F9;
+INSTANCE int key_menu_quit      = KEY_F10;
+INSTANCE int key_menu_gamma     = KEY_F11;
+
+INSTANCE int key_menu_incscreen = KEY_EQUALS;
+INSTANCE int key_menu_decscreen = KEY_MINUS;
+INSTANCE int key_menu_screenshot = 0;
 
 //
 // Joystick controls
 //
 
-int joybfire = 0;
-int joybstrafe = 1;
-int joybuse = 3;
-int joybspeed = 2;
+INSTANCE int joybfire = 0;
+INSTANCE int joybstrafe = 1;
+INSTANCE int joybuse = 3;
+INSTANCE int joybspeed = 2;
 
-int joybstrafeleft = -1;
-int joybstraferight = -1;
+INSTANCE int joybstrafeleft = -1;
+INSTANCE int joybstraferight = -1;
 
-int joybjump = -1;
+INSTANCE int joybjump = -1;
 
-int joybprevweapon = -1;
-int joybnextweapon = -1;
+INSTANCE int joybprevweapon = -1;
+INSTANCE int joybnextweapon = -1;
 
-int joybmenu = -1;
-int joybautomap = -1;
+INSTANCE int joybmenu = -1;
+INSTANCE int joybautomap = -1;
 
 // Control whether if a mouse button is double clicked, it acts like 
 // "use" has been pressed
 
-int dclick_use = 1;
+INSTANCE int dclick_use = 1;
  
 // 
 // Bind all of the common controls used by Doom and all other games.
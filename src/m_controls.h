@@ -17,142 +17,142 @@
 #ifndef __M_CONTROLS_H__
 #define __M_CONTROLS_H__
  
-extern int key_right;
-extern int key_left;
-
-extern int key_up;
-extern int key_down;
-extern int key_strafeleft;
-extern int key_straferight;
-extern int key_fire;
-extern int key_use;
-extern int key_strafe;
-extern int key_speed;
-
-extern int key_jump;
+extern INSTANCE int key_right;
+extern INSTANCE int key_left;
+
+extern INSTANCE int key_up;
+extern INSTANCE int key_down;
+extern INSTANCE int key_strafeleft;
+extern INSTANCE int key_straferight;
+extern INSTANCE int key_fire;
+extern INSTANCE int key_use;
+extern INSTANCE int key_strafe;
+extern INSTANCE int key_speed;
+
+extern INSTANCE int key_jump;
  
-extern int key_flyup;
-extern int key_flydown;
-extern int key_flycenter;
-extern int key_lookup;
-extern int key_lookdown;
-extern int key_lookcenter;
-extern int key_invleft;
-extern int key_invright;
-extern int key_useartifact;
+extern INSTANCE int key_flyup;
+extern INSTANCE int key_flydown;
+extern INSTANCE int key_flycenter;
+extern INSTANCE int key_lookup;
+extern INSTANCE int key_lookdown;
+extern INSTANCE int key_lookcenter;
+extern INSTANCE int key_invleft;
+extern INSTANCE int key_invright;
+extern INSTANCE int key_useartifact;
 
 // villsa [STRIFE] strife keys
-extern int key_usehealth;
-extern int key_invquery;
-extern int key_mission;
-extern int key_invpop;
-extern int key_invkey;
-extern int key_invhome;
-extern int key_invend;
-extern int key_invuse;
-extern int key_invdrop;
-
-extern int key_message_refresh;
-extern int key_pause;
-
-extern int key_multi_msg;
-extern int key_multi_msgplayer[32]; // MAXPLAYERS!!!
-
-extern int key_weapon1;
-extern int key_weapon2;
-extern int key_weapon3;
-extern int key_weapon4;
-extern int key_weapon5;
-extern int key_weapon6;
-extern int key_weapon7;
-extern int key_weapon8;
-
-extern int key_arti_all;
-extern int key_arti_health;
-extern int key_arti_poisonbag;
-extern int key_arti_blastradius;
-extern int key_arti_teleport;
-extern int key_arti_teleportother;
-extern int key_arti_egg;
-extern int key_arti_invulnerability;
-
-extern int key_demo_quit;
-extern int key_spy;
-extern int key_prevweapon;
-extern int key_nextweapon;
-
-extern int key_map_north;
-extern int key_map_south;
-extern int key_map_east;
-extern int key_map_west;
-extern int key_map_zoomin;
-extern int key_map_zoomout;
-extern int key_map_toggle;
-extern int key_map_maxzoom;
-extern int key_map_follow;
-extern int key_map_grid;
-extern int key_map_mark;
-extern int key_map_clearmark;
+extern INSTANCE int key_usehealth;
+extern INSTANCE int key_invquery;
+extern INSTANCE int key_mission;
+extern INSTANCE int key_invpop;
+extern INSTANCE int key_invkey;
+extern INSTANCE int key_invhome;
+extern INSTANCE int key_invend;
+extern INSTANCE int key_invuse;
+extern INSTANCE int key_invdrop;
+
+extern INSTANCE int key_message_refresh;
+extern INSTANCE int key_pause;
+
+extern INSTANCE int key_multi_msg;
+extern INSTANCE int key_multi_msgplayer[32]; // MAXPLAYERS!!!
+
+extern INSTANCE int key_weapon1;
+extern INSTANCE int key_weapon2;
+extern INSTANCE int key_weapon3;
+extern INSTANCE int key_weapon4;
+extern INSTANCE int key_weapon5;
+extern INSTANCE int key_weapon6;
+extern INSTANCE int key_weapon7;
+extern INSTANCE int key_weapon8;
+
+extern INSTANCE int key_arti_all;
+extern INSTANCE int key_arti_health;
+extern INSTANCE int key_arti_poisonbag;
+extern INSTANCE int key_arti_blastradius;
+extern INSTANCE int key_arti_teleport;
+extern INSTANCE int key_arti_teleportother;
+extern INSTANCE int key_arti_egg;
+extern INSTANCE int key_arti_invulnerability;
+
+extern INSTANCE int key_demo_quit;
+extern INSTANCE int key_spy;
+extern INSTANCE int key_prevweapon;
+extern INSTANCE int key_nextweapon;
+
+extern INSTANCE int key_map_north;
+extern INSTANCE int key_map_south;
+extern INSTANCE int key_map_east;
+extern INSTANCE int key_map_west;
+extern INSTANCE int key_map_zoomin;
+extern INSTANCE int key_map_zoomout;
+extern INSTANCE int key_map_toggle;
+extern INSTANCE int key_map_maxzoom;
+extern INSTANCE int key_map_follow;
+extern INSTANCE int key_map_grid;
+extern INSTANCE int key_map_mark;
+extern INSTANCE int key_map_clearmark;
 
 // menu keys:
 
-extern int key_menu_activate;
-extern int key_menu_up;
-extern int key_menu_down;
-extern int key_menu_left;
-extern int key_menu_right;
-extern int key_menu_back;
-extern int key_menu_forward;
-extern int key_menu_confirm;
-extern int key_menu_abort;
-
-extern int key_menu_help;
-extern int key_menu_save;
-extern int key_menu_load;
-extern int key_menu_volume;
-extern int key_menu_detail;
-extern int key_menu_qsave;
-extern int key_menu_endgame;
-extern int key_menu_messages;
-extern int key_menu_qload;
-extern int key_menu_quit;
-extern int key_menu_gamma;
-
-extern int key_menu_incscreen;
-extern int key_menu_decscreen;
-extern int key_menu_screenshot;
-
-extern int mousebfire;
-extern int mousebstrafe;
-extern int mousebforward;
-
-extern int mousebjump;
-
-extern int mousebstrafeleft;
-extern int mousebstraferight;
-extern int mousebbackward;
-extern int mousebuse;
-
-extern int mousebprevweapon;
-extern int mousebnextweapon;
-
-extern int joybfire;
-extern int joybstrafe;
-extern int joybuse;
-extern int joybspeed;
-
-extern int joybjump;
-
-extern int joybstrafeleft;
-extern int joybstraferight;
-
-extern int joybprevweapon;
-extern int joybnextweapon;
-
-extern int joybmenu;
-extern int joybautomap;
-
-extern int dclick_use;
+extern INSTANCE int key_menu_activate;
+extern INSTANCE int key_menu_up;
+extern INSTANCE int key_menu_down;
+extern INSTANCE int key_menu_left;
+extern INSTANCE int key_menu_right;
+extern INSTANCE int key_menu_back;
+extern INSTANCE int key_menu_forward;
+extern INSTANCE int key_menu_confirm;
+extern INSTANCE int key_menu_abort;
+
+extern INSTANCE int key_menu_help;
+extern INSTANCE int key_menu_save;
+extern INSTANCE int key_menu_load;
+extern INSTANCE int key_menu_volume;
+extern INSTANCE int key_menu_detail;
+extern INSTANCE int key_menu_qsave;
+extern INSTANCE int key_menu_endgame;
+extern INSTANCE int key_menu_messages;
+extern INSTANCE int key_menu_qload;
+extern INSTANCE int key_menu_quit;
+extern INSTANCE int key_menu_gamma;
+
+extern INSTANCE int key_menu_incscreen;
+extern INSTANCE int key_menu_decscreen;
+extern INSTANCE int key_menu_screenshot;
+
+extern INSTANCE int mousebfire;
+extern INSTANCE int mousebstrafe;
+extern INSTANCE int mousebforward;
+
+extern INSTANCE int mousebjump;
+
+extern INSTANCE int mousebstrafeleft;
+extern INSTANCE int mousebstraferight;
+extern INSTANCE int mousebbackward;
+extern INSTANCE int mousebuse;
+
+extern INSTANCE int mousebprevweapon;
+extern INSTANCE int mousebnextweapon;
+
+extern INSTANCE int joybfire;
+extern INSTANCE int joybstrafe;
+extern INSTANCE int joybuse;
+extern INSTANCE int joybspeed;
+
+extern INSTANCE int joybjump;
+
+extern INSTANCE int joybstrafeleft;
+extern INSTANCE int joybstraferight;
+
+extern INSTANCE int joybprevweapon;
+extern INSTANCE int joybnextweapon;
+
+extern INSTANCE int joybmenu;
+extern INSTANCE int joybautomap;
+
+extern INSTANCE int dclick_use;
 
 void M_BindBaseControls(void);
 void M_BindHereticControls(void);
@@ -32,11 +32,13 @@
 #include "net_client.h"
 #include "net_common.h"
 #include "net_defs.h"
+#include "net_epoll.h"
 #include "net_gui.h"
 #include "net_io.h"
 #include "net_packet.h"
 #include "net_query.h"
 #include "net_server.h"
+#include "net_snapshot.h"
 #include "net_structrw.h"
 #include "net_petname.h"
 #include "w_checksum.h"
@@ -94,81 +96,102 @@ typedef struct
 
     unsigned int time;
 
+    // Last time this tic was resent because the server was missing it
+
+    unsigned int resend_time;
+
     // Ticcmd diff
 
     net_ticdiff_t cmd;
 } net_server_send_t;
 
-extern fixed_t offsetms;
+extern INSTANCE fixed_t offsetms;
 
-static net_connection_t client_connection;
-static net_clientstate_t client_state;
-static net_addr_t *server_addr;
-static net_context_t *client_context;
+static INSTANCE net_connection_t client_connection;
+static INSTANCE net_clientstate_t client_state;
+static INSTANCE net_addr_t *server_addr;
+static INSTANCE net_context_t *client_context;
 
 // game settings, as received from the server when the game started
 
-static net_gamesettings_t settings;
+static INSTANCE net_gamesettings_t settings;
 
 // Why did the server reject us?
-char *net_client_reject_reason = NULL;
+INSTANCE char *net_client_reject_reason = NULL;
 
 // true if the client code is in use
 
-boolean net_client_connected;
+INSTANCE boolean net_client_connected;
 
 // true if we have received waiting data from the server,
 // and the wait data that was received.
 
-boolean net_client_received_wait_data;
-net_waitdata_t net_client_wait_data;
+INSTANCE boolean net_client_received_wait_data;
+INSTANCE net_waitdata_t net_client_wait_data;
 
 // Waiting at the initial wait screen for the game to be launched?
 
-boolean net_waiting_for_launch = false;
+INSTANCE boolean net_waiting_for_launch = false;
 
 // Name that we send to the server
 
-char *net_player_name = NULL;
+INSTANCE char *net_player_name = NULL;
 
 // Connected but not participating in the game (observer)
 
-boolean drone = false;
+INSTANCE boolean drone = false;
 
 // The last ticcmd constructed
 
-static ticcmd_t last_ticcmd;
+static INSTANCE ticcmd_t last_ticcmd;
 
 // Buffer of ticcmd diffs being sent to the server
 
-static net_server_send_t send_queue[BACKUPTICS];
+static INSTANCE net_server_send_t send_queue[BACKUPTICS];
+static INSTANCE unsigned int send_queue_latest;
 
 // Receive window
 
-static ticcmd_t recvwindow_cmd_base[NET_MAXPLAYERS];
-static int recvwindow_start;
-static net_server_recv_t recvwindow[BACKUPTICS];
+static INSTANCE ticcmd_t recvwindow_cmd_base[NET_MAXPLAYERS];
+static INSTANCE int recvwindow_start;
+static INSTANCE net_server_recv_t recvwindow[BACKUPTICS];
 
 // Whether we need to send an acknowledgement and
 // when gamedata was last received.
 
-static boolean need_to_acknowledge;
-static unsigned int gamedata_recv_time;
+static INSTANCE boolean need_to_acknowledge;
+static INSTANCE unsigned int gamedata_recv_time;
 
 // The latency (time between when we sent our command and we got all
 // the other players' commands from the server) for the last tic we
 // received. We include this latency in tics we send to the server so
 // that they can adjust to us.
-static int last_latency;
+static INSTANCE int last_latency;
+
+// If we joined a game that was already in progress, the first tic we
+// play in.  Zero otherwise.
+
+static INSTANCE unsigned int join_tic;
+
+// Snapshot of the game we are joining, as it arrives.
+
+static INSTANCE net_snapshot_recv_t snapshot_in;
+
+// A snapshot of our own game, requested by the server so that someone
+// else can join, and the tic it is to be taken at.
+
+static INSTANCE boolean snapshot_requested;
+static INSTANCE unsigned int snapshot_request_tic;
+static INSTANCE net_snapshot_send_t snapshot_out;
 
 // Hash checksums of our wad directory and dehacked data.
 
-sha1_digest_t net_local_wad_sha1sum;
-sha1_digest_t net_local_deh_sha1sum;
+INSTANCE sha1_digest_t net_local_wad_sha1sum;
+INSTANCE sha1_digest_t net_local_deh_sha1sum;
 
 // Are we playing with the freedoom IWAD?
 
-unsigned int net_local_is_freedoom;
+INSTANCE unsigned int net_local_is_freedoom;
 
 #define NET_CL_ExpandTicNum(b) NET_ExpandTicNum(recvwindow_start, (b))
 
@@ -185,7 +208,7 @@ static void NET_CL_Disconnected(void)
 static void UpdateClockSync(unsigned int seq,
                             unsigned int remote_latency)
 {
-    static int last_error, cumul_error;
+    static INSTANCE int last_error, cumul_error;
     int latency, error;
 
     if (seq == send_queue[seq % BACKUPTICS].seq)
@@ -236,13 +259,12 @@ static void NET_CL_ExpandFullTiccmd(net_full_ticcmd_t *cmd, unsigned int seq,
 
     // Expand tic diffs for all players
     
+    // Our own ticcmd is normally left out.  If the server sends it, it
+    // may have been made up by the server (see -straggler), and the
+    // local one is replaced by it in D_ReceiveTic.
+
     for (i=0; i<NET_MAXPLAYERS; ++i)
     {
-        if (i == settings.consoleplayer && !drone)
-        {
-            continue;
-        }
-        
         if (cmd->playeringame[i])
         {
             net_ticdiff_t *diff;
@@ -298,6 +320,10 @@ static void NET_CL_Shutdown(void)
 
         NET_ReleaseAddress(server_addr);
 
+        NET_Snapshot_FreeRecv(&snapshot_in);
+        NET_Snapshot_FreeSend(&snapshot_out);
+        snapshot_requested = false;
+
         // Shut down network module, etc.  To do.
     }
 }
@@ -323,15 +349,45 @@ void NET_CL_StartGame(net_gamesettings_t *settings)
     NET_WriteSettings(packet, settings);
 }
 
-static void NET_CL_SendGameDataACK(void)
+// Bitmap of the tics received, starting from the start of the
+// receive window.
+
+static uint64_t NET_CL_ReceivedBitmap(void)
+{
+    uint64_t result;
+    int i;
+
+    result = 0;
+
+    for (i=0; i<NET_SACK_TICS; ++i)
+    {
+        if (recvwindow[i].active)
+        {
+            result |= (uint64_t) 1 << i;
+        }
+    }
+
+    return result;
+}
+
+// Acknowledge the tics received so far.  With the SACK protocol, the
+// server also resends any of the first num_tics tics in the receive
+// window that we are missing.
+
+static void NET_CL_SendGameDataACK(unsigned int num_tics)
 {
     net_packet_t *packet;
 
-    packet = NET_NewPacket(10);
+    packet = NET_NewPacket(20);
 
     NET_WriteInt16(packet, NET_PACKET_TYPE_GAMEDATA_ACK);
     NET_WriteInt8(packet, recvwindow_start & 0xff);
 
+    if (client_connection.protocol >= NET_PROTOCOL_SACK_0)
+    {
+        NET_WriteSACK(packet, NET_CL_ReceivedBitmap(), num_tics);
+    }
+
     NET_Conn_SendPacket(&client_connection, packet);
 
     NET_FreePacket(packet);
@@ -342,6 +398,7 @@ static void NET_CL_SendGameDataACK(void)
 static void NET_CL_SendTics(int start, int end)
 {
     net_packet_t *packet;
+    net_bitstream_t stream;
     int i;
 
     if (!net_client_connected)
@@ -351,8 +408,8 @@ static void NET_CL_SendTics(int start, int end)
         return;
     }
 
-    if (start < 0)
-        start = 0;
+    if (start < (int) join_tic)
+        start = join_tic;
     
     // Build a new packet to send to the server
 
@@ -366,17 +423,34 @@ static void NET_CL_SendTics(int start, int end)
     NET_WriteInt8(packet, start & 0xff);
     NET_WriteInt8(packet, end - start + 1);
 
-    // Add the tics.
+    // Add the tics.  With the packed protocol, the latency (which is
+    // the same for every tic) is only sent once.
 
-    for (i=start; i<=end; ++i)
+    if (client_connection.protocol >= NET_PROTOCOL_PACKED_TICCMDS_0)
     {
-        net_server_send_t *sendobj;
+        NET_BitWriterInit(&stream, packet);
+        NET_WriteVarSInt(&stream, last_latency, PACKED_LATENCY_K);
 
-        sendobj = &send_queue[i % BACKUPTICS];
+        for (i=start; i<=end; ++i)
+        {
+            NET_WritePackedTiccmdDiff(&stream, &send_queue[i % BACKUPTICS].cmd,
+                                      settings.lowres_turn);
+        }
+
+        NET_BitWriterFinish(&stream);
+    }
+    else
+    {
+        for (i=start; i<=end; ++i)
+        {
+            net_server_send_t *sendobj;
+
+            sendobj = &send_queue[i % BACKUPTICS];
 
-        NET_WriteInt16(packet, last_latency);
+            NET_WriteInt16(packet, last_latency);
 
-        NET_WriteTiccmdDiff(packet, &sendobj->cmd, settings.lowres_turn);
+            NET_WriteTiccmdDiff(packet, &sendobj->cmd, settings.lowres_turn);
+        }
     }
     
     // Send the packet
@@ -410,7 +484,9 @@ void NET_CL_SendTiccmd(ticcmd_t *ticcmd, int maketic)
     sendobj->active = true;
     sendobj->seq = maketic;
     sendobj->time = I_GetTimeMS();
+    sendobj->resend_time = 0;
     sendobj->cmd = diff;
+    send_queue_latest = maketic;
 
     last_ticcmd = *ticcmd;
 
@@ -419,8 +495,8 @@ void NET_CL_SendTiccmd(ticcmd_t *ticcmd, int maketic)
     starttic = maketic - settings.extratics;
     endtic = maketic;
 
-    if (starttic < 0)
-        starttic = 0;
+    if (starttic < (int) join_tic)
+        starttic = join_tic;
 
     NET_Log("client: generated tic %d, sending %d-%d",
             maketic, starttic, endtic);
@@ -560,6 +636,51 @@ static void NET_CL_ParseLaunch(net_packet_t *packet)
     NET_Log("client: now waiting for game start");
 }
 
+// Check the settings received from the server are sane.
+
+static boolean NET_CL_ValidSettings(void)
+{
+    if (settings.num_players > NET_MAXPLAYERS
+     || settings.consoleplayer >= (signed int) settings.num_players)
+    {
+        // insane values
+        NET_Log("client: error: bad settings, num_players=%d, consoleplayer=%d",
+                settings.num_players, settings.consoleplayer);
+        return false;
+    }
+
+    if ((drone && settings.consoleplayer >= 0)
+     || (!drone && settings.consoleplayer < 0))
+    {
+        // Invalid player number: must be positive for real players,
+        // negative for drones
+        NET_Log("client: error: mismatch: drone=%d, consoleplayer=%d",
+                drone, settings.consoleplayer);
+        return false;
+    }
+
+    return true;
+}
+
+// Begin playing the game, starting from the given tic.
+
+static void NET_CL_BeginGame(unsigned int start_tic)
+{
+    NET_Log("client: beginning game state at tic %d", start_tic);
+    client_state = CLIENT_STATE_IN_GAME;
+
+    // Clear the receive window
+
+    memset(recvwindow, 0, sizeof(recvwindow));
+    recvwindow_start = start_tic;
+    memset(&recvwindow_cmd_base, 0, sizeof(recvwindow_cmd_base));
+
+    // Clear the send queue
+
+    memset(&send_queue, 0x00, sizeof(send_queue));
+    send_queue_latest = start_tic;
+}
+
 static void NET_CL_ParseGameStart(net_packet_t *packet)
 {
     NET_Log("client: processing game start packet");
@@ -577,37 +698,68 @@ static void NET_CL_ParseGameStart(net_packet_t *packet)
         return;
     }
 
-    if (settings.num_players > NET_MAXPLAYERS
-     || settings.consoleplayer >= (signed int) settings.num_players)
+    if (!NET_CL_ValidSettings())
     {
-        // insane values
-        NET_Log("client: error: bad settings, num_players=%d, consoleplayer=%d",
-                settings.num_players, settings.consoleplayer);
         return;
     }
 
-    if ((drone && settings.consoleplayer >= 0)
-     || (!drone && settings.consoleplayer < 0))
+    NET_CL_BeginGame(0);
+}
+
+// The server has let us into a game already in progress.  This takes
+// the place of the launch and game start packets; the game itself
+// follows as a snapshot (see NET_CL_GetSnapshot).
+
+static void NET_CL_ParseGameJoin(net_packet_t *packet)
+{
+    unsigned int tic;
+
+    NET_Log("client: processing game join packet");
+
+    if (!NET_ReadInt32(packet, &tic)
+     || !NET_ReadSettings(packet, &settings))
     {
-        // Invalid player number: must be positive for real players,
-        // negative for drones
-        NET_Log("client: error: mismatch: drone=%d, consoleplayer=%d",
-                drone, settings.consoleplayer);
+        NET_Log("client: error: failed to read join tic and settings");
         return;
     }
 
-    NET_Log("client: beginning game state");
-    client_state = CLIENT_STATE_IN_GAME;
+    if (client_state != CLIENT_STATE_WAITING_LAUNCH
+     && client_state != CLIENT_STATE_WAITING_START)
+    {
+        NET_Log("client: error: can't join game, client_state=%d",
+                client_state);
+        return;
+    }
 
-    // Clear the receive window
+    if (tic == 0 || !NET_CL_ValidSettings())
+    {
+        return;
+    }
 
-    memset(recvwindow, 0, sizeof(recvwindow));
-    recvwindow_start = 0;
-    memset(&recvwindow_cmd_base, 0, sizeof(recvwindow_cmd_base));
+    join_tic = tic;
+    memset(&last_ticcmd, 0, sizeof(ticcmd_t));
+    NET_CL_BeginGame(tic);
+}
 
-    // Clear the send queue
+// The server wants a snapshot of our game for someone who is joining.
 
-    memset(&send_queue, 0x00, sizeof(send_queue));
+static void NET_CL_ParseSnapshotRequest(net_packet_t *packet)
+{
+    unsigned int tic;
+
+    if (!NET_ReadInt32(packet, &tic))
+    {
+        return;
+    }
+
+    if (client_state != CLIENT_STATE_IN_GAME || drone)
+    {
+        return;
+    }
+
+    NET_Log("client: server wants a snapshot at tic %d", tic);
+    snapshot_requested = true;
+    snapshot_request_tic = tic;
 }
 
 static void NET_CL_SendResendRequest(int start, int end)
@@ -617,13 +769,28 @@ static void NET_CL_SendResendRequest(int start, int end)
     int i;
 
     //printf("CL: Send resend %i-%i\n", start, end);
-    
-    packet = NET_NewPacket(64);
-    NET_WriteInt16(packet, NET_PACKET_TYPE_GAMEDATA_RESEND);
-    NET_WriteInt32(packet, start);
-    NET_WriteInt8(packet, end - start + 1);
-    NET_Conn_SendPacket(&client_connection, packet);
-    NET_FreePacket(packet);
+
+    // With the SACK protocol, the server is told which tics we have
+    // and fills in the gaps up to the end of the range.
+
+    if (client_connection.protocol >= NET_PROTOCOL_SACK_0)
+    {
+        if (end - recvwindow_start >= NET_SACK_TICS)
+        {
+            end = recvwindow_start + NET_SACK_TICS - 1;
+        }
+
+        NET_CL_SendGameDataACK(end - recvwindow_start + 1);
+    }
+    else
+    {
+        packet = NET_NewPacket(64);
+        NET_WriteInt16(packet, NET_PACKET_TYPE_GAMEDATA_RESEND);
+        NET_WriteInt32(packet, start);
+        NET_WriteInt8(packet, end - start + 1);
+        NET_Conn_SendPacket(&client_connection, packet);
+        NET_FreePacket(packet);
+    }
 
     nowtime = I_GetTimeMS();
 
@@ -650,10 +817,16 @@ static void NET_CL_CheckResends(void)
     int resend_start, resend_end;
     unsigned int nowtime;
     boolean maybe_deadlocked;
+    boolean sack;
 
     nowtime = I_GetTimeMS();
     maybe_deadlocked = nowtime - gamedata_recv_time > 1000;
 
+    // With the SACK protocol, one request covers all the runs of
+    // missing tics, as the server only resends the ones we don't have.
+
+    sack = client_connection.protocol >= NET_PROTOCOL_SACK_0;
+
     resend_start = -1;
     resend_end = -1;
 
@@ -693,7 +866,7 @@ static void NET_CL_CheckResends(void)
 
             resend_end = i;
         }
-        else if (resend_start >= 0)
+        else if (resend_start >= 0 && !sack)
         {
             // End of a run of resend tics
             NET_Log("client: resend request timed out for %d-%d (%d)",
@@ -724,7 +897,7 @@ static void NET_CL_CheckResends(void)
     {
         NET_Log("client: no game data received since %d: triggering ack",
                 gamedata_recv_time);
-        NET_CL_SendGameDataACK();
+        NET_CL_SendGameDataACK(0);
     }
 }
 
@@ -735,6 +908,9 @@ static void NET_CL_CheckResends(void)
 static void NET_CL_ParseGameData(net_packet_t *packet)
 {
     net_server_recv_t *recvobj;
+    net_full_ticcmd_t prev_cmd;
+    net_bitstream_t stream;
+    boolean packed;
     unsigned int seq, num_tics;
     unsigned int nowtime;
     int resend_start, resend_end;
@@ -766,18 +942,35 @@ static void NET_CL_ParseGameData(net_packet_t *packet)
     seq = NET_CL_ExpandTicNum(seq);
     NET_Log("client: got game data, seq=%d, num_tics=%d", seq, num_tics);
 
+    packed = client_connection.protocol >= NET_PROTOCOL_PACKED_TICCMDS_0;
+    NET_BitReaderInit(&stream, packet);
+
     for (i=0; i<num_tics; ++i)
     {
         net_full_ticcmd_t cmd;
+        boolean ok;
 
         index = seq - recvwindow_start + i;
 
-        if (!NET_ReadFullTiccmd(packet, &cmd, settings.lowres_turn))
+        if (packed)
+        {
+            ok = NET_ReadPackedFullTiccmd(&stream, &cmd,
+                                          i > 0 ? &prev_cmd : NULL,
+                                          settings.lowres_turn);
+        }
+        else
+        {
+            ok = NET_ReadFullTiccmd(packet, &cmd, settings.lowres_turn);
+        }
+
+        if (!ok)
         {
             NET_Log("client: error: failed to read ticcmd %d", i);
             return;
         }
 
+        prev_cmd = cmd;
+
         if (index < 0 || index >= BACKUPTICS)
         {
             // Out of range of the recv window
@@ -858,9 +1051,9 @@ static void NET_CL_ParseGameData(net_packet_t *packet)
 
 static void NET_CL_ParseResendRequest(net_packet_t *packet)
 {
-    static unsigned int start;
-    static unsigned int end;
-    static unsigned int num_tics;
+    static INSTANCE unsigned int start;
+    static INSTANCE unsigned int end;
+    static INSTANCE unsigned int num_tics;
 
     NET_Log("client: processing resend request");
 
@@ -912,6 +1105,73 @@ static void NET_CL_ParseResendRequest(net_packet_t *packet)
     }
 }
 
+// Parse a selective acknowledgement from the server, and resend any
+// tics that it asks for that it has not received.
+
+static void NET_CL_ParseGameDataACK(net_packet_t *packet)
+{
+    net_server_send_t *sendobj;
+    unsigned int ackseq, num_tics;
+    unsigned int nowtime;
+    uint64_t received;
+    int resend_start;
+    unsigned int i;
+
+    NET_Log("client: processing game data ack");
+
+    if (drone || client_connection.protocol < NET_PROTOCOL_SACK_0)
+    {
+        return;
+    }
+
+    if (!NET_ReadInt8(packet, &ackseq)
+     || !NET_ReadSACK(packet, &received, &num_tics))
+    {
+        NET_Log("client: error: failed to read selective ack");
+        return;
+    }
+
+    ackseq = NET_ExpandTicNum(send_queue_latest, ackseq);
+    nowtime = I_GetTimeMS();
+    resend_start = -1;
+
+    // Resend each run of tics that the server is missing.  Tics that
+    // were only just resent are probably still on their way.
+
+    for (i=0; i<=num_tics; ++i)
+    {
+        boolean need_resend = false;
+
+        if (i < num_tics && (received & ((uint64_t) 1 << i)) == 0)
+        {
+            sendobj = &send_queue[(ackseq + i) % BACKUPTICS];
+
+            need_resend = sendobj->active
+                       && sendobj->seq == ackseq + i
+                       && (sendobj->resend_time == 0
+                        || nowtime - sendobj->resend_time
+                             >= NET_SACK_HOLDOFF);
+        }
+
+        if (need_resend)
+        {
+            send_queue[(ackseq + i) % BACKUPTICS].resend_time = nowtime;
+
+            if (resend_start < 0)
+            {
+                resend_start = i;
+            }
+        }
+        else if (resend_start >= 0)
+        {
+            NET_Log("client: resending %d-%d", ackseq + resend_start,
+                    ackseq + i - 1);
+            NET_CL_SendTics(ackseq + resend_start, ackseq + i - 1);
+            resend_start = -1;
+        }
+    }
+}
+
 // Console message that the server wants the client to print
 
 static void NET_CL_ParseConsoleMessage(net_packet_t *packet)
@@ -979,10 +1239,34 @@ static void NET_CL_ParsePacket(net_packet_t *packet)
                 NET_CL_ParseResendRequest(packet);
                 break;
 
+            case NET_PACKET_TYPE_GAMEDATA_ACK:
+                NET_CL_ParseGameDataACK(packet);
+                break;
+
             case NET_PACKET_TYPE_CONSOLE_MESSAGE:
                 NET_CL_ParseConsoleMessage(packet);
                 break;
 
+            case NET_PACKET_TYPE_GAMEJOIN:
+                NET_CL_ParseGameJoin(packet);
+                break;
+
+            case NET_PACKET_TYPE_SNAPSHOT_REQUEST:
+                NET_CL_ParseSnapshotRequest(packet);
+                break;
+
+            case NET_PACKET_TYPE_SNAPSHOT_DATA:
+                if (join_tic != 0)
+                {
+                    NET_Snapshot_ParseData(&snapshot_in, packet,
+                                           &client_connection);
+                }
+                break;
+
+            case NET_PACKET_TYPE_SNAPSHOT_ACK:
+                NET_Snapshot_ParseAck(&snapshot_out, packet);
+                break;
+
             default:
                 break;
         }
@@ -1040,6 +1324,15 @@ void NET_CL_Run(void)
         // Check if our resend requests have timed out
 
         NET_CL_CheckResends();
+
+        // Send any more of a snapshot the server asked us for
+
+        NET_Snapshot_RunSend(&snapshot_out, &client_connection);
+
+        if (NET_Snapshot_SendDone(&snapshot_out))
+        {
+            NET_Snapshot_FreeSend(&snapshot_out);
+        }
     }
 }
 
@@ -1171,6 +1464,101 @@ boolean NET_CL_GetSettings(net_gamesettings_t *_settings)
     return true;
 }
 
+// If we have joined a game in progress, get the tic we start playing
+// at.
+
+boolean NET_CL_GetJoinTic(unsigned int *tic)
+{
+    if (client_state != CLIENT_STATE_IN_GAME || join_tic == 0)
+    {
+        return false;
+    }
+
+    *tic = join_tic;
+
+    return true;
+}
+
+// Get the snapshot of the game we are joining, once it has all arrived.
+// The data is allocated with malloc(), and is NULL if the snapshot
+// could not be made or unpacked.
+
+boolean NET_CL_GetSnapshot(byte **data, size_t *len)
+{
+    byte *result;
+
+    if (!NET_Snapshot_Complete(&snapshot_in) || snapshot_in.tic != join_tic)
+    {
+        return false;
+    }
+
+    result = NULL;
+
+    if (snapshot_in.len > 0)
+    {
+        result = malloc(snapshot_in.raw_len + 1);
+
+        if (result != NULL
+         && !NET_Snapshot_Decompress(snapshot_in.data, snapshot_in.len,
+                                     result, snapshot_in.raw_len))
+        {
+            NET_Log("client: error: snapshot failed to decompress");
+            free(result);
+            result = NULL;
+        }
+    }
+
+    *data = result;
+    *len = snapshot_in.raw_len;
+
+    return true;
+}
+
+// Check if the server has asked for a snapshot of our game, and if so,
+// the tic it should be taken at.
+
+boolean NET_CL_GetSnapshotRequest(unsigned int *tic)
+{
+    if (!snapshot_requested)
+    {
+        return false;
+    }
+
+    *tic = snapshot_request_tic;
+
+    return true;
+}
+
+// Send the snapshot the server asked for.  If data is NULL, tell the
+// server that no snapshot could be made.
+
+void NET_CL_SendSnapshot(unsigned int tic, byte *data, size_t len)
+{
+    byte *compressed;
+    size_t compressed_len;
+
+    snapshot_requested = false;
+
+    if (data != NULL)
+    {
+        compressed = NET_Snapshot_Compress(data, len, &compressed_len);
+    }
+    else
+    {
+        compressed = NULL;
+    }
+
+    if (compressed == NULL)
+    {
+        NET_Log("client: can't make a snapshot for tic %d", tic);
+        compressed_len = 0;
+        len = 0;
+    }
+
+    NET_Snapshot_StartSend(&snapshot_out, tic, compressed, compressed_len,
+                           len);
+}
+
 // disconnect from the server
 
 void NET_CL_Disconnect(void)
@@ -1233,4 +1621,8 @@ void NET_Init(void)
 void NET_BindVariables(void)
 {
     M_BindStringVariable("player_name", &net_player_name);
+#ifdef HAVE_SYS_EPOLL_H
+    M_BindIntVariable("net_tcp_nodelay", &net_tcp_nodelay);
+    M_BindIntVariable("net_tcp_cork", &net_tcp_cork);
+#endif
 }
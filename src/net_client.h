@@ -30,24 +30,28 @@ void NET_CL_LaunchGame(void);
 void NET_CL_StartGame(net_gamesettings_t *settings);
 void NET_CL_SendTiccmd(ticcmd_t *ticcmd, int maketic);
 boolean NET_CL_GetSettings(net_gamesettings_t *_settings);
+boolean NET_CL_GetJoinTic(unsigned int *tic);
+boolean NET_CL_GetSnapshot(byte **data, size_t *len);
+boolean NET_CL_GetSnapshotRequest(unsigned int *tic);
+void NET_CL_SendSnapshot(unsigned int tic, byte *data, size_t len);
 void NET_Init(void);
 
 void NET_BindVariables(void);
 
-extern boolean net_client_connected;
-extern boolean net_client_received_wait_data;
-extern net_waitdata_t net_client_wait_data;
-extern char *net_client_reject_reason;
-extern boolean net_waiting_for_launch;
-extern char *net_player_name;
+extern INSTANCE boolean net_client_connected;
+extern INSTANCE boolean net_client_received_wait_data;
+extern INSTANCE net_waitdata_t net_client_wait_data;
+extern INSTANCE char *net_client_reject_reason;
+extern INSTANCE boolean net_waiting_for_launch;
+extern INSTANCE char *net_player_name;
 
 extern sha1_digest_t net_server_wad_sha1sum;
 extern sha1_digest_t net_server_deh_sha1sum;
 extern unsigned int net_server_is_freedoom;
-extern sha1_digest_t net_local_wad_sha1sum;
-extern sha1_digest_t net_local_deh_sha1sum;
-extern unsigned int net_local_is_freedoom;
+extern INSTANCE sha1_digest_t net_local_wad_sha1sum;
+extern INSTANCE sha1_digest_t net_local_deh_sha1sum;
+extern INSTANCE unsigned int net_local_is_freedoom;
 
-extern boolean drone;
+extern INSTANCE boolean drone;
 
 #endif /* #ifndef NET_CLIENT_H */
@@ -48,7 +48,7 @@ struct net_reliable_packet_s
     net_reliable_packet_t *next;
 };
 
-static FILE *net_debug = NULL;
+static INSTANCE FILE *net_debug = NULL;
 
 static void NET_Conn_Init(net_connection_t *conn, net_addr_t *addr,
                           net_protocol_t protocol)
@@ -20,12 +20,14 @@
 
 #include "doomtype.h"
 
+#include "i_instance.h"
 #include "i_system.h"
 #include "i_timer.h"
 
 #include "m_argv.h"
 
 #include "net_common.h"
+#include "net_io.h"
 #include "net_sdl.h"
 #include "net_server.h"
 
@@ -67,14 +69,19 @@ void NET_DedicatedServer(void)
 
     NET_OpenLog();
     NET_SV_Init();
-    NET_SV_AddModule(&net_sdl_module);
+    NET_SV_AddModule(NET_SV_TransportModule());
     NET_SV_RegisterWithMaster();
 
+    I_InstanceReady();
+
     while (true)
     {
         NET_SV_Run();
-        // TODO: Block on socket instead of polling.
-        I_Sleep(1);
+
+        // Sleep until a packet arrives, waking at least once a tic
+        // to run timeouts and resends.
+
+        NET_WaitForPackets(I_GetTimeNS() + 1000000000 / TICRATE);
     }
 }
 
@@ -44,6 +44,20 @@
 
 #define BACKUPTICS 128
 
+// Number of tics covered by a selective acknowledgement.
+
+#define NET_SACK_TICS 64
+
+// A tic is not resent in response to a selective acknowledgement if
+// it was already resent this recently (in ms).  This is shorter than
+// the 300ms after which a resend request is repeated.
+
+#define NET_SACK_HOLDOFF 200
+
+// Largest packet that will be sent or accepted by the network modules.
+
+#define MAX_PACKET_SIZE 1500
+
 typedef struct _net_module_s net_module_t;
 typedef struct _net_packet_s net_packet_t;
 typedef struct _net_addr_s net_addr_t;
@@ -88,6 +102,18 @@ struct _net_module_s
     // Try to resolve a name to an address
 
     net_addr_t *(*ResolveAddress)(const char *addr);
+
+    // Transmit any packets that SendPacket has queued up.  NULL if
+    // the module sends packets immediately.
+
+    void (*Flush)(void);
+
+    // Wait up to timeout_ms for a packet to arrive.  Returns true if
+    // RecvPacket may have something to return.  Modules whose packets
+    // can only come from this thread return at once.  NULL if the
+    // module has no way to wait.
+
+    boolean (*WaitPacket)(int timeout_ms);
 };
 
 // net_addr_t
@@ -123,6 +149,23 @@ typedef enum
     // number in this enum.
     NET_PROTOCOL_CHOCOLATE_DOOM_0,
 
+    // As above, but with ticcmds bit-packed to fit 32 players' worth of
+    // commands into fewer bytes (see NET_WritePackedFullTiccmd).
+    NET_PROTOCOL_PACKED_TICCMDS_0,
+
+    // As above, but GAMEDATA_ACK packets carry a bitmap of the tics
+    // received, and only the missing tics are resent (see NET_WriteSACK).
+    NET_PROTOCOL_SACK_0,
+
+    // As above, but the server may send a client its own ticcmds, which
+    // then replace the ones it made locally.  This lets the server make
+    // up ticcmds for a player who is holding up the game (see -straggler).
+    NET_PROTOCOL_SUBSTITUTE_0,
+
+    // As above, but players can join a game in progress: they are sent
+    // a snapshot of the game taken by another player (see -latejoin).
+    NET_PROTOCOL_SNAPSHOT_0,
+
     // Add your own protocol here; be sure to add a name for it to the list
     // in net_common.c too.
 
@@ -151,6 +194,10 @@ typedef enum
     NET_PACKET_TYPE_QUERY_RESPONSE,
     NET_PACKET_TYPE_LAUNCH,
     NET_PACKET_TYPE_NAT_HOLE_PUNCH,
+    NET_PACKET_TYPE_GAMEJOIN,
+    NET_PACKET_TYPE_SNAPSHOT_REQUEST,
+    NET_PACKET_TYPE_SNAPSHOT_DATA,
+    NET_PACKET_TYPE_SNAPSHOT_ACK,
 } net_packet_type_t;
 
 typedef enum
@@ -223,6 +270,7 @@ typedef struct
 #define NET_TICDIFF_BUTTONS      (1 << 3)
 #define NET_TICDIFF_CONSISTANCY  (1 << 4)
 #define NET_TICDIFF_CHATCHAR     (1 << 5)
+#define NET_TICDIFF_ALL          ((1 << 6) - 1)
 
 typedef struct
 {
@@ -0,0 +1,1654 @@
+//
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//     Networking module for Linux servers, using non-blocking TCP
+//     sockets and edge-triggered epoll.  This speaks the same framing
+//     as the TCP mode of net_sdl.c (a 4-byte little endian length
+//     followed by the packet data) but never blocks on a slow client:
+//     each connection has its own receive and transmit ring buffer,
+//     and only sockets reported ready by the kernel are touched.
+//
+//     Outgoing packets are appended to the connection's transmit buffer
+//     and only written out when the server calls Flush at the end of
+//     its run pass, so each client gets at most one writev() per pass
+//     however many packets were queued for it.
+//
+//     With -netthread, the sockets are owned by a separate I/O thread
+//     instead.  The game thread and the I/O thread then only exchange
+//     messages through a pair of single producer, single consumer
+//     queues, so the game thread never makes a socket call.
+//
+
+#include "config.h"
+
+#ifdef HAVE_SYS_EPOLL_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <unistd.h>
+#include <poll.h>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#include "SDL.h"
+
+#include "doomtype.h"
+#include "i_system.h"
+#include "m_argv.h"
+#include "m_misc.h"
+#include "net_defs.h"
+#include "net_epoll.h"
+#include "net_io.h"
+#include "net_packet.h"
+#include "net_proxy.h"
+
+#define DEFAULT_PORT 2342
+
+// Maximum number of simultaneously open client sockets.  There are more
+// connection slots than this, as a slot stays reserved after its socket
+// is closed until the server has released the address.
+
+#define MAX_SOCKETS 32
+#define MAX_CONNECTIONS (MAX_SOCKETS * 2)
+
+// Size of the per-connection ring buffers. These must be powers of two.
+// The transmit buffer holds several seconds worth of tics; a client
+// that falls further behind than that is disconnected.
+
+#define RX_BUFFER_SIZE 16384
+#define TX_BUFFER_SIZE 65536
+
+#define FRAME_HEADER_LEN 4
+#define MAX_EVENTS 64
+
+// Sizes of the queues between the I/O thread and the game thread, in
+// packets.  These must be powers of two.
+
+#define RECV_QUEUE_SIZE 512
+#define SEND_QUEUE_SIZE 1024
+
+// Slots kept free in each queue for connection open, close and release
+// messages, so that those can never be lost.  There are at most two
+// outstanding for each connection.
+
+#define CONTROL_RESERVE (MAX_CONNECTIONS * 2)
+
+// How long the I/O thread waits for socket activity when it has
+// nothing else to do, in ms.
+
+#define IO_POLL_TIMEOUT 100
+
+typedef struct
+{
+    byte *data;
+    unsigned int mask;
+
+    // Free-running read and write positions; the number of bytes in the
+    // buffer is always head - tail.
+
+    unsigned int head;
+    unsigned int tail;
+} ringbuf_t;
+
+typedef struct
+{
+    // Socket, or -1 if the connection is closed.
+
+    int fd;
+
+    net_addr_t net_addr;
+    struct sockaddr_in sockaddr;
+
+    ringbuf_t rx;
+    ringbuf_t tx;
+
+    // With edge-triggered epoll, we are only told once that there is
+    // data to read.  If the receive buffer filled before the socket was
+    // drained, this is set so that we go back for the rest later.
+
+    boolean read_pending;
+
+    // True once the remote end has closed its side.  The frames still
+    // in the receive buffer are delivered before the connection is
+    // closed.
+
+    boolean eof;
+
+    // True if this connection is in the ready queue.
+
+    boolean queued;
+
+    // True if packets have been queued since the last flush.
+
+    boolean dirty;
+
+    // True while we are waiting for the PROXY header (see
+    // NET_Proxy_Enabled).  No packets are read until it has arrived.
+
+    boolean handshaking;
+
+    // True if the source address was added to source_addrs.
+
+    boolean registered;
+
+    net_proxy_state_t proxy;
+
+    // With the I/O thread: true if the game thread has been told about
+    // the connection, and true once the game thread has finished with
+    // it after it closed.  Both are only used by the I/O thread.
+
+    boolean announced;
+    boolean released;
+
+    // The game thread's view of the connection: true if it has closed,
+    // and true once we have told the I/O thread we are finished with it.
+
+    boolean closed;
+    boolean release_sent;
+
+    byte rx_data[RX_BUFFER_SIZE];
+    byte tx_data[TX_BUFFER_SIZE];
+} epoll_conn_t;
+
+// Disable Nagle's algorithm on client sockets.
+
+INSTANCE int net_tcp_nodelay = 1;
+
+// Cork client sockets so that the kernel only sends full segments, and
+// push out whatever is left at the end of each flush.
+
+INSTANCE int net_tcp_cork = 0;
+
+static INSTANCE boolean initted = false;
+static INSTANCE int port = DEFAULT_PORT;
+
+// Messages passed between the I/O thread and the game thread.
+
+typedef enum
+{
+    MSG_PACKET,         // Packet received, or to be sent
+    MSG_OPENED,         // I/O thread: new connection is ready
+    MSG_CLOSED,         // I/O thread: connection has closed
+    MSG_RELEASE,        // Game thread: finished with closed connection
+} msg_type_t;
+
+typedef struct
+{
+    msg_type_t type;
+    epoll_conn_t *conn;
+    unsigned int len;
+    byte data[MAX_PACKET_SIZE];
+} net_msg_t;
+
+// Single producer, single consumer queue.  The head is only advanced by
+// the producer and the tail only by the consumer; the atomic update of
+// each publishes the message to the other thread.
+
+typedef struct
+{
+    net_msg_t *msgs;
+    unsigned int size;
+    SDL_atomic_t head;
+    SDL_atomic_t tail;
+} msgqueue_t;
+
+// Everything the I/O thread uses, so that it can be handed the game
+// thread's copy.  In the server build each match has its own copy of
+// the game's variables (see INSTANCE in doomtype.h), so the I/O thread
+// cannot find them by name.
+
+typedef struct
+{
+    int listen_fd;
+    int epoll_fd;
+
+    // Held open so that, when we run out of file descriptors, one can
+    // be freed up to accept and close a pending connection.  The listen
+    // socket is edge-triggered, so a connection left in the backlog
+    // would otherwise stay there until another one arrived.
+
+    int spare_fd;
+
+    // Set when accept() failed for want of memory, so that the backlog
+    // is tried again on the next poll.
+
+    boolean accept_retry;
+
+    epoll_conn_t *conns;
+    int num_open_sockets;
+
+    boolean enforce_proxy;
+    boolean allow_reentry;
+    int num_handshaking;
+    int tcp_nodelay;
+    int tcp_cork;
+
+    // Source addresses that have connected, for rejecting duplicates.
+
+    net_proxy_addrset_t source_addrs;
+
+    boolean io_thread;
+    msgqueue_t recv_queue;
+    msgqueue_t send_queue;
+    int wake_fd;
+    int notify_fd;
+
+    // Queue of connections that have at least one complete frame
+    // buffered (or more data waiting in the kernel).  RecvPacket only
+    // ever looks at connections in this queue.
+
+    epoll_conn_t *ready_queue[MAX_CONNECTIONS];
+    unsigned int ready_head, ready_tail;
+
+    // Connections with packets queued since the last flush.
+
+    epoll_conn_t *dirty_list[MAX_CONNECTIONS];
+    int num_dirty;
+} epoll_state_t;
+
+static INSTANCE epoll_state_t *ep;
+static INSTANCE unsigned int send_queue_drops;
+
+//
+// Ring buffers
+//
+
+static void RingInit(ringbuf_t *ring, byte *data, unsigned int size)
+{
+    ring->data = data;
+    ring->mask = size - 1;
+    ring->head = 0;
+    ring->tail = 0;
+}
+
+static unsigned int RingUsed(ringbuf_t *ring)
+{
+    return ring->head - ring->tail;
+}
+
+static unsigned int RingFree(ringbuf_t *ring)
+{
+    return ring->mask + 1 - RingUsed(ring);
+}
+
+// Returns a pointer to the largest contiguous free region, and its size.
+
+static byte *RingWritePtr(ringbuf_t *ring, unsigned int *len)
+{
+    unsigned int offset = ring->head & ring->mask;
+    unsigned int to_end = ring->mask + 1 - offset;
+    unsigned int space = RingFree(ring);
+
+    *len = space < to_end ? space : to_end;
+
+    return ring->data + offset;
+}
+
+// Describe the used region of the buffer as (up to) two iovecs, for
+// writev().  Returns the number of iovecs filled in.
+
+static int RingReadVec(ringbuf_t *ring, struct iovec *iov)
+{
+    unsigned int offset = ring->tail & ring->mask;
+    unsigned int to_end = ring->mask + 1 - offset;
+    unsigned int used = RingUsed(ring);
+
+    if (used == 0)
+    {
+        return 0;
+    }
+
+    iov[0].iov_base = ring->data + offset;
+
+    if (used <= to_end)
+    {
+        iov[0].iov_len = used;
+        return 1;
+    }
+
+    iov[0].iov_len = to_end;
+    iov[1].iov_base = ring->data;
+    iov[1].iov_len = used - to_end;
+
+    return 2;
+}
+
+static void RingWrite(ringbuf_t *ring, const byte *data, unsigned int len)
+{
+    unsigned int offset = ring->head & ring->mask;
+    unsigned int to_end = ring->mask + 1 - offset;
+
+    if (len <= to_end)
+    {
+        memcpy(ring->data + offset, data, len);
+    }
+    else
+    {
+        memcpy(ring->data + offset, data, to_end);
+        memcpy(ring->data, data + to_end, len - to_end);
+    }
+
+    ring->head += len;
+}
+
+// Copy data out of the buffer starting at the given offset from the
+// read position, without consuming it.
+
+static void RingPeek(ringbuf_t *ring, unsigned int start,
+                     byte *data, unsigned int len)
+{
+    unsigned int offset = (ring->tail + start) & ring->mask;
+    unsigned int to_end = ring->mask + 1 - offset;
+
+    if (len <= to_end)
+    {
+        memcpy(data, ring->data + offset, len);
+    }
+    else
+    {
+        memcpy(data, ring->data + offset, to_end);
+        memcpy(data + to_end, ring->data, len - to_end);
+    }
+}
+
+//
+// Message queues
+//
+
+static void QueueInit(msgqueue_t *queue, unsigned int size)
+{
+    queue->msgs = calloc(size, sizeof(net_msg_t));
+
+    if (queue->msgs == NULL)
+    {
+        I_Error("NET_Epoll_InitServer: Failed to allocate message queue");
+    }
+
+    queue->size = size;
+    SDL_AtomicSet(&queue->head, 0);
+    SDL_AtomicSet(&queue->tail, 0);
+}
+
+// Get the next free message, as long as more than 'reserve' are free.
+// It is not visible to the consumer until QueueCommit is called.
+
+static net_msg_t *QueueReserve(msgqueue_t *queue, unsigned int reserve)
+{
+    unsigned int head, tail;
+
+    head = SDL_AtomicGet(&queue->head);
+    tail = SDL_AtomicGet(&queue->tail);
+
+    if (queue->size - (head - tail) <= reserve)
+    {
+        return NULL;
+    }
+
+    return &queue->msgs[head & (queue->size - 1)];
+}
+
+static void QueueCommit(msgqueue_t *queue)
+{
+    SDL_AtomicAdd(&queue->head, 1);
+}
+
+// Get the oldest message without removing it, or NULL if empty.
+
+static net_msg_t *QueuePeek(msgqueue_t *queue)
+{
+    unsigned int head, tail;
+
+    tail = SDL_AtomicGet(&queue->tail);
+    head = SDL_AtomicGet(&queue->head);
+
+    if (head == tail)
+    {
+        return NULL;
+    }
+
+    return &queue->msgs[tail & (queue->size - 1)];
+}
+
+static void QueuePop(msgqueue_t *queue)
+{
+    SDL_AtomicAdd(&queue->tail, 1);
+}
+
+// Tell the game thread about a connection opening or closing.  Space
+// for this is always available (see CONTROL_RESERVE).
+
+static void Announce(epoll_conn_t *conn, msg_type_t type)
+{
+    net_msg_t *msg;
+
+    msg = QueueReserve(&ep->recv_queue, 0);
+    msg->type = type;
+    msg->conn = conn;
+    msg->len = 0;
+    QueueCommit(&ep->recv_queue);
+}
+
+//
+// Ready queue
+//
+
+static void ReadyPush(epoll_conn_t *conn)
+{
+    if (conn->queued)
+    {
+        return;
+    }
+
+    conn->queued = true;
+    ep->ready_queue[ep->ready_head % MAX_CONNECTIONS] = conn;
+    ++ep->ready_head;
+}
+
+static epoll_conn_t *ReadyPop(void)
+{
+    epoll_conn_t *conn;
+
+    if (ep->ready_tail == ep->ready_head)
+    {
+        return NULL;
+    }
+
+    conn = ep->ready_queue[ep->ready_tail % MAX_CONNECTIONS];
+    ++ep->ready_tail;
+    conn->queued = false;
+
+    return conn;
+}
+
+//
+// Connections
+//
+
+static void CloseConnection(epoll_conn_t *conn)
+{
+    if (conn->fd < 0)
+    {
+        return;
+    }
+
+    epoll_ctl(ep->epoll_fd, EPOLL_CTL_DEL, conn->fd, NULL);
+    close(conn->fd);
+    conn->fd = -1;
+    --ep->num_open_sockets;
+
+    // Anything still buffered is discarded.  The slot itself stays
+    // reserved until the server releases its reference to the address.
+
+    conn->rx.head = conn->rx.tail = 0;
+    conn->tx.head = conn->tx.tail = 0;
+    conn->read_pending = false;
+    conn->eof = false;
+
+    if (conn->handshaking)
+    {
+        conn->handshaking = false;
+        --ep->num_handshaking;
+    }
+
+    if (conn->registered)
+    {
+        if (ep->allow_reentry)
+        {
+            NET_Proxy_AddrSetRemove(&ep->source_addrs, &conn->proxy.source);
+        }
+        conn->registered = false;
+    }
+
+    // The game thread may still be using the slot; it tells us when it
+    // has finished.  If it never heard about the connection, the slot
+    // can be reused at once.
+
+    if (ep->io_thread)
+    {
+        if (conn->announced)
+        {
+            Announce(conn, MSG_CLOSED);
+            conn->announced = false;
+        }
+        else
+        {
+            conn->released = true;
+        }
+    }
+
+    printf("closing connection %d\n", (int) (conn - ep->conns));
+}
+
+static epoll_conn_t *AllocConnection(void)
+{
+    int i;
+
+    if (ep->num_open_sockets >= MAX_SOCKETS)
+    {
+        return NULL;
+    }
+
+    for (i = 0; i < MAX_CONNECTIONS; ++i)
+    {
+        if (ep->conns[i].fd >= 0)
+        {
+            continue;
+        }
+
+        if (ep->io_thread ? ep->conns[i].released
+                          : ep->conns[i].net_addr.refcount <= 0)
+        {
+            return &ep->conns[i];
+        }
+    }
+
+    return NULL;
+}
+
+// Read as much as we can from the socket into the receive buffer.
+
+static void ReadSocket(epoll_conn_t *conn)
+{
+    byte *ptr;
+    unsigned int len;
+    ssize_t result;
+
+    while (conn->fd >= 0 && !conn->eof)
+    {
+        ptr = RingWritePtr(&conn->rx, &len);
+
+        if (len == 0)
+        {
+            // Receive buffer is full; come back for the rest once
+            // some frames have been consumed.
+
+            conn->read_pending = true;
+            return;
+        }
+
+        result = recv(conn->fd, ptr, len, 0);
+
+        if (result > 0)
+        {
+            conn->rx.head += result;
+        }
+        else if (result == 0)
+        {
+            // Remote end closed the connection.  What it sent before
+            // closing may still be waiting in the buffer.
+
+            conn->eof = true;
+            conn->read_pending = false;
+        }
+        else if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            conn->read_pending = false;
+            return;
+        }
+        else if (errno != EINTR)
+        {
+            CloseConnection(conn);
+        }
+    }
+}
+
+// Write as much of the transmit buffer to the socket as the kernel
+// will take.  Whatever is left is sent when epoll reports EPOLLOUT.
+
+static void FlushSocket(epoll_conn_t *conn)
+{
+    struct iovec iov[2];
+    int iovcnt;
+    ssize_t result;
+
+    while (conn->fd >= 0 && RingUsed(&conn->tx) > 0)
+    {
+        // writev() on a socket cannot take send flags, but SIGPIPE is
+        // ignored when the server starts (see NET_Epoll_InitServer).
+
+        iovcnt = RingReadVec(&conn->tx, iov);
+        result = writev(conn->fd, iov, iovcnt);
+
+        if (result > 0)
+        {
+            conn->tx.tail += result;
+        }
+        else if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            return;
+        }
+        else if (result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        else
+        {
+            CloseConnection(conn);
+        }
+    }
+}
+
+// Returns the length of the next complete frame in the receive buffer,
+// or -1 if a complete frame has not been received yet.
+
+static int CompleteFrameLength(epoll_conn_t *conn)
+{
+    byte header[FRAME_HEADER_LEN];
+    unsigned int length;
+
+    if (RingUsed(&conn->rx) < FRAME_HEADER_LEN)
+    {
+        return -1;
+    }
+
+    RingPeek(&conn->rx, 0, header, FRAME_HEADER_LEN);
+    length = header[0] | (header[1] << 8) | (header[2] << 16)
+           | ((unsigned int) header[3] << 24);
+
+    if (length > MAX_PACKET_SIZE)
+    {
+        printf("oversized frame (%u bytes) on connection %d\n",
+               length, (int) (conn - ep->conns));
+        CloseConnection(conn);
+        return -1;
+    }
+
+    if (RingUsed(&conn->rx) < FRAME_HEADER_LEN + length)
+    {
+        return -1;
+    }
+
+    return length;
+}
+
+// Close a connection the remote end has closed, once every complete
+// frame it sent has been taken from the receive buffer.
+
+static void CloseIfDrained(epoll_conn_t *conn)
+{
+    if (conn->eof
+     && (conn->handshaking || CompleteFrameLength(conn) < 0))
+    {
+        CloseConnection(conn);
+    }
+}
+
+// A new connection is ready for game packets to be read from it.
+
+static void ConnectionReady(epoll_conn_t *conn)
+{
+    if (ep->io_thread)
+    {
+        Announce(conn, MSG_OPENED);
+        conn->announced = true;
+    }
+}
+
+// Parse as much of the PROXY header as has been received.  The header
+// is consumed from the receive buffer; anything after it is left for
+// RecvPacket.
+
+static void ProxyHandshake(epoll_conn_t *conn)
+{
+    net_proxy_state_t *state = &conn->proxy;
+    byte buf[NET_PROXY_MAX_HEADER];
+    unsigned int len, consumed;
+    char addr_str[64];
+
+    len = RingUsed(&conn->rx);
+
+    if (len == 0)
+    {
+        return;
+    }
+
+    if (len > sizeof(buf))
+    {
+        len = sizeof(buf);
+    }
+
+    RingPeek(&conn->rx, 0, buf, len);
+
+    switch (NET_Proxy_Feed(state, buf, len, &consumed))
+    {
+        case NET_PROXY_INCOMPLETE:
+            conn->rx.tail += consumed;
+            return;
+
+        case NET_PROXY_INVALID:
+            printf("rejecting malformed request (no proxy line)\n");
+            CloseConnection(conn);
+            return;
+
+        case NET_PROXY_COMPLETE:
+            conn->rx.tail += consumed;
+            break;
+    }
+
+    if (state->source.family == 0)
+    {
+        NET_Proxy_SetIPv4(&state->source, &conn->sockaddr.sin_addr.s_addr,
+                          ntohs(conn->sockaddr.sin_port));
+    }
+
+    NET_Proxy_AddrToString(&state->source, addr_str, sizeof(addr_str));
+
+    if (!NET_Proxy_AddrSetAdd(&ep->source_addrs, &state->source))
+    {
+        printf("rejecting duplicate connection %s at %d\n",
+               addr_str, (int) (conn - ep->conns));
+        CloseConnection(conn);
+        return;
+    }
+
+    printf("connection %d is from %s\n", (int) (conn - ep->conns), addr_str);
+
+    conn->registered = true;
+    conn->handshaking = false;
+    --ep->num_handshaking;
+
+    ConnectionReady(conn);
+}
+
+// Close any connections that have not sent their PROXY header in time.
+
+static void ExpireHandshakes(void)
+{
+    int i;
+
+    for (i = 0; i < MAX_CONNECTIONS && ep->num_handshaking > 0; ++i)
+    {
+        if (ep->conns[i].handshaking
+         && NET_Proxy_TimedOut(&ep->conns[i].proxy))
+        {
+            printf("connection %d timed out sending proxy line\n", i);
+            CloseConnection(&ep->conns[i]);
+        }
+    }
+}
+
+// Out of file descriptors: use the spare one to take the next pending
+// connection off the backlog and close it.  Returns false if there
+// was nothing to take.
+
+static boolean RefuseConnection(void)
+{
+    int fd;
+
+    if (ep->spare_fd < 0)
+    {
+        ep->spare_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    }
+
+    if (ep->spare_fd < 0)
+    {
+        printf("out of file descriptors, will try again\n");
+        ep->accept_retry = true;
+        return false;
+    }
+
+    close(ep->spare_fd);
+    fd = accept(ep->listen_fd, NULL, NULL);
+
+    if (fd >= 0)
+    {
+        printf("out of file descriptors, refusing a connection\n");
+        close(fd);
+    }
+
+    ep->spare_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+
+    return fd >= 0;
+}
+
+static void AcceptConnections(void)
+{
+    struct epoll_event ev;
+    struct sockaddr_in sa;
+    socklen_t sa_len;
+    epoll_conn_t *conn;
+    int one = 1;
+    int fd;
+
+    for (;;)
+    {
+        sa_len = sizeof(sa);
+        fd = accept(ep->listen_fd, (struct sockaddr *) &sa, &sa_len);
+
+        if (fd < 0)
+        {
+            // The client gave up before we got to it.
+
+            if (errno == EINTR || errno == ECONNABORTED)
+            {
+                continue;
+            }
+
+            if (errno == EMFILE || errno == ENFILE)
+            {
+                if (RefuseConnection())
+                {
+                    continue;
+                }
+
+                return;
+            }
+
+            if (errno == ENOBUFS || errno == ENOMEM)
+            {
+                printf("AcceptConnections: %s, will try again\n",
+                       strerror(errno));
+                ep->accept_retry = true;
+            }
+            else if (errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                printf("AcceptConnections: accept failed: %s\n",
+                       strerror(errno));
+            }
+
+            return;
+        }
+
+        conn = AllocConnection();
+
+        if (conn == NULL)
+        {
+            close(fd);
+            continue;
+        }
+
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+        if (ep->tcp_nodelay)
+        {
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+
+        if (ep->tcp_cork)
+        {
+            setsockopt(fd, IPPROTO_TCP, TCP_CORK, &one, sizeof(one));
+        }
+
+        conn->fd = fd;
+        conn->sockaddr = sa;
+        conn->read_pending = false;
+        conn->eof = false;
+        conn->released = false;
+
+        // With the I/O thread, the reference count belongs to the game
+        // thread and is reset when it hears about the connection.
+
+        if (!ep->io_thread)
+        {
+            conn->net_addr.refcount = 0;
+        }
+        RingInit(&conn->rx, conn->rx_data, RX_BUFFER_SIZE);
+        RingInit(&conn->tx, conn->tx_data, TX_BUFFER_SIZE);
+
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.ptr = conn;
+
+        if (epoll_ctl(ep->epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0)
+        {
+            close(fd);
+            conn->fd = -1;
+            continue;
+        }
+
+        ++ep->num_open_sockets;
+
+        printf("adding newconn to %d\n", (int) (conn - ep->conns));
+
+        if (ep->enforce_proxy)
+        {
+            conn->handshaking = true;
+            ++ep->num_handshaking;
+            NET_Proxy_Start(&conn->proxy);
+        }
+        else
+        {
+            ConnectionReady(conn);
+        }
+    }
+}
+
+// Collect readiness events from the kernel, waiting up to 'timeout' ms
+// for some to arrive.  Connections with complete frames are added to
+// the ready queue.
+
+static void PollEvents(int timeout)
+{
+    struct epoll_event events[MAX_EVENTS];
+    epoll_conn_t *conn;
+    uint64_t wakeups;
+    int num_events;
+    int i;
+
+    if (ep->accept_retry)
+    {
+        ep->accept_retry = false;
+        AcceptConnections();
+    }
+
+    num_events = epoll_wait(ep->epoll_fd, events, MAX_EVENTS, timeout);
+
+    for (i = 0; i < num_events; ++i)
+    {
+        if (events[i].data.ptr == NULL)
+        {
+            AcceptConnections();
+            continue;
+        }
+
+        if (events[i].data.ptr == &ep->wake_fd)
+        {
+            if (read(ep->wake_fd, &wakeups, sizeof(wakeups)) < 0)
+            {
+                // Nothing to read; someone else already reset it.
+            }
+            continue;
+        }
+
+        conn = events[i].data.ptr;
+
+        if (events[i].events & EPOLLOUT)
+        {
+            FlushSocket(conn);
+        }
+
+        if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+        {
+            ReadSocket(conn);
+        }
+
+        if (conn->handshaking)
+        {
+            ProxyHandshake(conn);
+        }
+
+        if (conn->fd >= 0 && !conn->handshaking
+         && CompleteFrameLength(conn) >= 0)
+        {
+            ReadyPush(conn);
+        }
+
+        CloseIfDrained(conn);
+    }
+}
+
+// Append a frame to a connection's transmit buffer, to be written out
+// on the next flush.
+
+static void QueueFrame(epoll_conn_t *conn, const byte *data,
+                       unsigned int len)
+{
+    byte header[FRAME_HEADER_LEN];
+
+    if (conn->fd < 0)
+    {
+        return;
+    }
+
+    // Out of space?  Try to make some by writing out what is already
+    // queued before giving up on the client.
+
+    if (RingFree(&conn->tx) < FRAME_HEADER_LEN + len)
+    {
+        FlushSocket(conn);
+    }
+
+    if (conn->fd < 0)
+    {
+        return;
+    }
+
+    if (RingFree(&conn->tx) < FRAME_HEADER_LEN + len)
+    {
+        printf("send buffer overflow on connection %d, closing\n",
+               (int) (conn - ep->conns));
+        CloseConnection(conn);
+        return;
+    }
+
+    header[0] = len & 0xff;
+    header[1] = (len >> 8) & 0xff;
+    header[2] = (len >> 16) & 0xff;
+    header[3] = (len >> 24) & 0xff;
+
+    RingWrite(&conn->tx, header, FRAME_HEADER_LEN);
+    RingWrite(&conn->tx, data, len);
+
+    // Sent on the next flush.
+
+    if (!conn->dirty)
+    {
+        conn->dirty = true;
+        ep->dirty_list[ep->num_dirty] = conn;
+        ++ep->num_dirty;
+    }
+}
+
+// Find the next connection in the ready queue with a complete frame,
+// returning the frame length in *length.  The frame is left in the
+// receive buffer until ConsumeFrame is called.
+
+static epoll_conn_t *NextFrame(int *length)
+{
+    epoll_conn_t *conn;
+
+    while ((conn = ReadyPop()) != NULL)
+    {
+        *length = CompleteFrameLength(conn);
+
+        if (*length >= 0)
+        {
+            return conn;
+        }
+    }
+
+    return NULL;
+}
+
+static void ConsumeFrame(epoll_conn_t *conn, int length)
+{
+    conn->rx.tail += FRAME_HEADER_LEN + length;
+
+    // Now that there is space in the buffer again, pick up anything
+    // we had to leave in the kernel.
+
+    if (conn->read_pending)
+    {
+        ReadSocket(conn);
+    }
+
+    // Go to the back of the queue if there is more to come, so that
+    // one busy client cannot starve the others.
+
+    if (conn->fd >= 0 && CompleteFrameLength(conn) >= 0)
+    {
+        ReadyPush(conn);
+    }
+
+    CloseIfDrained(conn);
+}
+
+static void FlushConnections(void)
+{
+    epoll_conn_t *conn;
+    int zero = 0, one = 1;
+    int i;
+
+    for (i = 0; i < ep->num_dirty; ++i)
+    {
+        conn = ep->dirty_list[i];
+        conn->dirty = false;
+
+        FlushSocket(conn);
+
+        // Pull the cork to push out the final partial segment, then put
+        // it back in for the next pass.
+
+        if (ep->tcp_cork && conn->fd >= 0)
+        {
+            setsockopt(conn->fd, IPPROTO_TCP, TCP_CORK, &zero, sizeof(zero));
+            setsockopt(conn->fd, IPPROTO_TCP, TCP_CORK, &one, sizeof(one));
+        }
+    }
+
+    ep->num_dirty = 0;
+}
+
+//
+// I/O thread
+//
+
+// Move complete frames from the receive buffers to the game thread.
+
+static void DeliverFrames(void)
+{
+    epoll_conn_t *conn;
+    net_msg_t *msg;
+    int length;
+
+    for (;;)
+    {
+        msg = QueueReserve(&ep->recv_queue, CONTROL_RESERVE);
+
+        if (msg == NULL)
+        {
+            // The game thread is behind; leave the rest in the buffers
+            // until it catches up.
+
+            break;
+        }
+
+        conn = NextFrame(&length);
+
+        if (conn == NULL)
+        {
+            break;
+        }
+
+        msg->type = MSG_PACKET;
+        msg->conn = conn;
+        msg->len = length;
+        RingPeek(&conn->rx, FRAME_HEADER_LEN, msg->data, length);
+        QueueCommit(&ep->recv_queue);
+
+        // This may close the connection, so only do it after the packet
+        // is in the queue ahead of the close message.
+
+        ConsumeFrame(conn, length);
+    }
+}
+
+// Handle messages from the game thread.
+
+static void ProcessSendQueue(void)
+{
+    net_msg_t *msg;
+
+    while ((msg = QueuePeek(&ep->send_queue)) != NULL)
+    {
+        if (msg->type == MSG_RELEASE)
+        {
+            msg->conn->released = true;
+        }
+        else
+        {
+            QueueFrame(msg->conn, msg->data, msg->len);
+        }
+
+        QueuePop(&ep->send_queue);
+    }
+}
+
+static int IOThread(void *data)
+{
+    uint64_t one = 1;
+    unsigned int head;
+
+    ep = data;
+
+    for (;;)
+    {
+        head = SDL_AtomicGet(&ep->recv_queue.head);
+
+        // Don't sleep if there are frames waiting for space in the
+        // receive queue.
+
+        PollEvents(ep->ready_tail != ep->ready_head ? 1 : IO_POLL_TIMEOUT);
+
+        if (ep->num_handshaking > 0)
+        {
+            ExpireHandshakes();
+        }
+
+        DeliverFrames();
+
+        // Wake the game thread if it is waiting in WaitPacket.
+
+        if (SDL_AtomicGet(&ep->recv_queue.head) != head
+         && write(ep->notify_fd, &one, sizeof(one)) < 0)
+        {
+            // Counter is saturated; the game thread is awake anyway.
+        }
+        ProcessSendQueue();
+        FlushConnections();
+    }
+
+    return 0;
+}
+
+static void StartIOThread(void)
+{
+    struct epoll_event ev;
+    SDL_Thread *thread;
+    int i;
+
+    ep->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    ep->notify_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+    if (ep->wake_fd < 0 || ep->notify_fd < 0)
+    {
+        I_Error("NET_Epoll_InitServer: eventfd failed: %s", strerror(errno));
+    }
+
+    ev.events = EPOLLIN | EPOLLET;
+    ev.data.ptr = &ep->wake_fd;
+    epoll_ctl(ep->epoll_fd, EPOLL_CTL_ADD, ep->wake_fd, &ev);
+
+    QueueInit(&ep->recv_queue, RECV_QUEUE_SIZE);
+    QueueInit(&ep->send_queue, SEND_QUEUE_SIZE);
+
+    for (i = 0; i < MAX_CONNECTIONS; ++i)
+    {
+        ep->conns[i].released = true;
+        ep->conns[i].closed = true;
+    }
+
+    ep->io_thread = true;
+
+    thread = SDL_CreateThread(IOThread, "net_io", ep);
+
+    if (thread == NULL)
+    {
+        I_Error("NET_Epoll_InitServer: Failed to start I/O thread: %s",
+                SDL_GetError());
+    }
+
+    SDL_DetachThread(thread);
+
+    printf("network I/O thread started\n");
+}
+
+// Game thread: tell the I/O thread we have finished with a closed
+// connection, so that its slot can be reused.
+
+static void SendRelease(epoll_conn_t *conn)
+{
+    net_msg_t *msg;
+
+    msg = QueueReserve(&ep->send_queue, 0);
+    msg->type = MSG_RELEASE;
+    msg->conn = conn;
+    msg->len = 0;
+    QueueCommit(&ep->send_queue);
+
+    conn->release_sent = true;
+}
+
+static boolean NET_Epoll_InitClient(void)
+{
+    // This module only implements the server end.
+
+    return false;
+}
+
+static boolean NET_Epoll_InitServer(void)
+{
+    struct epoll_event ev;
+    struct sockaddr_in sa;
+    int one = 1;
+    int i, p;
+
+    if (initted)
+        return true;
+
+    p = M_CheckParmWithArgs("-port", 1);
+    if (p > 0)
+        port = atoi(myargv[p+1]);
+
+    if (port == 0)
+    {
+        port = DEFAULT_PORT;
+    }
+
+    //!
+    // @category net
+    // @arg <n>
+    //
+    // When running a server on Linux, enable (1) or disable (0)
+    // TCP_NODELAY on client connections, overriding the
+    // net_tcp_nodelay config file setting.
+    //
+
+    p = M_CheckParmWithArgs("-tcpnodelay", 1);
+    if (p > 0)
+        net_tcp_nodelay = atoi(myargv[p+1]);
+
+    //!
+    // @category net
+    // @arg <n>
+    //
+    // When running a server on Linux, enable (1) or disable (0)
+    // TCP_CORK on client connections, overriding the net_tcp_cork
+    // config file setting.
+    //
+
+    p = M_CheckParmWithArgs("-tcpcork", 1);
+    if (p > 0)
+        net_tcp_cork = atoi(myargv[p+1]);
+
+    // A client disappearing while we are writing to it must not kill
+    // the server.
+
+    signal(SIGPIPE, SIG_IGN);
+
+    ep = calloc(1, sizeof(epoll_state_t));
+
+    if (ep == NULL)
+    {
+        I_Error("NET_Epoll_InitServer: Failed to allocate server state");
+    }
+
+    ep->listen_fd = -1;
+    ep->epoll_fd = -1;
+    ep->spare_fd = -1;
+    ep->wake_fd = -1;
+    ep->notify_fd = -1;
+    ep->tcp_nodelay = net_tcp_nodelay;
+    ep->tcp_cork = net_tcp_cork;
+    ep->enforce_proxy = NET_Proxy_Enabled();
+    ep->allow_reentry = NET_Proxy_AllowReentry();
+
+    ep->conns = calloc(MAX_CONNECTIONS, sizeof(epoll_conn_t));
+
+    if (ep->conns == NULL)
+    {
+        I_Error("NET_Epoll_InitServer: Failed to allocate connection table");
+    }
+
+    for (i = 0; i < MAX_CONNECTIONS; ++i)
+    {
+        ep->conns[i].fd = -1;
+        ep->conns[i].net_addr.module = &net_epoll_module;
+        ep->conns[i].net_addr.handle = &ep->conns[i];
+    }
+
+    printf("binding to %d\n", port);
+
+    ep->listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                           0);
+
+    if (ep->listen_fd < 0)
+    {
+        I_Error("NET_Epoll_InitServer: Unable to create socket: %s",
+                strerror(errno));
+    }
+
+    setsockopt(ep->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_addr.s_addr = htonl(INADDR_ANY);
+    sa.sin_port = htons(port);
+
+    if (bind(ep->listen_fd, (struct sockaddr *) &sa, sizeof(sa)) < 0
+     || listen(ep->listen_fd, SOMAXCONN) < 0)
+    {
+        I_Error("NET_Epoll_InitServer: Unable to bind to port %i", port);
+    }
+
+    ep->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+
+    if (ep->epoll_fd < 0)
+    {
+        I_Error("NET_Epoll_InitServer: epoll_create1 failed: %s",
+                strerror(errno));
+    }
+
+    ev.events = EPOLLIN | EPOLLET;
+    ev.data.ptr = NULL;
+    epoll_ctl(ep->epoll_fd, EPOLL_CTL_ADD, ep->listen_fd, &ev);
+
+    ep->spare_fd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+
+    //!
+    // @category net
+    //
+    // When running a server on Linux, handle all socket I/O on a
+    // separate thread from the game.
+    //
+
+    if (M_CheckParm("-netthread") > 0)
+    {
+        StartIOThread();
+    }
+
+    initted = true;
+
+    return true;
+}
+
+static void NET_Epoll_SendPacket(net_addr_t *addr, net_packet_t *packet)
+{
+    epoll_conn_t *conn;
+    net_msg_t *msg;
+
+    // There is no such thing as a broadcast over TCP.
+
+    if (addr == &net_broadcast_addr)
+    {
+        return;
+    }
+
+    conn = addr->handle;
+
+    if (!ep->io_thread)
+    {
+        QueueFrame(conn, packet->data, packet->len);
+        return;
+    }
+
+    if (conn->closed)
+    {
+        return;
+    }
+
+    // Leave room for release messages.  If the I/O thread has fallen
+    // this far behind there is little we can do but drop the packet.
+
+    msg = QueueReserve(&ep->send_queue, MAX_CONNECTIONS);
+
+    if (msg == NULL)
+    {
+        if (send_queue_drops == 0)
+        {
+            printf("network send queue full, dropping packets\n");
+        }
+
+        ++send_queue_drops;
+        return;
+    }
+
+    msg->type = MSG_PACKET;
+    msg->conn = conn;
+    msg->len = packet->len;
+    memcpy(msg->data, packet->data, packet->len);
+    QueueCommit(&ep->send_queue);
+}
+
+static boolean NET_Epoll_RecvPacket(net_addr_t **addr, net_packet_t **packet)
+{
+    epoll_conn_t *conn;
+    net_msg_t *msg;
+    int length;
+
+    if (ep->io_thread)
+    {
+        while ((msg = QueuePeek(&ep->recv_queue)) != NULL)
+        {
+            conn = msg->conn;
+
+            if (msg->type == MSG_PACKET)
+            {
+                *packet = NET_NewPacket(msg->len);
+                memcpy((*packet)->data, msg->data, msg->len);
+                (*packet)->len = msg->len;
+                *addr = &conn->net_addr;
+
+                QueuePop(&ep->recv_queue);
+                return true;
+            }
+            else if (msg->type == MSG_OPENED)
+            {
+                conn->closed = false;
+                conn->release_sent = false;
+                conn->net_addr.refcount = 0;
+            }
+            else if (msg->type == MSG_CLOSED)
+            {
+                conn->closed = true;
+
+                if (conn->net_addr.refcount <= 0)
+                {
+                    SendRelease(conn);
+                }
+            }
+
+            QueuePop(&ep->recv_queue);
+        }
+
+        return false;
+    }
+
+    if (ep->num_handshaking > 0)
+    {
+        ExpireHandshakes();
+    }
+
+    if (ep->ready_tail == ep->ready_head)
+    {
+        PollEvents(0);
+    }
+
+    conn = NextFrame(&length);
+
+    if (conn == NULL)
+    {
+        return false;
+    }
+
+    *packet = NET_NewPacket(length);
+    RingPeek(&conn->rx, FRAME_HEADER_LEN, (*packet)->data, length);
+    (*packet)->len = length;
+    *addr = &conn->net_addr;
+
+    ConsumeFrame(conn, length);
+
+    return true;
+}
+
+static void NET_Epoll_Flush(void)
+{
+    uint64_t one = 1;
+
+    if (!ep->io_thread)
+    {
+        FlushConnections();
+        return;
+    }
+
+    // Wake the I/O thread to send everything queued.  This is an
+    // eventfd, not a socket, and never blocks.
+
+    if (write(ep->wake_fd, &one, sizeof(one)) < 0)
+    {
+        // Counter is saturated; the thread is awake anyway.
+    }
+}
+
+static boolean NET_Epoll_WaitPacket(int timeout_ms)
+{
+    struct pollfd pfd;
+    uint64_t count;
+
+    if (ep->io_thread)
+    {
+        if (QueuePeek(&ep->recv_queue) != NULL)
+        {
+            return true;
+        }
+
+        pfd.fd = ep->notify_fd;
+        pfd.events = POLLIN;
+
+        if (poll(&pfd, 1, timeout_ms) > 0
+         && read(ep->notify_fd, &count, sizeof(count)) < 0)
+        {
+            // Nothing to read; someone else already reset it.
+        }
+
+        return QueuePeek(&ep->recv_queue) != NULL;
+    }
+
+    if (ep->ready_tail == ep->ready_head)
+    {
+        PollEvents(timeout_ms);
+    }
+
+    return ep->ready_tail != ep->ready_head;
+}
+
+static void NET_Epoll_AddrToString(net_addr_t *addr, char *buffer,
+                                   int buffer_len)
+{
+    epoll_conn_t *conn = addr->handle;
+    uint32_t host;
+    uint16_t remote_port;
+
+    host = ntohl(conn->sockaddr.sin_addr.s_addr);
+    remote_port = ntohs(conn->sockaddr.sin_port);
+
+    M_snprintf(buffer, buffer_len, "%i.%i.%i.%i",
+               (host >> 24) & 0xff, (host >> 16) & 0xff,
+               (host >> 8) & 0xff, host & 0xff);
+
+    if (remote_port != DEFAULT_PORT)
+    {
+        char portbuf[10];
+        M_snprintf(portbuf, sizeof(portbuf), ":%i", remote_port);
+        M_StringConcat(buffer, portbuf, buffer_len);
+    }
+}
+
+static void NET_Epoll_FreeAddress(net_addr_t *addr)
+{
+    epoll_conn_t *conn = addr->handle;
+
+    // Addresses are embedded in the connection slots.  A slot whose
+    // socket has been closed becomes free for reuse once its reference
+    // count drops to zero.  With the I/O thread, it has to be told.
+
+    if (ep->io_thread && conn->closed && !conn->release_sent)
+    {
+        SendRelease(conn);
+    }
+}
+
+static net_addr_t *NET_Epoll_ResolveAddress(const char *address)
+{
+    // Connections are only ever accepted, never initiated.
+
+    return NULL;
+}
+
+// Complete module
+
+net_module_t net_epoll_module =
+{
+    NET_Epoll_InitClient,
+    NET_Epoll_InitServer,
+    NET_Epoll_SendPacket,
+    NET_Epoll_RecvPacket,
+    NET_Epoll_AddrToString,
+    NET_Epoll_FreeAddress,
+    NET_Epoll_ResolveAddress,
+    NET_Epoll_Flush,
+    NET_Epoll_WaitPacket,
+};
+
+#endif /* #ifdef HAVE_SYS_EPOLL_H */
+
@@ -0,0 +1,35 @@
+//
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//     Networking module for Linux servers, using non-blocking TCP
+//     sockets and epoll.
+//
+
+#ifndef NET_EPOLL_H
+#define NET_EPOLL_H
+
+#include "config.h"
+#include "net_defs.h"
+
+#ifdef HAVE_SYS_EPOLL_H
+
+extern net_module_t net_epoll_module;
+
+extern INSTANCE int net_tcp_nodelay;
+extern INSTANCE int net_tcp_cork;
+
+#endif
+
+#endif /* #ifndef NET_EPOLL_H */
+
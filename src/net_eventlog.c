@@ -0,0 +1,483 @@
+//
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//     Server event log.  Events are queued by the game and written
+//     out by a background thread, so that the game never waits on
+//     file or terminal output.
+//
+//     With -eventlog, events are written as one JSON object per line
+//     and the file is rotated when it grows too large.  Otherwise the
+//     writer prints scoring events to stdout in the old "SCORING"
+//     form.
+//
+//     With -matches (see i_instance.c), all of the matches share the
+//     one log and writer thread, and each event records its match.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "SDL.h"
+
+#include "i_instance.h"
+#include "i_system.h"
+#include "m_argv.h"
+#include "m_misc.h"
+
+#include "net_defs.h"
+#include "net_eventlog.h"
+
+// Number of events that can be waiting to be written; a power of two.
+
+#define EVENT_QUEUE_SIZE 1024
+
+// Rotate the log file when it reaches this size, keeping this many
+// old files (named file.1, file.2, ...).
+
+#define EVENTLOG_MAX_SIZE (16 * 1024 * 1024)
+#define EVENTLOG_KEEP     4
+
+// How often the writer wakes up even if nothing has been queued, in ms.
+
+#define WRITER_PERIOD 1000
+
+typedef enum
+{
+    EVENT_SCORE,
+    EVENT_MESSAGE,
+} event_type_t;
+
+typedef struct
+{
+    event_type_t type;
+    int match;
+    int tic;
+    int player;
+    int sector_tag;
+    time_t time;
+    char name[MAXPLAYERNAME];
+    char text[256];
+} net_event_t;
+
+// Queue as in net_epoll.c: the games only advance the head, and the
+// writer thread only the tail.  There is a game for each match, so
+// they take events_lock from reserving an event until committing it.
+
+static net_event_t events[EVENT_QUEUE_SIZE];
+static SDL_atomic_t events_head;
+static SDL_atomic_t events_tail;
+static SDL_SpinLock events_lock;
+static SDL_atomic_t writer_quit;
+static SDL_sem *writer_sem;
+static SDL_Thread *writer_thread;
+static unsigned int events_dropped;
+
+// Number of matches using the log; the writer runs while there are
+// any.  eventlog_lock is held while starting or stopping it.
+
+static SDL_SpinLock eventlog_lock;
+static int eventlog_users;
+static INSTANCE boolean eventlog_initialized = false;
+
+static char *eventlog_path = NULL;
+static FILE *eventlog_file;
+static long eventlog_size;
+
+static void OpenLogFile(void)
+{
+    eventlog_file = fopen(eventlog_path, "a");
+
+    if (eventlog_file == NULL)
+    {
+        fprintf(stderr, "NET_EventLog: failed to open %s\n", eventlog_path);
+        eventlog_size = 0;
+        return;
+    }
+
+    fseek(eventlog_file, 0, SEEK_END);
+    eventlog_size = ftell(eventlog_file);
+}
+
+// Move file.N to file.N+1 and so on, dropping the oldest, then start
+// a new file.
+
+static void RotateLogFile(void)
+{
+    char *oldname, *newname;
+    size_t len;
+    int i;
+
+    fclose(eventlog_file);
+
+    len = strlen(eventlog_path) + 12;
+    oldname = malloc(len);
+    newname = malloc(len);
+
+    for (i = EVENTLOG_KEEP; i > 0; --i)
+    {
+        M_snprintf(newname, len, "%s.%d", eventlog_path, i);
+
+        if (i > 1)
+        {
+            M_snprintf(oldname, len, "%s.%d", eventlog_path, i - 1);
+        }
+        else
+        {
+            M_StringCopy(oldname, eventlog_path, len);
+        }
+
+        remove(newname);
+        rename(oldname, newname);
+    }
+
+    free(oldname);
+    free(newname);
+
+    OpenLogFile();
+}
+
+static void WriteJSONString(FILE *fstream, const char *s)
+{
+    fputc('"', fstream);
+
+    for (; *s != '\0'; ++s)
+    {
+        if (*s == '"' || *s == '\\')
+        {
+            fputc('\\', fstream);
+            fputc(*s, fstream);
+        }
+        else if ((unsigned char) *s < 0x20)
+        {
+            fprintf(fstream, "\\u%04x", (unsigned char) *s);
+        }
+        else
+        {
+            fputc(*s, fstream);
+        }
+    }
+
+    fputc('"', fstream);
+}
+
+static void WriteEvent(net_event_t *event)
+{
+    FILE *fstream;
+    long start;
+
+    if (eventlog_path == NULL)
+    {
+        // Messages are already printed by the server itself.
+
+        if (event->type == EVENT_SCORE)
+        {
+            printf("SCORING %s %hd", event->name, (short) event->sector_tag);
+
+            if (I_NumInstances() > 1)
+            {
+                printf(" %d", event->match);
+            }
+
+            printf("\n");
+        }
+
+        return;
+    }
+
+    fstream = eventlog_file;
+
+    if (fstream == NULL)
+    {
+        return;
+    }
+
+    start = ftell(fstream);
+
+    switch (event->type)
+    {
+        case EVENT_SCORE:
+            fprintf(fstream, "{\"event\":\"score\",\"time\":%ld,"
+                             "\"match\":%d,\"tic\":%d,\"player\":%d,"
+                             "\"name\":",
+                    (long) event->time, event->match, event->tic,
+                    event->player);
+            WriteJSONString(fstream, event->name);
+            fprintf(fstream, ",\"sector\":%d}\n", event->sector_tag);
+            break;
+
+        case EVENT_MESSAGE:
+            fprintf(fstream, "{\"event\":\"message\",\"time\":%ld,"
+                             "\"match\":%d,\"text\":",
+                    (long) event->time, event->match);
+            WriteJSONString(fstream, event->text);
+            fprintf(fstream, "}\n");
+            break;
+    }
+
+    eventlog_size += ftell(fstream) - start;
+
+    if (eventlog_size >= EVENTLOG_MAX_SIZE)
+    {
+        RotateLogFile();
+    }
+}
+
+// Write out everything in the queue.  Returns false if it was empty.
+
+static boolean DrainQueue(void)
+{
+    unsigned int head, tail;
+
+    tail = SDL_AtomicGet(&events_tail);
+    head = SDL_AtomicGet(&events_head);
+
+    if (head == tail)
+    {
+        return false;
+    }
+
+    while (tail != head)
+    {
+        WriteEvent(&events[tail & (EVENT_QUEUE_SIZE - 1)]);
+        ++tail;
+    }
+
+    SDL_AtomicSet(&events_tail, tail);
+
+    if (eventlog_path == NULL)
+    {
+        fflush(stdout);
+    }
+    else if (eventlog_file != NULL)
+    {
+        fflush(eventlog_file);
+    }
+
+    return true;
+}
+
+static int WriterThread(void *unused)
+{
+    while (!SDL_AtomicGet(&writer_quit))
+    {
+        if (!DrainQueue())
+        {
+            SDL_SemWaitTimeout(writer_sem, WRITER_PERIOD);
+        }
+    }
+
+    DrainQueue();
+
+    return 0;
+}
+
+static void StopWriter(void)
+{
+    SDL_AtomicSet(&writer_quit, 1);
+    SDL_SemPost(writer_sem);
+    SDL_WaitThread(writer_thread, NULL);
+
+    if (eventlog_file != NULL)
+    {
+        fclose(eventlog_file);
+        eventlog_file = NULL;
+    }
+}
+
+// Open the log and start the writer thread.  Returns false if the
+// thread could not be started.
+
+static boolean StartWriter(void)
+{
+    int p;
+
+    //!
+    // @category net
+    // @arg <file>
+    //
+    // When running a server, write scoring events and server messages
+    // to the given file, one JSON object per line.
+    //
+
+    p = M_CheckParmWithArgs("-eventlog", 1);
+
+    if (p > 0)
+    {
+        eventlog_path = myargv[p + 1];
+        OpenLogFile();
+    }
+
+    SDL_AtomicSet(&events_head, 0);
+    SDL_AtomicSet(&events_tail, 0);
+    SDL_AtomicSet(&writer_quit, 0);
+
+    writer_sem = SDL_CreateSemaphore(0);
+    writer_thread = SDL_CreateThread(WriterThread, "eventlog", NULL);
+
+    return writer_sem != NULL && writer_thread != NULL;
+}
+
+static void NET_EventLog_Shutdown(void)
+{
+    if (!eventlog_initialized)
+    {
+        return;
+    }
+
+    eventlog_initialized = false;
+
+    SDL_AtomicLock(&eventlog_lock);
+
+    --eventlog_users;
+
+    if (eventlog_users == 0)
+    {
+        StopWriter();
+    }
+
+    SDL_AtomicUnlock(&eventlog_lock);
+}
+
+void NET_EventLog_Init(void)
+{
+    boolean started;
+
+    if (eventlog_initialized)
+    {
+        return;
+    }
+
+    // The first match to get here starts the writer for all of them.
+
+    SDL_AtomicLock(&eventlog_lock);
+
+    started = eventlog_users > 0 || StartWriter();
+
+    if (started)
+    {
+        ++eventlog_users;
+    }
+
+    SDL_AtomicUnlock(&eventlog_lock);
+
+    if (!started)
+    {
+        I_Error("NET_EventLog_Init: Failed to start writer thread: %s",
+                SDL_GetError());
+    }
+
+    eventlog_initialized = true;
+    I_AtExit(NET_EventLog_Shutdown, true);
+}
+
+// Get the next free event, or NULL if the queue is full.  If one is
+// returned, events_lock is held until it is committed.
+
+static net_event_t *ReserveEvent(void)
+{
+    unsigned int head, tail;
+
+    SDL_AtomicLock(&events_lock);
+
+    head = SDL_AtomicGet(&events_head);
+    tail = SDL_AtomicGet(&events_tail);
+
+    if (head - tail >= EVENT_QUEUE_SIZE)
+    {
+        if (events_dropped == 0)
+        {
+            fprintf(stderr, "NET_EventLog: queue full, dropping events\n");
+        }
+
+        ++events_dropped;
+        SDL_AtomicUnlock(&events_lock);
+        return NULL;
+    }
+
+    return &events[head & (EVENT_QUEUE_SIZE - 1)];
+}
+
+// Publish the reserved event.  The writer is only woken if it may
+// have gone to sleep on an empty queue.
+
+static void CommitEvent(void)
+{
+    unsigned int head;
+
+    head = SDL_AtomicAdd(&events_head, 1);
+
+    SDL_AtomicUnlock(&events_lock);
+
+    if (SDL_AtomicGet(&events_tail) == head)
+    {
+        SDL_SemPost(writer_sem);
+    }
+}
+
+void NET_EventLog_Score(int tic, int player, const char *name,
+                        int sector_tag)
+{
+    net_event_t *event;
+
+    if (!eventlog_initialized)
+    {
+        return;
+    }
+
+    event = ReserveEvent();
+
+    if (event == NULL)
+    {
+        return;
+    }
+
+    event->type = EVENT_SCORE;
+    event->match = I_InstanceNumber();
+    event->time = time(NULL);
+    event->tic = tic;
+    event->player = player;
+    event->sector_tag = sector_tag;
+    M_StringCopy(event->name, name != NULL ? name : "", sizeof(event->name));
+
+    CommitEvent();
+}
+
+void NET_EventLog_Message(const char *text)
+{
+    net_event_t *event;
+
+    // Without a log file, messages are only printed to the console.
+
+    if (!eventlog_initialized || eventlog_path == NULL)
+    {
+        return;
+    }
+
+    event = ReserveEvent();
+
+    if (event == NULL)
+    {
+        return;
+    }
+
+    event->type = EVENT_MESSAGE;
+    event->match = I_InstanceNumber();
+    event->time = time(NULL);
+    M_StringCopy(event->text, text, sizeof(event->text));
+
+    CommitEvent();
+}
+
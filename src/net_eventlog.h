@@ -0,0 +1,30 @@
+//
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//     Server event log.  Events are queued by the game and written
+//     out by a background thread.
+//
+
+#ifndef NET_EVENTLOG_H
+#define NET_EVENTLOG_H
+
+#include "doomtype.h"
+
+void NET_EventLog_Init(void);
+void NET_EventLog_Score(int tic, int player, const char *name,
+                        int sector_tag);
+void NET_EventLog_Message(const char *text);
+
+#endif /* #ifndef NET_EVENTLOG_H */
+
@@ -32,23 +32,24 @@
 
 #include "net_client.h"
 #include "net_gui.h"
+#include "net_io.h"
 #include "net_query.h"
 #include "net_server.h"
 
 #include "textscreen.h"
 
-static txt_window_t *window;
-static int old_max_players;
-static txt_label_t *player_labels[NET_MAXPLAYERS];
-static txt_label_t *ip_labels[NET_MAXPLAYERS];
-static txt_label_t *drone_label;
-static txt_label_t *master_msg_label;
-static boolean had_warning;
+static INSTANCE txt_window_t *window;
+static INSTANCE int old_max_players;
+static INSTANCE txt_label_t *player_labels[NET_MAXPLAYERS];
+static INSTANCE txt_label_t *ip_labels[NET_MAXPLAYERS];
+static INSTANCE txt_label_t *drone_label;
+static INSTANCE txt_label_t *master_msg_label;
+static INSTANCE boolean had_warning;
 
 // Number of players we expect to be in the game. When the number is
 // reached, we auto-start the game (if we're the controller). If
 // zero, do not autostart.
-static int expected_nodes;
+static INSTANCE int expected_nodes;
 
 static void EscapePressed(TXT_UNCAST_ARG(widget), void *unused)
 {
@@ -392,6 +393,40 @@ static void CheckAutoLaunch(void)
     }
 }
 
+#ifdef SERVER
+
+// The server build has no display to show the wait dialog on, so just
+// keep the network running until enough nodes have joined to launch
+// the game (see -nodes).
+
+void NET_WaitForLaunch(void)
+{
+    ParseCommandLineArgs();
+
+    if (expected_nodes <= 0)
+    {
+        printf("NET_WaitForLaunch: No -nodes given; waiting for another "
+               "player to start the game.\n");
+    }
+
+    while (net_waiting_for_launch)
+    {
+        CheckAutoLaunch();
+
+        NET_CL_Run();
+        NET_SV_Run();
+
+        if (!net_client_connected)
+        {
+            I_Error("Lost connection to server");
+        }
+
+        NET_WaitForPackets(I_GetTimeNS() + 100000000);
+    }
+}
+
+#else
+
 void NET_WaitForLaunch(void)
 {
     if (!TXT_Init())
@@ -431,3 +466,5 @@ void NET_WaitForLaunch(void)
 
     TXT_Shutdown();
 }
+
+#endif /* #ifdef SERVER */
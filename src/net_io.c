@@ -19,8 +19,10 @@
 #include <stdio.h>
 
 #include "i_system.h"
+#include "i_timer.h"
 #include "net_defs.h"
 #include "net_io.h"
+#include "net_metrics.h"
 #include "z_zone.h"
 
 #define MAX_MODULES 16
@@ -31,7 +33,12 @@ struct _net_context_s
     int num_modules;
 };
 
-net_addr_t net_broadcast_addr;
+INSTANCE net_addr_t net_broadcast_addr;
+
+// Every module added to any context, for NET_WaitForPackets.
+
+static INSTANCE net_module_t *all_modules[MAX_MODULES];
+static INSTANCE int num_all_modules;
 
 net_context_t *NET_NewContext(void)
 {
@@ -45,6 +52,8 @@ net_context_t *NET_NewContext(void)
 
 void NET_AddModule(net_context_t *context, net_module_t *module)
 {
+    int i;
+
     if (context->num_modules >= MAX_MODULES)
     {
         I_Error("NET_AddModule: No more modules for context");
@@ -52,6 +61,20 @@ void NET_AddModule(net_context_t *context, net_module_t *module)
     
     context->modules[context->num_modules] = module;
     ++context->num_modules;
+
+    for (i = 0; i < num_all_modules; ++i)
+    {
+        if (all_modules[i] == module)
+        {
+            return;
+        }
+    }
+
+    if (num_all_modules < MAX_MODULES)
+    {
+        all_modules[num_all_modules] = module;
+        ++num_all_modules;
+    }
 }
 
 net_addr_t *NET_ResolveAddress(net_context_t *context, const char *addr)
@@ -75,6 +98,7 @@ net_addr_t *NET_ResolveAddress(net_context_t *context, const char *addr)
 
 void NET_SendPacket(net_addr_t *addr, net_packet_t *packet)
 {
+    NET_Metrics_PacketOut(packet->len);
     addr->module->SendPacket(addr, packet);
 }
 
@@ -88,6 +112,93 @@ void NET_SendBroadcast(net_context_t *context, net_packet_t *packet)
     }
 }
 
+void NET_FlushPackets(net_context_t *context)
+{
+    int i;
+
+    for (i=0; i<context->num_modules; ++i)
+    {
+        if (context->modules[i]->Flush != NULL)
+        {
+            context->modules[i]->Flush();
+        }
+    }
+}
+
+// Block until a packet arrives for any module, or until I_GetTimeNS()
+// reaches the deadline.  Only one module is expected to really block
+// (the transport used by the server or client); any others are only
+// checked.  If some module cannot wait at all, fall back to checking
+// every millisecond.
+
+boolean NET_WaitForPackets(uint64_t deadline)
+{
+    boolean polling;
+    uint64_t now;
+    int timeout;
+    int i;
+
+    // Check everything first, so that a packet already waiting in one
+    // module is not held up while we block on another.
+
+    polling = false;
+
+    for (i = 0; i < num_all_modules; ++i)
+    {
+        if (all_modules[i]->WaitPacket == NULL)
+        {
+            polling = true;
+        }
+        else if (all_modules[i]->WaitPacket(0))
+        {
+            return true;
+        }
+    }
+
+    for (i = 0; i < num_all_modules; ++i)
+    {
+        if (all_modules[i]->WaitPacket == NULL)
+        {
+            continue;
+        }
+
+        now = I_GetTimeNS();
+
+        if (now >= deadline)
+        {
+            return false;
+        }
+
+        // Round down: the rest is slept precisely below.
+
+        timeout = (deadline - now) / 1000000;
+
+        if (polling && timeout > 1)
+        {
+            timeout = 1;
+        }
+
+        if (timeout > 0 && all_modules[i]->WaitPacket(timeout))
+        {
+            return true;
+        }
+    }
+
+    if (polling)
+    {
+        now = I_GetTimeNS();
+
+        if (deadline > now + 1000000)
+        {
+            deadline = now + 1000000;
+        }
+    }
+
+    I_SleepUntilNS(deadline);
+
+    return false;
+}
+
 boolean NET_RecvPacket(net_context_t *context, 
                        net_addr_t **addr, 
                        net_packet_t **packet)
@@ -100,6 +211,7 @@ boolean NET_RecvPacket(net_context_t *context,
     {
         if (context->modules[i]->RecvPacket(addr, packet))
         {
+            NET_Metrics_PacketIn((*packet)->len);
             NET_ReferenceAddress(*addr);
             return true;
         }
@@ -113,7 +225,7 @@ boolean NET_RecvPacket(net_context_t *context,
 
 char *NET_AddrToString(net_addr_t *addr)
 {
-    static char buf[128];
+    static INSTANCE char buf[128];
 
     addr->module->AddrToString(addr, buf, sizeof(buf) - 1);
 
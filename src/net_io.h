@@ -20,7 +20,7 @@
 
 #include "net_defs.h"
 
-extern net_addr_t net_broadcast_addr;
+extern INSTANCE net_addr_t net_broadcast_addr;
 
 // Create a new network context.
 net_context_t *NET_NewContext(void);
@@ -34,6 +34,13 @@ void NET_SendPacket(net_addr_t *addr, net_packet_t *packet);
 // Send a broadcast using all modules in the given context.
 void NET_SendBroadcast(net_context_t *context, net_packet_t *packet);
 
+// Transmit any packets queued up by modules in the given context.
+void NET_FlushPackets(net_context_t *context);
+
+// Wait until a packet arrives for any module, or until I_GetTimeNS()
+// reaches the given deadline.  Returns true if a packet may be ready.
+boolean NET_WaitForPackets(uint64_t deadline);
+
 // Check all modules in the given context and receive a packet, returning true
 // if a packet was received. The result is stored in *packet and the source is
 // stored in *addr, with an implicit reference added. The packet must be freed
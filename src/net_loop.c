@@ -33,10 +33,10 @@ typedef struct
     int head, tail;
 } packet_queue_t;
 
-static packet_queue_t client_queue;
-static packet_queue_t server_queue;
-static net_addr_t client_addr;
-static net_addr_t server_addr;
+static INSTANCE packet_queue_t client_queue;
+static INSTANCE packet_queue_t server_queue;
+static INSTANCE net_addr_t client_addr;
+static INSTANCE net_addr_t server_addr;
 
 static void QueueInit(packet_queue_t *queue)
 {
@@ -101,6 +101,14 @@ static void NET_CL_SendPacket(net_addr_t *addr, net_packet_t *packet)
     QueuePush(&server_queue, NET_PacketDup(packet));
 }
 
+// Packets are only ever queued by this thread, so there is nothing to
+// wait for.
+
+static boolean NET_CL_WaitPacket(int timeout_ms)
+{
+    return client_queue.head != client_queue.tail;
+}
+
 static boolean NET_CL_RecvPacket(net_addr_t **addr, net_packet_t **packet)
 {
     net_packet_t *popped;
@@ -151,6 +159,8 @@ net_module_t net_loop_client_module =
     NET_CL_AddrToString,
     NET_CL_FreeAddress,
     NET_CL_ResolveAddress,
+    NULL,
+    NET_CL_WaitPacket,
 };
 
 //-----------------------------------------------------------------------------
@@ -177,6 +187,11 @@ static void NET_SV_SendPacket(net_addr_t *addr, net_packet_t *packet)
     QueuePush(&client_queue, NET_PacketDup(packet));
 }
 
+static boolean NET_SV_WaitPacket(int timeout_ms)
+{
+    return server_queue.head != server_queue.tail;
+}
+
 static boolean NET_SV_RecvPacket(net_addr_t **addr, net_packet_t **packet)
 {
     net_packet_t *popped;
@@ -226,6 +241,8 @@ net_module_t net_loop_server_module =
     NET_SV_AddrToString,
     NET_SV_FreeAddress,
     NET_SV_ResolveAddress,
+    NULL,
+    NET_SV_WaitPacket,
 };
 
 
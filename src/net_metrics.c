@@ -0,0 +1,636 @@
+//
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//     Server telemetry: counters and latency histograms, written out
+//     periodically in the Prometheus text format.
+//
+//     All of the counters are updated from the main loop, as is the
+//     code that writes them out, so none of them need locking.  The
+//     file is written under a temporary name and renamed into place,
+//     so that a collector never sees a partly written file.
+//
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "i_timer.h"
+#include "m_argv.h"
+#include "m_misc.h"
+
+#include "net_defs.h"
+#include "net_metrics.h"
+#include "net_packet.h"
+
+// How often to write out the metrics file, in ms.
+
+#define METRICS_PERIOD 5000
+
+#define METRICS_PREFIX "doom_server_"
+
+typedef struct
+{
+    boolean active;
+    char name[32];
+
+    net_histogram_t rtt;
+    net_histogram_t send_lag;
+    net_histogram_t recovery;
+    uint64_t resend_requests;
+    uint64_t resend_tics;
+    uint64_t tics_resent;
+    uint64_t stalls;
+    uint64_t substituted;
+    uint64_t late_accepted;
+    uint64_t late_dropped;
+    uint64_t bundle;
+} player_metrics_t;
+
+static INSTANCE char *metrics_path = NULL;
+static INSTANCE char *metrics_temp_path;
+static INSTANCE int metrics_last_write;
+
+static INSTANCE uint64_t packets_in, bytes_in;
+static INSTANCE uint64_t packets_out, bytes_out;
+static INSTANCE uint64_t packets_dropped, bytes_dropped;
+static INSTANCE uint64_t queries_answered, queries_refused;
+static INSTANCE net_histogram_t tic_time;
+static INSTANCE net_histogram_t tic_jitter;
+
+static INSTANCE player_metrics_t player_metrics[NET_MAXPLAYERS];
+
+// Find the bucket for the given value.  Values below 4 get a bucket
+// each; above that, the bucket is chosen by the position of the top
+// bit and the two bits following it.
+
+static int BucketIndex(unsigned int value)
+{
+    int exponent;
+    int index;
+
+    if (value < 4)
+    {
+        return value;
+    }
+
+    exponent = 2;
+
+    while ((value >> exponent) > 1)
+    {
+        ++exponent;
+    }
+
+    index = 4 * (exponent - 1) + ((value >> (exponent - 2)) & 3);
+
+    if (index >= NET_METRICS_BUCKETS)
+    {
+        index = NET_METRICS_BUCKETS - 1;
+    }
+
+    return index;
+}
+
+// Smallest value that falls into the given bucket.
+
+static uint64_t BucketLowest(int index)
+{
+    if (index < 4)
+    {
+        return index;
+    }
+
+    return (uint64_t) (4 + (index & 3)) << (index / 4 - 1);
+}
+
+void NET_Histogram_Add(net_histogram_t *hist, unsigned int value)
+{
+    ++hist->buckets[BucketIndex(value)];
+    ++hist->count;
+    hist->sum += value;
+}
+
+static player_metrics_t *GetPlayer(int player)
+{
+    if (player < 0 || player >= NET_MAXPLAYERS)
+    {
+        return NULL;
+    }
+
+    return &player_metrics[player];
+}
+
+void NET_Metrics_PacketIn(size_t len)
+{
+    ++packets_in;
+    bytes_in += len;
+}
+
+void NET_Metrics_PacketOut(size_t len)
+{
+    ++packets_out;
+    bytes_out += len;
+}
+
+// A packet deliberately not sent, to simulate packet loss (see
+// DROP_PACKETS in net_sdl.c).  It is still counted as sent.
+
+void NET_Metrics_PacketDropped(size_t len)
+{
+    ++packets_dropped;
+    bytes_dropped += len;
+}
+
+// A query from a server browser, answered or not according to the
+// rate limits.
+
+void NET_Metrics_Query(boolean answered)
+{
+    if (answered)
+    {
+        ++queries_answered;
+    }
+    else
+    {
+        ++queries_refused;
+    }
+}
+
+// Called when a player slot is assigned to a new client at the
+// start of a game.
+
+void NET_Metrics_ResetPlayer(int player, const char *name)
+{
+    player_metrics_t *pm = GetPlayer(player);
+
+    if (pm == NULL)
+    {
+        return;
+    }
+
+    memset(pm, 0, sizeof(*pm));
+
+    if (name != NULL)
+    {
+        pm->active = true;
+        M_StringCopy(pm->name, name, sizeof(pm->name));
+    }
+}
+
+// Round trip time as measured by the client's clock sync, and
+// reported back to us with each tic.
+
+void NET_Metrics_PlayerRTT(int player, int ms)
+{
+    player_metrics_t *pm = GetPlayer(player);
+
+    if (pm != NULL && ms >= 0)
+    {
+        NET_Histogram_Add(&pm->rtt, ms);
+    }
+}
+
+void NET_Metrics_PlayerResend(int player, int tics)
+{
+    player_metrics_t *pm = GetPlayer(player);
+
+    if (pm != NULL)
+    {
+        ++pm->resend_requests;
+        pm->resend_tics += tics;
+    }
+}
+
+// Tics sent to the player again because they did not receive them.
+
+void NET_Metrics_PlayerTicsResent(int player, int tics)
+{
+    player_metrics_t *pm = GetPlayer(player);
+
+    if (pm != NULL)
+    {
+        pm->tics_resent += tics;
+    }
+}
+
+// Time from asking the player to resend a tic to receiving it.
+
+void NET_Metrics_PlayerRecovery(int player, int ms)
+{
+    player_metrics_t *pm = GetPlayer(player);
+
+    if (pm != NULL && ms >= 0)
+    {
+        NET_Histogram_Add(&pm->recovery, ms);
+    }
+}
+
+// Number of tics sent to the player that they have not acknowledged
+// yet, sampled each time a new tic is sent.
+
+void NET_Metrics_PlayerSendLag(int player, int tics)
+{
+    player_metrics_t *pm = GetPlayer(player);
+
+    if (pm != NULL && tics >= 0)
+    {
+        NET_Histogram_Add(&pm->send_lag, tics);
+    }
+}
+
+// Sending to the player was held up waiting for acknowledgements.
+
+void NET_Metrics_PlayerStall(int player)
+{
+    player_metrics_t *pm = GetPlayer(player);
+
+    if (pm != NULL)
+    {
+        ++pm->stalls;
+    }
+}
+
+// A ticcmd was made up for the player because theirs was too late.
+
+void NET_Metrics_PlayerSubstituted(int player)
+{
+    player_metrics_t *pm = GetPlayer(player);
+
+    if (pm != NULL)
+    {
+        ++pm->substituted;
+    }
+}
+
+// A ticcmd arrived from the player after one had been made up for
+// them; it was either still used in some form or thrown away.
+
+void NET_Metrics_PlayerLateTic(int player, boolean accepted)
+{
+    player_metrics_t *pm = GetPlayer(player);
+
+    if (pm == NULL)
+    {
+        return;
+    }
+
+    if (accepted)
+    {
+        ++pm->late_accepted;
+    }
+    else
+    {
+        ++pm->late_dropped;
+    }
+}
+
+// Number of new tics currently being sent to the player in each packet.
+
+void NET_Metrics_PlayerBundle(int player, int tics)
+{
+    player_metrics_t *pm = GetPlayer(player);
+
+    if (pm != NULL)
+    {
+        pm->bundle = tics;
+    }
+}
+
+// Time taken to run a tic.
+
+void NET_Metrics_TicTime(uint64_t ns)
+{
+    NET_Histogram_Add(&tic_time, ns / 1000);
+}
+
+// How late the main loop woke up for the start of a tic.
+
+void NET_Metrics_TicJitter(uint64_t ns)
+{
+    NET_Histogram_Add(&tic_jitter, ns / 1000);
+}
+
+// Write a label value, escaped as the text format requires.
+
+static void WriteLabelValue(FILE *fstream, const char *value)
+{
+    for (; *value != '\0'; ++value)
+    {
+        switch (*value)
+        {
+            case '\\':
+                fputs("\\\\", fstream);
+                break;
+            case '"':
+                fputs("\\\"", fstream);
+                break;
+            case '\n':
+                fputs("\\n", fstream);
+                break;
+            default:
+                fputc(*value, fstream);
+                break;
+        }
+    }
+}
+
+static void WriteHeader(FILE *fstream, const char *name, const char *type,
+                        const char *help)
+{
+    fprintf(fstream, "# HELP " METRICS_PREFIX "%s %s\n", name, help);
+    fprintf(fstream, "# TYPE " METRICS_PREFIX "%s %s\n", name, type);
+}
+
+// Labels for a player's series, without the surrounding braces.
+
+static void WritePlayerLabels(FILE *fstream, int player)
+{
+    fprintf(fstream, "player=\"%d\",name=\"", player);
+    WriteLabelValue(fstream, player_metrics[player].name);
+    fputc('"', fstream);
+}
+
+static void WriteHistogram(FILE *fstream, const char *name,
+                           net_histogram_t *hist, int player)
+{
+    uint64_t total;
+    int last;
+    int i;
+
+    // Only write out buckets as far as the largest value seen.
+
+    for (last = NET_METRICS_BUCKETS - 2; last > 0; --last)
+    {
+        if (hist->buckets[last] != 0)
+        {
+            break;
+        }
+    }
+
+    total = 0;
+
+    for (i = 0; i <= last; ++i)
+    {
+        total += hist->buckets[i];
+
+        fprintf(fstream, METRICS_PREFIX "%s_bucket{", name);
+        if (player >= 0)
+        {
+            WritePlayerLabels(fstream, player);
+            fputc(',', fstream);
+        }
+        fprintf(fstream, "le=\"%llu\"} %llu\n",
+                (unsigned long long) (BucketLowest(i + 1) - 1),
+                (unsigned long long) total);
+    }
+
+    fprintf(fstream, METRICS_PREFIX "%s_bucket{", name);
+    if (player >= 0)
+    {
+        WritePlayerLabels(fstream, player);
+        fputc(',', fstream);
+    }
+    fprintf(fstream, "le=\"+Inf\"} %llu\n",
+            (unsigned long long) hist->count);
+
+    fprintf(fstream, METRICS_PREFIX "%s_sum", name);
+    if (player >= 0)
+    {
+        fputc('{', fstream);
+        WritePlayerLabels(fstream, player);
+        fputc('}', fstream);
+    }
+    fprintf(fstream, " %llu\n", (unsigned long long) hist->sum);
+
+    fprintf(fstream, METRICS_PREFIX "%s_count", name);
+    if (player >= 0)
+    {
+        fputc('{', fstream);
+        WritePlayerLabels(fstream, player);
+        fputc('}', fstream);
+    }
+    fprintf(fstream, " %llu\n", (unsigned long long) hist->count);
+}
+
+static void WriteCounter(FILE *fstream, const char *name, uint64_t value)
+{
+    fprintf(fstream, METRICS_PREFIX "%s %llu\n", name,
+            (unsigned long long) value);
+}
+
+// Write one counter series per active player, using the field at the
+// given offset into player_metrics_t.
+
+static void WritePlayerCounters(FILE *fstream, const char *name,
+                                size_t offset)
+{
+    uint64_t value;
+    int i;
+
+    for (i = 0; i < NET_MAXPLAYERS; ++i)
+    {
+        if (!player_metrics[i].active)
+        {
+            continue;
+        }
+
+        memcpy(&value, (byte *) &player_metrics[i] + offset, sizeof(value));
+
+        fprintf(fstream, METRICS_PREFIX "%s{", name);
+        WritePlayerLabels(fstream, i);
+        fprintf(fstream, "} %llu\n", (unsigned long long) value);
+    }
+}
+
+static void WriteMetrics(FILE *fstream)
+{
+    unsigned int pool_hits, pool_misses;
+    int i;
+
+    WriteHeader(fstream, "packets_received_total", "counter",
+                "Packets received.");
+    WriteCounter(fstream, "packets_received_total", packets_in);
+    WriteHeader(fstream, "bytes_received_total", "counter",
+                "Bytes of packet data received.");
+    WriteCounter(fstream, "bytes_received_total", bytes_in);
+    WriteHeader(fstream, "packets_sent_total", "counter",
+                "Packets sent.");
+    WriteCounter(fstream, "packets_sent_total", packets_out);
+    WriteHeader(fstream, "bytes_sent_total", "counter",
+                "Bytes of packet data sent.");
+    WriteCounter(fstream, "bytes_sent_total", bytes_out);
+    WriteHeader(fstream, "packets_dropped_total", "counter",
+                "Packets dropped to simulate packet loss.");
+    WriteCounter(fstream, "packets_dropped_total", packets_dropped);
+    WriteHeader(fstream, "bytes_dropped_total", "counter",
+                "Bytes of packet data dropped to simulate packet loss.");
+    WriteCounter(fstream, "bytes_dropped_total", bytes_dropped);
+
+    WriteHeader(fstream, "queries_answered_total", "counter",
+                "Server queries answered.");
+    WriteCounter(fstream, "queries_answered_total", queries_answered);
+    WriteHeader(fstream, "queries_refused_total", "counter",
+                "Server queries not answered because of rate limits.");
+    WriteCounter(fstream, "queries_refused_total", queries_refused);
+
+    NET_PacketPoolStats(&pool_hits, &pool_misses);
+    WriteHeader(fstream, "packet_pool_hits_total", "counter",
+                "Packets allocated from the packet pool.");
+    WriteCounter(fstream, "packet_pool_hits_total", pool_hits);
+    WriteHeader(fstream, "packet_pool_misses_total", "counter",
+                "Packets allocated with malloc because the pool was empty.");
+    WriteCounter(fstream, "packet_pool_misses_total", pool_misses);
+
+    WriteHeader(fstream, "tic_time_us", "histogram",
+                "Time taken to run each game tic, in microseconds.");
+    WriteHistogram(fstream, "tic_time_us", &tic_time, -1);
+    WriteHeader(fstream, "tic_jitter_us", "histogram",
+                "How late each tic was started, in microseconds.");
+    WriteHistogram(fstream, "tic_jitter_us", &tic_jitter, -1);
+
+    WriteHeader(fstream, "resend_requests_total", "counter",
+                "Resend requests sent to each player.");
+    WritePlayerCounters(fstream, "resend_requests_total",
+                        offsetof(player_metrics_t, resend_requests));
+    WriteHeader(fstream, "resend_tics_total", "counter",
+                "Tics asked for in resend requests sent to each player.");
+    WritePlayerCounters(fstream, "resend_tics_total",
+                        offsetof(player_metrics_t, resend_tics));
+    WriteHeader(fstream, "tics_resent_total", "counter",
+                "Tics sent again to each player because they were lost.");
+    WritePlayerCounters(fstream, "tics_resent_total",
+                        offsetof(player_metrics_t, tics_resent));
+    WriteHeader(fstream, "send_stalls_total", "counter",
+                "Times sending to each player waited for acknowledgements.");
+    WritePlayerCounters(fstream, "send_stalls_total",
+                        offsetof(player_metrics_t, stalls));
+    WriteHeader(fstream, "substituted_tics_total", "counter",
+                "Tics for which a ticcmd was made up for each player.");
+    WritePlayerCounters(fstream, "substituted_tics_total",
+                        offsetof(player_metrics_t, substituted));
+    WriteHeader(fstream, "late_tics_accepted_total", "counter",
+                "Late ticcmds from each player that were still used.");
+    WritePlayerCounters(fstream, "late_tics_accepted_total",
+                        offsetof(player_metrics_t, late_accepted));
+    WriteHeader(fstream, "late_tics_dropped_total", "counter",
+                "Late ticcmds from each player that were thrown away.");
+    WritePlayerCounters(fstream, "late_tics_dropped_total",
+                        offsetof(player_metrics_t, late_dropped));
+
+    WriteHeader(fstream, "tic_bundle", "gauge",
+                "New tics sent to each player in each packet.");
+    WritePlayerCounters(fstream, "tic_bundle",
+                        offsetof(player_metrics_t, bundle));
+
+    WriteHeader(fstream, "rtt_ms", "histogram",
+                "Round trip time reported by each player, in ms.");
+
+    for (i = 0; i < NET_MAXPLAYERS; ++i)
+    {
+        if (player_metrics[i].active)
+        {
+            WriteHistogram(fstream, "rtt_ms", &player_metrics[i].rtt, i);
+        }
+    }
+
+    WriteHeader(fstream, "send_lag_tics", "histogram",
+                "Tics sent to each player but not yet acknowledged.");
+
+    for (i = 0; i < NET_MAXPLAYERS; ++i)
+    {
+        if (player_metrics[i].active)
+        {
+            WriteHistogram(fstream, "send_lag_tics",
+                           &player_metrics[i].send_lag, i);
+        }
+    }
+
+    WriteHeader(fstream, "resend_recovery_ms", "histogram",
+                "Time from a resend request to receiving the tic, in ms.");
+
+    for (i = 0; i < NET_MAXPLAYERS; ++i)
+    {
+        if (player_metrics[i].active)
+        {
+            WriteHistogram(fstream, "resend_recovery_ms",
+                           &player_metrics[i].recovery, i);
+        }
+    }
+}
+
+void NET_Metrics_Init(void)
+{
+    int p;
+
+    //!
+    // @category net
+    // @arg <file>
+    //
+    // When running a server, periodically write server metrics to
+    // the given file in the Prometheus text format.
+    //
+
+    p = M_CheckParmWithArgs("-metrics", 1);
+
+    if (p > 0)
+    {
+        metrics_path = myargv[p + 1];
+        metrics_temp_path = M_StringJoin(metrics_path, ".tmp", NULL);
+        metrics_last_write = I_GetTimeMS();
+    }
+}
+
+// Write out the metrics file if it is due.
+
+void NET_Metrics_Run(void)
+{
+    FILE *fstream;
+    int nowtime;
+
+    if (metrics_path == NULL)
+    {
+        return;
+    }
+
+    nowtime = I_GetTimeMS();
+
+    if (nowtime - metrics_last_write < METRICS_PERIOD)
+    {
+        return;
+    }
+
+    metrics_last_write = nowtime;
+
+    fstream = fopen(metrics_temp_path, "w");
+
+    if (fstream == NULL)
+    {
+        return;
+    }
+
+    WriteMetrics(fstream);
+
+    if (fclose(fstream) != 0)
+    {
+        remove(metrics_temp_path);
+        return;
+    }
+
+#ifdef _WIN32
+    remove(metrics_path);
+#endif
+
+    rename(metrics_temp_path, metrics_path);
+}
+
@@ -0,0 +1,62 @@
+//
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//     Server telemetry: counters and latency histograms, written out
+//     periodically in the Prometheus text format.
+//
+
+#ifndef NET_METRICS_H
+#define NET_METRICS_H
+
+#include "doomtype.h"
+
+// Number of histogram buckets.  Buckets are log-linear: four per
+// power of two, so each is within 25% of its neighbour.  The last
+// bucket holds everything too large for the others.
+
+#define NET_METRICS_BUCKETS 64
+
+typedef struct
+{
+    uint64_t buckets[NET_METRICS_BUCKETS];
+    uint64_t count;
+    uint64_t sum;
+} net_histogram_t;
+
+void NET_Metrics_Init(void);
+void NET_Metrics_Run(void);
+
+void NET_Metrics_PacketIn(size_t len);
+void NET_Metrics_PacketOut(size_t len);
+void NET_Metrics_PacketDropped(size_t len);
+void NET_Metrics_Query(boolean answered);
+
+void NET_Metrics_ResetPlayer(int player, const char *name);
+void NET_Metrics_PlayerRTT(int player, int ms);
+void NET_Metrics_PlayerResend(int player, int tics);
+void NET_Metrics_PlayerTicsResent(int player, int tics);
+void NET_Metrics_PlayerRecovery(int player, int ms);
+void NET_Metrics_PlayerSendLag(int player, int tics);
+void NET_Metrics_PlayerStall(int player);
+void NET_Metrics_PlayerSubstituted(int player);
+void NET_Metrics_PlayerLateTic(int player, boolean accepted);
+void NET_Metrics_PlayerBundle(int player, int tics);
+
+void NET_Metrics_TicTime(uint64_t ns);
+void NET_Metrics_TicJitter(uint64_t ns);
+
+void NET_Histogram_Add(net_histogram_t *hist, unsigned int value);
+
+#endif /* #ifndef NET_METRICS_H */
+
@@ -21,11 +21,81 @@
 #include "net_packet.h"
 #include "z_zone.h"
 
-static int total_packet_memory = 0;
+// Packets up to MAX_PACKET_SIZE are taken from a fixed pool rather
+// than the zone, so that the steady-state receive path does not
+// allocate.  Larger packets, or any packet requested while the pool
+// is exhausted, fall back to Z_Malloc.
+
+#define PACKET_POOL_SIZE 128
+
+typedef struct
+{
+    net_packet_t packet;
+    byte data[MAX_PACKET_SIZE];
+} pooled_packet_t;
+
+static INSTANCE pooled_packet_t packet_pool[PACKET_POOL_SIZE];
+static INSTANCE pooled_packet_t *packet_pool_free[PACKET_POOL_SIZE];
+static INSTANCE int packet_pool_num_free = -1;
+
+static INSTANCE unsigned int packet_pool_hits = 0;
+static INSTANCE unsigned int packet_pool_misses = 0;
+
+static INSTANCE int total_packet_memory = 0;
+
+static void InitPacketPool(void)
+{
+    int i;
+
+    for (i = 0; i < PACKET_POOL_SIZE; ++i)
+    {
+        packet_pool_free[i] = &packet_pool[i];
+    }
+
+    packet_pool_num_free = PACKET_POOL_SIZE;
+}
+
+// Returns the pool entry for a packet, or NULL if it was allocated
+// from the zone.
+
+static pooled_packet_t *PoolEntry(net_packet_t *packet)
+{
+    pooled_packet_t *entry = (pooled_packet_t *) packet;
+
+    if (entry >= packet_pool && entry < packet_pool + PACKET_POOL_SIZE)
+    {
+        return entry;
+    }
+
+    return NULL;
+}
 
 net_packet_t *NET_NewPacket(int initial_size)
 {
     net_packet_t *packet;
+    pooled_packet_t *entry;
+
+    if (packet_pool_num_free < 0)
+    {
+        InitPacketPool();
+    }
+
+    if (initial_size <= MAX_PACKET_SIZE && packet_pool_num_free > 0)
+    {
+        ++packet_pool_hits;
+        --packet_pool_num_free;
+        entry = packet_pool_free[packet_pool_num_free];
+
+        packet = &entry->packet;
+        packet->data = entry->data;
+        packet->alloced = MAX_PACKET_SIZE;
+        packet->len = 0;
+        packet->pos = 0;
+
+        return packet;
+    }
+
+    ++packet_pool_misses;
 
     packet = (net_packet_t *) Z_Malloc(sizeof(net_packet_t), PU_STATIC, 0);
     
@@ -60,13 +130,42 @@ net_packet_t *NET_PacketDup(net_packet_t *packet)
 
 void NET_FreePacket(net_packet_t *packet)
 {
+    pooled_packet_t *entry;
+
     //printf("%p: destroyed\n", packet);
+
+    entry = PoolEntry(packet);
+
+    if (entry != NULL)
+    {
+        // The data may have been moved to the zone if the packet
+        // outgrew its pool buffer.
+
+        if (packet->data != entry->data)
+        {
+            total_packet_memory -= packet->alloced;
+            Z_Free(packet->data);
+        }
+
+        packet_pool_free[packet_pool_num_free] = entry;
+        ++packet_pool_num_free;
+        return;
+    }
     
     total_packet_memory -= sizeof(net_packet_t) + packet->alloced;
     Z_Free(packet->data);
     Z_Free(packet);
 }
 
+// Get statistics on the packet pool: the number of packets allocated
+// from the pool, and the number that had to be allocated from the zone.
+
+void NET_PacketPoolStats(unsigned int *hits, unsigned int *misses)
+{
+    *hits = packet_pool_hits;
+    *misses = packet_pool_misses;
+}
+
 // Read a byte from the packet, returning true if read
 // successfully
 
@@ -238,17 +337,29 @@ char *NET_ReadSafeString(net_packet_t *packet)
 
 static void NET_IncreasePacket(net_packet_t *packet)
 {
+    pooled_packet_t *entry;
     byte *newdata;
 
-    total_packet_memory -= packet->alloced;
-   
+    entry = PoolEntry(packet);
+
+    if (entry == NULL || packet->data != entry->data)
+    {
+        total_packet_memory -= packet->alloced;
+    }
+
     packet->alloced *= 2;
 
     newdata = Z_Malloc(packet->alloced, PU_STATIC, 0);
 
     memcpy(newdata, packet->data, packet->len);
 
-    Z_Free(packet->data);
+    // Pooled packets keep their pool buffer; only free zone memory.
+
+    if (entry == NULL || packet->data != entry->data)
+    {
+        Z_Free(packet->data);
+    }
+
     packet->data = newdata;
 
     total_packet_memory += packet->alloced;
@@ -323,6 +434,204 @@ void NET_WriteString(net_packet_t *packet, const char *string)
     packet->len += string_size;
 }
 
+// Write a block of raw bytes to the packet
+
+void NET_WriteBlob(net_packet_t *packet, const byte *data, size_t len)
+{
+    while (packet->len + len > packet->alloced)
+    {
+        NET_IncreasePacket(packet);
+    }
+
+    memcpy(packet->data + packet->len, data, len);
+
+    packet->len += len;
+}
+
+//
+// Bit streams
+//
+
+void NET_BitWriterInit(net_bitstream_t *stream, net_packet_t *packet)
+{
+    stream->packet = packet;
+    stream->bits = 0;
+    stream->num_bits = 0;
+}
+
+// Write the low num_bits bits of value (up to 32).
+
+void NET_WriteBits(net_bitstream_t *stream, unsigned int value, int num_bits)
+{
+    int n;
+
+    while (num_bits > 0)
+    {
+        n = num_bits > 8 ? 8 : num_bits;
+        num_bits -= n;
+
+        stream->bits = (stream->bits << n)
+                     | ((value >> num_bits) & ((1U << n) - 1));
+        stream->num_bits += n;
+
+        if (stream->num_bits >= 8)
+        {
+            stream->num_bits -= 8;
+            NET_WriteInt8(stream->packet,
+                          (stream->bits >> stream->num_bits) & 0xff);
+        }
+    }
+}
+
+// Write bits saved from another stream, held most significant bit
+// first as NET_BitWriterFinish leaves them.
+
+void NET_WriteBitBlob(net_bitstream_t *stream, const byte *data,
+                      int num_bits)
+{
+    while (num_bits >= 8)
+    {
+        NET_WriteBits(stream, *data++, 8);
+        num_bits -= 8;
+    }
+
+    if (num_bits > 0)
+    {
+        NET_WriteBits(stream, *data >> (8 - num_bits), num_bits);
+    }
+}
+
+// Pad the last byte with zero bits and write it out.
 
+void NET_BitWriterFinish(net_bitstream_t *stream)
+{
+    if (stream->num_bits > 0)
+    {
+        NET_WriteInt8(stream->packet,
+                      (stream->bits << (8 - stream->num_bits)) & 0xff);
+        stream->num_bits = 0;
+    }
+}
+
+// Write an unsigned value as an order-k exponential Golomb code: small
+// values (below 2^k) take k+1 bits, and each doubling after that costs
+// two more.
 
+void NET_WriteVarUInt(net_bitstream_t *stream, unsigned int value, int k)
+{
+    unsigned int w;
+    int num_bits;
+
+    w = value + (1U << k);
+
+    for (num_bits = 1; num_bits < 32 && (w >> num_bits) != 0; ++num_bits);
+
+    NET_WriteBits(stream, 0, num_bits - k - 1);
+    NET_WriteBits(stream, w, num_bits);
+}
+
+// Signed values are zigzag encoded first (0, -1, 1, -2, ...) so that
+// small negative values stay short.
+
+void NET_WriteVarSInt(net_bitstream_t *stream, signed int value, int k)
+{
+    unsigned int zigzag;
+
+    zigzag = ((unsigned int) value << 1) ^ (unsigned int) (value >> 31);
+
+    NET_WriteVarUInt(stream, zigzag, k);
+}
+
+void NET_BitReaderInit(net_bitstream_t *stream, net_packet_t *packet)
+{
+    stream->packet = packet;
+    stream->bits = 0;
+    stream->num_bits = 0;
+}
+
+boolean NET_ReadBits(net_bitstream_t *stream, unsigned int *value,
+                     int num_bits)
+{
+    unsigned int result = 0;
+    unsigned int b;
+    int n;
+
+    while (num_bits > 0)
+    {
+        if (stream->num_bits == 0)
+        {
+            if (!NET_ReadInt8(stream->packet, &b))
+            {
+                return false;
+            }
+
+            stream->bits = b;
+            stream->num_bits = 8;
+        }
+
+        n = num_bits < stream->num_bits ? num_bits : stream->num_bits;
+        num_bits -= n;
+        stream->num_bits -= n;
+
+        result = (result << n)
+               | ((stream->bits >> stream->num_bits) & ((1U << n) - 1));
+    }
+
+    *value = result;
+
+    return true;
+}
+
+boolean NET_ReadVarUInt(net_bitstream_t *stream, unsigned int *value, int k)
+{
+    unsigned int bit, rest;
+    int zeros;
+
+    // Count the leading zeros up to the first 1 bit.
+
+    zeros = 0;
+
+    for (;;)
+    {
+        if (!NET_ReadBits(stream, &bit, 1))
+        {
+            return false;
+        }
+
+        if (bit)
+        {
+            break;
+        }
+
+        ++zeros;
+
+        if (zeros + k >= 32)
+        {
+            return false;
+        }
+    }
+
+    if (!NET_ReadBits(stream, &rest, zeros + k))
+    {
+        return false;
+    }
+
+    *value = ((1U << (zeros + k)) | rest) - (1U << k);
+
+    return true;
+}
+
+boolean NET_ReadVarSInt(net_bitstream_t *stream, signed int *value, int k)
+{
+    unsigned int zigzag;
+
+    if (!NET_ReadVarUInt(stream, &zigzag, k))
+    {
+        return false;
+    }
+
+    *value = (signed int) (zigzag >> 1) ^ -(signed int) (zigzag & 1);
+
+    return true;
+}
 
@@ -20,9 +20,20 @@
 
 #include "net_defs.h"
 
+// Bit-level access to a packet.  Bits are packed most significant bit
+// first; a writer must be finished to flush the last partial byte.
+
+typedef struct
+{
+    net_packet_t *packet;
+    unsigned int bits;
+    int num_bits;
+} net_bitstream_t;
+
 net_packet_t *NET_NewPacket(int initial_size);
 net_packet_t *NET_PacketDup(net_packet_t *packet);
 void NET_FreePacket(net_packet_t *packet);
+void NET_PacketPoolStats(unsigned int *hits, unsigned int *misses);
 
 boolean NET_ReadInt8(net_packet_t *packet, unsigned int *data);
 boolean NET_ReadInt16(net_packet_t *packet, unsigned int *data);
@@ -40,6 +51,21 @@ void NET_WriteInt16(net_packet_t *packet, unsigned int i);
 void NET_WriteInt32(net_packet_t *packet, unsigned int i);
 
 void NET_WriteString(net_packet_t *packet, const char *string);
+void NET_WriteBlob(net_packet_t *packet, const byte *data, size_t len);
+
+void NET_BitWriterInit(net_bitstream_t *stream, net_packet_t *packet);
+void NET_BitWriterFinish(net_bitstream_t *stream);
+void NET_WriteBits(net_bitstream_t *stream, unsigned int value, int num_bits);
+void NET_WriteBitBlob(net_bitstream_t *stream, const byte *data,
+                      int num_bits);
+void NET_WriteVarUInt(net_bitstream_t *stream, unsigned int value, int k);
+void NET_WriteVarSInt(net_bitstream_t *stream, signed int value, int k);
+
+void NET_BitReaderInit(net_bitstream_t *stream, net_packet_t *packet);
+boolean NET_ReadBits(net_bitstream_t *stream, unsigned int *value,
+                     int num_bits);
+boolean NET_ReadVarUInt(net_bitstream_t *stream, unsigned int *value, int k);
+boolean NET_ReadVarSInt(net_bitstream_t *stream, signed int *value, int k);
 
 #endif /* #ifndef NET_PACKET_H */
 
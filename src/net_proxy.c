@@ -0,0 +1,749 @@
+//
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//     Parser for the HAProxy PROXY protocol (versions 1 and 2).
+//
+//     The parser is fed whatever bytes have arrived on a connection
+//     and never consumes anything past the end of the header, so
+//     that game data sent straight after it is left for the caller.
+//
+
+#include <string.h>
+
+#include "i_timer.h"
+#include "m_argv.h"
+#include "m_misc.h"
+#include "net_proxy.h"
+#include "z_zone.h"
+
+#define V1_MIN_LEN 15   /* "PROXY UNKNOWN\r\n" */
+#define V1_MAX_LEN 107
+#define V2_HEADER_LEN 16
+
+static const byte v1_signature[] = "PROXY ";
+static const byte v2_signature[] =
+    "\x0d\x0a\x0d\x0a\x00\x0d\x0a\x51\x55\x49\x54\x0a";
+
+#define V1_SIGNATURE_LEN 6
+#define V2_SIGNATURE_LEN 12
+
+boolean NET_Proxy_Enabled(void)
+{
+    //!
+    // @category net
+    //
+    // When running a server, require connections to begin with a
+    // HAProxy PROXY protocol header, and only allow one connection
+    // from each source address.
+    //
+
+    return ENFORCE_PROXY || M_CheckParm("-proxy") > 0;
+}
+
+// A player who has dropped out can only connect again to rejoin a game
+// in progress if their address is let through again.
+
+boolean NET_Proxy_AllowReentry(void)
+{
+    return ALLOW_REENTRY || M_CheckParm("-latejoin") > 0;
+}
+
+void NET_Proxy_Start(net_proxy_state_t *state)
+{
+    state->len = 0;
+    state->deadline = I_GetTimeMS() + NET_PROXY_TIMEOUT;
+    memset(&state->source, 0, sizeof(state->source));
+}
+
+boolean NET_Proxy_TimedOut(net_proxy_state_t *state)
+{
+    return I_GetTimeMS() - state->deadline >= 0;
+}
+
+static boolean IsVersion2(net_proxy_state_t *state)
+{
+    return state->len > 0 && state->buf[0] == v2_signature[0];
+}
+
+// Returns how many more bytes can be read from the connection without
+// reading past the end of the header.  This is for callers that cannot
+// push data back; it is always at least 1 while the header is
+// incomplete.
+
+unsigned int NET_Proxy_BytesWanted(net_proxy_state_t *state)
+{
+    unsigned int total;
+
+    if (state->len < V1_MIN_LEN)
+    {
+        return V1_MIN_LEN - state->len;
+    }
+
+    if (IsVersion2(state))
+    {
+        if (state->len < V2_HEADER_LEN)
+        {
+            return V2_HEADER_LEN - state->len;
+        }
+
+        total = V2_HEADER_LEN
+              + ((state->buf[14] << 8) | state->buf[15]);
+
+        return total - state->len;
+    }
+
+    // A version 1 header ends with CRLF, so unless we already have the
+    // CR there are at least two bytes still to come.
+
+    if (state->buf[state->len - 1] == '\r')
+    {
+        return 1;
+    }
+    else
+    {
+        return 2;
+    }
+}
+
+//
+// Version 1 (text) headers
+//
+
+// Find the next space-separated field in the line, returning its
+// length.
+
+static int NextField(const char **p, const char *end)
+{
+    const char *start = *p;
+
+    while (*p < end && **p != ' ')
+    {
+        ++*p;
+    }
+
+    return *p - start;
+}
+
+static boolean ParsePort(const char *s, int len, unsigned int *port)
+{
+    unsigned int result = 0;
+    int i;
+
+    if (len < 1 || len > 5)
+    {
+        return false;
+    }
+
+    for (i = 0; i < len; ++i)
+    {
+        if (s[i] < '0' || s[i] > '9')
+        {
+            return false;
+        }
+
+        result = result * 10 + (s[i] - '0');
+    }
+
+    if (result > 65535)
+    {
+        return false;
+    }
+
+    *port = result;
+
+    return true;
+}
+
+static boolean ParseIPv4(const char *s, int len, byte *out)
+{
+    unsigned int octet;
+    int digits;
+    int i, n;
+
+    i = 0;
+
+    for (n = 0; n < 4; ++n)
+    {
+        if (n > 0)
+        {
+            if (i >= len || s[i] != '.')
+            {
+                return false;
+            }
+            ++i;
+        }
+
+        octet = 0;
+        digits = 0;
+
+        while (i < len && s[i] >= '0' && s[i] <= '9' && digits < 3)
+        {
+            octet = octet * 10 + (s[i] - '0');
+            ++digits;
+            ++i;
+        }
+
+        if (digits == 0 || octet > 255)
+        {
+            return false;
+        }
+
+        out[n] = octet;
+    }
+
+    return i == len;
+}
+
+static int HexDigit(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+
+    return -1;
+}
+
+// Parse an IPv6 address, including the "::" shorthand and a trailing
+// dotted IPv4 part (eg. "::ffff:192.0.2.1").
+
+static boolean ParseIPv6(const char *s, int len, byte *out)
+{
+    unsigned int words[8];
+    unsigned int value;
+    int num_words = 0;
+    int gap = -1;
+    int group_start;
+    int digits, d;
+    int i, n;
+
+    i = 0;
+
+    if (len >= 2 && s[0] == ':' && s[1] == ':')
+    {
+        gap = 0;
+        i = 2;
+    }
+
+    while (i < len)
+    {
+        group_start = i;
+        value = 0;
+        digits = 0;
+
+        while (i < len && (d = HexDigit(s[i])) >= 0)
+        {
+            value = (value << 4) | d;
+            ++digits;
+            ++i;
+        }
+
+        // Embedded IPv4 address at the end?
+
+        if (i < len && s[i] == '.')
+        {
+            byte v4[4];
+
+            if (num_words > 6
+             || !ParseIPv4(s + group_start, len - group_start, v4))
+            {
+                return false;
+            }
+
+            words[num_words++] = (v4[0] << 8) | v4[1];
+            words[num_words++] = (v4[2] << 8) | v4[3];
+            i = len;
+            break;
+        }
+
+        if (digits < 1 || digits > 4 || num_words >= 8)
+        {
+            return false;
+        }
+
+        words[num_words++] = value;
+
+        if (i >= len)
+        {
+            break;
+        }
+
+        if (s[i] != ':')
+        {
+            return false;
+        }
+
+        ++i;
+
+        if (i < len && s[i] == ':')
+        {
+            if (gap >= 0)
+            {
+                return false;
+            }
+
+            gap = num_words;
+            ++i;
+        }
+        else if (i >= len)
+        {
+            // Trailing single colon.
+
+            return false;
+        }
+    }
+
+    if (gap < 0 ? num_words != 8 : num_words > 7)
+    {
+        return false;
+    }
+
+    // Expand the "::" into however many zero words are missing.
+
+    memset(out, 0, 16);
+
+    for (n = 0; n < num_words; ++n)
+    {
+        int pos = n;
+
+        if (gap >= 0 && n >= gap)
+        {
+            pos = n + 8 - num_words;
+        }
+
+        out[pos * 2] = (words[n] >> 8) & 0xff;
+        out[pos * 2 + 1] = words[n] & 0xff;
+    }
+
+    return true;
+}
+
+static boolean ParseVersion1(net_proxy_state_t *state)
+{
+    const char *p, *end, *field;
+    net_proxy_addr_t *src = &state->source;
+    byte dest[16];
+    unsigned int dest_port;
+    int family;
+    int len;
+
+    // Line without the trailing CRLF, and skipping "PROXY ":
+
+    p = (const char *) state->buf + V1_SIGNATURE_LEN;
+    end = (const char *) state->buf + state->len - 2;
+
+    field = p;
+    len = NextField(&p, end);
+
+    if (len == 7 && !memcmp(field, "UNKNOWN", 7))
+    {
+        // The proxy does not know the source; the rest of the line
+        // is to be ignored.
+
+        src->family = 0;
+        return true;
+    }
+    else if (len == 4 && !memcmp(field, "TCP4", 4))
+    {
+        family = 4;
+    }
+    else if (len == 4 && !memcmp(field, "TCP6", 4))
+    {
+        family = 6;
+    }
+    else
+    {
+        return false;
+    }
+
+    // Source address, destination address, source port, destination
+    // port, each preceded by a single space.
+
+    if (p >= end || *p++ != ' ')
+        return false;
+    field = p;
+    len = NextField(&p, end);
+
+    if (family == 4 ? !ParseIPv4(field, len, src->addr)
+                    : !ParseIPv6(field, len, src->addr))
+    {
+        return false;
+    }
+
+    if (p >= end || *p++ != ' ')
+        return false;
+    field = p;
+    len = NextField(&p, end);
+
+    if (family == 4 ? !ParseIPv4(field, len, dest)
+                    : !ParseIPv6(field, len, dest))
+    {
+        return false;
+    }
+
+    if (p >= end || *p++ != ' ')
+        return false;
+    field = p;
+    len = NextField(&p, end);
+
+    if (!ParsePort(field, len, &src->port))
+        return false;
+
+    if (p >= end || *p++ != ' ')
+        return false;
+    field = p;
+    len = NextField(&p, end);
+
+    if (!ParsePort(field, len, &dest_port) || p != end)
+        return false;
+
+    src->family = family;
+
+    return true;
+}
+
+//
+// Version 2 (binary) headers
+//
+
+static boolean ParseVersion2(net_proxy_state_t *state)
+{
+    net_proxy_addr_t *src = &state->source;
+    const byte *addrs = state->buf + V2_HEADER_LEN;
+    unsigned int addr_len;
+    byte ver_cmd, family;
+
+    ver_cmd = state->buf[12];
+    family = state->buf[13];
+    addr_len = state->len - V2_HEADER_LEN;
+
+    if ((ver_cmd & 0xf0) != 0x20)
+    {
+        return false;
+    }
+
+    switch (ver_cmd & 0x0f)
+    {
+        case 0x0:
+            // LOCAL: a connection made by the proxy itself (eg. a
+            // health check).  Use the real connection address.
+
+            src->family = 0;
+            return true;
+
+        case 0x1:
+            // PROXY
+            break;
+
+        default:
+            return false;
+    }
+
+    switch (family >> 4)
+    {
+        case 0x1:
+            // AF_INET: 4 byte source and destination, 2 byte ports.
+
+            if (addr_len < 12)
+                return false;
+
+            src->family = 4;
+            memcpy(src->addr, addrs, 4);
+            src->port = (addrs[8] << 8) | addrs[9];
+            break;
+
+        case 0x2:
+            // AF_INET6: 16 byte source and destination, 2 byte ports.
+
+            if (addr_len < 36)
+                return false;
+
+            src->family = 6;
+            memcpy(src->addr, addrs, 16);
+            src->port = (addrs[32] << 8) | addrs[33];
+            break;
+
+        default:
+            // AF_UNSPEC or AF_UNIX; nothing useful to record.
+
+            src->family = 0;
+            break;
+    }
+
+    return true;
+}
+
+// Feed newly received bytes to the parser.  *consumed is set to the
+// number of bytes that were part of the header; anything after that
+// belongs to the connection.
+
+net_proxy_result_t NET_Proxy_Feed(net_proxy_state_t *state,
+                                  const byte *data, unsigned int len,
+                                  unsigned int *consumed)
+{
+    unsigned int total;
+    unsigned int i;
+    byte c;
+
+    for (i = 0; i < len; ++i)
+    {
+        c = data[i];
+        state->buf[state->len] = c;
+        ++state->len;
+
+        // Still reading the signature?  Check it byte by byte so that
+        // junk is rejected as early as possible.
+
+        if (IsVersion2(state))
+        {
+            if (state->len <= V2_SIGNATURE_LEN)
+            {
+                if (c != v2_signature[state->len - 1])
+                {
+                    break;
+                }
+                continue;
+            }
+
+            if (state->len < V2_HEADER_LEN)
+            {
+                continue;
+            }
+
+            total = V2_HEADER_LEN
+                  + ((state->buf[14] << 8) | state->buf[15]);
+
+            if (total > NET_PROXY_MAX_HEADER)
+            {
+                break;
+            }
+
+            if (state->len == total)
+            {
+                *consumed = i + 1;
+                return ParseVersion2(state) ? NET_PROXY_COMPLETE
+                                            : NET_PROXY_INVALID;
+            }
+        }
+        else
+        {
+            if (state->len <= V1_SIGNATURE_LEN)
+            {
+                if (c != v1_signature[state->len - 1])
+                {
+                    break;
+                }
+                continue;
+            }
+
+            if (c == '\n')
+            {
+                *consumed = i + 1;
+
+                if (state->buf[state->len - 2] != '\r')
+                {
+                    return NET_PROXY_INVALID;
+                }
+
+                return ParseVersion1(state) ? NET_PROXY_COMPLETE
+                                            : NET_PROXY_INVALID;
+            }
+
+            if (state->len >= V1_MAX_LEN)
+            {
+                break;
+            }
+        }
+    }
+
+    *consumed = i;
+
+    return i < len ? NET_PROXY_INVALID : NET_PROXY_INCOMPLETE;
+}
+
+void NET_Proxy_SetIPv4(net_proxy_addr_t *addr, const void *host,
+                       unsigned int port)
+{
+    memset(addr, 0, sizeof(*addr));
+    addr->family = 4;
+    memcpy(addr->addr, host, 4);
+    addr->port = port;
+}
+
+void NET_Proxy_AddrToString(net_proxy_addr_t *addr, char *buffer,
+                            int buffer_len)
+{
+    const byte *a = addr->addr;
+
+    if (addr->family == 4)
+    {
+        M_snprintf(buffer, buffer_len, "%i.%i.%i.%i",
+                   a[0], a[1], a[2], a[3]);
+    }
+    else if (addr->family == 6)
+    {
+        M_snprintf(buffer, buffer_len, "%x:%x:%x:%x:%x:%x:%x:%x",
+                   (a[0] << 8) | a[1], (a[2] << 8) | a[3],
+                   (a[4] << 8) | a[5], (a[6] << 8) | a[7],
+                   (a[8] << 8) | a[9], (a[10] << 8) | a[11],
+                   (a[12] << 8) | a[13], (a[14] << 8) | a[15]);
+    }
+    else
+    {
+        M_StringCopy(buffer, "unknown", buffer_len);
+    }
+}
+
+//
+// Address set.  This is an open addressing hash table keyed on the
+// address alone (not the port); an entry with family 0 is empty.
+//
+
+static unsigned int AddrLength(net_proxy_addr_t *addr)
+{
+    return addr->family == 6 ? 16 : 4;
+}
+
+static unsigned int HashAddr(net_proxy_addrset_t *set,
+                             net_proxy_addr_t *addr)
+{
+    unsigned int h = 2166136261U;
+    unsigned int i;
+
+    for (i = 0; i < AddrLength(addr); ++i)
+    {
+        h = (h ^ addr->addr[i]) * 16777619U;
+    }
+
+    h ^= addr->family;
+
+    return h & (set->size - 1);
+}
+
+static boolean AddrsEqual(net_proxy_addr_t *a, net_proxy_addr_t *b)
+{
+    return a->family == b->family
+        && !memcmp(a->addr, b->addr, AddrLength(a));
+}
+
+static void ResizeAddrSet(net_proxy_addrset_t *set, unsigned int new_size)
+{
+    net_proxy_addr_t *old_entries;
+    unsigned int old_size;
+    unsigned int i, j;
+
+    old_entries = set->entries;
+    old_size = set->size;
+
+    set->size = new_size;
+    set->entries = Z_Malloc(sizeof(net_proxy_addr_t) * new_size,
+                            PU_STATIC, 0);
+    memset(set->entries, 0, sizeof(net_proxy_addr_t) * new_size);
+
+    for (i = 0; i < old_size; ++i)
+    {
+        if (old_entries[i].family == 0)
+        {
+            continue;
+        }
+
+        for (j = HashAddr(set, &old_entries[i]);
+             set->entries[j].family != 0;
+             j = (j + 1) & (set->size - 1));
+
+        set->entries[j] = old_entries[i];
+    }
+
+    if (old_entries != NULL)
+    {
+        Z_Free(old_entries);
+    }
+}
+
+// Add an address to the set.  Returns false if it was already there.
+// Unknown addresses are never added, and always succeed.
+
+boolean NET_Proxy_AddrSetAdd(net_proxy_addrset_t *set,
+                             net_proxy_addr_t *addr)
+{
+    unsigned int i;
+
+    if (addr->family == 0)
+    {
+        return true;
+    }
+
+    if (set->size == 0 || (set->count + 1) * 2 > set->size)
+    {
+        ResizeAddrSet(set, set->size == 0 ? 64 : set->size * 2);
+    }
+
+    for (i = HashAddr(set, addr); set->entries[i].family != 0;
+         i = (i + 1) & (set->size - 1))
+    {
+        if (AddrsEqual(&set->entries[i], addr))
+        {
+            return false;
+        }
+    }
+
+    set->entries[i] = *addr;
+    ++set->count;
+
+    return true;
+}
+
+void NET_Proxy_AddrSetRemove(net_proxy_addrset_t *set,
+                             net_proxy_addr_t *addr)
+{
+    unsigned int i, j, home;
+    unsigned int mask;
+
+    if (addr->family == 0 || set->size == 0)
+    {
+        return;
+    }
+
+    mask = set->size - 1;
+
+    for (i = HashAddr(set, addr); !AddrsEqual(&set->entries[i], addr);
+         i = (i + 1) & mask)
+    {
+        if (set->entries[i].family == 0)
+        {
+            return;
+        }
+    }
+
+    set->entries[i].family = 0;
+    --set->count;
+
+    // Shift back entries later in the probe sequence so that they can
+    // still be found.
+
+    for (j = (i + 1) & mask; set->entries[j].family != 0; j = (j + 1) & mask)
+    {
+        home = HashAddr(set, &set->entries[j]);
+
+        if (((j - home) & mask) >= ((j - i) & mask))
+        {
+            set->entries[i] = set->entries[j];
+            set->entries[j].family = 0;
+            i = j;
+        }
+    }
+}
+
@@ -0,0 +1,110 @@
+//
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//     Parser for the HAProxy PROXY protocol (versions 1 and 2), used
+//     to find the real source address of connections to the server.
+//
+
+#ifndef NET_PROXY_H
+#define NET_PROXY_H
+
+#include "doomtype.h"
+
+// Require every connection to the server to start with a PROXY
+// header, and reject connections from a source address that has
+// already connected.  This can also be turned on with -proxy.
+
+#define ENFORCE_PROXY 0
+
+// Allow a source address to connect again once its previous
+// connection has closed.  This is also turned on by -latejoin.
+
+#define ALLOW_REENTRY 0
+
+// Longest header we accept.  A version 1 header is at most 107 bytes;
+// version 2 headers can carry extra TLVs after the addresses.
+
+#define NET_PROXY_MAX_HEADER 512
+
+// Time allowed for a new connection to send its header, in ms.
+
+#define NET_PROXY_TIMEOUT 5000
+
+typedef enum
+{
+    NET_PROXY_INCOMPLETE,
+    NET_PROXY_COMPLETE,
+    NET_PROXY_INVALID,
+} net_proxy_result_t;
+
+typedef struct
+{
+    // 4 or 6, or 0 if the address is not known.
+
+    int family;
+
+    // Address in network byte order; only the first 4 bytes are used
+    // for IPv4.
+
+    byte addr[16];
+    unsigned int port;
+} net_proxy_addr_t;
+
+// Per-connection state while reading the header.
+
+typedef struct
+{
+    byte buf[NET_PROXY_MAX_HEADER];
+    unsigned int len;
+
+    // I_GetTimeMS() value by which the header must have arrived.
+
+    int deadline;
+
+    // Source address, once the header is complete.
+
+    net_proxy_addr_t source;
+} net_proxy_state_t;
+
+// Set of source addresses, for rejecting duplicate connections.
+
+typedef struct
+{
+    net_proxy_addr_t *entries;
+    unsigned int size;
+    unsigned int count;
+} net_proxy_addrset_t;
+
+boolean NET_Proxy_Enabled(void);
+boolean NET_Proxy_AllowReentry(void);
+
+void NET_Proxy_Start(net_proxy_state_t *state);
+unsigned int NET_Proxy_BytesWanted(net_proxy_state_t *state);
+net_proxy_result_t NET_Proxy_Feed(net_proxy_state_t *state,
+                                  const byte *data, unsigned int len,
+                                  unsigned int *consumed);
+boolean NET_Proxy_TimedOut(net_proxy_state_t *state);
+
+void NET_Proxy_SetIPv4(net_proxy_addr_t *addr, const void *host,
+                       unsigned int port);
+void NET_Proxy_AddrToString(net_proxy_addr_t *addr, char *buffer,
+                            int buffer_len);
+
+boolean NET_Proxy_AddrSetAdd(net_proxy_addrset_t *set,
+                             net_proxy_addr_t *addr);
+void NET_Proxy_AddrSetRemove(net_proxy_addrset_t *set,
+                             net_proxy_addr_t *addr);
+
+#endif /* #ifndef NET_PROXY_H */
+
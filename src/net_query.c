@@ -75,18 +75,18 @@ typedef struct
     boolean printed;
 } query_target_t;
 
-static boolean registered_with_master = false;
-static boolean got_master_response = false;
+static INSTANCE boolean registered_with_master = false;
+static INSTANCE boolean got_master_response = false;
 
-static net_context_t *query_context;
-static query_target_t *targets;
-static int num_targets;
+static INSTANCE net_context_t *query_context;
+static INSTANCE query_target_t *targets;
+static INSTANCE int num_targets;
 
-static boolean query_loop_running = false;
-static boolean printed_header = false;
-static int last_query_time = 0;
+static INSTANCE boolean query_loop_running = false;
+static INSTANCE boolean printed_header = false;
+static INSTANCE int last_query_time = 0;
 
-static char *securedemo_start_message = NULL;
+static INSTANCE char *securedemo_start_message = NULL;
 
 // Resolve the master server address.
 
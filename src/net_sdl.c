@@ -18,14 +18,18 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <time.h>
 
 #include "doomtype.h"
 #include "i_system.h"
+#include "i_timer.h"
 #include "m_argv.h"
 #include "m_misc.h"
 #include "net_defs.h"
 #include "net_io.h"
+#include "net_metrics.h"
 #include "net_packet.h"
+#include "net_proxy.h"
 #include "net_sdl.h"
 #include "z_zone.h"
 
@@ -44,50 +48,151 @@
 
 #define DEFAULT_PORT 2342
 #define MAX_SOCKETS 32
-#define MAX_PACKET_SIZE 1500
 #define HAPROXY_MAX_BUF 108
 
-#define ENFORCE_PROXY 0
 #define SIMULATE_PROXY_CONNECTION 0
-#define ALLOW_REENTRY 0
 
-static boolean initted = false;
-static int port = DEFAULT_PORT;
+static INSTANCE boolean initted = false;
+static INSTANCE int port = DEFAULT_PORT;
 
-#define IS_TCP 1
+#ifdef DROP_PACKETS
 
-#ifdef IS_TCP
-TCPsocket tcpsocket;
+// Percentage of packets sent that are dropped, to test recovery from
+// packet loss.  Its cost in bandwidth and recovery time shows up in the
+// server metrics (see net_metrics.c).
 
-TCPsocket serverconnections[MAX_SOCKETS];
-uint32_t actual_ip_list[MAX_SOCKETS];
+static int drop_percent = 25;
+
+// Packets are also held back for this long (in ms) before they are
+// sent, to simulate a slow link.  They are kept in order.
+
+#define DELAY_QUEUE_SIZE 1024
+
+typedef struct
+{
+    net_addr_t *addr;
+    net_packet_t *packet;
+    int send_time;
+} delayed_packet_t;
+
+static int delay_ms = 0;
+static delayed_packet_t delay_queue[DELAY_QUEUE_SIZE];
+static unsigned int delay_head, delay_tail;
+
+static void InitDropPackets(void)
+{
+    int p;
+
+    srand(time(NULL));
+
+    //!
+    // @category net
+    // @arg <n>
+    //
+    // When built with DROP_PACKETS, drop n% of the packets sent
+    // (default 25) to simulate a lossy connection.
+    //
+
+    p = M_CheckParmWithArgs("-droprate", 1);
+
+    if (p > 0)
+    {
+        drop_percent = atoi(myargv[p + 1]);
+    }
+
+    //!
+    // @category net
+    // @arg <ms>
+    //
+    // When built with DROP_PACKETS, delay every packet sent by the
+    // given number of milliseconds to simulate a slow link.
+    //
+
+    p = M_CheckParmWithArgs("-netdelay", 1);
+
+    if (p > 0)
+    {
+        delay_ms = atoi(myargv[p + 1]);
+    }
+}
+
+static boolean DropPacket(net_packet_t *packet)
+{
+    if (rand() % 100 >= drop_percent)
+    {
+        return false;
+    }
+
+    NET_Metrics_PacketDropped(packet->len);
+
+    return true;
+}
 
-SDLNet_SocketSet clientsocketSet;
-SDLNet_SocketSet serversocketSet;
-#else
-static UDPsocket udpsocket;
-static UDPpacket *recvpacket;
 #endif
 
+// TCP is used unless -udp is given (see ChooseTransport).  Over TCP,
+// each packet is sent as a frame: a 4-byte length followed by the
+// packet data.  Over UDP, each packet is one datagram.
+
+static INSTANCE boolean use_tcp = true;
+
+INSTANCE TCPsocket tcpsocket;
+
+INSTANCE TCPsocket serverconnections[MAX_SOCKETS];
+
+// With the PROXY protocol enforced, new connections must send a PROXY
+// header before anything else.  Until they have, they are "handshaking"
+// and we do not read game packets from them.
+
+static INSTANCE boolean enforce_proxy;
+static INSTANCE boolean allow_reentry;
+static INSTANCE boolean handshaking[MAX_SOCKETS];
+static INSTANCE net_proxy_state_t proxy_states[MAX_SOCKETS];
+
+// Source addresses from PROXY headers that have connected, for
+// rejecting duplicates.  source_registered[i] is true if connection i
+// added its address to the set.
+
+static INSTANCE net_proxy_addrset_t source_addrs;
+static INSTANCE boolean source_registered[MAX_SOCKETS];
+
+INSTANCE SDLNet_SocketSet clientsocketSet;
+INSTANCE SDLNet_SocketSet serversocketSet;
+
+static INSTANCE UDPsocket udpsocket;
+static INSTANCE UDPpacket *recvpacket;
+static INSTANCE SDLNet_SocketSet udpsocketSet;
+
 typedef struct
 {
     net_addr_t net_addr;
     IPaddress sdl_addr;
+
+    // Index into serverconnections[] of the connection from this
+    // address, or -1 if there is none (always, with UDP).
+
+    int conn;
 } addrpair_t;
 
-static addrpair_t **addr_table;
-static int addr_table_size = -1;
+// Table of known addresses.  This is an open addressing hash table
+// (linear probing) keyed on host and port, so that looking up the
+// address of a received packet does not depend on how many clients
+// there are.  The size is always a power of two, and is kept at most
+// half full.
 
-// Initializes the address table
+static INSTANCE addrpair_t **addr_table;
+static INSTANCE unsigned int addr_table_size = 0;
+static INSTANCE unsigned int addr_table_count = 0;
 
-static void NET_SDL_InitAddrTable(void)
-{
-    addr_table_size = 16;
+// Address of each server connection.  A reference is held for as long
+// as the connection is open, so that the receive path can hand the
+// address straight to the caller.
 
-    addr_table = Z_Malloc(sizeof(addrpair_t *) * addr_table_size,
-                          PU_STATIC, 0);
-    memset(addr_table, 0, sizeof(addrpair_t *) * addr_table_size);
-}
+static INSTANCE addrpair_t *serveraddrs[MAX_SOCKETS];
+
+// Address of the server we are connected to, when a client.
+
+static INSTANCE net_addr_t *client_server_addr = NULL;
 
 static boolean AddressesEqual(IPaddress *a, IPaddress *b)
 {
@@ -95,134 +200,233 @@ static boolean AddressesEqual(IPaddress *a, IPaddress *b)
         && a->port == b->port;
 }
 
-
-uint32_t ipStringToID(char* ip_string)
+static unsigned int HashAddress(IPaddress *addr)
 {
-    char packet[strlen(ip_string)];
-    uint32_t ipaddr = 0;
-    uint32_t iparray[4];
-
-    memset(packet, 0, strlen(ip_string));
-    memcpy(packet, ip_string, strlen(ip_string));
+    uint32_t h;
 
-    sscanf(packet, "%d.%d.%d.%d", &iparray[0],&iparray[1],&iparray[2],&iparray[3]);
+    h = addr->host ^ ((uint32_t) addr->port * 0x9e3779b1U);
+    h ^= h >> 16;
+    h *= 0x45d9f3bU;
+    h ^= h >> 16;
 
-    /*for(int i = 0; i < 4; i++) {
-        ipaddr = ipaddr << 8;
-        ipaddr = ipaddr + iparray[i];
-    }*/
-
-    return iparray[2];
+    return h & (addr_table_size - 1);
 }
 
-static boolean checkIsProxyPacket(char *packet)
+// Insert an entry into the table without checking whether it needs to
+// grow.
+
+static void InsertAddress(addrpair_t *entry)
 {
-    return strstr(packet, "PROXY") != NULL;
+    unsigned int i;
+
+    i = HashAddress(&entry->sdl_addr);
+
+    while (addr_table[i] != NULL)
+    {
+        i = (i + 1) & (addr_table_size - 1);
+    }
+
+    addr_table[i] = entry;
 }
 
-static uint32_t getIPfromProxyPacket(char *packet)
-{
-    uint32_t src_ip = 0;
-    //IPaddress src_ip;
+// Allocate the address table at the given size, and rehash any
+// entries from the old table into it.
 
-    char ip_string[16];
+static void ResizeAddrTable(unsigned int new_size)
+{
+    addrpair_t **old_table;
+    unsigned int old_size;
+    unsigned int i;
 
-    memset(ip_string, 0, 16);
+    old_table = addr_table;
+    old_size = addr_table_size;
 
-    //get ip out of buffer
-    sscanf(packet, "%*s %*s %s", ip_string);
+    addr_table_size = new_size;
+    addr_table = Z_Malloc(sizeof(addrpair_t *) * addr_table_size,
+                          PU_STATIC, 0);
+    memset(addr_table, 0, sizeof(addrpair_t *) * addr_table_size);
 
-    //convert to uint_3
-    src_ip = ipStringToID(ip_string);
+    for (i = 0; i < old_size; ++i)
+    {
+        if (old_table[i] != NULL)
+        {
+            InsertAddress(old_table[i]);
+        }
+    }
 
-    return src_ip;
+    if (old_table != NULL)
+    {
+        Z_Free(old_table);
+    }
 }
 
-// Finds an address by searching the table.  If the address is not found,
-// it is added to the table.
+// Finds an address in the table.  If the address is not found, it is
+// added to the table.
 
 static net_addr_t *NET_SDL_FindAddress(IPaddress *addr)
 {
     addrpair_t *new_entry;
-    int empty_entry = -1;
-    int i;
+    unsigned int i;
 
-    if (addr_table_size < 0)
+    if (addr_table_size == 0)
     {
-        NET_SDL_InitAddrTable();
+        ResizeAddrTable(16);
     }
 
-    for (i=0; i<addr_table_size; ++i)
+    for (i = HashAddress(addr); addr_table[i] != NULL;
+         i = (i + 1) & (addr_table_size - 1))
     {
-        if (addr_table[i] != NULL
-         && AddressesEqual(addr, &addr_table[i]->sdl_addr))
+        if (AddressesEqual(addr, &addr_table[i]->sdl_addr))
         {
             return &addr_table[i]->net_addr;
         }
-
-        if (empty_entry < 0 && addr_table[i] == NULL)
-            empty_entry = i;
     }
 
-    // Was not found in list.  We need to add it.
-
-    // Is there any space in the table? If not, increase the table size
+    // Was not found in list.  We need to add it, first making sure
+    // the table stays at most half full.
 
-    if (empty_entry < 0)
+    if ((addr_table_count + 1) * 2 > addr_table_size)
     {
-        addrpair_t **new_addr_table;
-        int new_addr_table_size;
-
-        // after reallocing, we will add this in as the first entry
-        // in the new block of memory
-
-        empty_entry = addr_table_size;
-        
-        // allocate a new array twice the size, init to 0 and copy 
-        // the existing table in.  replace the old table.
-
-        new_addr_table_size = addr_table_size * 2;
-        new_addr_table = Z_Malloc(sizeof(addrpair_t *) * new_addr_table_size,
-                                  PU_STATIC, 0);
-        memset(new_addr_table, 0, sizeof(addrpair_t *) * new_addr_table_size);
-        memcpy(new_addr_table, addr_table, 
-               sizeof(addrpair_t *) * addr_table_size);
-        Z_Free(addr_table);
-        addr_table = new_addr_table;
-        addr_table_size = new_addr_table_size;
+        ResizeAddrTable(addr_table_size * 2);
     }
 
-    // Add a new entry
-
     new_entry = Z_Malloc(sizeof(addrpair_t), PU_STATIC, 0);
 
     new_entry->sdl_addr = *addr;
     new_entry->net_addr.refcount = 0;
     new_entry->net_addr.handle = &new_entry->sdl_addr;
     new_entry->net_addr.module = &net_sdl_module;
+    new_entry->conn = -1;
 
-    addr_table[empty_entry] = new_entry;
+    InsertAddress(new_entry);
+    ++addr_table_count;
 
     return &new_entry->net_addr;
 }
 
 static void NET_SDL_FreeAddress(net_addr_t *addr)
 {
-    int i;
+    addrpair_t *entry = (addrpair_t *) addr;
+    unsigned int i, j, home;
+
+    if (addr_table_size == 0)
+    {
+        I_Error("NET_SDL_FreeAddress: Attempted to remove an unused address!");
+    }
 
-    for (i=0; i<addr_table_size; ++i)
+    for (i = HashAddress(&entry->sdl_addr); addr_table[i] != entry;
+         i = (i + 1) & (addr_table_size - 1))
     {
-        if (addr == &addr_table[i]->net_addr)
+        if (addr_table[i] == NULL)
         {
-            Z_Free(addr_table[i]);
-            addr_table[i] = NULL;
-            return;
+            I_Error("NET_SDL_FreeAddress: Attempted to remove an unused address!");
+        }
+    }
+
+    // Remove the entry, then shift back any entries further along the
+    // probe sequence that would otherwise become unreachable.
+
+    addr_table[i] = NULL;
+    --addr_table_count;
+
+    for (j = (i + 1) & (addr_table_size - 1); addr_table[j] != NULL;
+         j = (j + 1) & (addr_table_size - 1))
+    {
+        home = HashAddress(&addr_table[j]->sdl_addr);
+
+        // Can the entry at j move into the hole at i?  Only if its home
+        // slot is not cyclically within (i, j].
+
+        if (((j - home) & (addr_table_size - 1))
+         >= ((j - i) & (addr_table_size - 1)))
+        {
+            addr_table[i] = addr_table[j];
+            addr_table[j] = NULL;
+            i = j;
         }
     }
 
-    I_Error("NET_SDL_FreeAddress: Attempted to remove an unused address!");
+    Z_Free(entry);
+}
+
+// -addrbench: time address lookups as the table grows.  Addresses
+// are made up from 198.18.0.0/15, which is set aside for benchmarks.
+
+#define ADDR_BENCH_MAX      4096
+#define ADDR_BENCH_LOOKUPS  4000000
+#define ADDR_BENCH_CHURN    400000
+
+static void BenchAddress(IPaddress *ip, unsigned int id)
+{
+    SDLNet_Write32(0xc6120000U + (id & 0x1ffff), &ip->host);
+    SDLNet_Write16(1024 + (id >> 17), &ip->port);
 }
 
+static void AddressBenchmark(void)
+{
+    net_addr_t **addrs;
+    IPaddress ip;
+    unsigned int next_id;
+    int count, i, n, start, find_ms, churn_ms;
+
+    addrs = malloc(ADDR_BENCH_MAX * sizeof(*addrs));
+
+    if (addrs == NULL)
+    {
+        I_Error("AddressBenchmark: Failed to allocate address list");
+    }
+
+    for (count = 1; count <= ADDR_BENCH_MAX; count *= 2)
+    {
+        for (i = 0; i < count; ++i)
+        {
+            BenchAddress(&ip, i);
+            addrs[i] = NET_SDL_FindAddress(&ip);
+        }
+
+        // Look up addresses that are already known, as happens for
+        // every packet received.
+
+        start = I_GetTimeMS();
+
+        for (n = 0; n < ADDR_BENCH_LOOKUPS; ++n)
+        {
+            BenchAddress(&ip, n & (count - 1));
+            NET_SDL_FindAddress(&ip);
+        }
+
+        find_ms = I_GetTimeMS() - start;
+
+        // Free an address and add a new one, as happens when one
+        // client leaves and another joins.
+
+        next_id = count;
+        start = I_GetTimeMS();
+
+        for (n = 0; n < ADDR_BENCH_CHURN; ++n)
+        {
+            i = n & (count - 1);
+            NET_SDL_FreeAddress(addrs[i]);
+            BenchAddress(&ip, next_id);
+            addrs[i] = NET_SDL_FindAddress(&ip);
+            ++next_id;
+        }
+
+        churn_ms = I_GetTimeMS() - start;
+
+        printf("NET_SDL_AddrBench: %5d addresses: find %4d ns, "
+               "free and add %4d ns\n", count,
+               (int) (find_ms * 1000000LL / ADDR_BENCH_LOOKUPS),
+               (int) (churn_ms * 1000000LL / ADDR_BENCH_CHURN));
+
+        for (i = 0; i < count; ++i)
+        {
+            NET_SDL_FreeAddress(addrs[i]);
+        }
+    }
+
+    free(addrs);
+}
 
 net_addr_t *NET_SDL_ResolveAddress(const char *address)
 {
@@ -293,9 +497,24 @@ extern char xbox_ip_str[16];
 extern char central_server_ip_str[16];
 #endif
 
-static boolean NET_SDL_InitClient(void)
+// Choose whether to use TCP or UDP.  This must be the same at both
+// ends of the connection.
+
+static void ChooseTransport(void)
+{
+    //!
+    // @category net
+    //
+    // Use UDP rather than TCP for communications.  This must be given
+    // to the server and to every client.  With UDP, a lost packet only
+    // delays the tics it carried, rather than everything after it.
+    //
+
+    use_tcp = !M_ParmExists("-udp");
+}
+
+static void InitClientTCP(void)
 {
-#ifdef IS_TCP
     int p;
     int port = 0;
     IPaddress ip;
@@ -304,14 +523,11 @@ static boolean NET_SDL_InitClient(void)
 
     const char* host = "127.0.0.1";
 
-    if (initted)
-        return true;
-
     //!
     // @category net
     // @arg <n>
     //
-    // Use the specified UDP port for communications, instead of
+    // Use the specified port for communications, instead of
     // the default (2342).
     //
 
@@ -369,34 +585,17 @@ static boolean NET_SDL_InitClient(void)
 
 #endif
 
-    //recvpacket = SDLNet_AllocPacket(1500);
-
-#ifdef DROP_PACKETS
-    srand(time(NULL));
-#endif
     serversocketSet = NULL;
     clientsocketSet = SDLNet_AllocSocketSet(128);
     assert(clientsocketSet != NULL);
     status = SDLNet_TCP_AddSocket(clientsocketSet, tcpsocket);
     assert(status > 0);
+}
 
-    initted = true;
-
-    return true;
-#else
+static void InitClientUDP(void)
+{
     int p;
 
-    if (initted)
-        return true;
-
-    //!
-    // @category net
-    // @arg <n>
-    //
-    // Use the specified UDP port for communications, instead of
-    // the default (2342).
-    //
-
     p = M_CheckParmWithArgs("-port", 1);
     if (p > 0)
         port = atoi(myargv[p+1]);
@@ -411,36 +610,52 @@ static boolean NET_SDL_InitClient(void)
     }
 
     recvpacket = SDLNet_AllocPacket(1500);
+    udpsocketSet = SDLNet_AllocSocketSet(1);
+    SDLNet_UDP_AddSocket(udpsocketSet, udpsocket);
+}
+
+static boolean NET_SDL_InitClient(void)
+{
+    if (initted)
+        return true;
+
+    ChooseTransport();
+
+    if (use_tcp)
+    {
+        InitClientTCP();
+    }
+    else
+    {
+        InitClientUDP();
+    }
 
 #ifdef DROP_PACKETS
-    srand(time(NULL));
+    InitDropPackets();
 #endif
 
+    //!
+    // @category net
+    //
+    // When starting a server, time looking up, freeing and adding
+    // client addresses with growing numbers of addresses known,
+    // and print the cost of each.
+    //
+
+    if (M_ParmExists("-addrbench"))
+    {
+        AddressBenchmark();
+    }
+
     initted = true;
 
     return true;
-#endif
 }
 
-static boolean NET_SDL_InitServer(void)
+static void InitServerTCP(void)
 {
-#ifdef IS_TCP
-    int p;
     IPaddress ip;
 
-    if (initted)
-        return true;
-
-    p = M_CheckParmWithArgs("-port", 1);
-    if (p > 0)
-        port = atoi(myargv[p+1]);
-
-    if (port == 0) {
-        port = DEFAULT_PORT;
-    }
-
-    SDLNet_Init();
-
     //udpsocket = SDLNet_UDP_Open(port);
     printf("binding to %d\n", port);
 
@@ -454,73 +669,215 @@ static boolean NET_SDL_InitServer(void)
         I_Error("NET_SDL_InitServer: Unable to bind to port %i", port);
     }
 
+    // The listening socket goes in the set too, so that
+    // NET_SDL_WaitPacket wakes up for new connections.
 
-#ifdef DROP_PACKETS
-    srand(time(NULL));
-#endif
-
-    serversocketSet = SDLNet_AllocSocketSet(MAX_SOCKETS);
+    serversocketSet = SDLNet_AllocSocketSet(MAX_SOCKETS + 1);
+    SDLNet_TCP_AddSocket(serversocketSet, tcpsocket);
     clientsocketSet = NULL;
 
     for(int i = 0; i < MAX_SOCKETS; i++) {
         serverconnections[i] = NULL;
-        actual_ip_list[i] = 0xFFFF;
+        serveraddrs[i] = NULL;
+        handshaking[i] = false;
+        source_registered[i] = false;
     }
 
-    initted = true;
+    enforce_proxy = NET_Proxy_Enabled();
+    allow_reentry = NET_Proxy_AllowReentry();
+}
 
-    return true;
-#else
+static void InitServerUDP(void)
+{
+    // There is no connection to receive a PROXY header on.
+
+    if (NET_Proxy_Enabled())
+    {
+        I_Error("NET_SDL_InitServer: The PROXY protocol needs TCP.");
+    }
+
+    udpsocket = SDLNet_UDP_Open(port);
+
+    if (udpsocket == NULL)
+    {
+        I_Error("NET_SDL_InitServer: Unable to bind to port %i", port);
+    }
+
+    recvpacket = SDLNet_AllocPacket(1500);
+    udpsocketSet = SDLNet_AllocSocketSet(1);
+    SDLNet_UDP_AddSocket(udpsocketSet, udpsocket);
+}
+
+static boolean NET_SDL_InitServer(void)
+{
     int p;
 
     if (initted)
         return true;
 
+    ChooseTransport();
+
     p = M_CheckParmWithArgs("-port", 1);
     if (p > 0)
         port = atoi(myargv[p+1]);
 
-    SDLNet_Init();
+    if (port == 0) {
+        port = DEFAULT_PORT;
+    }
 
-    udpsocket = SDLNet_UDP_Open(port);
+    SDLNet_Init();
 
-    if (udpsocket == NULL)
+    if (use_tcp)
     {
-        I_Error("NET_SDL_InitServer: Unable to bind to port %i", port);
+        InitServerTCP();
+    }
+    else
+    {
+        InitServerUDP();
     }
 
-    recvpacket = SDLNet_AllocPacket(1500);
 #ifdef DROP_PACKETS
-    srand(time(NULL));
+    InitDropPackets();
 #endif
 
     initted = true;
 
     return true;
-#endif
 }
 
-static void NET_SDL_SendPacket(net_addr_t *addr, net_packet_t *packet)
+// Send a complete frame (length header followed by the packet data)
+// with a single call, so that it is one write rather than two.
+
+static boolean SendFrame(TCPsocket sock, net_packet_t *packet)
 {
-#ifdef IS_TCP
+    static INSTANCE byte *frame = NULL;
+    static INSTANCE size_t frame_alloced = 0;
     uint32_t length;
-    IPaddress *remote;
-    int found = 0;
+    size_t frame_len;
 
-    if (serversocketSet == NULL) { // is client
-        int bytes_sent;
+    length = packet->len;
+    frame_len = sizeof(length) + packet->len;
 
-        assert(tcpsocket != NULL);
+    if (frame_len > frame_alloced)
+    {
+        frame = I_Realloc(frame, frame_len);
+        frame_alloced = frame_len;
+    }
 
-        length = packet->len;
-        bytes_sent = SDLNet_TCP_Send(tcpsocket, &length, sizeof(length));
-        if (bytes_sent < sizeof(length)) {
-            I_Error("NET_SDL_SendPacket: Error transmitting packet: %s",
-                    SDLNet_GetError());
+    memcpy(frame, &length, sizeof(length));
+    memcpy(frame + sizeof(length), packet->data, packet->len);
+
+    return SDLNet_TCP_Send(sock, frame, frame_len) == (int) frame_len;
+}
+
+// Close a server connection and drop our reference to its address.
+
+static void CloseServerConnection(int i)
+{
+    SDLNet_TCP_DelSocket(serversocketSet, serverconnections[i]);
+    SDLNet_TCP_Close(serverconnections[i]);
+    serverconnections[i] = NULL;
+
+    handshaking[i] = false;
+
+    if (source_registered[i])
+    {
+        if (allow_reentry)
+        {
+            NET_Proxy_AddrSetRemove(&source_addrs, &proxy_states[i].source);
+        }
+        source_registered[i] = false;
+    }
+
+    serveraddrs[i]->conn = -1;
+    NET_ReleaseAddress(&serveraddrs[i]->net_addr);
+    serveraddrs[i] = NULL;
+}
+
+// Read more of the PROXY header from a connection that is handshaking.
+// We only ask for as many bytes as cannot overrun the header, so that
+// nothing after it is lost.
+
+static void ProxyHandshake(int i)
+{
+    net_proxy_state_t *state = &proxy_states[i];
+    byte buf[NET_PROXY_MAX_HEADER];
+    unsigned int consumed;
+    char addr_str[64];
+    int len;
+
+    len = SDLNet_TCP_Recv(serverconnections[i], buf,
+                          NET_Proxy_BytesWanted(state));
+
+    if (len <= 0)
+    {
+        CloseServerConnection(i);
+        return;
+    }
+
+    switch (NET_Proxy_Feed(state, buf, len, &consumed))
+    {
+        case NET_PROXY_INCOMPLETE:
+            return;
+
+        case NET_PROXY_INVALID:
+            printf("rejecting malformed request (no proxy line)\n");
+            CloseServerConnection(i);
+            return;
+
+        case NET_PROXY_COMPLETE:
+            break;
+    }
+
+    // The proxy did not know the source address; use the address of
+    // the connection itself.
+
+    if (state->source.family == 0)
+    {
+        IPaddress *peer = SDLNet_TCP_GetPeerAddress(serverconnections[i]);
+
+        NET_Proxy_SetIPv4(&state->source, &peer->host,
+                          SDLNet_Read16(&peer->port));
+    }
+
+    NET_Proxy_AddrToString(&state->source, addr_str, sizeof(addr_str));
+
+    if (!NET_Proxy_AddrSetAdd(&source_addrs, &state->source))
+    {
+        printf("rejecting duplicate connection %s at %d\n", addr_str, i);
+        CloseServerConnection(i);
+        return;
+    }
+
+    printf("connection %d is from %s\n", i, addr_str);
+
+    source_registered[i] = true;
+    handshaking[i] = false;
+}
+
+// Close any connections that have not sent their PROXY header in time.
+
+static void ExpireHandshakes(void)
+{
+    int i;
+
+    for (i = 0; i < MAX_SOCKETS; ++i)
+    {
+        if (serverconnections[i] != NULL && handshaking[i]
+         && NET_Proxy_TimedOut(&proxy_states[i]))
+        {
+            printf("connection %d timed out sending proxy line\n", i);
+            CloseServerConnection(i);
         }
+    }
+}
 
-        bytes_sent = SDLNet_TCP_Send(tcpsocket, packet->data, packet->len);
-        if (bytes_sent < packet->len) {
+static void SendPacketTCP(net_addr_t *addr, net_packet_t *packet)
+{
+    if (serversocketSet == NULL) { // is client
+        assert(tcpsocket != NULL);
+
+        if (!SendFrame(tcpsocket, packet)) {
             I_Error("NET_SDL_SendPacket: Error transmitting packet: %s",
                     SDLNet_GetError());
         }
@@ -528,51 +885,24 @@ static void NET_SDL_SendPacket(net_addr_t *addr, net_packet_t *packet)
         //
         // Server
         //
-        for (int i = 0; i < MAX_SOCKETS; i++) {
-            TCPsocket conn = serverconnections[i];
-            if(conn != NULL) {
-                // printf("sending data to %d\n", i);
-                remote = SDLNet_TCP_GetPeerAddress(conn);
-                if(AddressesEqual((IPaddress *) addr->handle, remote)) {
-                    int bytes_sent;
-
-                    uint32_t length = packet->len;
-                    bytes_sent = SDLNet_TCP_Send(conn, &length, sizeof(length));
-                    if (bytes_sent < sizeof(length)) {
-                        // I_Error("NET_SDL_SendPacket: Error transmitting packet: %s",
-                        //         SDLNet_GetError());
-                        printf("failed to send to client!\n");
-                        SDLNet_TCP_DelSocket(serversocketSet, conn);
-                        SDLNet_TCP_Close(conn);
-                        serverconnections[i] = NULL;
-#if ALLOW_REENTRY
-                        actual_ip_list[i] = 0xFFFF;
-#endif
-                        break;
-                    }
+        addrpair_t *entry = (addrpair_t *) addr;
 
-                    bytes_sent = SDLNet_TCP_Send(conn, packet->data, packet->len);
-                    if (bytes_sent < packet->len) {
-                        // I_Error("NET_SDL_SendPacket: Error transmitting packet: %s",
-                        //         SDLNet_GetError());
-                        printf("failed to send to client!\n");
-                        SDLNet_TCP_DelSocket(serversocketSet, conn);
-                        SDLNet_TCP_Close(conn);
-                        serverconnections[i] = NULL;
-#if ALLOW_REENTRY
-                        actual_ip_list[i] = 0xFFFF;
-#endif
-                        break;
-                    }
+        if (entry->conn < 0) {
+            // Connection has already been closed.
+            return;
+        }
 
-                    found = 1;
-                    break;
-                }
-            }
+        if (!SendFrame(serverconnections[entry->conn], packet)) {
+            // I_Error("NET_SDL_SendPacket: Error transmitting packet: %s",
+            //         SDLNet_GetError());
+            printf("failed to send to client!\n");
+            CloseServerConnection(entry->conn);
         }
-        // assert(found);
     }
-#else
+}
+
+static void SendPacketUDP(net_addr_t *addr, net_packet_t *packet)
+{
     UDPpacket sdl_packet;
     IPaddress ip;
 
@@ -602,11 +932,6 @@ static void NET_SDL_SendPacket(net_addr_t *addr, net_packet_t *packet)
     }
 #endif
 
-#ifdef DROP_PACKETS
-    if ((rand() % 4) == 0)
-        return;
-#endif
-
     sdl_packet.channel = 0;
     sdl_packet.data = packet->data;
     sdl_packet.len = packet->len;
@@ -617,29 +942,96 @@ static void NET_SDL_SendPacket(net_addr_t *addr, net_packet_t *packet)
         I_Error("NET_SDL_SendPacket: Error transmitting packet: %s",
                 SDLNet_GetError());
     }
+}
+
+static void TransmitPacket(net_addr_t *addr, net_packet_t *packet)
+{
+    if (use_tcp)
+    {
+        SendPacketTCP(addr, packet);
+    }
+    else
+    {
+        SendPacketUDP(addr, packet);
+    }
+}
+
+#ifdef DROP_PACKETS
+
+// Hold back a copy of a packet until it is due.  Returns false if it
+// should be sent now instead.
+
+static boolean DelayPacket(net_addr_t *addr, net_packet_t *packet)
+{
+    delayed_packet_t *delayed;
+
+    if (delay_ms <= 0 || delay_head - delay_tail >= DELAY_QUEUE_SIZE)
+    {
+        return false;
+    }
+
+    delayed = &delay_queue[delay_head % DELAY_QUEUE_SIZE];
+    delayed->addr = addr;
+    delayed->packet = NET_PacketDup(packet);
+    delayed->send_time = I_GetTimeMS() + delay_ms;
+    NET_ReferenceAddress(addr);
+    ++delay_head;
+
+    return true;
+}
+
+// Send any held back packets that are now due.
+
+static void SendDelayedPackets(void)
+{
+    delayed_packet_t *delayed;
+    int nowtime;
+
+    nowtime = I_GetTimeMS();
+
+    while (delay_tail != delay_head)
+    {
+        delayed = &delay_queue[delay_tail % DELAY_QUEUE_SIZE];
+
+        if (nowtime - delayed->send_time < 0)
+        {
+            break;
+        }
+
+        ++delay_tail;
+
+        TransmitPacket(delayed->addr, delayed->packet);
+        NET_FreePacket(delayed->packet);
+        NET_ReleaseAddress(delayed->addr);
+    }
+}
+
 #endif
 
+static void NET_SDL_SendPacket(net_addr_t *addr, net_packet_t *packet)
+{
+#ifdef DROP_PACKETS
+    SendDelayedPackets();
+
+    if (DropPacket(packet) || DelayPacket(addr, packet))
+    {
+        return;
+    }
+#endif
+
+    TransmitPacket(addr, packet);
 }
 
-static boolean NET_SDL_RecvPacket(net_addr_t **addr, net_packet_t **packet)
+static boolean RecvPacketTCP(net_addr_t **addr, net_packet_t **packet)
 {
-#ifdef IS_TCP
     int length_recv = -1;
     int num_active;
-    IPaddress *remote;
-    uint32_t actual_ip;
 
     int added = 0;
 
     uint32_t length_expected;
     int numServerActiveConnections;
-    char *data;
-
-    uint8_t proxy_packet_buffer[HAPROXY_MAX_BUF];
-    uint8_t recv_c = '\0';
-    size_t packet_index = 0;
     TCPsocket newConnection;
-    int should_close = 0;
 
 
     //printf("receiving packet\n");
@@ -670,35 +1062,33 @@ static boolean NET_SDL_RecvPacket(net_addr_t **addr, net_packet_t **packet)
                     SDLNet_GetError());
         }
 
-        // *packet = NET_NewPacket(length_recv); //result == size of msg received
-        // assert(*packet != NULL);
+        // Receive straight into the packet; this comes from the packet
+        // pool, so nothing is allocated here.
 
-        data = malloc(length_expected + 4);
-        memset(data, 0, length_expected + 4);
-        data[length_expected] = '\xCC';
+        *packet = NET_NewPacket(length_expected);
+        assert(*packet != NULL);
 
         // printf("length expected = %d bytes\n", length_expected);
 
-        length_recv = SDLNet_TCP_Recv(tcpsocket, data, length_expected);
+        length_recv = SDLNet_TCP_Recv(tcpsocket, (*packet)->data, length_expected);
         if (length_recv != length_expected) {
             I_Error("NET_SDL_RecvPacket: Error receiving packet 3: %s",
                     SDLNet_GetError());
-            free(data);
         }
 
-        assert(data[length_expected] == '\xCC');
-
-        *packet = NET_NewPacket(length_expected);
-        assert(*packet != NULL);
-        memcpy((*packet)->data, data, length_expected);
         (*packet)->len = length_recv;
-        free(data);
 
         // printf("received %d bytes\n", length_recv);
 
-        // checkme
-        *addr = NET_SDL_FindAddress(SDLNet_TCP_GetPeerAddress(tcpsocket));
-        assert(*addr != NULL);
+        // All packets come from the server we are connected to, so
+        // look its address up once and keep a reference to it.
+        if (client_server_addr == NULL) {
+            client_server_addr =
+                NET_SDL_FindAddress(SDLNet_TCP_GetPeerAddress(tcpsocket));
+            NET_ReferenceAddress(client_server_addr);
+        }
+
+        *addr = client_server_addr;
 
         return true;
 
@@ -720,66 +1110,24 @@ static boolean NET_SDL_RecvPacket(net_addr_t **addr, net_packet_t **packet)
                 break;
             }
 
-            ///////////////////////////////////// HAPROXY TRACKING
-#if ENFORCE_PROXY
-
-            //printf("adding new connection\n");
             added = 0;
-            should_close = 0;
-
-            //check if already added
-
-            memset( proxy_packet_buffer, 0, HAPROXY_MAX_BUF );
-            packet_index = 0;
-
-            while(1) {
-                length_recv = SDLNet_TCP_Recv(newConnection, &recv_c, 1);
-
-                if (length_recv <= 0) {
-                    should_close = 1;
-                    break;
-                }
-
-                if(recv_c == '\n') {
-                    proxy_packet_buffer[packet_index] = '\0';
-                    break;
-                }
-
-                proxy_packet_buffer[packet_index] = recv_c;
-                packet_index = packet_index+1;
-                if(packet_index >= HAPROXY_MAX_BUF) {
-                    printf("max proxy packet size reached without a CRLF\n");
-                    should_close = 1;
-                    break;
-                }
-            }
-
-            if (should_close ||
-                !checkIsProxyPacket((char*)proxy_packet_buffer)) {
-                SDLNet_TCP_Close(newConnection);
-                printf("rejecting malformed request (no proxy line)\n");
-                continue; // Look for more connections
-            }
-
-            // Get the originating IP address from the proxy line
-            actual_ip = getIPfromProxyPacket((char*)proxy_packet_buffer);
-
-            // Check for an open sockets with this IP address already
-            for (int i = 0; i < MAX_SOCKETS; i++) {
-                if (actual_ip_list[i] == actual_ip) {
-                    printf("rejecting duplicate connection %x at %d\n", actual_ip, i);
-                    SDLNet_TCP_Close(newConnection);
-                    return false;
-                }
-            }
-#endif
 
             for (int i = 0; i < MAX_SOCKETS; i++) {
                 if (serverconnections[i] == NULL) {
                     printf("adding newconn to %d\n", i);
                     serverconnections[i] = newConnection;
-                    actual_ip_list[i] = actual_ip;
+                    serveraddrs[i] = (addrpair_t *) NET_SDL_FindAddress(
+                        SDLNet_TCP_GetPeerAddress(newConnection));
+                    serveraddrs[i]->conn = i;
+                    NET_ReferenceAddress(&serveraddrs[i]->net_addr);
                     SDLNet_TCP_AddSocket(serversocketSet, newConnection);
+
+                    // The PROXY header is read as it arrives, rather
+                    // than waiting for it here.
+                    if (enforce_proxy) {
+                        handshaking[i] = true;
+                        NET_Proxy_Start(&proxy_states[i]);
+                    }
                     added = 1;
                     break;
                 }
@@ -792,6 +1140,10 @@ static boolean NET_SDL_RecvPacket(net_addr_t **addr, net_packet_t **packet)
             }
         }
 
+        if (enforce_proxy) {
+            ExpireHandshakes();
+        }
+
         numServerActiveConnections = SDLNet_CheckSockets(serversocketSet, 0);
         if (numServerActiveConnections <= 0) {
             return false;
@@ -799,9 +1151,6 @@ static boolean NET_SDL_RecvPacket(net_addr_t **addr, net_packet_t **packet)
 
         // printf("server receiving packet\n");
 
-        // char data[MAX_PACKET_SIZE];
-        // memset( data, 0, MAX_PACKET_SIZE );
-
         for (int i = 0; i < MAX_SOCKETS; i++)
         {
             TCPsocket conn = serverconnections[i];
@@ -809,63 +1158,51 @@ static boolean NET_SDL_RecvPacket(net_addr_t **addr, net_packet_t **packet)
                 continue;
             }
 
+            if (handshaking[i]) {
+                ProxyHandshake(i);
+                continue;
+            }
+
             length_recv = SDLNet_TCP_Recv(conn, &length_expected, 4);
             if ((length_recv < sizeof(length_expected))
                 || (length_expected > MAX_PACKET_SIZE)) {
                 // I_Error("NET_SDL_RecvPacket: Error receiving packet: %s",
                 //         SDLNet_GetError());
                 // printf("failed to recv, closing socket\n");
-                SDLNet_TCP_DelSocket(serversocketSet, conn);
-                SDLNet_TCP_Close(conn);
-                serverconnections[i] = NULL;
-#if ALLOW_REENTRY
-                actual_ip_list[i] = 0xFFFF;
-#endif 
+                CloseServerConnection(i);
                 continue; // Check other sockets
             }
 
-            data = malloc(length_expected + 4);
-            memset(data, 0, length_expected + 4);
-            data[length_expected] = '\xCC';
+            *packet = NET_NewPacket(length_expected);
+            assert(*packet != NULL);
 
             // printf("length expected = %d bytes\n", length_expected);
 
-            length_recv = SDLNet_TCP_Recv(conn, data, length_expected);
+            length_recv = SDLNet_TCP_Recv(conn, (*packet)->data, length_expected);
             if (length_recv < length_expected) {
                 // I_Error("NET_SDL_RecvPacket: Error receiving packet: %s",
                 //         SDLNet_GetError());
                 printf("failed to recv, closing socket\n");
-                SDLNet_TCP_DelSocket(serversocketSet, conn);
-                SDLNet_TCP_Close(conn);
-                serverconnections[i] = NULL;
-#if ALLOW_REENTRY
-                actual_ip_list[i] = 0xFFFF;
-#endif
-                // NET_FreePacket(*packet);
-                free(data);
+                CloseServerConnection(i);
+                NET_FreePacket(*packet);
                 continue; // Check other sockets
             }
 
-            assert(data[length_expected] == '\xCC');
-
-            *packet = NET_NewPacket(length_expected);
-            assert(*packet != NULL);
-            memcpy((*packet)->data, data, length_expected);
             (*packet)->len = length_recv;
-            free(data);
 
             // printf("received %d bytes\n", length_recv);
 
-            remote = SDLNet_TCP_GetPeerAddress(conn);
-            *addr = NET_SDL_FindAddress(remote);
-            assert(*addr != NULL);
+            *addr = &serveraddrs[i]->net_addr;
 
             return true;
         }
 
         return false;
     }
-#else
+}
+
+static boolean RecvPacketUDP(net_addr_t **addr, net_packet_t **packet)
+{
     int result;
     result = SDLNet_UDP_Recv(udpsocket, recvpacket);
 
@@ -891,7 +1228,52 @@ static boolean NET_SDL_RecvPacket(net_addr_t **addr, net_packet_t **packet)
     *addr = NET_SDL_FindAddress(&recvpacket->address);
 
     return true;
+}
+
+static boolean NET_SDL_RecvPacket(net_addr_t **addr, net_packet_t **packet)
+{
+#ifdef DROP_PACKETS
+    SendDelayedPackets();
+#endif
+
+    if (use_tcp)
+    {
+        return RecvPacketTCP(addr, packet);
+    }
+    else
+    {
+        return RecvPacketUDP(addr, packet);
+    }
+}
+
+static boolean NET_SDL_WaitPacket(int timeout_ms)
+{
+    SDLNet_SocketSet set;
+
+    if (use_tcp)
+    {
+        set = serversocketSet != NULL ? serversocketSet : clientsocketSet;
+    }
+    else
+    {
+        set = udpsocketSet;
+    }
+
+    if (set == NULL)
+    {
+        return false;
+    }
+
+#ifdef DROP_PACKETS
+    // Wake up in time to send held back packets.
+
+    if (delay_tail != delay_head && timeout_ms > 1)
+    {
+        timeout_ms = 1;
+    }
 #endif
+
+    return SDLNet_CheckSockets(set, timeout_ms) > 0;
 }
 
 // Complete module
@@ -905,4 +1287,6 @@ net_module_t net_sdl_module =
     NET_SDL_AddrToString,
     NET_SDL_FreeAddress,
     NET_SDL_ResolveAddress,
+    NULL,
+    NET_SDL_WaitPacket,
 };
\ No newline at end of file
@@ -22,6 +22,7 @@
 #include "config.h"
 
 #include "doomtype.h"
+#include "d_event.h"
 #include "d_mode.h"
 #include "i_system.h"
 #include "i_timer.h"
@@ -31,13 +32,18 @@
 #include "net_client.h"
 #include "net_common.h"
 #include "net_defs.h"
+#include "net_epoll.h"
+#include "net_eventlog.h"
 #include "net_io.h"
 #include "net_loop.h"
+#include "net_metrics.h"
 #include "net_packet.h"
 #include "net_query.h"
 #include "net_server.h"
 #include "net_sdl.h"
+#include "net_snapshot.h"
 #include "net_structrw.h"
+#include "net_udp.h"
 
 // How often to refresh our registration with the master server.
 #define MASTER_REFRESH_PERIOD 30  /* twice per minute */
@@ -45,7 +51,40 @@
 // How often to re-resolve the address of the master server?
 #define MASTER_RESOLVE_PERIOD 8 * 60 * 60 /* 8 hours */
 
-char *sv_player_names[NET_MAXPLAYERS];
+// How long (in ms) to spend getting a player into a game in progress
+// before giving up.
+
+#define LATEJOIN_TIMEOUT 30000
+
+// Queries are answered at most QUERY_BURST at a time from any one
+// address, which then gets to send another every QUERY_PERIOD ms.
+// All addresses together get QUERY_TOTAL_BURST and QUERY_TOTAL_PERIOD,
+// so that a flood from many addresses can't crowd out the game either.
+
+#define QUERY_BURST 4
+#define QUERY_PERIOD 500
+#define QUERY_TOTAL_BURST 64
+#define QUERY_TOTAL_PERIOD 5
+
+// Number of addresses whose queries are tracked, and how far through
+// the table an address is looked for from the slot it hashes to.
+
+#define QUERY_TABLE_SIZE 256
+#define QUERY_TABLE_PROBES 8
+
+// How often (in ms) to reconsider how many tics to bundle into each
+// packet sent to a client, and how many quiet periods in a row it
+// takes before bundling fewer.
+
+#define BUNDLE_ADAPT_PERIOD 1000
+#define BUNDLE_QUIET_PERIODS 5
+
+// Bundle more tics when more than this many tics are waiting to be
+// acknowledged than the round trip time accounts for.
+
+#define BUNDLE_QUEUED_TICS 2
+
+INSTANCE char *sv_player_names[NET_MAXPLAYERS];
 
 typedef enum
 {
@@ -97,10 +136,40 @@ typedef struct
     int sendseq;
     net_full_ticcmd_t sendqueue[BACKUPTICS];
 
+    // Last time each tic in the send queue was resent because the
+    // client was missing it
+
+    unsigned int resend_time[BACKUPTICS];
+
     // Latest acknowledged by the client
 
     unsigned int acknowledged;
 
+    // Time each tic in the send queue was first sent, for measuring
+    // the round trip time.
+
+    unsigned int send_time[BACKUPTICS];
+
+    // On a slow link, several new tics are sent in each packet, so
+    // that the per-packet overhead and the extra tics sent in each
+    // packet as insurance are paid less often.  This is how many, the
+    // number of tics queued but not sent yet, and when the first of
+    // them was queued.
+
+    int bundle;
+    int unsent;
+    unsigned int unsent_time;
+
+    // Measurements the bundle size is chosen from: smoothed round trip
+    // time (in ms, or -1 if not known yet), and the number of tics
+    // waiting to be acknowledged, summed over each adapt period.
+
+    int rtt;
+    unsigned int backlog_sum;
+    unsigned int backlog_samples;
+    unsigned int adapt_time;
+    int quiet_periods;
+
     // Value of max_players specified by the client on connect.
 
     int max_players;
@@ -122,6 +191,22 @@ typedef struct
 
     int player_class;
 
+    // Set for a client that connected while a game was in progress,
+    // until it has been sent the game (see NET_SV_RunLateJoin).  It
+    // has no player number until then.
+
+    boolean joining;
+
+    // The client is loading the game it was sent, so is not expected
+    // to send any game data yet.
+
+    boolean loading;
+
+    // The first tic this client played in, for a client that joined
+    // a game in progress.
+
+    unsigned int join_tic;
+
 } net_client_t;
 
 // structure used for the recv window
@@ -140,32 +225,156 @@ typedef struct
 
     unsigned int resend_time;
 
+    // Time a client was first held up waiting for this tic
+
+    unsigned int due_time;
+
+    // The ticcmd did not arrive in time, and one was made up in its
+    // place (see NET_SV_Substitute)
+
+    boolean substituted;
+
+    // Set once the tic has been put in a send queue: from then on every
+    // client must be sent the same thing, so it can no longer change.
+
+    boolean used;
+
     // Tic data itself
 
     net_ticdiff_t diff;
+
+    // The whole ticcmd, once the tic has been used
+
+    ticcmd_t cmd;
 } net_client_recv_t;
 
-static net_server_state_t server_state;
-static boolean server_initialized = false;
-static net_client_t clients[MAXNETNODES];
-static net_client_t *sv_players[NET_MAXPLAYERS];
-static net_context_t *server_context;
-static unsigned int sv_gamemode;
-static unsigned int sv_gamemission;
-static net_gamesettings_t sv_settings;
+static INSTANCE boolean server_initialized = false;
 
 // For registration with master server:
 
-static net_addr_t *master_server = NULL;
-static unsigned int master_refresh_time;
-static unsigned int master_resolve_time;
+static INSTANCE net_addr_t *master_server = NULL;
+static INSTANCE unsigned int master_refresh_time;
+static INSTANCE unsigned int master_resolve_time;
+
+// With -straggler, how long (in ms) to wait for a player's ticcmd
+// before making one up for them.  Zero waits forever.
+
+static INSTANCE int straggler_deadline = 0;
+
+// Make up a null ticcmd rather than repeating the last one.
+
+static INSTANCE boolean straggler_null = false;
+
+// Fold late ticcmds into the player's next one rather than dropping them.
+
+static INSTANCE boolean straggler_accept_late = false;
+
+// Let players join a game that is already in progress.
+
+static INSTANCE boolean latejoin = false;
+
+// Most new tics to send to a client in one packet (see -maxbundle).
+
+static INSTANCE int max_bundle = 4;
+
+// Description of the server sent in query responses (see -servername).
+
+static INSTANCE const char *server_description = "Unnamed server";
+
+// Token buckets for rate limiting queries.
+
+typedef struct
+{
+    net_addr_t *addr;
+    unsigned int tokens;
+    unsigned int last_time;
+} query_limit_t;
+
+static INSTANCE query_limit_t query_limits[QUERY_TABLE_SIZE];
+static INSTANCE query_limit_t query_total_limit;
+
+// The query response is the same for everyone, so it is only built
+// again when something in it changes.
+
+static INSTANCE net_packet_t *query_response = NULL;
+static INSTANCE net_querydata_t query_response_data;
+
+#define NET_SV_ExpandTicNum(b) NET_ExpandTicNum(sv->recvwindow_start, (b))
+
+// Longest encoding of a single net_ticdiff_t, in the original
+// protocol (see NET_WriteTiccmdDiff) and bit-packed (6 header bits,
+// up to 13 bits per move, 27 for turning and 24 for the rest).
+
+#define MAX_TICDIFF_LEN 8
+#define MAX_PACKED_TICDIFF_LEN 12
+
+// Every client is sent the same diff for a given player and tic, so
+// each is only encoded once and the bits are copied into the packet
+// for each client.  Entries are checked against the diff being sent,
+// so resends of old tics still come out right.  The packed form of a
+// diff does not depend on the tic before it; only the header of each
+// full ticcmd does, and that is written for each client.
+
+typedef struct
+{
+    unsigned int seq;
+    boolean lowres_turn;
+    unsigned int encoded;
+    unsigned int packed;
+    net_ticdiff_t diffs[NET_MAXPLAYERS];
+    byte data[NET_MAXPLAYERS][MAX_TICDIFF_LEN];
+    byte len[NET_MAXPLAYERS];
+    byte packed_data[NET_MAXPLAYERS][MAX_PACKED_TICDIFF_LEN];
+    byte packed_bits[NET_MAXPLAYERS];
+} net_encoded_tic_t;
+
+// Everything belonging to a single game being hosted.  The server
+// build can host several games in one process (see INSTANCE in
+// doomtype.h), each with its own one of these.
+
+typedef struct
+{
+    net_server_state_t state;
+    net_client_t clients[MAXNETNODES];
+    net_client_t *players[NET_MAXPLAYERS];
+    net_context_t *context;
+    unsigned int gamemode;
+    unsigned int gamemission;
+    net_gamesettings_t settings;
+
+    // receive window
+
+    unsigned int recvwindow_start;
+    net_client_recv_t recvwindow[BACKUPTICS][NET_MAXPLAYERS];
+
+    net_encoded_tic_t encoded_tics[BACKUPTICS];
+    net_packet_t *encode_scratch;
+
+    // Each player's ticcmd as clients rebuild it from the diffs they
+    // have been sent, and changes from late ticcmds waiting to be
+    // folded into the next diff (late_seq is the tic they came from).
 
-// receive window
+    ticcmd_t sent_cmd[NET_MAXPLAYERS];
+    net_ticdiff_t late_diff[NET_MAXPLAYERS];
+    unsigned int late_seq[NET_MAXPLAYERS];
 
-static unsigned int recvwindow_start;
-static net_client_recv_t recvwindow[BACKUPTICS][NET_MAXPLAYERS];
+    // Player currently joining the game in progress, and the player
+    // asked for a snapshot of the game to send them.  The snapshot
+    // passes through the server on its way.
 
-#define NET_SV_ExpandTicNum(b) NET_ExpandTicNum(recvwindow_start, (b))
+    net_client_t *joiner;
+    net_client_t *donor;
+    unsigned int join_start_time;
+    net_snapshot_recv_t snapshot_in;
+    net_snapshot_send_t snapshot_out;
+} net_server_instance_t;
+
+static INSTANCE net_server_instance_t *sv;
+
+// Bytes of tic data sent, and number of tics, for each protocol.
+
+static INSTANCE uint64_t sv_tic_bytes[NET_NUM_PROTOCOLS];
+static INSTANCE uint64_t sv_tics_sent[NET_NUM_PROTOCOLS];
 
 static void NET_SV_DisconnectClient(net_client_t *client)
 {
@@ -184,6 +393,14 @@ static boolean ClientConnected(net_client_t *client)
         && client->connection.state == NET_CONN_STATE_CONNECTED;
 }
 
+// Check if a client has connected to a game in progress, and has not
+// been given a player slot yet.
+
+static boolean WaitingToJoin(net_client_t *client)
+{
+    return client->joining && client->player_number < 0;
+}
+
 // Send a message to be displayed on a client's console
 
 static void NET_SV_SendConsoleMessage(net_client_t *client, const char *s, ...) PRINTF_ATTR(2, 3);
@@ -218,13 +435,14 @@ static void NET_SV_BroadcastMessage(const char *s, ...)
 
     for (i=0; i<MAXNETNODES; ++i)
     {
-        if (ClientConnected(&clients[i]))
+        if (ClientConnected(&sv->clients[i]))
         {
-            NET_SV_SendConsoleMessage(&clients[i], "%s", buf);
+            NET_SV_SendConsoleMessage(&sv->clients[i], "%s", buf);
         }
     }
 
     printf("%s\n", buf);
+    NET_EventLog_Message(buf);
 }
 
 
@@ -239,24 +457,24 @@ static void NET_SV_AssignPlayers(void)
 
     for (i=0; i<MAXNETNODES; ++i)
     {
-        if (ClientConnected(&clients[i]))
+        if (ClientConnected(&sv->clients[i]))
         {
-            if (!clients[i].drone)
+            if (!sv->clients[i].drone)
             {
-                sv_players[pl] = &clients[i];
-                sv_players[pl]->player_number = pl;
+                sv->players[pl] = &sv->clients[i];
+                sv->players[pl]->player_number = pl;
                 ++pl;
             }
             else
             {
-                clients[i].player_number = -1;
+                sv->clients[i].player_number = -1;
             }
         }
     }
 
     for (; pl<NET_MAXPLAYERS; ++pl)
     {
-        sv_players[pl] = NULL;
+        sv->players[pl] = NULL;
     }
 }
 
@@ -271,7 +489,7 @@ static int NET_SV_NumPlayers(void)
 
     for (i=0; i<NET_MAXPLAYERS; ++i)
     {
-        if (sv_players[i] != NULL && ClientConnected(sv_players[i]))
+        if (sv->players[i] != NULL && ClientConnected(sv->players[i]))
         {
             result += 1;
         }
@@ -289,8 +507,8 @@ static int NET_SV_NumReadyPlayers(void)
 
     for (i = 0; i < MAXNETNODES; ++i)
     {
-        if (ClientConnected(&clients[i])
-         && !clients[i].drone && clients[i].ready)
+        if (ClientConnected(&sv->clients[i])
+         && !sv->clients[i].drone && sv->clients[i].ready)
         {
             ++result;
         }
@@ -307,9 +525,9 @@ static int NET_SV_MaxPlayers(void)
 
     for (i = 0; i < MAXNETNODES; ++i)
     {
-        if (ClientConnected(&clients[i]))
+        if (ClientConnected(&sv->clients[i]))
         {
-            return clients[i].max_players;
+            return sv->clients[i].max_players;
         }
     }
 
@@ -327,7 +545,7 @@ static int NET_SV_NumDrones(void)
 
     for (i=0; i<MAXNETNODES; ++i)
     {
-        if (ClientConnected(&clients[i]) && clients[i].drone)
+        if (ClientConnected(&sv->clients[i]) && sv->clients[i].drone)
         {
             result += 1;
         }
@@ -347,7 +565,7 @@ static int NET_SV_NumClients(void)
 
     for (i=0; i<MAXNETNODES; ++i)
     {
-        if (ClientConnected(&clients[i]))
+        if (ClientConnected(&sv->clients[i]))
         {
             ++count;
         }
@@ -371,14 +589,14 @@ static net_client_t *NET_SV_Controller(void)
     {
         // Can't be controller?
 
-        if (!ClientConnected(&clients[i]) || clients[i].drone)
+        if (!ClientConnected(&sv->clients[i]) || sv->clients[i].drone)
         {
             continue;
         }
 
-        if (best == NULL || clients[i].connect_time < best->connect_time)
+        if (best == NULL || sv->clients[i].connect_time < best->connect_time)
         {
-            best = &clients[i];
+            best = &sv->clients[i];
         }
     }
 
@@ -424,11 +642,11 @@ static void NET_SV_SendWaitingData(net_client_t *client)
     {
         //printf("setting player name %s\n", sv_players[i]->name);
         M_StringCopy(wait_data.player_names[i],
-                     sv_players[i]->name,
+                     sv->players[i]->name,
                      MAXPLAYERNAME);
-        sv_player_names[i] = sv_players[i]->name;
+        sv_player_names[i] = sv->players[i]->name;
         M_StringCopy(wait_data.player_addrs[i],
-                     NET_AddrToString(sv_players[i]->addr),
+                     NET_AddrToString(sv->players[i]->addr),
                      MAXPLAYERNAME);
     }
 
@@ -454,11 +672,12 @@ static unsigned int NET_SV_LatestAcknowledged(void)
 
     for (i=0; i<MAXNETNODES; ++i) 
     {
-        if (ClientConnected(&clients[i]))
+        if (ClientConnected(&sv->clients[i])
+         && !WaitingToJoin(&sv->clients[i]))
         {
-            if (clients[i].acknowledged < lowtic)
+            if (sv->clients[i].acknowledged < lowtic)
             {
-                lowtic = clients[i].acknowledged;
+                lowtic = sv->clients[i].acknowledged;
             }
         }
     }
@@ -484,7 +703,7 @@ static void NET_SV_AdvanceWindow(void)
 
     // Advance the recv window until it catches up with lowtic
 
-    while (recvwindow_start < lowtic)
+    while (sv->recvwindow_start < lowtic)
     {
         boolean should_advance;
 
@@ -495,12 +714,13 @@ static void NET_SV_AdvanceWindow(void)
 
         for (i=0; i<NET_MAXPLAYERS; ++i)
         {
-            if (sv_players[i] == NULL || !ClientConnected(sv_players[i]))
+            if (sv->players[i] == NULL || !ClientConnected(sv->players[i])
+             || sv->recvwindow_start < sv->players[i]->join_tic)
             {
                 continue;
             }
 
-            if (!recvwindow[0][i].active)
+            if (!sv->recvwindow[0][i].active)
             {
                 should_advance = false;
                 break;
@@ -518,11 +738,11 @@ static void NET_SV_AdvanceWindow(void)
         
         // Advance the window
 
-        memmove(recvwindow, recvwindow + 1,
-                sizeof(*recvwindow) * (BACKUPTICS - 1));
-        memset(&recvwindow[BACKUPTICS-1], 0, sizeof(*recvwindow));
-        ++recvwindow_start;
-        NET_Log("server: advanced receive window to %d", recvwindow_start);
+        memmove(sv->recvwindow, sv->recvwindow + 1,
+                sizeof(*sv->recvwindow) * (BACKUPTICS - 1));
+        memset(&sv->recvwindow[BACKUPTICS-1], 0, sizeof(*sv->recvwindow));
+        ++sv->recvwindow_start;
+        NET_Log("server: advanced receive window to %d", sv->recvwindow_start);
     }
 }
 
@@ -534,11 +754,11 @@ static net_client_t *NET_SV_FindClient(net_addr_t *addr)
 
     for (i=0; i<MAXNETNODES; ++i) 
     {
-        if (clients[i].active && clients[i].addr == addr)
+        if (sv->clients[i].active && sv->clients[i].addr == addr)
         {
             // found the client
 
-            return &clients[i];
+            return &sv->clients[i];
         }
     }
 
@@ -576,14 +796,133 @@ static void NET_SV_InitNewClient(net_client_t *client, net_addr_t *addr,
     client->acknowledged = 0;
     client->drone = false;
     client->ready = false;
+    client->joining = false;
+    client->loading = false;
+    client->join_tic = 0;
+
+    client->bundle = 1;
+    client->unsent = 0;
+    client->rtt = -1;
+    client->backlog_sum = 0;
+    client->backlog_samples = 0;
+    client->adapt_time = client->connect_time;
+    client->quiet_periods = 0;
 
     client->last_gamedata_time = 0;
 
     memset(client->sendqueue, 0xff, sizeof(client->sendqueue));
+    memset(client->resend_time, 0, sizeof(client->resend_time));
+    memset(client->send_time, 0, sizeof(client->send_time));
 
     NET_Log("server: initialized new client from %s", NET_AddrToString(addr));
 }
 
+// Find a player slot for someone joining a game in progress.  In a
+// cooperative game, only the slots the game started with can be used,
+// as a level has no more start spots than that.
+
+static int NET_SV_FreeSlot(void)
+{
+    int max_players;
+    int i;
+
+    if (sv->settings.deathmatch)
+    {
+        max_players = NET_SV_MaxPlayers();
+    }
+    else
+    {
+        max_players = sv->settings.num_players;
+    }
+
+    for (i = 0; i < max_players && i < NET_MAXPLAYERS; ++i)
+    {
+        if (sv->players[i] == NULL || !ClientConnected(sv->players[i]))
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+// Check whether a client can join the game in progress, and reject it
+// if not.  Only Doom can save a snapshot of the game to send them.
+
+static boolean NET_SV_CanJoinLate(net_addr_t *addr, net_connect_data_t *data,
+                                  net_protocol_t protocol)
+{
+    net_client_t *controller;
+
+    if (data->drone || protocol < NET_PROTOCOL_SNAPSHOT_0)
+    {
+        NET_SV_SendReject(addr, "This game is already in progress.");
+        return false;
+    }
+
+    if (sv->gamemission != doom && sv->gamemission != doom2
+     && sv->gamemission != pack_tnt && sv->gamemission != pack_plut
+     && sv->gamemission != pack_chex && sv->gamemission != pack_hacx)
+    {
+        NET_SV_SendReject(addr, "This game is already in progress, and "
+                                "can't be joined once it has started.");
+        return false;
+    }
+
+    // Without the same WADs, the snapshot would make no sense.
+
+    controller = NET_SV_Controller();
+
+    if (controller == NULL
+     || memcmp(controller->wad_sha1sum, data->wad_sha1sum,
+               sizeof(sha1_digest_t)) != 0
+     || memcmp(controller->deh_sha1sum, data->deh_sha1sum,
+               sizeof(sha1_digest_t)) != 0)
+    {
+        NET_SV_SendReject(addr, "Your WAD and dehacked files do not match "
+                                "those of the game in progress.");
+        return false;
+    }
+
+    if (NET_SV_FreeSlot() < 0 || NET_SV_NumClients() >= MAXNETNODES)
+    {
+        NET_SV_SendReject(addr, "Server is full!");
+        return false;
+    }
+
+    return true;
+}
+
+// Give up on getting a player into the game in progress.  Any snapshot
+// still arriving from the donor is left to finish, so that the donor
+// gets its acknowledgements and stops sending.
+
+static void NET_SV_AbortJoin(const char *reason)
+{
+    net_client_t *joiner = sv->joiner;
+
+    NET_Log("server: late join aborted: %s", reason);
+
+    if (ClientConnected(joiner))
+    {
+        NET_SV_SendConsoleMessage(joiner, "Couldn't join the game: %s",
+                                  reason);
+        NET_SV_DisconnectClient(joiner);
+    }
+
+    if (joiner->player_number >= 0
+     && sv->players[joiner->player_number] == joiner)
+    {
+        sv->players[joiner->player_number] = NULL;
+    }
+
+    joiner->joining = false;
+    joiner->loading = false;
+
+    NET_Snapshot_FreeSend(&sv->snapshot_out);
+    sv->joiner = NULL;
+}
+
 // parse a SYN from a client(initiating a connection)
 
 static void NET_SV_ParseSYN(net_packet_t *packet, net_client_t *client,
@@ -595,6 +934,7 @@ static void NET_SV_ParseSYN(net_packet_t *packet, net_client_t *client,
     net_protocol_t protocol;
     char *player_name;
     char *client_version;
+    boolean late;
     int num_players;
     int i;
 
@@ -678,18 +1018,33 @@ static void NET_SV_ParseSYN(net_packet_t *packet, net_client_t *client,
 
     // At this point we have received a valid SYN.
 
-    // Not accepting new connections?
-    if (server_state != SERVER_WAITING_LAUNCH)
+    // Not accepting new connections?  With -latejoin, players can join
+    // a game in progress.
+    late = sv->state == SERVER_IN_GAME && latejoin;
+
+    if (late)
+    {
+        if (!NET_SV_CanJoinLate(addr, &data, protocol))
+        {
+            return;
+        }
+    }
+    else if (sv->state != SERVER_WAITING_LAUNCH)
     {
         NET_Log("server: error: not in waiting launch state, server_state=%d",
-                server_state);
+                sv->state);
         NET_SV_SendReject(addr,
                           "Server is not currently accepting connections");
         return;
     }
 
     // Before accepting a new client, check that there is a slot free.
-    NET_SV_AssignPlayers();
+    // Players in a game in progress keep the numbers they have.
+    if (!late)
+    {
+        NET_SV_AssignPlayers();
+    }
+
     num_players = NET_SV_NumPlayers();
 
     if ((!data.drone && num_players >= NET_SV_MaxPlayers())
@@ -710,23 +1065,24 @@ static void NET_SV_ParseSYN(net_packet_t *packet, net_client_t *client,
     // Adopt the game mode and mission of the first connecting client:
     if (num_players == 0 && !data.drone)
     {
-        sv_gamemode = data.gamemode;
-        sv_gamemission = data.gamemission;
+        sv->gamemode = data.gamemode;
+        sv->gamemission = data.gamemission;
         NET_Log("server: new game, mode=%d, mission=%d",
-                sv_gamemode, sv_gamemission);
+                sv->gamemode, sv->gamemission);
     }
 
     // Check the connecting client is playing the same game as all
     // the other clients
-    if (data.gamemode != sv_gamemode || data.gamemission != sv_gamemission)
+    if (data.gamemode != sv->gamemode || data.gamemission != sv->gamemission)
     {
         char msg[128];
         NET_Log("server: wrong mode/mission, %d != %d || %d != %d",
-                data.gamemode, sv_gamemode, data.gamemission, sv_gamemission);
+                data.gamemode, sv->gamemode,
+                data.gamemission, sv->gamemission);
         M_snprintf(msg, sizeof(msg),
                    "Game mismatch: server is %s (%s), client is %s (%s)",
-                   D_GameMissionString(sv_gamemission),
-                   D_GameModeString(sv_gamemode),
+                   D_GameMissionString(sv->gamemission),
+                   D_GameModeString(sv->gamemode),
                    D_GameMissionString(data.gamemission),
                    D_GameModeString(data.gamemode));
 
@@ -741,9 +1097,9 @@ static void NET_SV_ParseSYN(net_packet_t *packet, net_client_t *client,
 
         for (i=0; i<MAXNETNODES; ++i)
         {
-            if (!clients[i].active)
+            if (!sv->clients[i].active)
             {
-                client = &clients[i];
+                client = &sv->clients[i];
                 break;
             }
         }
@@ -771,6 +1127,11 @@ static void NET_SV_ParseSYN(net_packet_t *packet, net_client_t *client,
         return;
     }
 
+    if (client == sv->joiner)
+    {
+        NET_SV_AbortJoin("reconnected");
+    }
+
     // Activate, initialize connection
     NET_SV_InitNewClient(client, addr, protocol);
 
@@ -784,6 +1145,23 @@ static void NET_SV_ParseSYN(net_packet_t *packet, net_client_t *client,
     client->drone = data.drone;
     client->player_class = data.player_class;
 
+    // Someone joining a game in progress gets a player slot when the
+    // game is sent to them.  If this client was playing before, it
+    // doesn't have its old slot any more.
+    if (late)
+    {
+        for (i = 0; i < NET_MAXPLAYERS; ++i)
+        {
+            if (sv->players[i] == client)
+            {
+                sv->players[i] = NULL;
+            }
+        }
+
+        client->joining = true;
+        client->player_number = -1;
+    }
+
     // Send a reply back to the client, indicating a successful connection
     // and specifying the protocol that will be used for communications.
     reply = NET_Conn_NewReliable(&client->connection, NET_PACKET_TYPE_SYN);
@@ -813,10 +1191,10 @@ static void NET_SV_ParseLaunch(net_packet_t *packet, net_client_t *client)
 
     // Can only launch when we are in the waiting state.
 
-    if (server_state != SERVER_WAITING_LAUNCH)
+    if (sv->state != SERVER_WAITING_LAUNCH)
     {
         NET_Log("server: error: not in waiting launch state, state=%d",
-                server_state);
+                sv->state);
         return;
     }
 
@@ -827,17 +1205,17 @@ static void NET_SV_ParseLaunch(net_packet_t *packet, net_client_t *client)
 
     for (i=0; i<MAXNETNODES; ++i)
     {
-        if (!ClientConnected(&clients[i]))
+        if (!ClientConnected(&sv->clients[i]))
             continue;
 
-        launchpacket = NET_Conn_NewReliable(&clients[i].connection,
+        launchpacket = NET_Conn_NewReliable(&sv->clients[i].connection,
                                             NET_PACKET_TYPE_LAUNCH);
         NET_WriteInt8(launchpacket, num_players);
     }
 
     // Now in launch state.
 
-    server_state = SERVER_WAITING_START;
+    sv->state = SERVER_WAITING_START;
 }
 
 // Transition to the in-game state and send all players the start game
@@ -856,29 +1234,29 @@ static void StartGame(void)
 
     // Check if anyone is recording a demo and set lowres_turn if so.
 
-    sv_settings.lowres_turn = false;
+    sv->settings.lowres_turn = false;
 
     for (i = 0; i < NET_MAXPLAYERS; ++i)
     {
-        if (sv_players[i] != NULL && sv_players[i]->recording_lowres)
+        if (sv->players[i] != NULL && sv->players[i]->recording_lowres)
         {
-            sv_settings.lowres_turn = true;
+            sv->settings.lowres_turn = true;
         }
     }
 
-    sv_settings.num_players = NET_SV_NumPlayers();
+    sv->settings.num_players = NET_SV_NumPlayers();
 
     // Copy player classes:
 
     for (i = 0; i < NET_MAXPLAYERS; ++i)
     {
-        if (sv_players[i] != NULL)
+        if (sv->players[i] != NULL)
         {
-            sv_settings.player_classes[i] = sv_players[i]->player_class;
+            sv->settings.player_classes[i] = sv->players[i]->player_class;
         }
         else
         {
-            sv_settings.player_classes[i] = 0;
+            sv->settings.player_classes[i] = 0;
         }
     }
 
@@ -888,25 +1266,34 @@ static void StartGame(void)
 
     for (i = 0; i < MAXNETNODES; ++i)
     {
-        if (!ClientConnected(&clients[i]))
+        if (!ClientConnected(&sv->clients[i]))
             continue;
 
-        clients[i].last_gamedata_time = nowtime;
+        sv->clients[i].last_gamedata_time = nowtime;
 
-        startpacket = NET_Conn_NewReliable(&clients[i].connection,
+        startpacket = NET_Conn_NewReliable(&sv->clients[i].connection,
                                            NET_PACKET_TYPE_GAMESTART);
 
-        sv_settings.consoleplayer = clients[i].player_number;
+        sv->settings.consoleplayer = sv->clients[i].player_number;
 
-        NET_WriteSettings(startpacket, &sv_settings);
+        NET_WriteSettings(startpacket, &sv->settings);
     }
 
     // Change server state
     NET_Log("server: beginning game state");
-    server_state = SERVER_IN_GAME;
+    sv->state = SERVER_IN_GAME;
 
-    memset(recvwindow, 0, sizeof(recvwindow));
-    recvwindow_start = 0;
+    memset(sv->recvwindow, 0, sizeof(sv->recvwindow));
+    memset(sv->encoded_tics, 0, sizeof(sv->encoded_tics));
+    memset(sv->sent_cmd, 0, sizeof(sv->sent_cmd));
+    memset(sv->late_diff, 0, sizeof(sv->late_diff));
+    sv->recvwindow_start = 0;
+
+    for (i = 0; i < NET_MAXPLAYERS; ++i)
+    {
+        NET_Metrics_ResetPlayer(i, sv->players[i] != NULL ?
+                                   sv->players[i]->name : NULL);
+    }
 }
 
 // Returns true when all nodes have indicated readiness to start the game.
@@ -917,7 +1304,7 @@ static boolean AllNodesReady(void)
 
     for (i = 0; i < MAXNETNODES; ++i)
     {
-        if (ClientConnected(&clients[i]) && !clients[i].ready)
+        if (ClientConnected(&sv->clients[i]) && !sv->clients[i].ready)
         {
             return false;
         }
@@ -949,9 +1336,9 @@ static void SendAllWaitingData(void)
 
     for (i = 0; i < MAXNETNODES; ++i)
     {
-        if (ClientConnected(&clients[i]) && clients[i].ready)
+        if (ClientConnected(&sv->clients[i]) && sv->clients[i].ready)
         {
-            NET_SV_SendWaitingData(&clients[i]);
+            NET_SV_SendWaitingData(&sv->clients[i]);
         }
     }
 }
@@ -966,10 +1353,10 @@ static void NET_SV_ParseGameStart(net_packet_t *packet, net_client_t *client)
 
     // Can only start a game if we are in the waiting start state.
 
-    if (server_state != SERVER_WAITING_START)
+    if (sv->state != SERVER_WAITING_START)
     {
         NET_Log("server: error: not in waiting start state, server_state=%d",
-                server_state);
+                sv->state);
         return;
     }
 
@@ -984,13 +1371,13 @@ static void NET_SV_ParseGameStart(net_packet_t *packet, net_client_t *client)
 
         // Check the game settings are valid
 
-        if (!NET_ValidGameSettings(sv_gamemode, sv_gamemission, &settings))
+        if (!NET_ValidGameSettings(sv->gamemode, sv->gamemission, &settings))
         {
             NET_Log("server: error: invalid game settings");
             return;
         }
 
-        sv_settings = settings;
+        sv->settings = settings;
     }
 
     client->ready = true;
@@ -1004,6 +1391,27 @@ static void NET_SV_ParseGameStart(net_packet_t *packet, net_client_t *client)
     SendAllWaitingData();
 }
 
+// Bitmap of the tics received from a player, starting from the start
+// of the receive window.
+
+static uint64_t NET_SV_ReceivedBitmap(int player)
+{
+    uint64_t result;
+    int i;
+
+    result = 0;
+
+    for (i=0; i<NET_SACK_TICS; ++i)
+    {
+        if (sv->recvwindow[i][player].active)
+        {
+            result |= (uint64_t) 1 << i;
+        }
+    }
+
+    return result;
+}
+
 // Send a resend request to a client
 
 static void NET_SV_SendResendRequest(net_client_t *client, int start, int end)
@@ -1013,26 +1421,54 @@ static void NET_SV_SendResendRequest(net_client_t *client, int start, int end)
     int i;
     unsigned int nowtime;
     int index;
+    boolean sack;
+
+    // With the SACK protocol, the client is told which tics we have
+    // and fills in the gaps up to the end of the range.  The bitmap
+    // only covers the first part of the receive window, so a run of
+    // tics that starts beyond it is asked for the old way, and one
+    // that runs past its end is cut short; the rest is asked for
+    // again on a later check.
+
+    sack = client->connection.protocol >= NET_PROTOCOL_SACK_0
+        && start - (int) sv->recvwindow_start < NET_SACK_TICS;
+
+    if (sack && end - (int) sv->recvwindow_start >= NET_SACK_TICS)
+    {
+        end = sv->recvwindow_start + NET_SACK_TICS - 1;
+    }
 
     NET_Log("server: send resend to %s for tics %d-%d",
             NET_AddrToString(client->addr), start, end);
 
     packet = NET_NewPacket(20);
 
-    NET_WriteInt16(packet, NET_PACKET_TYPE_GAMEDATA_RESEND);
-    NET_WriteInt32(packet, start);
-    NET_WriteInt8(packet, end - start + 1);
+    if (sack)
+    {
+        NET_WriteInt16(packet, NET_PACKET_TYPE_GAMEDATA_ACK);
+        NET_WriteInt8(packet, sv->recvwindow_start & 0xff);
+        NET_WriteSACK(packet, NET_SV_ReceivedBitmap(client->player_number),
+                      end - sv->recvwindow_start + 1);
+    }
+    else
+    {
+        NET_WriteInt16(packet, NET_PACKET_TYPE_GAMEDATA_RESEND);
+        NET_WriteInt32(packet, start);
+        NET_WriteInt8(packet, end - start + 1);
+    }
 
     NET_Conn_SendPacket(&client->connection, packet);
     NET_FreePacket(packet);
 
+    NET_Metrics_PlayerResend(client->player_number, end - start + 1);
+
     // Store the time we send the resend request
 
     nowtime = I_GetTimeMS();
 
     for (i=start; i<=end; ++i)
     {
-        index = i - recvwindow_start;
+        index = i - sv->recvwindow_start;
 
         if (index >= BACKUPTICS)
         {
@@ -1041,7 +1477,7 @@ static void NET_SV_SendResendRequest(net_client_t *client, int start, int end)
             continue;
         }
         
-        recvobj = &recvwindow[index][client->player_number];
+        recvobj = &sv->recvwindow[index][client->player_number];
 
         recvobj->resend_time = nowtime;
     }
@@ -1055,9 +1491,16 @@ static void NET_SV_CheckResends(net_client_t *client)
     int player;
     int resend_start, resend_end;
     unsigned int nowtime;
+    boolean sack;
 
     nowtime = I_GetTimeMS();
 
+    // With the SACK protocol, one request covers all the runs of
+    // missing tics, as the client only resends the ones we don't have.
+    // Runs that start past the SACK bitmap are asked for one by one.
+
+    sack = client->connection.protocol >= NET_PROTOCOL_SACK_0;
+
     player = client->player_number;
     resend_start = -1;
     resend_end = -1;
@@ -1067,7 +1510,7 @@ static void NET_SV_CheckResends(net_client_t *client)
         net_client_recv_t *recvobj;
         boolean need_resend;
 
-        recvobj = &recvwindow[i][player];
+        recvobj = &sv->recvwindow[i][player];
 
         // if need_resend is true, this tic needs another retransmit
         // request (300ms timeout)
@@ -1085,17 +1528,18 @@ static void NET_SV_CheckResends(net_client_t *client)
             }
             resend_end = i;
         }
-        else if (resend_start >= 0)
+        else if (resend_start >= 0
+              && (!sack || resend_start >= NET_SACK_TICS))
         {
             // End of a run of resend tics
             NET_Log("server: resend request to %s timed out for %d-%d (%d)",
                     NET_AddrToString(client->addr),
-                    recvwindow_start + resend_start,
-                    recvwindow_start + resend_end,
-                    &recvwindow[resend_start][player].resend_time);
+                    sv->recvwindow_start + resend_start,
+                    sv->recvwindow_start + resend_end,
+                    &sv->recvwindow[resend_start][player].resend_time);
             NET_SV_SendResendRequest(client, 
-                                     recvwindow_start + resend_start,
-                                     recvwindow_start + resend_end);
+                                     sv->recvwindow_start + resend_start,
+                                     sv->recvwindow_start + resend_end);
 
             resend_start = -1;
         }
@@ -1105,110 +1549,387 @@ static void NET_SV_CheckResends(net_client_t *client)
     {
         NET_Log("server: resend request to %s timed out for %d-%d (%d)",
                 NET_AddrToString(client->addr),
-                recvwindow_start + resend_start,
-                recvwindow_start + resend_end,
-                &recvwindow[resend_start][player].resend_time);
+                sv->recvwindow_start + resend_start,
+                sv->recvwindow_start + resend_end,
+                &sv->recvwindow[resend_start][player].resend_time);
         NET_SV_SendResendRequest(client,
-                                 recvwindow_start + resend_start,
-                                 recvwindow_start + resend_end);
+                                 sv->recvwindow_start + resend_start,
+                                 sv->recvwindow_start + resend_end);
     }
 }
 
 // Process game data from a client
 
-static void NET_SV_ParseGameData(net_packet_t *packet, net_client_t *client)
-{
-    net_client_recv_t *recvobj;
-    unsigned int seq;
-    unsigned int ackseq;
-    unsigned int num_tics;
-    unsigned int nowtime;
-    size_t i;
-    int player;
-    int resend_start, resend_end;
-    int index;
-
-    if (server_state != SERVER_IN_GAME)
-    {
-        NET_Log("server: error: not in game state: server_state=%d",
-                server_state);
-        return;
-    }
+// With -straggler, a player who holds up the game for too long has a
+// ticcmd made up for them.  Their own game has to run the same ticcmd
+// as everyone else's, so this can only be done for clients that take
+// their own ticcmds back from the server.
 
-    if (client->drone)
-    {
-        // Drones do not contribute any game data.
-        NET_Log("server: error: game data from a drone?");
-        return;
-    }
+static boolean NET_SV_Substitutable(int player)
+{
+    net_client_t *client = sv->players[player];
 
-    player = client->player_number;
+    return straggler_deadline > 0
+        && client != NULL
+        && !client->loading
+        && client->connection.protocol >= NET_PROTOCOL_SUBSTITUTE_0;
+}
 
-    // Read header
-    if (!NET_ReadInt8(packet, &ackseq)
-     || !NET_ReadInt8(packet, &seq)
-     || !NET_ReadInt8(packet, &num_tics))
-    {
-        NET_Log("server: error: failed to read header");
-        return;
-    }
+// Copy the given fields, where set in src, into dest.
 
-    NET_Log("server: got game data, seq=%d, num_tics=%d, ackseq=%d",
-            seq, num_tics, ackseq);
+static void CopyDiffFields(net_ticdiff_t *dest, net_ticdiff_t *src,
+                           unsigned int fields)
+{
+    fields &= src->diff;
+
+    if (fields & NET_TICDIFF_FORWARD)
+        dest->cmd.forwardmove = src->cmd.forwardmove;
+    if (fields & NET_TICDIFF_SIDE)
+        dest->cmd.sidemove = src->cmd.sidemove;
+    if (fields & NET_TICDIFF_TURN)
+        dest->cmd.angleturn = src->cmd.angleturn;
+    if (fields & NET_TICDIFF_BUTTONS)
+        dest->cmd.buttons = src->cmd.buttons;
+    if (fields & NET_TICDIFF_CONSISTANCY)
+        dest->cmd.consistancy = src->cmd.consistancy;
+    if (fields & NET_TICDIFF_CHATCHAR)
+        dest->cmd.chatchar = src->cmd.chatchar;
+
+    dest->diff |= fields;
+}
 
-    // Get the current time
-    nowtime = I_GetTimeMS();
+// Make up a ticcmd for a player whose own has not arrived.
 
-    // Expand 8-bit values to the full sequence number
-    ackseq = NET_SV_ExpandTicNum(ackseq);
-    seq = NET_SV_ExpandTicNum(seq);
+static void NET_SV_Substitute(net_client_recv_t *recvobj, int player)
+{
+    memset(&recvobj->diff, 0, sizeof(recvobj->diff));
 
-    // Sanity checks
+    if (straggler_null)
+    {
+        // Stand still and let go of everything.
 
-    for (i=0; i<num_tics; ++i)
+        recvobj->diff.diff = NET_TICDIFF_FORWARD | NET_TICDIFF_SIDE
+                           | NET_TICDIFF_TURN | NET_TICDIFF_BUTTONS;
+    }
+    else if (sv->sent_cmd[player].buttons & BT_SPECIAL)
     {
-        net_ticdiff_t diff;
-        signed int latency;
+        // An empty diff repeats the last ticcmd, but repeating a
+        // pause or a save game would do it again.
 
-        if (!NET_ReadSInt16(packet, &latency)
-         || !NET_ReadTiccmdDiff(packet, &diff, sv_settings.lowres_turn))
-        {
-            return;
-        }
+        recvobj->diff.diff = NET_TICDIFF_BUTTONS;
+    }
 
-        index = seq + i - recvwindow_start;
+    recvobj->active = true;
+    recvobj->substituted = true;
+    recvobj->latency = 0;
+}
 
-        if (index < 0 || index >= BACKUPTICS)
-        {
-            // Not in range of the recv window
+// Check if a player's ticcmd for a tic is available, making one up if
+// they have held things up for longer than -straggler allows.
 
-            continue;
-        }
+static boolean NET_SV_TicReady(int index, int player)
+{
+    net_client_recv_t *recvobj = &sv->recvwindow[index][player];
+    unsigned int nowtime;
 
-        recvobj = &recvwindow[index][player];
-        recvobj->active = true;
-        recvobj->diff = diff;
-        recvobj->latency = latency;
+    if (recvobj->active)
+    {
+        return true;
+    }
 
-        client->last_gamedata_time = nowtime;
-        NET_Log("server: stored tic %d for player %d", seq + i, player);
+    if (!NET_SV_Substitutable(player))
+    {
+        return false;
     }
 
-    // Higher acknowledgement point?
+    nowtime = I_GetTimeMS();
 
-    if (ackseq > client->acknowledged)
+    if (recvobj->due_time == 0)
     {
-        NET_Log("server: acknowledged up to %d", ackseq);
-        client->acknowledged = ackseq;
+        recvobj->due_time = nowtime;
+        return false;
     }
 
-    // Has this been received out of sequence, ie. have we not received
-    // all tics before the first tic in this packet?  If so, send a 
-    // resend request.
+    if (nowtime - recvobj->due_time < (unsigned int) straggler_deadline)
+    {
+        return false;
+    }
 
-    //printf("SV: %p: %i\n", client, seq);
+    NET_Log("server: no ticcmd from player %d for tic %d after %dms, "
+            "making one up", player, sv->recvwindow_start + index,
+            straggler_deadline);
+    NET_SV_Substitute(recvobj, player);
 
-    resend_end = seq - recvwindow_start;
+    return true;
+}
+
+// Called the first time a tic is put in a send queue.  Changes from
+// late ticcmds are folded in now, and the result is remembered so that
+// a substitute can repeat it.
+
+static void NET_SV_UseTic(net_client_recv_t *recvobj, int player,
+                          unsigned int seq)
+{
+    net_ticdiff_t *late = &sv->late_diff[player];
+    net_client_t *client = sv->players[player];
+
+    if (recvobj->substituted)
+    {
+        NET_Metrics_PlayerSubstituted(player);
+    }
+    else if (late->diff != 0)
+    {
+        CopyDiffFields(&recvobj->diff, late, ~recvobj->diff.diff);
+        late->diff = 0;
+    }
+
+    NET_TiccmdPatch(&sv->sent_cmd[player], &recvobj->diff,
+                    &sv->sent_cmd[player]);
+    recvobj->cmd = sv->sent_cmd[player];
+    recvobj->used = true;
+
+    // The first tic of a player who joined the game in progress is sent
+    // in full: the other clients last saw someone else in this slot.
+
+    if (client != NULL && client->join_tic != 0 && seq == client->join_tic)
+    {
+        recvobj->diff.diff = NET_TICDIFF_ALL;
+        recvobj->diff.cmd = recvobj->cmd;
+    }
+}
+
+// A ticcmd has arrived for a tic that was sent out with a made-up one
+// instead.  It is dropped, unless late ticcmds are being accepted, in
+// which case whatever it changed is carried over to the next ticcmd
+// sent for the player.
+
+static void NET_SV_LateTic(int index, int player, net_ticdiff_t *diff)
+{
+    net_ticdiff_t *late = &sv->late_diff[player];
+    unsigned int seq = sv->recvwindow_start + index;
+    unsigned int fields;
+    int i;
+
+    if (!straggler_accept_late)
+    {
+        NET_Metrics_PlayerLateTic(player, false);
+        return;
+    }
+
+    // Anything changed again in a tic that has already been sent, or
+    // in a later late ticcmd, is out of date.
+
+    fields = diff->diff;
+
+    for (i = index + 1; i < BACKUPTICS && sv->recvwindow[i][player].used; ++i)
+    {
+        if (!sv->recvwindow[i][player].substituted)
+        {
+            fields &= ~sv->recvwindow[i][player].diff.diff;
+        }
+    }
+
+    if (late->diff != 0 && sv->late_seq[player] > seq)
+    {
+        fields &= ~late->diff;
+    }
+    else
+    {
+        sv->late_seq[player] = seq;
+    }
+
+    CopyDiffFields(late, diff, fields);
+    NET_Metrics_PlayerLateTic(player, fields != 0);
+}
+
+// The client has received everything we sent before ackseq.  Measure
+// the round trip time from the latest tic acknowledged, unless it was
+// sent more than once, in which case we can't tell which one arrived.
+
+static void NET_SV_Acknowledge(net_client_t *client, unsigned int ackseq)
+{
+    unsigned int latest;
+    int sample;
+
+    if (ackseq <= client->acknowledged)
+    {
+        return;
+    }
+
+    NET_Log("server: acknowledged up to %d", ackseq);
+    client->acknowledged = ackseq;
+
+    latest = ackseq - 1;
+
+    if (ackseq > (unsigned int) client->sendseq
+     || client->sendqueue[latest % BACKUPTICS].seq != latest
+     || client->resend_time[latest % BACKUPTICS] != 0)
+    {
+        return;
+    }
+
+    sample = I_GetTimeMS() - client->send_time[latest % BACKUPTICS];
+
+    if (client->rtt < 0)
+    {
+        client->rtt = sample;
+    }
+    else
+    {
+        client->rtt = (client->rtt * 7 + sample) / 8;
+    }
+}
+
+static void NET_SV_ParseGameData(net_packet_t *packet, net_client_t *client)
+{
+    net_client_recv_t *recvobj;
+    net_bitstream_t stream;
+    boolean packed;
+    signed int latency;
+    unsigned int seq;
+    unsigned int ackseq;
+    unsigned int num_tics;
+    unsigned int nowtime;
+    size_t i;
+    int player;
+    int resend_start, resend_end;
+    int index;
+
+    if (sv->state != SERVER_IN_GAME)
+    {
+        NET_Log("server: error: not in game state: server_state=%d",
+                sv->state);
+        return;
+    }
+
+    if (client->drone)
+    {
+        // Drones do not contribute any game data.
+        NET_Log("server: error: game data from a drone?");
+        return;
+    }
+
+    if (WaitingToJoin(client))
+    {
+        NET_Log("server: error: game data from a client not in the game");
+        return;
+    }
+
+    // A player joining the game has finished loading it.
+
+    client->loading = false;
+
+    player = client->player_number;
+
+    // Read header
+    if (!NET_ReadInt8(packet, &ackseq)
+     || !NET_ReadInt8(packet, &seq)
+     || !NET_ReadInt8(packet, &num_tics))
+    {
+        NET_Log("server: error: failed to read header");
+        return;
+    }
+
+    NET_Log("server: got game data, seq=%d, num_tics=%d, ackseq=%d",
+            seq, num_tics, ackseq);
+
+    // Get the current time
+    nowtime = I_GetTimeMS();
+
+    // Expand 8-bit values to the full sequence number
+    ackseq = NET_SV_ExpandTicNum(ackseq);
+    seq = NET_SV_ExpandTicNum(seq);
+
+    // With the packed protocol, the latency is only sent once.
+
+    packed = client->connection.protocol >= NET_PROTOCOL_PACKED_TICCMDS_0;
+    NET_BitReaderInit(&stream, packet);
+
+    if (packed && !NET_ReadVarSInt(&stream, &latency, PACKED_LATENCY_K))
+    {
+        return;
+    }
+
+    // Sanity checks
+
+    for (i=0; i<num_tics; ++i)
+    {
+        net_ticdiff_t diff;
+
+        if (packed)
+        {
+            if (!NET_ReadPackedTiccmdDiff(&stream, &diff,
+                                          sv->settings.lowres_turn))
+            {
+                return;
+            }
+        }
+        else if (!NET_ReadSInt16(packet, &latency)
+              || !NET_ReadTiccmdDiff(packet, &diff, sv->settings.lowres_turn))
+        {
+            return;
+        }
+
+        index = seq + i - sv->recvwindow_start;
+
+        if (index < 0 || index >= BACKUPTICS
+         || seq + i < client->join_tic)
+        {
+            // Not in range of the recv window, or from before the
+            // player joined the game
+
+            continue;
+        }
+
+        recvobj = &sv->recvwindow[index][player];
+        client->last_gamedata_time = nowtime;
+
+        if (recvobj->substituted && recvobj->used)
+        {
+            // Too late: everyone has been sent a made-up ticcmd.
+
+            NET_Log("server: tic %d for player %d arrived too late",
+                    seq + i, player);
+            NET_SV_LateTic(index, player, &diff);
+            continue;
+        }
+
+        if (recvobj->used)
+        {
+            // A duplicate of a tic that has already been sent on.
+
+            continue;
+        }
+
+        // How long did it take to recover this tic after it was lost?
+
+        if (!recvobj->active && recvobj->resend_time != 0)
+        {
+            NET_Metrics_PlayerRecovery(player,
+                                       nowtime - recvobj->resend_time);
+        }
+
+        recvobj->active = true;
+        recvobj->substituted = false;
+        recvobj->diff = diff;
+        recvobj->latency = latency;
+
+        NET_Metrics_PlayerRTT(player, latency);
+
+        NET_Log("server: stored tic %d for player %d", seq + i, player);
+    }
+
+    // Higher acknowledgement point?
+
+    NET_SV_Acknowledge(client, ackseq);
+
+    // Has this been received out of sequence, ie. have we not received
+    // all tics before the first tic in this packet?  If so, send a 
+    // resend request.
+
+    //printf("SV: %p: %i\n", client, seq);
+
+    resend_end = seq - sv->recvwindow_start;
 
     if (resend_end <= 0)
         return;
@@ -1216,53 +1937,593 @@ static void NET_SV_ParseGameData(net_packet_t *packet, net_client_t *client)
     if (resend_end >= BACKUPTICS)
         resend_end = BACKUPTICS - 1;
 
-    index = resend_end - 1;
-    resend_start = resend_end;
-    
-    while (index >= 0)
-    {
-        recvobj = &recvwindow[index][player];
+    index = resend_end - 1;
+    resend_start = resend_end;
+    
+    while (index >= 0 && sv->recvwindow_start + index >= client->join_tic)
+    {
+        recvobj = &sv->recvwindow[index][player];
+
+        if (recvobj->active)
+        {
+            // ended our run of unreceived tics
+
+            break;
+        }
+
+        if (recvobj->resend_time != 0)
+        {
+            // Already sent a resend request for this tic
+
+            break;
+        }
+
+        resend_start = index;
+        --index;
+    }
+
+    // Possibly send a resend request
+    if (resend_start < resend_end)
+    {
+        NET_Log("server: request resend for %d-%d before %d",
+                sv->recvwindow_start + resend_start,
+                sv->recvwindow_start + resend_end - 1, seq);
+        NET_SV_SendResendRequest(client, 
+                                 sv->recvwindow_start + resend_start, 
+                                 sv->recvwindow_start + resend_end - 1);
+    }
+}
+
+// Find the shared cache entry for a player's diff for a tic, throwing
+// away anything encoded from a different diff.
+
+static net_encoded_tic_t *NET_SV_EncodedTic(unsigned int seq, int player,
+                                            net_ticdiff_t *diff)
+{
+    net_encoded_tic_t *enc;
+    unsigned int bit = 1U << player;
+
+    enc = &sv->encoded_tics[seq % BACKUPTICS];
+
+    if (enc->seq != seq || enc->lowres_turn != sv->settings.lowres_turn)
+    {
+        enc->seq = seq;
+        enc->lowres_turn = sv->settings.lowres_turn;
+        enc->encoded = 0;
+        enc->packed = 0;
+    }
+
+    if (((enc->encoded | enc->packed) & bit) == 0
+     || memcmp(&enc->diffs[player], diff, sizeof(net_ticdiff_t)) != 0)
+    {
+        enc->diffs[player] = *diff;
+        enc->encoded &= ~bit;
+        enc->packed &= ~bit;
+    }
+
+    if (sv->encode_scratch == NULL)
+    {
+        sv->encode_scratch = NET_NewPacket(MAX_PACKED_TICDIFF_LEN);
+    }
+
+    return enc;
+}
+
+// Get the encoded form of a player's diff for a tic, encoding it if it
+// is not already in the shared cache.
+
+static net_encoded_tic_t *NET_SV_EncodedDiff(unsigned int seq, int player,
+                                             net_ticdiff_t *diff)
+{
+    net_encoded_tic_t *enc;
+    unsigned int bit = 1U << player;
+
+    enc = NET_SV_EncodedTic(seq, player, diff);
+
+    if ((enc->encoded & bit) != 0)
+    {
+        return enc;
+    }
+
+    sv->encode_scratch->len = 0;
+    NET_WriteTiccmdDiff(sv->encode_scratch, diff, sv->settings.lowres_turn);
+
+    memcpy(enc->data[player], sv->encode_scratch->data,
+           sv->encode_scratch->len);
+    enc->len[player] = sv->encode_scratch->len;
+    enc->encoded |= bit;
+
+    return enc;
+}
+
+// The same for the bit-packed form.
+
+static net_encoded_tic_t *NET_SV_PackedDiff(unsigned int seq, int player,
+                                            net_ticdiff_t *diff)
+{
+    net_encoded_tic_t *enc;
+    net_bitstream_t stream;
+    unsigned int bit = 1U << player;
+
+    enc = NET_SV_EncodedTic(seq, player, diff);
+
+    if ((enc->packed & bit) != 0)
+    {
+        return enc;
+    }
+
+    sv->encode_scratch->len = 0;
+    NET_BitWriterInit(&stream, sv->encode_scratch);
+    NET_WritePackedTiccmdDiff(&stream, diff, sv->settings.lowres_turn);
+
+    enc->packed_bits[player] = sv->encode_scratch->len * 8 + stream.num_bits;
+    NET_BitWriterFinish(&stream);
+
+    memcpy(enc->packed_data[player], sv->encode_scratch->data,
+           sv->encode_scratch->len);
+    enc->packed |= bit;
+
+    return enc;
+}
+
+// Write a full ticcmd to a packet.  This produces the same output as
+// NET_WriteFullTiccmd, but uses the shared encoded diffs.
+
+static void NET_SV_WriteFullTiccmd(net_packet_t *packet,
+                                   net_full_ticcmd_t *cmd)
+{
+    net_encoded_tic_t *enc;
+    unsigned int bitfield;
+    int i;
+
+    NET_WriteInt16(packet, cmd->latency);
+
+    bitfield = 0;
+
+    for (i=0; i<NET_MAXPLAYERS; ++i)
+    {
+        if (cmd->playeringame[i])
+        {
+            bitfield |= 1U << i;
+        }
+    }
+
+    NET_WriteInt32(packet, bitfield);
+
+    for (i=0; i<NET_MAXPLAYERS; ++i)
+    {
+        if (cmd->playeringame[i])
+        {
+            enc = NET_SV_EncodedDiff(cmd->seq, i, &cmd->cmds[i]);
+            NET_WriteBlob(packet, enc->data[i], enc->len[i]);
+        }
+    }
+}
+
+// Write a bit-packed full ticcmd.  This produces the same output as
+// NET_WritePackedFullTiccmd, but uses the shared encoded diffs.
+
+static void NET_SV_WritePackedFullTiccmd(net_bitstream_t *stream,
+                                         net_full_ticcmd_t *cmd,
+                                         net_full_ticcmd_t *prev)
+{
+    net_encoded_tic_t *enc;
+    unsigned int run;
+    int i;
+
+    NET_WritePackedTiccmdHeader(stream, cmd, prev);
+
+    run = 0;
+
+    for (i=0; i<NET_MAXPLAYERS; ++i)
+    {
+        if (!cmd->playeringame[i])
+        {
+            continue;
+        }
+
+        if (cmd->cmds[i].diff == 0)
+        {
+            ++run;
+            continue;
+        }
+
+        NET_WriteVarUInt(stream, run, PACKED_RUN_K);
+        enc = NET_SV_PackedDiff(cmd->seq, i, &cmd->cmds[i]);
+        NET_WriteBitBlob(stream, enc->packed_data[i], enc->packed_bits[i]);
+        run = 0;
+    }
+
+    if (run > 0)
+    {
+        NET_WriteVarUInt(stream, run, PACKED_RUN_K);
+    }
+}
+
+static void NET_SV_SendTics(net_client_t *client, 
+                            unsigned int start, unsigned int end)
+{
+    net_packet_t *packet;
+    net_full_ticcmd_t *prev;
+    net_bitstream_t stream;
+    boolean packed;
+    unsigned int i;
+
+    packet = NET_NewPacket(500);
+
+    NET_WriteInt16(packet, NET_PACKET_TYPE_GAMEDATA);
+
+    // Send the start tic and number of tics
+
+    NET_WriteInt8(packet, start & 0xff);
+    NET_WriteInt8(packet, end-start + 1);
+
+    // Write the tics
+
+    packed = client->connection.protocol >= NET_PROTOCOL_PACKED_TICCMDS_0;
+    NET_BitWriterInit(&stream, packet);
+    prev = NULL;
+
+    for (i=start; i<=end; ++i)
+    {
+        net_full_ticcmd_t *cmd;
+
+        cmd = &client->sendqueue[i % BACKUPTICS];
+
+        if (i != cmd->seq)
+        {
+            I_Error("Wanted to send %i, but %i is in its place", i, cmd->seq);
+        }
+
+        // Add command
+       
+        if (packed)
+        {
+            NET_SV_WritePackedFullTiccmd(&stream, cmd, prev);
+            prev = cmd;
+        }
+        else
+        {
+            NET_SV_WriteFullTiccmd(packet, cmd);
+        }
+    }
+
+    NET_BitWriterFinish(&stream);
+
+    // Keep count of how compact the tic data is.
+
+    sv_tic_bytes[client->connection.protocol] += packet->len - 4;
+    sv_tics_sent[client->connection.protocol] += end - start + 1;
+
+    NET_Log("server: tic data averaging %d bytes per tic",
+            (int) (sv_tic_bytes[client->connection.protocol]
+                 / sv_tics_sent[client->connection.protocol]));
+    
+    // Send packet
+
+    NET_Conn_SendPacket(&client->connection, packet);
+    
+    NET_FreePacket(packet);
+}
+
+//
+// -ticcmdbench: the bytes per tic of the old and the bit-packed tic
+// data, for a generated 32-player game.  Each player switches between
+// standing still and moving, turns with the mouse some of the time and
+// holds down fire some of the time, as often as the scenario says.
+//
+
+#define TICBENCH_TICS 10500
+
+typedef struct
+{
+    const char *name;
+
+    // Percentage of players moving, turning and firing.
+
+    int moving;
+    int turning;
+    int firing;
+} ticbench_scenario_t;
+
+static const ticbench_scenario_t ticbench_scenarios[] =
+{
+    { "waiting",   5,  5,  0 },
+    { "roaming",  60, 40, 10 },
+    { "fighting", 95, 80, 50 },
+};
+
+static const int ticbench_packet_tics[] = { 1, 8 };
+
+static INSTANCE unsigned int ticbench_seed;
+
+static int TicBenchRandom(int n)
+{
+    ticbench_seed = ticbench_seed * 1103515245 + 12345;
+
+    return (ticbench_seed >> 16) % n;
+}
+
+// Make up the next ticcmd for a player.
+
+static void TicBenchCommand(const ticbench_scenario_t *scenario,
+                            boolean *moving, ticcmd_t *cmd)
+{
+    static const signed char forwardmoves[] = { 50, 50, -50, 25 };
+    static const signed char sidemoves[] = { 0, 0, 40, -40 };
+
+    if (TicBenchRandom(TICRATE) == 0)
+    {
+        *moving = TicBenchRandom(100) < scenario->moving;
+    }
+
+    if (*moving)
+    {
+        if (cmd->forwardmove == 0 || TicBenchRandom(10) == 0)
+        {
+            cmd->forwardmove = forwardmoves[TicBenchRandom(4)];
+        }
+
+        if (TicBenchRandom(10) == 0)
+        {
+            cmd->sidemove = sidemoves[TicBenchRandom(4)];
+        }
+
+        // The consistancy byte follows the player's position.
+
+        cmd->consistancy = TicBenchRandom(256);
+    }
+    else
+    {
+        cmd->forwardmove = 0;
+        cmd->sidemove = 0;
+    }
+
+    if (TicBenchRandom(100) < scenario->turning)
+    {
+        cmd->angleturn = TicBenchRandom(1201) - 600;
+    }
+    else
+    {
+        cmd->angleturn = 0;
+    }
+
+    if (TicBenchRandom(10) == 0)
+    {
+        cmd->buttons = TicBenchRandom(100) < scenario->firing ? BT_ATTACK : 0;
+    }
+
+    cmd->chatchar = 0;
+}
+
+// Check that a tic read back from a packet gives the same commands
+// that were written.
+
+static void TicBenchCheck(net_full_ticcmd_t *cmd, net_full_ticcmd_t *read,
+                          ticcmd_t *base, const char *protocol)
+{
+    ticcmd_t expected, result;
+    int i;
+
+    for (i = 0; i < NET_MAXPLAYERS; ++i)
+    {
+        NET_TiccmdPatch(&base[i], &cmd->cmds[i], &expected);
+        NET_TiccmdPatch(&base[i], &read->cmds[i], &result);
+
+        if (cmd->latency != read->latency
+         || cmd->playeringame[i] != read->playeringame[i]
+         || expected.forwardmove != result.forwardmove
+         || expected.sidemove != result.sidemove
+         || expected.angleturn != result.angleturn
+         || expected.buttons != result.buttons
+         || expected.consistancy != result.consistancy
+         || expected.chatchar != result.chatchar)
+        {
+            I_Error("NET_SV_TiccmdBench: %s tic data for player %d "
+                    "does not read back", protocol, i);
+        }
+    }
+}
+
+static void NET_SV_TiccmdBench(const ticbench_scenario_t *scenario,
+                               int packet_tics)
+{
+    net_full_ticcmd_t *cmds;
+    ticcmd_t last[NET_MAXPLAYERS], next;
+    ticcmd_t base_old[NET_MAXPLAYERS], base_packed[NET_MAXPLAYERS];
+    boolean moving[NET_MAXPLAYERS];
+    net_full_ticcmd_t read, read_prev;
+    net_full_ticcmd_t *prev;
+    net_bitstream_t stream;
+    net_packet_t *packet;
+    uint64_t old_bytes, packed_bytes;
+    int tic, start, end, i;
+
+    // Make up the game.  Each player's command is sent as a diff
+    // against their command from the tic before, as the server does.
+
+    cmds = malloc(TICBENCH_TICS * sizeof(*cmds));
+
+    if (cmds == NULL)
+    {
+        I_Error("NET_SV_TiccmdBench: Failed to allocate tic list");
+    }
+
+    ticbench_seed = 1;
+    memset(last, 0, sizeof(last));
+    memset(moving, 0, sizeof(moving));
+
+    for (tic = 0; tic < TICBENCH_TICS; ++tic)
+    {
+        cmds[tic].latency = 60 + (tic / (TICRATE * 10)) % 3;
+        cmds[tic].seq = tic;
+
+        for (i = 0; i < NET_MAXPLAYERS; ++i)
+        {
+            next = last[i];
+            TicBenchCommand(scenario, &moving[i], &next);
+            NET_TiccmdDiff(&last[i], &next, &cmds[tic].cmds[i]);
+            cmds[tic].playeringame[i] = true;
+            last[i] = next;
+        }
+    }
+
+    // Write the tics out in packets of packet_tics, as NET_SV_SendTics
+    // does, then read them back.
+
+    old_bytes = 0;
+    packed_bytes = 0;
+    memset(base_old, 0, sizeof(base_old));
+    memset(base_packed, 0, sizeof(base_packed));
+
+    for (start = 0; start < TICBENCH_TICS; start += packet_tics)
+    {
+        end = start + packet_tics;
+
+        if (end > TICBENCH_TICS)
+        {
+            end = TICBENCH_TICS;
+        }
+
+        packet = NET_NewPacket(500);
+
+        for (tic = start; tic < end; ++tic)
+        {
+            NET_WriteFullTiccmd(packet, &cmds[tic], false);
+        }
+
+        old_bytes += packet->len;
+
+        for (tic = start; tic < end; ++tic)
+        {
+            if (!NET_ReadFullTiccmd(packet, &read, false))
+            {
+                I_Error("NET_SV_TiccmdBench: old tic data does not "
+                        "read back");
+            }
+
+            TicBenchCheck(&cmds[tic], &read, base_old, "old");
+
+            for (i = 0; i < NET_MAXPLAYERS; ++i)
+            {
+                NET_TiccmdPatch(&base_old[i], &read.cmds[i], &base_old[i]);
+            }
+        }
+
+        NET_FreePacket(packet);
+
+        packet = NET_NewPacket(500);
+        NET_BitWriterInit(&stream, packet);
+        prev = NULL;
+
+        for (tic = start; tic < end; ++tic)
+        {
+            NET_WritePackedFullTiccmd(&stream, &cmds[tic], prev, false);
+            prev = &cmds[tic];
+        }
+
+        NET_BitWriterFinish(&stream);
+        packed_bytes += packet->len;
+
+        NET_BitReaderInit(&stream, packet);
+
+        for (tic = start; tic < end; ++tic)
+        {
+            if (!NET_ReadPackedFullTiccmd(&stream, &read,
+                                          tic > start ? &read_prev : NULL,
+                                          false))
+            {
+                I_Error("NET_SV_TiccmdBench: packed tic data does not "
+                        "read back");
+            }
+
+            TicBenchCheck(&cmds[tic], &read, base_packed, "packed");
+
+            for (i = 0; i < NET_MAXPLAYERS; ++i)
+            {
+                NET_TiccmdPatch(&base_packed[i], &read.cmds[i],
+                                &base_packed[i]);
+            }
+
+            read_prev = read;
+        }
+
+        NET_FreePacket(packet);
+    }
+
+    printf("NET_SV_TiccmdBench: %-8s %d tic%s per packet: "
+           "old %5.1f bytes per tic, packed %5.1f (%d%%)\n",
+           scenario->name, packet_tics, packet_tics == 1 ? " " : "s",
+           (double) old_bytes / TICBENCH_TICS,
+           (double) packed_bytes / TICBENCH_TICS,
+           (int) (packed_bytes * 100 / old_bytes));
+
+    free(cmds);
+}
+
+// Parse a retransmission request from a client
+
+static void NET_SV_ParseResendRequest(net_packet_t *packet, net_client_t *client)
+{
+    unsigned int start, last;
+    unsigned int num_tics;
+    unsigned int i;
+
+    NET_Log("server: processing resend request");
+
+    // Read the starting tic and number of tics
+
+    if (!NET_ReadInt32(packet, &start)
+     || !NET_ReadInt8(packet, &num_tics))
+    {
+        NET_Log("server: error: missing fields for resend");
+        return;
+    }
+
+    //printf("SV: %p: resend %i-%i\n", client, start, start+num_tics-1);
+
+    // Check we have all the requested tics
+
+    last = start + num_tics - 1;
 
-        if (recvobj->active)
-        {
-            // ended our run of unreceived tics
+    for (i=start; i<=last; ++i)
+    {
+        net_full_ticcmd_t *cmd;
 
-            break;
-        }
+        cmd = &client->sendqueue[i % BACKUPTICS];
 
-        if (recvobj->resend_time != 0)
+        if (i != cmd->seq)
         {
-            // Already sent a resend request for this tic
-
-            break;
+            // We do not have the requested tic (any more)
+            // This is pretty fatal.  We could disconnect the client, 
+            // but then again this could be a spoofed packet.  Just 
+            // ignore it.
+            NET_Log("server: error: don't have tic %d any more, "
+                    "can't resend", i);
+            return;
         }
-
-        resend_start = index;
-        --index;
     }
 
-    // Possibly send a resend request
-    if (resend_start < resend_end)
-    {
-        NET_Log("server: request resend for %d-%d before %d",
-                recvwindow_start + resend_start,
-                recvwindow_start + resend_end - 1, seq);
-        NET_SV_SendResendRequest(client, 
-                                 recvwindow_start + resend_start, 
-                                 recvwindow_start + resend_end - 1);
-    }
+    // Resend those tics
+    NET_Log("server: resending tics %d-%d", start, last);
+    NET_SV_SendTics(client, start, last);
+    NET_Metrics_PlayerTicsResent(client->player_number, num_tics);
 }
 
 static void NET_SV_ParseGameDataACK(net_packet_t *packet, net_client_t *client)
 {
-    unsigned int ackseq;
+    unsigned int ackseq, num_tics;
+    unsigned int nowtime;
+    uint64_t received;
+    int resend_start;
+    unsigned int i;
 
     NET_Log("server: processing game data ack packet");
 
-    if (server_state != SERVER_IN_GAME)
+    if (sv->state != SERVER_IN_GAME || WaitingToJoin(client))
     {
         NET_Log("server: error: not in game state, server_state=%d",
-                server_state);
+                sv->state);
         return;
     }
 
@@ -1280,152 +2541,200 @@ static void NET_SV_ParseGameDataACK(net_packet_t *packet, net_client_t *client)
 
     // Higher acknowledgement point than we already have?
 
-    if (ackseq > client->acknowledged)
+    NET_SV_Acknowledge(client, ackseq);
+
+    if (client->connection.protocol < NET_PROTOCOL_SACK_0)
     {
-        NET_Log("server: acknowledged up to %d", ackseq);
-        client->acknowledged = ackseq;
+        return;
     }
-}
-
-static void NET_SV_SendTics(net_client_t *client, 
-                            unsigned int start, unsigned int end)
-{
-    net_packet_t *packet;
-    unsigned int i;
-
-    packet = NET_NewPacket(500);
 
-    NET_WriteInt16(packet, NET_PACKET_TYPE_GAMEDATA);
-
-    // Send the start tic and number of tics
+    if (!NET_ReadSACK(packet, &received, &num_tics))
+    {
+        NET_Log("server: error: failed to read selective ack");
+        return;
+    }
 
-    NET_WriteInt8(packet, start & 0xff);
-    NET_WriteInt8(packet, end-start + 1);
+    nowtime = I_GetTimeMS();
+    resend_start = -1;
 
-    // Write the tics
+    // Resend each run of tics that the client is missing.  Tics that
+    // were only just resent are probably still on their way.
 
-    for (i=start; i<=end; ++i)
+    for (i=0; i<=num_tics; ++i)
     {
-        net_full_ticcmd_t *cmd;
-
-        cmd = &client->sendqueue[i % BACKUPTICS];
+        unsigned int seq = ackseq + i;
+        boolean need_resend = false;
 
-        if (i != cmd->seq)
+        if (i < num_tics && (received & ((uint64_t) 1 << i)) == 0)
         {
-            I_Error("Wanted to send %i, but %i is in its place", i, cmd->seq);
+            need_resend = seq < (unsigned int) (client->sendseq
+                                               - client->unsent)
+                       && client->sendqueue[seq % BACKUPTICS].seq == seq
+                       && (client->resend_time[seq % BACKUPTICS] == 0
+                        || nowtime - client->resend_time[seq % BACKUPTICS]
+                             >= NET_SACK_HOLDOFF);
         }
 
-        // Add command
-       
-        NET_WriteFullTiccmd(packet, cmd, sv_settings.lowres_turn);
-    }
-    
-    // Send packet
+        if (need_resend)
+        {
+            client->resend_time[seq % BACKUPTICS] = nowtime;
 
-    NET_Conn_SendPacket(&client->connection, packet);
-    
-    NET_FreePacket(packet);
+            if (resend_start < 0)
+            {
+                resend_start = i;
+            }
+        }
+        else if (resend_start >= 0)
+        {
+            NET_Log("server: resending tics %d-%d", ackseq + resend_start,
+                    seq - 1);
+            NET_SV_SendTics(client, ackseq + resend_start, seq - 1);
+            NET_Metrics_PlayerTicsResent(client->player_number,
+                                         i - resend_start);
+            resend_start = -1;
+        }
+    }
 }
 
-// Parse a retransmission request from a client
+// Take a token from a query rate limiting bucket, if there is one.
 
-static void NET_SV_ParseResendRequest(net_packet_t *packet, net_client_t *client)
+static boolean TakeQueryToken(query_limit_t *limit, unsigned int burst,
+                              unsigned int period, unsigned int nowtime)
 {
-    unsigned int start, last;
-    unsigned int num_tics;
-    unsigned int i;
+    unsigned int refill;
 
-    NET_Log("server: processing resend request");
+    refill = (nowtime - limit->last_time) / period;
 
-    // Read the starting tic and number of tics
+    if (refill > 0)
+    {
+        limit->last_time += refill * period;
+        limit->tokens += refill;
 
-    if (!NET_ReadInt32(packet, &start)
-     || !NET_ReadInt8(packet, &num_tics))
+        if (limit->tokens >= burst)
+        {
+            limit->tokens = burst;
+            limit->last_time = nowtime;
+        }
+    }
+
+    if (limit->tokens == 0)
     {
-        NET_Log("server: error: missing fields for resend");
-        return;
+        return false;
     }
 
-    //printf("SV: %p: resend %i-%i\n", client, start, start+num_tics-1);
+    --limit->tokens;
 
-    // Check we have all the requested tics
+    return true;
+}
 
-    last = start + num_tics - 1;
+// Find the rate limiting bucket for an address.  If there is none,
+// the least recently refilled bucket nearby is given to it.
 
-    for (i=start; i<=last; ++i)
+static query_limit_t *NET_SV_QueryLimit(net_addr_t *addr,
+                                        unsigned int nowtime)
+{
+    query_limit_t *limit;
+    query_limit_t *oldest;
+    unsigned int i, start;
+
+    start = (unsigned int) (((uintptr_t) addr >> 4) * 0x9e3779b1U);
+    oldest = NULL;
+
+    for (i = 0; i < QUERY_TABLE_PROBES; ++i)
     {
-        net_full_ticcmd_t *cmd;
+        limit = &query_limits[(start + i) % QUERY_TABLE_SIZE];
 
-        cmd = &client->sendqueue[i % BACKUPTICS];
+        if (limit->addr == addr)
+        {
+            return limit;
+        }
 
-        if (i != cmd->seq)
+        if (oldest == NULL || limit->addr == NULL
+         || (oldest->addr != NULL
+          && nowtime - limit->last_time > nowtime - oldest->last_time))
         {
-            // We do not have the requested tic (any more)
-            // This is pretty fatal.  We could disconnect the client, 
-            // but then again this could be a spoofed packet.  Just 
-            // ignore it.
-            NET_Log("server: error: don't have tic %d any more, "
-                    "can't resend", i);
-            return;
+            oldest = limit;
         }
     }
 
-    // Resend those tics
-    NET_Log("server: resending tics %d-%d", start, last);
-    NET_SV_SendTics(client, start, last);
+    // The address is referenced while it is in the table, so that it
+    // is not freed and another address given the same pointer.
+
+    if (oldest->addr != NULL)
+    {
+        NET_ReleaseAddress(oldest->addr);
+    }
+
+    NET_ReferenceAddress(addr);
+    oldest->addr = addr;
+    oldest->tokens = QUERY_BURST;
+    oldest->last_time = nowtime;
+
+    return oldest;
 }
 
-// Send a response back to the client
+// Get the response to send to queries, building it again if anything
+// in it has changed.
 
-void NET_SV_SendQueryResponse(net_addr_t *addr)
+static net_packet_t *NET_SV_QueryResponse(void)
 {
-    net_packet_t *reply;
     net_querydata_t querydata;
-    int p;
-
-    // Version
 
     querydata.version = PACKAGE_STRING;
+    querydata.server_state = sv->state;
+    querydata.num_players = NET_SV_NumPlayers();
+    querydata.max_players = NET_SV_MaxPlayers();
+    querydata.gamemode = sv->gamemode;
+    querydata.gamemission = sv->gamemission;
+    querydata.description = server_description;
+    querydata.protocol = NET_PROTOCOL_UNKNOWN;
 
-    // Server state
-
-    querydata.server_state = server_state;
+    if (query_response != NULL
+     && querydata.server_state == query_response_data.server_state
+     && querydata.num_players == query_response_data.num_players
+     && querydata.max_players == query_response_data.max_players
+     && querydata.gamemode == query_response_data.gamemode
+     && querydata.gamemission == query_response_data.gamemission)
+    {
+        return query_response;
+    }
 
-    // Number of players/maximum players
+    if (query_response != NULL)
+    {
+        NET_FreePacket(query_response);
+    }
 
-    querydata.num_players = NET_SV_NumPlayers();
-    querydata.max_players = NET_SV_MaxPlayers();
+    query_response = NET_NewPacket(64);
+    NET_WriteInt16(query_response, NET_PACKET_TYPE_QUERY_RESPONSE);
+    NET_WriteQueryData(query_response, &querydata);
+    query_response_data = querydata;
 
-    // Game mode/mission
+    return query_response;
+}
 
-    querydata.gamemode = sv_gamemode;
-    querydata.gamemission = sv_gamemission;
+// Send a response back to the client
 
-    //!
-    // @category net
-    // @arg <name>
-    //
-    // When starting a network server, specify a name for the server.
-    //
+void NET_SV_SendQueryResponse(net_addr_t *addr)
+{
+    unsigned int nowtime;
 
-    p = M_CheckParmWithArgs("-servername", 1);
+    nowtime = I_GetTimeMS();
 
-    if (p > 0)
-    {
-        querydata.description = myargv[p + 1];
-    }
-    else
+    if (!TakeQueryToken(NET_SV_QueryLimit(addr, nowtime),
+                        QUERY_BURST, QUERY_PERIOD, nowtime)
+     || !TakeQueryToken(&query_total_limit, QUERY_TOTAL_BURST,
+                        QUERY_TOTAL_PERIOD, nowtime))
     {
-        querydata.description = "Unnamed server";
+        NET_Log("server: too many queries, not answering %s",
+                NET_AddrToString(addr));
+        NET_Metrics_Query(false);
+        return;
     }
 
     // Send it and we're done.
     NET_Log("server: sending query response to %s", NET_AddrToString(addr));
-    reply = NET_NewPacket(64);
-    NET_WriteInt16(reply, NET_PACKET_TYPE_QUERY_RESPONSE);
-    NET_WriteQueryData(reply, &querydata);
-    NET_SendPacket(addr, reply);
-    NET_FreePacket(reply);
+    NET_SendPacket(addr, NET_SV_QueryResponse());
+    NET_Metrics_Query(true);
 }
 
 static void NET_SV_ParseHolePunch(net_packet_t *packet)
@@ -1441,7 +2750,7 @@ static void NET_SV_ParseHolePunch(net_packet_t *packet)
         return;
     }
 
-    addr = NET_ResolveAddress(server_context, addr_string);
+    addr = NET_ResolveAddress(sv->context, addr_string);
     if (addr == NULL)
     {
         NET_Log("server: error: failed to resolve address: %s", addr_string);
@@ -1552,6 +2861,19 @@ static void NET_SV_Packet(net_packet_t *packet, net_addr_t *addr)
             case NET_PACKET_TYPE_GAMEDATA_RESEND:
                 NET_SV_ParseResendRequest(packet, client);
                 break;
+            case NET_PACKET_TYPE_SNAPSHOT_DATA:
+                if (client == sv->donor)
+                {
+                    NET_Snapshot_ParseData(&sv->snapshot_in, packet,
+                                           &client->connection);
+                }
+                break;
+            case NET_PACKET_TYPE_SNAPSHOT_ACK:
+                if (client == sv->joiner)
+                {
+                    NET_Snapshot_ParseAck(&sv->snapshot_out, packet);
+                }
+                break;
             default:
                 // unknown packet type
 
@@ -1564,22 +2886,30 @@ static void NET_SV_Packet(net_packet_t *packet, net_addr_t *addr)
 static void NET_SV_PumpSendQueue(net_client_t *client)
 {
     net_full_ticcmd_t cmd;
+    boolean ready;
     int recv_index;
     int num_players;
     int i;
-    int starttic, endtic;
+
+    // Nothing to send to someone waiting to join the game.
+
+    if (WaitingToJoin(client))
+    {
+        return;
+    }
 
     // If a client has not sent any acknowledgments for a while,
     // wait until they catch up.
 
     if (client->sendseq - NET_SV_LatestAcknowledged() > 40)
     {
+        NET_Metrics_PlayerStall(client->player_number);
         return;
     }
     
     // Work out the index into the receive window
    
-    recv_index = client->sendseq - recvwindow_start;
+    recv_index = client->sendseq - sv->recvwindow_start;
 
     if (recv_index < 0 || recv_index >= BACKUPTICS)
     {
@@ -1589,31 +2919,44 @@ static void NET_SV_PumpSendQueue(net_client_t *client)
     // Check if we can generate a new entry for the send queue
     // using the data in recvwindow.
 
+    // Every player is checked, even once one is found to be missing,
+    // so that the -straggler deadline starts for all of them at once.
+
     num_players = 0;
+    ready = true;
 
     for (i=0; i<NET_MAXPLAYERS; ++i)
     {
-        if (sv_players[i] == client)
+        if (sv->players[i] == NULL || !ClientConnected(sv->players[i])
+         || (unsigned int) client->sendseq < sv->players[i]->join_tic)
         {
-            // Client does not rely on itself for data
-
             continue;
         }
 
-        if (sv_players[i] == NULL || !ClientConnected(sv_players[i]))
+        if (sv->players[i] == client && !NET_SV_Substitutable(i))
         {
+            // Client does not rely on itself for data
+
             continue;
         }
 
-        if (!recvwindow[recv_index][i].active)
+        if (!NET_SV_TicReady(recv_index, i))
         {
             // We do not have this player's ticcmd, so we cannot
             // generate a complete command yet.
 
-            return;
+            ready = false;
+        }
+
+        if (sv->players[i] != client)
+        {
+            ++num_players;
         }
+    }
 
-        ++num_players;
+    if (!ready)
+    {
+        return;
     }
 
     // If this is a game with only a single player in it, we might
@@ -1622,66 +2965,190 @@ static void NET_SV_PumpSendQueue(net_client_t *client)
     // and never stopping. Don't let the server get too far ahead
     // of the client.
 
-    if (num_players == 0 && client->sendseq > recvwindow_start + 10)
+    if (num_players == 0 && client->sendseq > sv->recvwindow_start + 10)
+    {
+        return;
+    }
+
+    // We have all data we need to generate a command for this tic.
+    
+    cmd.seq = client->sendseq;
+
+    // Add ticcmds from all players
+
+    cmd.latency = 0;
+
+    for (i=0; i<NET_MAXPLAYERS; ++i)
+    {
+        net_client_recv_t *recvobj;
+
+        if (sv->players[i] == client && !NET_SV_Substitutable(i))
+        {
+            // Not the player we are sending to
+
+            cmd.playeringame[i] = false;
+            continue;
+        }
+        
+        // Tics from a player who has since left (or whose slot has
+        // been given to someone joining the game) must still go to
+        // everyone, as some clients may have been sent them already.
+
+        if (!sv->recvwindow[recv_index][i].active)
+        {
+            cmd.playeringame[i] = false;
+            continue;
+        }
+
+        cmd.playeringame[i] = true;
+
+        recvobj = &sv->recvwindow[recv_index][i];
+
+        if (!recvobj->used)
+        {
+            NET_SV_UseTic(recvobj, i, cmd.seq);
+        }
+
+        cmd.cmds[i] = recvobj->diff;
+
+        // A client that has just joined the game has nothing for the
+        // first tic's diffs to apply to, so gets whole ticcmds.
+
+        if (client->join_tic != 0 && cmd.seq == client->join_tic)
+        {
+            cmd.cmds[i].diff = NET_TICDIFF_ALL;
+            cmd.cmds[i].cmd = recvobj->cmd;
+        }
+
+        if (sv->players[i] != client && recvobj->latency > cmd.latency)
+            cmd.latency = recvobj->latency;
+    }
+
+    //printf("SV: %i: latency %i\n", client->player_number, cmd.latency);
+
+    // Add into the queue
+
+    client->sendqueue[client->sendseq % BACKUPTICS] = cmd;
+    client->resend_time[client->sendseq % BACKUPTICS] = 0;
+
+    // The new tic is transmitted to the client by NET_SV_SendBundle,
+    // along with any others waiting to go.
+
+    if (client->unsent == 0)
+    {
+        client->unsent_time = I_GetTimeMS();
+    }
+
+    ++client->unsent;
+
+    NET_Metrics_PlayerSendLag(client->player_number,
+                              client->sendseq - client->acknowledged);
+
+    client->backlog_sum += client->sendseq - client->acknowledged;
+    ++client->backlog_samples;
+
+    ++client->sendseq;
+}
+
+// Decide how many tics to bundle into each packet sent to a client.
+// Tics waiting to be acknowledged are either on their way (as many as
+// fit in the round trip time, plus those held back for bundling) or
+// queued up on a link too slow for them.  If they are queuing, bundle
+// more; if they have not been for a while, bundle fewer again.
+
+static void NET_SV_AdaptBundle(net_client_t *client)
+{
+    unsigned int nowtime;
+    int backlog;
+    int expected;
+
+    nowtime = I_GetTimeMS();
+
+    if (nowtime - client->adapt_time < BUNDLE_ADAPT_PERIOD)
     {
         return;
     }
 
-    // We have all data we need to generate a command for this tic.
-    
-    cmd.seq = client->sendseq;
+    client->adapt_time = nowtime;
 
-    // Add ticcmds from all players
+    if (client->backlog_samples == 0 || client->rtt < 0)
+    {
+        return;
+    }
 
-    cmd.latency = 0;
+    backlog = client->backlog_sum / client->backlog_samples;
+    expected = client->rtt * TICRATE / 1000 + client->bundle;
 
-    for (i=0; i<NET_MAXPLAYERS; ++i)
-    {
-        net_client_recv_t *recvobj;
+    client->backlog_sum = 0;
+    client->backlog_samples = 0;
 
-        if (sv_players[i] == client)
-        {
-            // Not the player we are sending to
+    if (backlog > expected + BUNDLE_QUEUED_TICS)
+    {
+        client->quiet_periods = 0;
 
-            cmd.playeringame[i] = false;
-            continue;
-        }
-        
-        if (sv_players[i] == NULL || !recvwindow[recv_index][i].active)
+        if (client->bundle < max_bundle)
         {
-            cmd.playeringame[i] = false;
-            continue;
+            ++client->bundle;
+            NET_Log("server: %s: rtt=%dms, %d tics unacknowledged, "
+                    "bundling %d tics", NET_AddrToString(client->addr),
+                    client->rtt, backlog, client->bundle);
         }
+    }
+    else if (client->bundle > 1
+          && ++client->quiet_periods >= BUNDLE_QUIET_PERIODS)
+    {
+        client->quiet_periods = 0;
+        --client->bundle;
+        NET_Log("server: %s: rtt=%dms, %d tics unacknowledged, "
+                "bundling %d tics", NET_AddrToString(client->addr),
+                client->rtt, backlog, client->bundle);
+    }
+}
 
-        cmd.playeringame[i] = true;
+// Send the tics queued for a client, once there are enough to fill a
+// bundle, or the first has been held back for as long as a bundle
+// takes to fill.
 
-        recvobj = &recvwindow[recv_index][i];
+static void NET_SV_SendBundle(net_client_t *client)
+{
+    unsigned int nowtime;
+    int starttic, endtic;
+    int i;
 
-        cmd.cmds[i] = recvobj->diff;
+    NET_SV_AdaptBundle(client);
 
-        if (recvobj->latency > cmd.latency)
-            cmd.latency = recvobj->latency;
+    if (client->unsent <= 0)
+    {
+        return;
     }
 
-    //printf("SV: %i: latency %i\n", client->player_number, cmd.latency);
-
-    // Add into the queue
-
-    client->sendqueue[client->sendseq % BACKUPTICS] = cmd;
+    nowtime = I_GetTimeMS();
 
-    // Transmit the new tic to the client
+    if (client->unsent < client->bundle
+     && nowtime - client->unsent_time
+          < (unsigned int) (client->bundle * 1000 / TICRATE))
+    {
+        return;
+    }
 
-    starttic = client->sendseq - sv_settings.extratics;
-    endtic = client->sendseq;
+    starttic = client->sendseq - client->unsent - sv->settings.extratics;
+    endtic = client->sendseq - 1;
 
-    if (starttic < 0)
-        starttic = 0;
+    if (starttic < (int) client->join_tic)
+        starttic = client->join_tic;
 
     NET_Log("server: send tics %d-%d to %s", starttic, endtic,
             NET_AddrToString(client->addr));
     NET_SV_SendTics(client, starttic, endtic);
 
-    ++client->sendseq;
+    for (i = client->sendseq - client->unsent; i < client->sendseq; ++i)
+    {
+        client->send_time[i % BACKUPTICS] = nowtime;
+    }
+
+    NET_Metrics_PlayerBundle(client->player_number, client->bundle);
+
+    client->unsent = 0;
 }
 
 // Prevent against deadlock: resend requests are usually only
@@ -1696,9 +3163,10 @@ void NET_SV_CheckDeadlock(net_client_t *client)
     int nowtime;
     int i;
 
-    // Don't expect game data from clients.
+    // Don't expect game data from clients, or from players still
+    // joining the game.
 
-    if (client->drone)
+    if (client->drone || client->joining || client->loading)
     {
         return;
     }
@@ -1718,16 +3186,17 @@ void NET_SV_CheckDeadlock(net_client_t *client)
 
         for (i=0; i<BACKUPTICS; ++i)
         {
-            if (!recvwindow[client->player_number][i].active)
+            if (!sv->recvwindow[client->player_number][i].active)
             {
                 NET_Log("server: deadlock: sending resend request for %d-%d",
-                        recvwindow_start + i, recvwindow_start + i + 5);
+                        sv->recvwindow_start + i,
+                        sv->recvwindow_start + i + 5);
 
                 // Found a tic we haven't received.  Send a resend request.
 
                 NET_SV_SendResendRequest(client,
-                                         recvwindow_start + i,
-                                         recvwindow_start + i + 5);
+                                         sv->recvwindow_start + i,
+                                         sv->recvwindow_start + i + 5);
 
                 client->last_gamedata_time = nowtime;
                 break;
@@ -1748,6 +3217,212 @@ void NET_SV_CheckDeadlock(net_client_t *client)
     }
 }
 
+// Start getting a client into the game in progress.  It is given a
+// player slot from the tic after the latest one anybody has been sent,
+// and one of the players is asked for a snapshot of their game as it
+// is at the start of that tic.  Until the new player has loaded it and
+// sent their first ticcmd, the game waits for them.
+
+static void NET_SV_StartJoin(net_client_t *client)
+{
+    net_gamesettings_t settings;
+    net_packet_t *packet;
+    net_client_t *donor;
+    unsigned int latest;
+    unsigned int join_tic;
+    int p;
+    int i;
+
+    sv->joiner = client;
+    sv->join_start_time = I_GetTimeMS();
+
+    // Everyone has to play the new player's first tic from the snapshot,
+    // so everyone needs a client that can.
+
+    for (i = 0; i < MAXNETNODES; ++i)
+    {
+        if (ClientConnected(&sv->clients[i])
+         && sv->clients[i].connection.protocol < NET_PROTOCOL_SNAPSHOT_0)
+        {
+            NET_SV_AbortJoin("another player's client does not support "
+                             "joining games in progress");
+            return;
+        }
+    }
+
+    p = NET_SV_FreeSlot();
+
+    if (p < 0)
+    {
+        NET_SV_AbortJoin("the game is full");
+        return;
+    }
+
+    donor = NULL;
+
+    for (i = 0; i < NET_MAXPLAYERS; ++i)
+    {
+        if (sv->players[i] != NULL && ClientConnected(sv->players[i])
+         && !sv->players[i]->loading)
+        {
+            donor = sv->players[i];
+            break;
+        }
+    }
+
+    if (donor == NULL)
+    {
+        NET_SV_AbortJoin("there is nobody in the game to send it");
+        return;
+    }
+
+    latest = 0;
+
+    for (i = 0; i < MAXNETNODES; ++i)
+    {
+        if (ClientConnected(&sv->clients[i])
+         && !WaitingToJoin(&sv->clients[i])
+         && (unsigned int) sv->clients[i].sendseq > latest)
+        {
+            latest = sv->clients[i].sendseq;
+        }
+    }
+
+    // The new player is not in the game for the tic before the one
+    // they join at, so everyone sees whoever had the slot before them
+    // leave the game first.
+
+    join_tic = latest + 1;
+
+    for (i = 0; i < BACKUPTICS; ++i)
+    {
+        if (sv->recvwindow_start + i >= latest)
+        {
+            memset(&sv->recvwindow[i][p], 0, sizeof(net_client_recv_t));
+        }
+        else
+        {
+            sv->recvwindow[i][p].resend_time = 0;
+        }
+    }
+
+    sv->players[p] = client;
+    client->player_number = p;
+    client->join_tic = join_tic;
+    client->sendseq = join_tic;
+    client->acknowledged = join_tic;
+    client->loading = true;
+    client->last_gamedata_time = sv->join_start_time;
+
+    memset(&sv->sent_cmd[p], 0, sizeof(ticcmd_t));
+    memset(&sv->late_diff[p], 0, sizeof(net_ticdiff_t));
+    NET_Metrics_ResetPlayer(p, client->name);
+
+    sv->settings.player_classes[p] = client->player_class;
+
+    settings = sv->settings;
+    settings.consoleplayer = p;
+
+    if (settings.num_players < p + 1)
+    {
+        settings.num_players = p + 1;
+    }
+
+    packet = NET_Conn_NewReliable(&client->connection,
+                                  NET_PACKET_TYPE_GAMEJOIN);
+    NET_WriteInt32(packet, join_tic);
+    NET_WriteSettings(packet, &settings);
+
+    packet = NET_Conn_NewReliable(&donor->connection,
+                                  NET_PACKET_TYPE_SNAPSHOT_REQUEST);
+    NET_WriteInt32(packet, join_tic);
+
+    NET_Snapshot_FreeRecv(&sv->snapshot_in);
+    NET_Snapshot_FreeSend(&sv->snapshot_out);
+    sv->donor = donor;
+
+    NET_Log("server: '%s' joining as player %d at tic %d, snapshot "
+            "from '%s'", client->name, p, join_tic, donor->name);
+}
+
+// Get players who connected to a game in progress into it, one at a
+// time.
+
+static void NET_SV_RunLateJoin(void)
+{
+    net_snapshot_recv_t *snapshot_in = &sv->snapshot_in;
+    int i;
+
+    if (sv->joiner == NULL)
+    {
+        for (i = 0; i < MAXNETNODES; ++i)
+        {
+            if (ClientConnected(&sv->clients[i])
+             && WaitingToJoin(&sv->clients[i]))
+            {
+                NET_SV_StartJoin(&sv->clients[i]);
+                break;
+            }
+        }
+
+        return;
+    }
+
+    if (!ClientConnected(sv->joiner))
+    {
+        NET_SV_AbortJoin("disconnected");
+        return;
+    }
+
+    if (I_GetTimeMS() - sv->join_start_time > LATEJOIN_TIMEOUT)
+    {
+        NET_SV_AbortJoin("timed out waiting for the game to be sent");
+        return;
+    }
+
+    // Still waiting for the snapshot?
+
+    if (!sv->snapshot_out.active)
+    {
+        if (!ClientConnected(sv->donor))
+        {
+            NET_SV_AbortJoin("the player sending the game left");
+            return;
+        }
+
+        if (!NET_Snapshot_Complete(snapshot_in)
+         || snapshot_in->tic != sv->joiner->join_tic)
+        {
+            return;
+        }
+
+        if (snapshot_in->len == 0)
+        {
+            NET_SV_AbortJoin("the game can't be joined at the moment; "
+                             "try again shortly");
+            return;
+        }
+
+        // Pass it on as it is.  What was received is kept, so that the
+        // donor is still acknowledged if it sends it again.
+
+        NET_Snapshot_StartSend(&sv->snapshot_out, snapshot_in->tic,
+                               snapshot_in->data, snapshot_in->len,
+                               snapshot_in->raw_len);
+        snapshot_in->data = NULL;
+    }
+
+    NET_Snapshot_RunSend(&sv->snapshot_out, &sv->joiner->connection);
+
+    if (NET_Snapshot_SendDone(&sv->snapshot_out))
+    {
+        NET_Snapshot_FreeSend(&sv->snapshot_out);
+        sv->joiner->joining = false;
+        NET_SV_BroadcastMessage("'%s' joined the game", sv->joiner->name);
+        sv->joiner = NULL;
+    }
+}
+
 // Called when all players have disconnected.  Return to listening for 
 // players to start a new game, and disconnect any drones still connected.
 
@@ -1755,14 +3430,19 @@ static void NET_SV_GameEnded(void)
 {
     int i;
 
-    server_state = SERVER_WAITING_LAUNCH;
-    sv_gamemode = indetermined;
+    sv->state = SERVER_WAITING_LAUNCH;
+    sv->gamemode = indetermined;
+
+    sv->joiner = NULL;
+    sv->donor = NULL;
+    NET_Snapshot_FreeRecv(&sv->snapshot_in);
+    NET_Snapshot_FreeSend(&sv->snapshot_out);
 
     for (i=0; i<MAXNETNODES; ++i)
     {
-        if (clients[i].active)
+        if (sv->clients[i].active)
         {
-            NET_SV_DisconnectClient(&clients[i]);
+            NET_SV_DisconnectClient(&sv->clients[i]);
         }
     }
 }
@@ -1793,7 +3473,7 @@ static void NET_SV_RunClient(net_client_t *client)
         // If we were about to start a game, any player disconnecting
         // should cause an abort.
 
-        if (server_state == SERVER_WAITING_START && !client->drone)
+        if (sv->state == SERVER_WAITING_START && !client->drone)
         {
             NET_SV_BroadcastMessage("Game startup aborted because "
                                     "player '%s' disconnected.",
@@ -1823,7 +3503,7 @@ static void NET_SV_RunClient(net_client_t *client)
         return;
     }
 
-    if (server_state == SERVER_WAITING_LAUNCH)
+    if (sv->state == SERVER_WAITING_LAUNCH)
     {
         // Waiting for the game to start
 
@@ -1837,43 +3517,209 @@ static void NET_SV_RunClient(net_client_t *client)
         }
     }
 
-    if (server_state == SERVER_IN_GAME)
+    if (sv->state == SERVER_IN_GAME)
     {
         NET_SV_PumpSendQueue(client);
+        NET_SV_SendBundle(client);
         NET_SV_CheckDeadlock(client);
     }
 }
 
+// Choose the network module used to accept connections from remote
+// clients.
+
+net_module_t *NET_SV_TransportModule(void)
+{
+    // With -udp (see net_sdl.c), batch datagrams with recvmmsg and
+    // sendmmsg where we can.
+
+    if (M_ParmExists("-udp"))
+    {
+#ifdef HAVE_RECVMMSG
+        if (!M_ParmExists("-sdlnet"))
+        {
+            return &net_udp_module;
+        }
+#endif
+        return &net_sdl_module;
+    }
+
+#ifdef HAVE_SYS_EPOLL_H
+    //!
+    // @category net
+    //
+    // When running a server on Linux, use the portable SDL_net
+    // transport instead of the non-blocking epoll (TCP) or batched
+    // recvmmsg (UDP) transports.
+    //
+
+    if (!M_ParmExists("-sdlnet"))
+    {
+        return &net_epoll_module;
+    }
+#endif
+
+    return &net_sdl_module;
+}
+
 // Add a network module to the server context
 
 void NET_SV_AddModule(net_module_t *module)
 {
     module->InitServer();
-    NET_AddModule(server_context, module);
+    NET_AddModule(sv->context, module);
+}
+
+// Read the -straggler options.
+
+static void NET_SV_InitStragglers(void)
+{
+    int p;
+
+    //!
+    // @category net
+    // @arg <ms>
+    //
+    // When running a server, do not let a slow player hold up the
+    // game.  If their ticcmd for a tic has not arrived this many
+    // milliseconds after another player needed it, one is made up
+    // for them by repeating their last.  Only players whose client
+    // supports this can be treated this way.
+    //
+
+    p = M_CheckParmWithArgs("-straggler", 1);
+
+    if (p > 0)
+    {
+        straggler_deadline = atoi(myargv[p + 1]);
+    }
+
+    //!
+    // @category net
+    //
+    // With -straggler, make up ticcmds that stand still and press
+    // nothing, rather than repeating the player's last ticcmd.
+    //
+
+    straggler_null = M_ParmExists("-stragglernull");
+
+    //!
+    // @category net
+    //
+    // With -straggler, when a player's ticcmd arrives after one was
+    // made up for them, carry whatever it changed over to their next
+    // ticcmd, rather than dropping it.
+    //
+
+    straggler_accept_late = M_ParmExists("-straggleraccept");
 }
 
 // Initialize server and wait for connections
 
 void NET_SV_Init(void)
 {
-    int i;
+    int i, j;
+
+    sv = calloc(1, sizeof(*sv));
+
+    if (sv == NULL)
+    {
+        I_Error("NET_SV_Init: Failed to allocate server state");
+    }
 
     // initialize send/receive context
 
-    server_context = NET_NewContext();
+    sv->context = NET_NewContext();
 
     // no clients yet
    
     for (i=0; i<MAXNETNODES; ++i) 
     {
-        clients[i].active = false;
+        sv->clients[i].active = false;
     }
 
     NET_SV_AssignPlayers();
 
-    server_state = SERVER_WAITING_LAUNCH;
-    sv_gamemode = indetermined;
+    sv->state = SERVER_WAITING_LAUNCH;
+    sv->gamemode = indetermined;
     server_initialized = true;
+
+    NET_SV_InitStragglers();
+
+    //!
+    // @category net
+    //
+    // When running a server, let players join a game that has already
+    // started, or rejoin one they dropped out of.  The new player is
+    // sent a snapshot of the game, taken by one of the other players.
+    // The game pauses while it is sent.  Only works with Doom, and only
+    // if every player's client supports it.  In a cooperative game,
+    // players can only join in the slots the game started with.
+    //
+
+    latejoin = M_ParmExists("-latejoin");
+
+    //!
+    // @category net
+    // @arg <n>
+    //
+    // When running a server, send at most n new tics in each packet to
+    // a client.  Clients on slow links are sent several tics at a time,
+    // to save bandwidth; fast links are always sent one.  The default
+    // is 4; 1 turns bundling off.
+    //
+
+    i = M_CheckParmWithArgs("-maxbundle", 1);
+
+    if (i > 0)
+    {
+        max_bundle = atoi(myargv[i + 1]);
+
+        if (max_bundle < 1)
+        {
+            max_bundle = 1;
+        }
+    }
+
+    //!
+    // @category net
+    // @arg <name>
+    //
+    // When starting a network server, specify a name for the server.
+    //
+
+    i = M_CheckParmWithArgs("-servername", 1);
+
+    if (i > 0)
+    {
+        server_description = myargv[i + 1];
+    }
+
+    query_total_limit.tokens = QUERY_TOTAL_BURST;
+    query_total_limit.last_time = I_GetTimeMS();
+
+    NET_Metrics_Init();
+    NET_EventLog_Init();
+
+    //!
+    // @category net
+    //
+    // When starting a server, write a generated 32-player game with
+    // both the old and the bit-packed tic data, and print how many
+    // bytes per tic each takes.
+    //
+
+    if (M_ParmExists("-ticcmdbench"))
+    {
+        for (i = 0; i < arrlen(ticbench_scenarios); ++i)
+        {
+            for (j = 0; j < arrlen(ticbench_packet_tics); ++j)
+            {
+                NET_SV_TiccmdBench(&ticbench_scenarios[i],
+                                   ticbench_packet_tics[j]);
+            }
+        }
+    }
 }
 
 static void UpdateMasterServer(void)
@@ -1889,7 +3735,7 @@ static void UpdateMasterServer(void)
     {
         net_addr_t *new_addr;
 
-        new_addr = NET_Query_ResolveMaster(server_context);
+        new_addr = NET_Query_ResolveMaster(sv->context);
         NET_ReleaseAddress(master_server);
         master_server = new_addr;
 
@@ -1947,7 +3793,7 @@ void NET_SV_Run(void)
         return;
     }
 
-    while (NET_RecvPacket(server_context, &addr, &packet))
+    while (NET_RecvPacket(sv->context, &addr, &packet))
     {
         NET_SV_Packet(packet, addr);
         NET_FreePacket(packet);
@@ -1964,13 +3810,13 @@ void NET_SV_Run(void)
 
     for (i=0; i<MAXNETNODES; ++i)
     {
-        if (clients[i].active)
+        if (sv->clients[i].active)
         {
-            NET_SV_RunClient(&clients[i]);
+            NET_SV_RunClient(&sv->clients[i]);
         }
     }
 
-    switch (server_state)
+    switch (sv->state)
     {
         case SERVER_WAITING_LAUNCH:
             break;
@@ -1980,17 +3826,28 @@ void NET_SV_Run(void)
             break;
 
         case SERVER_IN_GAME:
+            if (latejoin)
+            {
+                NET_SV_RunLateJoin();
+            }
+
             NET_SV_AdvanceWindow();
 
             for (i = 0; i < NET_MAXPLAYERS; ++i)
             {
-                if (sv_players[i] != NULL && ClientConnected(sv_players[i]))
+                if (sv->players[i] != NULL && ClientConnected(sv->players[i]))
                 {
-                    NET_SV_CheckResends(sv_players[i]);
+                    NET_SV_CheckResends(sv->players[i]);
                 }
             }
             break;
     }
+
+    // Everything sent during this pass goes out together.
+
+    NET_FlushPackets(sv->context);
+
+    NET_Metrics_Run();
 }
 
 void NET_SV_Shutdown(void)
@@ -2010,9 +3867,9 @@ void NET_SV_Shutdown(void)
     
     for (i=0; i<MAXNETNODES; ++i)
     {
-        if (clients[i].active)
+        if (sv->clients[i].active)
         {
-            NET_SV_DisconnectClient(&clients[i]);
+            NET_SV_DisconnectClient(&sv->clients[i]);
         }
     }
 
@@ -2029,7 +3886,7 @@ void NET_SV_Shutdown(void)
 
         for (i=0; i<MAXNETNODES; ++i)
         {
-            if (clients[i].active)
+            if (sv->clients[i].active)
             {
                 running = true;
             }
@@ -16,7 +16,7 @@
 
 #ifndef NET_SERVER_H
 #define NET_SERVER_H
-extern char *sv_player_names[NET_MAXPLAYERS];
+extern INSTANCE char *sv_player_names[NET_MAXPLAYERS];
 
 // initialize server and wait for connections
 
@@ -31,6 +31,10 @@ void NET_SV_Run(void);
 
 void NET_SV_Shutdown(void);
 
+// Network module to use for remote clients
+
+net_module_t *NET_SV_TransportModule(void);
+
 // Add a network module to the context used by the server
 
 void NET_SV_AddModule(net_module_t *module);
@@ -0,0 +1,486 @@
+//
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//     Transfer of game state snapshots to players joining a game in
+//     progress: compression, and sending in acknowledged chunks.
+//
+//     A snapshot is far too big to go as a reliable packet: only one
+//     of those is in flight at a time.  Instead it is split into
+//     chunks that are sent a window at a time, and the receiver
+//     acknowledges how many it has received without a gap.
+//
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "i_system.h"
+#include "i_timer.h"
+
+#include "net_common.h"
+#include "net_defs.h"
+#include "net_packet.h"
+#include "net_snapshot.h"
+
+// Number of chunks sent ahead of the last acknowledged one.
+
+#define SNAPSHOT_WINDOW 32
+
+// If nothing is acknowledged for this long (in ms), send the
+// unacknowledged chunks again.
+
+#define SNAPSHOT_TIMEOUT 250
+
+// Largest snapshot we are prepared to receive.  A savegame of even a
+// large level is a few hundred kilobytes.
+
+#define SNAPSHOT_MAX_SIZE (16 * 1024 * 1024)
+
+// Compression is a simple LZ77: the output is a series of literal
+// runs, each followed by a copy from earlier in the output, except for
+// the last.  Lengths and offsets are written as variable length
+// integers, seven bits to the byte.  Savegames are mostly small
+// integers padded out to 32 bits, so even this does well on them.
+
+#define MIN_MATCH 4
+#define MAX_OFFSET 65535
+#define HASH_BITS 14
+
+static void WriteVarInt(byte **p, size_t value)
+{
+    while (value >= 0x80)
+    {
+        *(*p)++ = (value & 0x7f) | 0x80;
+        value >>= 7;
+    }
+
+    *(*p)++ = value;
+}
+
+static boolean ReadVarInt(const byte **p, const byte *end, size_t *value)
+{
+    unsigned int shift;
+    byte b;
+
+    *value = 0;
+
+    for (shift = 0; shift < 32; shift += 7)
+    {
+        if (*p >= end)
+        {
+            return false;
+        }
+
+        b = *(*p)++;
+        *value |= (size_t) (b & 0x7f) << shift;
+
+        if ((b & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static unsigned int Hash(const byte *p)
+{
+    uint32_t value;
+
+    value = p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+
+    return (value * 2654435761U) >> (32 - HASH_BITS);
+}
+
+// Compress a block of data.  The result is allocated with malloc.
+
+byte *NET_Snapshot_Compress(const byte *data, size_t len, size_t *out_len)
+{
+    size_t *table;
+    byte *result, *p;
+    size_t pos, lit_start, match, match_len;
+    size_t i;
+    unsigned int h;
+
+    // A match of four bytes or more is written in at most five (the
+    // offset fits in three), so this leaves plenty of room.
+
+    result = malloc(len + len / 2 + 16);
+    table = calloc(1 << HASH_BITS, sizeof(*table));
+
+    if (result == NULL || table == NULL)
+    {
+        I_Error("NET_Snapshot_Compress: Failed to allocate %d bytes",
+                (int) len);
+    }
+
+    p = result;
+    pos = 0;
+    lit_start = 0;
+
+    while (pos + MIN_MATCH <= len)
+    {
+        // Table entries are positions plus one, so that zero is empty.
+
+        h = Hash(data + pos);
+        match = table[h];
+        table[h] = pos + 1;
+
+        if (match == 0 || pos - (match - 1) > MAX_OFFSET
+         || memcmp(data + match - 1, data + pos, MIN_MATCH) != 0)
+        {
+            ++pos;
+            continue;
+        }
+
+        --match;
+        match_len = MIN_MATCH;
+
+        while (pos + match_len < len
+            && data[match + match_len] == data[pos + match_len])
+        {
+            ++match_len;
+        }
+
+        WriteVarInt(&p, pos - lit_start);
+        memcpy(p, data + lit_start, pos - lit_start);
+        p += pos - lit_start;
+        WriteVarInt(&p, match_len - MIN_MATCH);
+        WriteVarInt(&p, pos - match);
+
+        for (i = pos + 1; i < pos + match_len && i + MIN_MATCH <= len; ++i)
+        {
+            table[Hash(data + i)] = i + 1;
+        }
+
+        pos += match_len;
+        lit_start = pos;
+    }
+
+    WriteVarInt(&p, len - lit_start);
+    memcpy(p, data + lit_start, len - lit_start);
+    p += len - lit_start;
+
+    free(table);
+
+    *out_len = p - result;
+
+    return result;
+}
+
+// Decompress data from NET_Snapshot_Compress into a buffer of exactly
+// the original size.  Returns false if the data is malformed.
+
+boolean NET_Snapshot_Decompress(const byte *data, size_t len,
+                                byte *out, size_t out_len)
+{
+    const byte *end = data + len;
+    size_t pos, run, offset;
+
+    pos = 0;
+
+    while (pos < out_len || data < end)
+    {
+        if (!ReadVarInt(&data, end, &run)
+         || run > out_len - pos || run > (size_t) (end - data))
+        {
+            return false;
+        }
+
+        memcpy(out + pos, data, run);
+        data += run;
+        pos += run;
+
+        if (data == end)
+        {
+            break;
+        }
+
+        if (!ReadVarInt(&data, end, &run)
+         || !ReadVarInt(&data, end, &offset))
+        {
+            return false;
+        }
+
+        run += MIN_MATCH;
+
+        if (offset == 0 || offset > pos || run > out_len - pos)
+        {
+            return false;
+        }
+
+        // The copy can overlap itself, so it is done a byte at a time.
+
+        for (; run > 0; --run, ++pos)
+        {
+            out[pos] = out[pos - offset];
+        }
+    }
+
+    return pos == out_len;
+}
+
+//
+// Sending
+//
+
+// Start sending a snapshot, which takes ownership of the data (which
+// must have been allocated with malloc).  A snapshot with no data
+// tells the receiver that none could be made.
+
+void NET_Snapshot_StartSend(net_snapshot_send_t *send, unsigned int tic,
+                            byte *data, size_t len, size_t raw_len)
+{
+    NET_Snapshot_FreeSend(send);
+
+    send->active = true;
+    send->tic = tic;
+    send->data = data;
+    send->len = len;
+    send->raw_len = raw_len;
+    send->num_chunks = (len + NET_SNAPSHOT_CHUNK - 1) / NET_SNAPSHOT_CHUNK;
+    send->acked = 0;
+    send->next = 0;
+    send->ack_time = I_GetTimeMS();
+
+    if (send->num_chunks == 0)
+    {
+        send->num_chunks = 1;
+    }
+
+    NET_Log("snapshot: sending %d bytes for tic %d (%d before "
+            "compression) in %d chunks", (int) len, tic, (int) raw_len,
+            send->num_chunks);
+}
+
+static void SendChunk(net_snapshot_send_t *send, net_connection_t *conn,
+                      unsigned int chunk)
+{
+    net_packet_t *packet;
+    size_t start, chunk_len;
+
+    start = (size_t) chunk * NET_SNAPSHOT_CHUNK;
+    chunk_len = send->len - start;
+
+    if (chunk_len > NET_SNAPSHOT_CHUNK)
+    {
+        chunk_len = NET_SNAPSHOT_CHUNK;
+    }
+
+    packet = NET_NewPacket(NET_SNAPSHOT_CHUNK + 20);
+    NET_WriteInt16(packet, NET_PACKET_TYPE_SNAPSHOT_DATA);
+    NET_WriteInt32(packet, send->tic);
+    NET_WriteInt32(packet, send->raw_len);
+    NET_WriteInt32(packet, send->len);
+    NET_WriteInt32(packet, chunk);
+    NET_WriteBlob(packet, send->data + start, chunk_len);
+    NET_Conn_SendPacket(conn, packet);
+    NET_FreePacket(packet);
+}
+
+// Send any chunks that are due.
+
+void NET_Snapshot_RunSend(net_snapshot_send_t *send, net_connection_t *conn)
+{
+    unsigned int nowtime;
+
+    if (!send->active || NET_Snapshot_SendDone(send))
+    {
+        return;
+    }
+
+    nowtime = I_GetTimeMS();
+
+    if (nowtime - send->ack_time > SNAPSHOT_TIMEOUT)
+    {
+        NET_Log("snapshot: no acknowledgement, resending from chunk %d",
+                send->acked);
+        send->next = send->acked;
+        send->ack_time = nowtime;
+    }
+
+    while (send->next < send->num_chunks
+        && send->next < send->acked + SNAPSHOT_WINDOW)
+    {
+        SendChunk(send, conn, send->next);
+        ++send->next;
+    }
+}
+
+void NET_Snapshot_ParseAck(net_snapshot_send_t *send, net_packet_t *packet)
+{
+    unsigned int tic, count;
+
+    if (!NET_ReadInt32(packet, &tic)
+     || !NET_ReadInt32(packet, &count))
+    {
+        return;
+    }
+
+    if (!send->active || tic != send->tic
+     || count <= send->acked || count > send->num_chunks)
+    {
+        return;
+    }
+
+    send->acked = count;
+    send->ack_time = I_GetTimeMS();
+
+    if (send->next < send->acked)
+    {
+        send->next = send->acked;
+    }
+}
+
+boolean NET_Snapshot_SendDone(net_snapshot_send_t *send)
+{
+    return send->active && send->acked >= send->num_chunks;
+}
+
+void NET_Snapshot_FreeSend(net_snapshot_send_t *send)
+{
+    free(send->data);
+    memset(send, 0, sizeof(*send));
+}
+
+//
+// Receiving
+//
+
+static void SendAck(net_snapshot_recv_t *recv, net_connection_t *conn)
+{
+    net_packet_t *packet;
+
+    packet = NET_NewPacket(12);
+    NET_WriteInt16(packet, NET_PACKET_TYPE_SNAPSHOT_ACK);
+    NET_WriteInt32(packet, recv->tic);
+    NET_WriteInt32(packet, recv->contiguous);
+    NET_Conn_SendPacket(conn, packet);
+    NET_FreePacket(packet);
+}
+
+// Start receiving a new snapshot.
+
+static boolean StartRecv(net_snapshot_recv_t *recv, unsigned int tic,
+                         size_t raw_len, size_t len)
+{
+    NET_Snapshot_FreeRecv(recv);
+
+    if (raw_len > SNAPSHOT_MAX_SIZE || len > raw_len + raw_len / 2 + 16)
+    {
+        NET_Log("snapshot: error: bad size %d (%d before compression)",
+                (int) len, (int) raw_len);
+        return false;
+    }
+
+    recv->tic = tic;
+    recv->len = len;
+    recv->raw_len = raw_len;
+    recv->num_chunks = (len + NET_SNAPSHOT_CHUNK - 1) / NET_SNAPSHOT_CHUNK;
+
+    if (recv->num_chunks == 0)
+    {
+        recv->num_chunks = 1;
+    }
+
+    recv->data = malloc(len + 1);
+    recv->received = calloc(recv->num_chunks, 1);
+
+    if (recv->data == NULL || recv->received == NULL)
+    {
+        NET_Snapshot_FreeRecv(recv);
+        return false;
+    }
+
+    recv->active = true;
+
+    return true;
+}
+
+// Parse a SNAPSHOT_DATA packet, and acknowledge it.  A chunk of a
+// snapshot for a different tic replaces the one being received.
+
+boolean NET_Snapshot_ParseData(net_snapshot_recv_t *recv,
+                               net_packet_t *packet,
+                               net_connection_t *conn)
+{
+    unsigned int tic, raw_len, len, chunk;
+    size_t start, chunk_len;
+
+    if (!NET_ReadInt32(packet, &tic)
+     || !NET_ReadInt32(packet, &raw_len)
+     || !NET_ReadInt32(packet, &len)
+     || !NET_ReadInt32(packet, &chunk))
+    {
+        return false;
+    }
+
+    if (!recv->active || recv->tic != tic
+     || recv->raw_len != raw_len || recv->len != len)
+    {
+        if (!StartRecv(recv, tic, raw_len, len))
+        {
+            return false;
+        }
+    }
+
+    if (chunk >= recv->num_chunks)
+    {
+        return false;
+    }
+
+    start = (size_t) chunk * NET_SNAPSHOT_CHUNK;
+    chunk_len = recv->len - start;
+
+    if (chunk_len > NET_SNAPSHOT_CHUNK)
+    {
+        chunk_len = NET_SNAPSHOT_CHUNK;
+    }
+
+    if (packet->len - packet->pos != chunk_len)
+    {
+        return false;
+    }
+
+    if (!recv->received[chunk])
+    {
+        memcpy(recv->data + start, packet->data + packet->pos, chunk_len);
+        recv->received[chunk] = 1;
+
+        while (recv->contiguous < recv->num_chunks
+            && recv->received[recv->contiguous])
+        {
+            ++recv->contiguous;
+        }
+    }
+
+    // Duplicates are acknowledged too, in case the last acknowledgement
+    // was lost.
+
+    SendAck(recv, conn);
+
+    return true;
+}
+
+boolean NET_Snapshot_Complete(net_snapshot_recv_t *recv)
+{
+    return recv->active && recv->contiguous >= recv->num_chunks;
+}
+
+void NET_Snapshot_FreeRecv(net_snapshot_recv_t *recv)
+{
+    free(recv->data);
+    free(recv->received);
+    memset(recv, 0, sizeof(*recv));
+}
+
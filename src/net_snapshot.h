@@ -0,0 +1,85 @@
+//
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//     Transfer of game state snapshots to players joining a game in
+//     progress: compression, and sending in acknowledged chunks.
+//
+
+#ifndef NET_SNAPSHOT_H
+#define NET_SNAPSHOT_H
+
+#include "net_common.h"
+
+// Bytes of compressed data carried by each SNAPSHOT_DATA packet.
+
+#define NET_SNAPSHOT_CHUNK 1024
+
+// A snapshot being sent.  Chunks are sent a window at a time; if no
+// acknowledgement arrives for a while, sending starts again from the
+// first chunk that has not been acknowledged.
+
+typedef struct
+{
+    boolean active;
+    unsigned int tic;
+
+    // Compressed data, and the length it decompresses to.  A snapshot
+    // with no data tells the receiver that none could be made.
+
+    byte *data;
+    size_t len;
+    size_t raw_len;
+
+    unsigned int num_chunks;
+    unsigned int acked;
+    unsigned int next;
+    unsigned int ack_time;
+} net_snapshot_send_t;
+
+// A snapshot being received.
+
+typedef struct
+{
+    boolean active;
+    unsigned int tic;
+
+    byte *data;
+    size_t len;
+    size_t raw_len;
+
+    unsigned int num_chunks;
+    unsigned int contiguous;
+    byte *received;
+} net_snapshot_recv_t;
+
+byte *NET_Snapshot_Compress(const byte *data, size_t len, size_t *out_len);
+boolean NET_Snapshot_Decompress(const byte *data, size_t len,
+                                byte *out, size_t out_len);
+
+void NET_Snapshot_StartSend(net_snapshot_send_t *send, unsigned int tic,
+                            byte *data, size_t len, size_t raw_len);
+void NET_Snapshot_RunSend(net_snapshot_send_t *send,
+                          net_connection_t *conn);
+void NET_Snapshot_ParseAck(net_snapshot_send_t *send, net_packet_t *packet);
+boolean NET_Snapshot_SendDone(net_snapshot_send_t *send);
+void NET_Snapshot_FreeSend(net_snapshot_send_t *send);
+
+boolean NET_Snapshot_ParseData(net_snapshot_recv_t *recv,
+                               net_packet_t *packet,
+                               net_connection_t *conn);
+boolean NET_Snapshot_Complete(net_snapshot_recv_t *recv);
+void NET_Snapshot_FreeRecv(net_snapshot_recv_t *recv);
+
+#endif /* #ifndef NET_SNAPSHOT_H */
+
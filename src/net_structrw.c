@@ -32,6 +32,10 @@ static struct
     const char *name;
 } protocol_names[] = {
     {NET_PROTOCOL_CHOCOLATE_DOOM_0, "CHOCOLATE_DOOM_0"},
+    {NET_PROTOCOL_PACKED_TICCMDS_0, "DC27_PACKED_TICCMDS_0"},
+    {NET_PROTOCOL_SACK_0, "DC27_SACK_0"},
+    {NET_PROTOCOL_SUBSTITUTE_0, "DC27_SUBSTITUTE_0"},
+    {NET_PROTOCOL_SNAPSHOT_0, "DC27_SNAPSHOT_0"},
 };
 
 void NET_WriteConnectData(net_packet_t *packet, net_connect_data_t *data)
@@ -394,6 +398,307 @@ void NET_WriteFullTiccmd(net_packet_t *packet, net_full_ticcmd_t *cmd, boolean l
     }
 }
 
+//
+// Bit-packed ticcmds (NET_PROTOCOL_PACKED_TICCMDS_0)
+//
+// The diff header is 6 bits, movement and turning are zigzag encoded
+// with variable length codes, and in a full ticcmd, runs of players
+// whose commands have not changed are stored as a single count.
+//
+
+void NET_WritePackedTiccmdDiff(net_bitstream_t *stream, net_ticdiff_t *diff,
+                               boolean lowres_turn)
+{
+    NET_WriteBits(stream, diff->diff, PACKED_DIFF_BITS);
+
+    if (diff->diff & NET_TICDIFF_FORWARD)
+        NET_WriteVarSInt(stream, diff->cmd.forwardmove, PACKED_MOVE_K);
+    if (diff->diff & NET_TICDIFF_SIDE)
+        NET_WriteVarSInt(stream, diff->cmd.sidemove, PACKED_MOVE_K);
+    if (diff->diff & NET_TICDIFF_TURN)
+    {
+        if (lowres_turn)
+        {
+            NET_WriteVarSInt(stream, diff->cmd.angleturn / 256,
+                             PACKED_LOWRES_TURN_K);
+        }
+        else
+        {
+            NET_WriteVarSInt(stream, diff->cmd.angleturn, PACKED_TURN_K);
+        }
+    }
+    if (diff->diff & NET_TICDIFF_BUTTONS)
+        NET_WriteBits(stream, diff->cmd.buttons, 8);
+    if (diff->diff & NET_TICDIFF_CONSISTANCY)
+        NET_WriteBits(stream, diff->cmd.consistancy, 8);
+    if (diff->diff & NET_TICDIFF_CHATCHAR)
+        NET_WriteBits(stream, diff->cmd.chatchar, 8);
+}
+
+// Read a signed value and check that it is within range.
+
+static boolean ReadPackedSInt(net_bitstream_t *stream, signed int *value,
+                              int k, signed int min, signed int max)
+{
+    return NET_ReadVarSInt(stream, value, k)
+        && *value >= min && *value <= max;
+}
+
+boolean NET_ReadPackedTiccmdDiff(net_bitstream_t *stream, net_ticdiff_t *diff,
+                                 boolean lowres_turn)
+{
+    unsigned int val;
+    signed int sval;
+
+    if (!NET_ReadBits(stream, &diff->diff, PACKED_DIFF_BITS))
+        return false;
+
+    if (diff->diff & NET_TICDIFF_FORWARD)
+    {
+        if (!ReadPackedSInt(stream, &sval, PACKED_MOVE_K, -128, 127))
+            return false;
+        diff->cmd.forwardmove = sval;
+    }
+
+    if (diff->diff & NET_TICDIFF_SIDE)
+    {
+        if (!ReadPackedSInt(stream, &sval, PACKED_MOVE_K, -128, 127))
+            return false;
+        diff->cmd.sidemove = sval;
+    }
+
+    if (diff->diff & NET_TICDIFF_TURN)
+    {
+        if (lowres_turn)
+        {
+            if (!ReadPackedSInt(stream, &sval, PACKED_LOWRES_TURN_K,
+                                -128, 127))
+                return false;
+            diff->cmd.angleturn = sval * 256;
+        }
+        else
+        {
+            if (!ReadPackedSInt(stream, &sval, PACKED_TURN_K,
+                                -32768, 32767))
+                return false;
+            diff->cmd.angleturn = sval;
+        }
+    }
+
+    if (diff->diff & NET_TICDIFF_BUTTONS)
+    {
+        if (!NET_ReadBits(stream, &val, 8))
+            return false;
+        diff->cmd.buttons = val;
+    }
+
+    if (diff->diff & NET_TICDIFF_CONSISTANCY)
+    {
+        if (!NET_ReadBits(stream, &val, 8))
+            return false;
+        diff->cmd.consistancy = val;
+    }
+
+    if (diff->diff & NET_TICDIFF_CHATCHAR)
+    {
+        if (!NET_ReadBits(stream, &val, 8))
+            return false;
+        diff->cmd.chatchar = val;
+    }
+    else
+        diff->cmd.chatchar = 0;
+
+    return true;
+}
+
+static unsigned int PlayerBitfield(net_full_ticcmd_t *cmd)
+{
+    unsigned int bitfield = 0;
+    int i;
+
+    for (i=0; i<NET_MAXPLAYERS; ++i)
+    {
+        if (cmd->playeringame[i])
+        {
+            bitfield |= 1U << i;
+        }
+    }
+
+    return bitfield;
+}
+
+// Write the start of a full ticcmd: the latency and the players in
+// the game.  'prev' is the previous ticcmd written to the same packet,
+// or NULL for the first; both are usually the same and so only take a
+// bit each.
+
+void NET_WritePackedTiccmdHeader(net_bitstream_t *stream,
+                                 net_full_ticcmd_t *cmd,
+                                 net_full_ticcmd_t *prev)
+{
+    unsigned int bitfield;
+
+    if (prev != NULL && cmd->latency == prev->latency)
+    {
+        NET_WriteBits(stream, 1, 1);
+    }
+    else
+    {
+        NET_WriteBits(stream, 0, 1);
+        NET_WriteVarSInt(stream, cmd->latency, PACKED_LATENCY_K);
+    }
+
+    bitfield = PlayerBitfield(cmd);
+
+    if (prev != NULL && bitfield == PlayerBitfield(prev))
+    {
+        NET_WriteBits(stream, 1, 1);
+    }
+    else
+    {
+        NET_WriteBits(stream, 0, 1);
+        NET_WriteBits(stream, bitfield, NET_MAXPLAYERS);
+    }
+}
+
+// Write a full ticcmd: the header, then the commands that changed.
+
+void NET_WritePackedFullTiccmd(net_bitstream_t *stream,
+                               net_full_ticcmd_t *cmd,
+                               net_full_ticcmd_t *prev,
+                               boolean lowres_turn)
+{
+    unsigned int run;
+    int i;
+
+    NET_WritePackedTiccmdHeader(stream, cmd, prev);
+
+    // Each player whose command changed is preceded by the number of
+    // unchanged players before it.  A final count covers any unchanged
+    // players at the end.
+
+    run = 0;
+
+    for (i=0; i<NET_MAXPLAYERS; ++i)
+    {
+        if (!cmd->playeringame[i])
+        {
+            continue;
+        }
+
+        if (cmd->cmds[i].diff == 0)
+        {
+            ++run;
+            continue;
+        }
+
+        NET_WriteVarUInt(stream, run, PACKED_RUN_K);
+        NET_WritePackedTiccmdDiff(stream, &cmd->cmds[i], lowres_turn);
+        run = 0;
+    }
+
+    if (run > 0)
+    {
+        NET_WriteVarUInt(stream, run, PACKED_RUN_K);
+    }
+}
+
+boolean NET_ReadPackedFullTiccmd(net_bitstream_t *stream,
+                                 net_full_ticcmd_t *cmd,
+                                 net_full_ticcmd_t *prev,
+                                 boolean lowres_turn)
+{
+    unsigned int same, bitfield;
+    unsigned int run;
+    int players[NET_MAXPLAYERS];
+    unsigned int num_players, n;
+    int i;
+
+    if (!NET_ReadBits(stream, &same, 1))
+    {
+        return false;
+    }
+
+    if (same)
+    {
+        if (prev == NULL)
+        {
+            return false;
+        }
+
+        cmd->latency = prev->latency;
+    }
+    else if (!ReadPackedSInt(stream, &cmd->latency, PACKED_LATENCY_K,
+                             -32768, 32767))
+    {
+        return false;
+    }
+
+    if (!NET_ReadBits(stream, &same, 1))
+    {
+        return false;
+    }
+
+    if (same)
+    {
+        if (prev == NULL)
+        {
+            return false;
+        }
+
+        bitfield = PlayerBitfield(prev);
+    }
+    else if (!NET_ReadBits(stream, &bitfield, NET_MAXPLAYERS))
+    {
+        return false;
+    }
+
+    num_players = 0;
+
+    for (i=0; i<NET_MAXPLAYERS; ++i)
+    {
+        cmd->playeringame[i] = (bitfield & (1U << i)) != 0;
+
+        if (cmd->playeringame[i])
+        {
+            players[num_players] = i;
+            ++num_players;
+        }
+    }
+
+    // Mirror of the writer: a run of unchanged players, then (unless
+    // the run reached the end) one player whose command changed.
+
+    n = 0;
+
+    while (n < num_players)
+    {
+        if (!NET_ReadVarUInt(stream, &run, PACKED_RUN_K) || run > num_players - n)
+        {
+            return false;
+        }
+
+        for (; run > 0; --run)
+        {
+            cmd->cmds[players[n]].diff = 0;
+            ++n;
+        }
+
+        if (n < num_players)
+        {
+            if (!NET_ReadPackedTiccmdDiff(stream, &cmd->cmds[players[n]],
+                                          lowres_turn))
+            {
+                return false;
+            }
+
+            ++n;
+        }
+    }
+
+    return true;
+}
+
 void NET_WriteWaitData(net_packet_t *packet, net_waitdata_t *data)
 {
     int i;
@@ -475,14 +780,40 @@ static boolean NET_ReadBlob(net_packet_t *packet, uint8_t *buf, size_t len)
     return true;
 }
 
-static void NET_WriteBlob(net_packet_t *packet, uint8_t *buf, size_t len)
+// Selective acknowledgement, following the acknowledged tic in a
+// GAMEDATA_ACK packet (NET_PROTOCOL_SACK_0).  Bit i of the bitmap is set
+// if tic ack+i has been received.  Any of the first num_tics tics that
+// have not been received should be resent; num_tics is zero if the
+// packet is only an acknowledgement.
+
+void NET_WriteSACK(net_packet_t *packet, uint64_t received,
+                   unsigned int num_tics)
 {
-    int i;
+    NET_WriteInt32(packet, (unsigned int) (received & 0xffffffff));
+    NET_WriteInt32(packet, (unsigned int) (received >> 32));
+    NET_WriteInt8(packet, num_tics);
+}
 
-    for (i=0; i<len; ++i)
+boolean NET_ReadSACK(net_packet_t *packet, uint64_t *received,
+                     unsigned int *num_tics)
+{
+    unsigned int low, high;
+
+    if (!NET_ReadInt32(packet, &low)
+     || !NET_ReadInt32(packet, &high)
+     || !NET_ReadInt8(packet, num_tics))
+    {
+        return false;
+    }
+
+    *received = ((uint64_t) high << 32) | low;
+
+    if (*num_tics > NET_SACK_TICS)
     {
-        NET_WriteInt8(packet, buf[i]);
+        *num_tics = NET_SACK_TICS;
     }
+
+    return true;
 }
 
 boolean NET_ReadSHA1Sum(net_packet_t *packet, sha1_digest_t digest)
@@ -20,6 +20,18 @@
 #include "net_defs.h"
 #include "net_packet.h"
 
+// Parameters for the variable length codes of the bit-packed
+// protocol (see NET_WriteVarUInt).  Turning with the keyboard or mouse
+// produces larger values than movement, which only changes when a key
+// is pressed or released.
+
+#define PACKED_MOVE_K       4
+#define PACKED_TURN_K       6
+#define PACKED_LOWRES_TURN_K 2
+#define PACKED_LATENCY_K    4
+#define PACKED_RUN_K        0
+#define PACKED_DIFF_BITS    6
+
 void NET_WriteConnectData(net_packet_t *packet, net_connect_data_t *data);
 boolean NET_ReadConnectData(net_packet_t *packet, net_connect_data_t *data);
 
@@ -37,6 +49,27 @@ extern void NET_TiccmdPatch(ticcmd_t *src, net_ticdiff_t *diff, ticcmd_t *dest);
 boolean NET_ReadFullTiccmd(net_packet_t *packet, net_full_ticcmd_t *cmd, boolean lowres_turn);
 void NET_WriteFullTiccmd(net_packet_t *packet, net_full_ticcmd_t *cmd, boolean lowres_turn);
 
+void NET_WritePackedTiccmdDiff(net_bitstream_t *stream, net_ticdiff_t *diff,
+                               boolean lowres_turn);
+boolean NET_ReadPackedTiccmdDiff(net_bitstream_t *stream, net_ticdiff_t *diff,
+                                 boolean lowres_turn);
+void NET_WritePackedTiccmdHeader(net_bitstream_t *stream,
+                                 net_full_ticcmd_t *cmd,
+                                 net_full_ticcmd_t *prev);
+void NET_WritePackedFullTiccmd(net_bitstream_t *stream,
+                               net_full_ticcmd_t *cmd,
+                               net_full_ticcmd_t *prev,
+                               boolean lowres_turn);
+boolean NET_ReadPackedFullTiccmd(net_bitstream_t *stream,
+                                 net_full_ticcmd_t *cmd,
+                                 net_full_ticcmd_t *prev,
+                                 boolean lowres_turn);
+
+void NET_WriteSACK(net_packet_t *packet, uint64_t received,
+                   unsigned int num_tics);
+boolean NET_ReadSACK(net_packet_t *packet, uint64_t *received,
+                     unsigned int *num_tics);
+
 boolean NET_ReadSHA1Sum(net_packet_t *packet, sha1_digest_t digest);
 void NET_WriteSHA1Sum(net_packet_t *packet, sha1_digest_t digest);
 
@@ -0,0 +1,545 @@
+//
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//     Networking module for Linux servers, using a single non-blocking
+//     UDP socket.  This speaks the same protocol as the UDP mode of
+//     net_sdl.c (one packet per datagram), so clients connect with
+//     -udp as normal.
+//
+//     Received datagrams are read a batch at a time with recvmmsg().
+//     Outgoing packets are queued and only sent when the server calls
+//     Flush at the end of its run pass, so everything sent to every
+//     client in one pass goes out with one sendmmsg() call.
+//
+
+// For recvmmsg() and sendmmsg().
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include "config.h"
+
+#ifdef HAVE_RECVMMSG
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "doomtype.h"
+#include "i_system.h"
+#include "m_argv.h"
+#include "m_misc.h"
+#include "net_defs.h"
+#include "net_io.h"
+#include "net_packet.h"
+#include "net_proxy.h"
+#include "net_udp.h"
+#include "z_zone.h"
+
+#define DEFAULT_PORT 2342
+
+// Number of datagrams read by one recvmmsg() call, and the number that
+// can be queued to send before a Flush.  If the send queue fills up
+// before then, it is sent early.
+
+#define RECV_BATCH 32
+#define SEND_BATCH 128
+
+typedef struct
+{
+    net_addr_t net_addr;
+    struct sockaddr_in sockaddr;
+} udp_addr_t;
+
+static INSTANCE boolean initted = false;
+static INSTANCE int port = DEFAULT_PORT;
+static INSTANCE int udp_fd = -1;
+
+// Table of known addresses, as in net_sdl.c: open addressing with
+// linear probing, kept at most half full.
+
+static INSTANCE udp_addr_t **addr_table;
+static INSTANCE unsigned int addr_table_size = 0;
+static INSTANCE unsigned int addr_table_count = 0;
+
+// Receive batch.  recv_next is the next datagram to hand out, and
+// recv_count the number read by the last recvmmsg().
+
+static INSTANCE struct mmsghdr recv_msgs[RECV_BATCH];
+static INSTANCE struct iovec recv_iovs[RECV_BATCH];
+static INSTANCE struct sockaddr_in recv_addrs[RECV_BATCH];
+static INSTANCE byte recv_bufs[RECV_BATCH][MAX_PACKET_SIZE];
+static INSTANCE int recv_next, recv_count;
+
+// Send queue.
+
+static INSTANCE struct mmsghdr send_msgs[SEND_BATCH];
+static INSTANCE struct iovec send_iovs[SEND_BATCH];
+static INSTANCE struct sockaddr_in send_addrs[SEND_BATCH];
+static INSTANCE byte send_bufs[SEND_BATCH][MAX_PACKET_SIZE];
+static INSTANCE int send_count;
+
+static boolean AddressesEqual(struct sockaddr_in *a, struct sockaddr_in *b)
+{
+    return a->sin_addr.s_addr == b->sin_addr.s_addr
+        && a->sin_port == b->sin_port;
+}
+
+static unsigned int HashAddress(struct sockaddr_in *addr)
+{
+    uint32_t h;
+
+    h = addr->sin_addr.s_addr ^ ((uint32_t) addr->sin_port * 0x9e3779b1U);
+    h ^= h >> 16;
+    h *= 0x45d9f3bU;
+    h ^= h >> 16;
+
+    return h & (addr_table_size - 1);
+}
+
+static void InsertAddress(udp_addr_t *entry)
+{
+    unsigned int i;
+
+    i = HashAddress(&entry->sockaddr);
+
+    while (addr_table[i] != NULL)
+    {
+        i = (i + 1) & (addr_table_size - 1);
+    }
+
+    addr_table[i] = entry;
+}
+
+static void ResizeAddrTable(unsigned int new_size)
+{
+    udp_addr_t **old_table;
+    unsigned int old_size;
+    unsigned int i;
+
+    old_table = addr_table;
+    old_size = addr_table_size;
+
+    addr_table_size = new_size;
+    addr_table = Z_Malloc(sizeof(udp_addr_t *) * addr_table_size,
+                          PU_STATIC, 0);
+    memset(addr_table, 0, sizeof(udp_addr_t *) * addr_table_size);
+
+    for (i = 0; i < old_size; ++i)
+    {
+        if (old_table[i] != NULL)
+        {
+            InsertAddress(old_table[i]);
+        }
+    }
+
+    if (old_table != NULL)
+    {
+        Z_Free(old_table);
+    }
+}
+
+// Find an address in the table, adding it if it is not there.
+
+static net_addr_t *FindAddress(struct sockaddr_in *addr)
+{
+    udp_addr_t *new_entry;
+    unsigned int i;
+
+    if (addr_table_size == 0)
+    {
+        ResizeAddrTable(16);
+    }
+
+    for (i = HashAddress(addr); addr_table[i] != NULL;
+         i = (i + 1) & (addr_table_size - 1))
+    {
+        if (AddressesEqual(addr, &addr_table[i]->sockaddr))
+        {
+            return &addr_table[i]->net_addr;
+        }
+    }
+
+    if ((addr_table_count + 1) * 2 > addr_table_size)
+    {
+        ResizeAddrTable(addr_table_size * 2);
+    }
+
+    new_entry = Z_Malloc(sizeof(udp_addr_t), PU_STATIC, 0);
+
+    new_entry->sockaddr = *addr;
+    new_entry->net_addr.refcount = 0;
+    new_entry->net_addr.handle = &new_entry->sockaddr;
+    new_entry->net_addr.module = &net_udp_module;
+
+    InsertAddress(new_entry);
+    ++addr_table_count;
+
+    return &new_entry->net_addr;
+}
+
+static void NET_UDP_FreeAddress(net_addr_t *addr)
+{
+    udp_addr_t *entry = (udp_addr_t *) addr;
+    unsigned int i, j, home;
+
+    if (addr_table_size == 0)
+    {
+        I_Error("NET_UDP_FreeAddress: Attempted to remove an unused address!");
+    }
+
+    for (i = HashAddress(&entry->sockaddr); addr_table[i] != entry;
+         i = (i + 1) & (addr_table_size - 1))
+    {
+        if (addr_table[i] == NULL)
+        {
+            I_Error("NET_UDP_FreeAddress: Attempted to remove an unused address!");
+        }
+    }
+
+    addr_table[i] = NULL;
+    --addr_table_count;
+
+    for (j = (i + 1) & (addr_table_size - 1); addr_table[j] != NULL;
+         j = (j + 1) & (addr_table_size - 1))
+    {
+        home = HashAddress(&addr_table[j]->sockaddr);
+
+        if (((j - home) & (addr_table_size - 1))
+         >= ((j - i) & (addr_table_size - 1)))
+        {
+            addr_table[i] = addr_table[j];
+            addr_table[j] = NULL;
+            i = j;
+        }
+    }
+
+    Z_Free(entry);
+}
+
+// Read the next batch of datagrams.  Returns false if there were none.
+
+static boolean RecvBatch(void)
+{
+    int i, result;
+
+    for (i = 0; i < RECV_BATCH; ++i)
+    {
+        recv_msgs[i].msg_hdr.msg_namelen = sizeof(recv_addrs[i]);
+    }
+
+    do
+    {
+        result = recvmmsg(udp_fd, recv_msgs, RECV_BATCH, MSG_DONTWAIT, NULL);
+    } while (result < 0 && errno == EINTR);
+
+    if (result <= 0)
+    {
+        recv_next = recv_count = 0;
+        return false;
+    }
+
+    recv_next = 0;
+    recv_count = result;
+
+    return true;
+}
+
+// Send everything in the send queue.
+
+static void SendBatch(void)
+{
+    int sent, result;
+
+    sent = 0;
+
+    while (sent < send_count)
+    {
+        result = sendmmsg(udp_fd, send_msgs + sent, send_count - sent, 0);
+
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            // The socket buffer is full, or the datagram could not be
+            // sent.  Either way it is lost, which the protocol has to
+            // cope with anyway; skip it.
+
+            ++sent;
+            continue;
+        }
+
+        sent += result;
+    }
+
+    send_count = 0;
+}
+
+static boolean NET_UDP_InitClient(void)
+{
+    // This module only implements the server end.
+
+    return false;
+}
+
+static boolean NET_UDP_InitServer(void)
+{
+    struct sockaddr_in sa;
+    int bufsize;
+    int i, p;
+
+    if (initted)
+        return true;
+
+    // There is no connection to receive a PROXY header on.
+
+    if (NET_Proxy_Enabled())
+    {
+        I_Error("NET_UDP_InitServer: The PROXY protocol needs TCP.");
+    }
+
+    p = M_CheckParmWithArgs("-port", 1);
+    if (p > 0)
+        port = atoi(myargv[p+1]);
+
+    if (port == 0)
+    {
+        port = DEFAULT_PORT;
+    }
+
+    printf("binding to UDP port %d\n", port);
+
+    udp_fd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+    if (udp_fd < 0)
+    {
+        I_Error("NET_UDP_InitServer: Unable to create socket: %s",
+                strerror(errno));
+    }
+
+    // A whole pass worth of packets for every client is sent at once,
+    // so make sure the socket buffer can hold it.
+
+    bufsize = SEND_BATCH * MAX_PACKET_SIZE;
+    setsockopt(udp_fd, SOL_SOCKET, SO_SNDBUF, &bufsize, sizeof(bufsize));
+    setsockopt(udp_fd, SOL_SOCKET, SO_RCVBUF, &bufsize, sizeof(bufsize));
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_addr.s_addr = htonl(INADDR_ANY);
+    sa.sin_port = htons(port);
+
+    if (bind(udp_fd, (struct sockaddr *) &sa, sizeof(sa)) < 0)
+    {
+        I_Error("NET_UDP_InitServer: Unable to bind to port %i", port);
+    }
+
+    for (i = 0; i < RECV_BATCH; ++i)
+    {
+        recv_iovs[i].iov_base = recv_bufs[i];
+        recv_iovs[i].iov_len = MAX_PACKET_SIZE;
+        memset(&recv_msgs[i], 0, sizeof(recv_msgs[i]));
+        recv_msgs[i].msg_hdr.msg_name = &recv_addrs[i];
+        recv_msgs[i].msg_hdr.msg_iov = &recv_iovs[i];
+        recv_msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    for (i = 0; i < SEND_BATCH; ++i)
+    {
+        send_iovs[i].iov_base = send_bufs[i];
+        memset(&send_msgs[i], 0, sizeof(send_msgs[i]));
+        send_msgs[i].msg_hdr.msg_name = &send_addrs[i];
+        send_msgs[i].msg_hdr.msg_namelen = sizeof(send_addrs[i]);
+        send_msgs[i].msg_hdr.msg_iov = &send_iovs[i];
+        send_msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    recv_next = recv_count = 0;
+    send_count = 0;
+
+    initted = true;
+
+    return true;
+}
+
+static void NET_UDP_SendPacket(net_addr_t *addr, net_packet_t *packet)
+{
+    // Broadcasts are only used to find servers on the LAN, which is
+    // done by clients.
+
+    if (addr == &net_broadcast_addr)
+    {
+        return;
+    }
+
+    if (packet->len > MAX_PACKET_SIZE)
+    {
+        fprintf(stderr, "NET_UDP_SendPacket: %d byte packet too large\n",
+                (int) packet->len);
+        return;
+    }
+
+    if (send_count >= SEND_BATCH)
+    {
+        SendBatch();
+    }
+
+    memcpy(send_bufs[send_count], packet->data, packet->len);
+    send_iovs[send_count].iov_len = packet->len;
+    send_addrs[send_count] = *((struct sockaddr_in *) addr->handle);
+    ++send_count;
+}
+
+static boolean NET_UDP_RecvPacket(net_addr_t **addr, net_packet_t **packet)
+{
+    struct msghdr *hdr;
+    unsigned int len;
+
+    for (;;)
+    {
+        if (recv_next >= recv_count && !RecvBatch())
+        {
+            return false;
+        }
+
+        hdr = &recv_msgs[recv_next].msg_hdr;
+        len = recv_msgs[recv_next].msg_len;
+
+        // Truncated datagrams are larger than anything we send, so
+        // they are not ours.
+
+        if ((hdr->msg_flags & MSG_TRUNC) == 0
+         && hdr->msg_namelen == sizeof(struct sockaddr_in))
+        {
+            break;
+        }
+
+        ++recv_next;
+    }
+
+    *packet = NET_NewPacket(len);
+    memcpy((*packet)->data, recv_bufs[recv_next], len);
+    (*packet)->len = len;
+
+    *addr = FindAddress(&recv_addrs[recv_next]);
+
+    ++recv_next;
+
+    return true;
+}
+
+static void NET_UDP_Flush(void)
+{
+    SendBatch();
+}
+
+static boolean NET_UDP_WaitPacket(int timeout_ms)
+{
+    struct pollfd pfd;
+
+    if (recv_next < recv_count)
+    {
+        return true;
+    }
+
+    pfd.fd = udp_fd;
+    pfd.events = POLLIN;
+
+    return poll(&pfd, 1, timeout_ms) > 0;
+}
+
+static void NET_UDP_AddrToString(net_addr_t *addr, char *buffer,
+                                 int buffer_len)
+{
+    struct sockaddr_in *sa = addr->handle;
+    uint32_t host;
+    uint16_t remote_port;
+
+    host = ntohl(sa->sin_addr.s_addr);
+    remote_port = ntohs(sa->sin_port);
+
+    M_snprintf(buffer, buffer_len, "%i.%i.%i.%i",
+               (host >> 24) & 0xff, (host >> 16) & 0xff,
+               (host >> 8) & 0xff, host & 0xff);
+
+    if (remote_port != DEFAULT_PORT)
+    {
+        char portbuf[10];
+        M_snprintf(portbuf, sizeof(portbuf), ":%i", remote_port);
+        M_StringConcat(buffer, portbuf, buffer_len);
+    }
+}
+
+static net_addr_t *NET_UDP_ResolveAddress(const char *address)
+{
+    struct sockaddr_in sa;
+    char *addr_hostname;
+    char *colon;
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_port = htons(DEFAULT_PORT);
+
+    addr_hostname = M_StringDuplicate(address);
+    colon = strchr(addr_hostname, ':');
+
+    if (colon != NULL)
+    {
+        *colon = '\0';
+        sa.sin_port = htons(atoi(colon + 1));
+    }
+
+    // Only numeric addresses; the server never needs to look up
+    // anything else through this module.
+
+    if (inet_pton(AF_INET, addr_hostname, &sa.sin_addr) != 1)
+    {
+        free(addr_hostname);
+        return NULL;
+    }
+
+    free(addr_hostname);
+
+    return FindAddress(&sa);
+}
+
+// Complete module
+
+net_module_t net_udp_module =
+{
+    NET_UDP_InitClient,
+    NET_UDP_InitServer,
+    NET_UDP_SendPacket,
+    NET_UDP_RecvPacket,
+    NET_UDP_AddrToString,
+    NET_UDP_FreeAddress,
+    NET_UDP_ResolveAddress,
+    NET_UDP_Flush,
+    NET_UDP_WaitPacket,
+};
+
+#endif /* #ifdef HAVE_RECVMMSG */
+
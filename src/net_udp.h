@@ -0,0 +1,32 @@
+//
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//     Networking module for Linux servers, using a single UDP socket
+//     and batched recvmmsg/sendmmsg.
+//
+
+#ifndef NET_UDP_H
+#define NET_UDP_H
+
+#include "config.h"
+#include "net_defs.h"
+
+#ifdef HAVE_RECVMMSG
+
+extern net_module_t net_udp_module;
+
+#endif
+
+#endif /* #ifndef NET_UDP_H */
+
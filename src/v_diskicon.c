@@ -35,15 +35,15 @@ static const int diskicon_threshold = 20*1024;
 // Two buffers: disk_data contains the data representing the disk icon
 // (raw, not a patch_t) while saved_background is an equivalently-sized
 // buffer where we save the background data while the disk is on screen.
-static pixel_t *disk_data;
-static pixel_t *saved_background;
+static INSTANCE pixel_t *disk_data;
+static INSTANCE pixel_t *saved_background;
 
-static int loading_disk_xoffs = 0;
-static int loading_disk_yoffs = 0;
+static INSTANCE int loading_disk_xoffs = 0;
+static INSTANCE int loading_disk_yoffs = 0;
 
 // Number of bytes read since the last call to V_DrawDiskIcon().
-static size_t recent_bytes_read = 0;
-static boolean disk_drawn;
+static INSTANCE size_t recent_bytes_read = 0;
+static INSTANCE boolean disk_drawn;
 
 static void CopyRegion(pixel_t *dest, int dest_pitch,
                        pixel_t *src, int src_pitch,
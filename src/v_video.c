@@ -50,20 +50,20 @@
 // Blending table used for fuzzpatch, etc.
 // Only used in Heretic/Hexen
 
-byte *tinttable = NULL;
+INSTANCE byte *tinttable = NULL;
 
 // villsa [STRIFE] Blending table used for Strife
-byte *xlatab = NULL;
+INSTANCE byte *xlatab = NULL;
 
 // The screen buffer that the v_video.c code draws to.
 
-static pixel_t *dest_screen = NULL;
+static INSTANCE pixel_t *dest_screen = NULL;
 
-int dirtybox[4]; 
+INSTANCE int dirtybox[4]; 
 
 // haleyjd 08/28/10: clipping callback function for patches.
 // This is needed for Chocolate Strife, which clips patches to the screen.
-static vpatchclipfunc_t patchclip_callback = NULL;
+static INSTANCE vpatchclipfunc_t patchclip_callback = NULL;
 
 //
 // V_MarkRect 
@@ -841,7 +841,7 @@ void V_ScreenShot(const char *format)
     // find a file name to save it to
 
 #ifdef HAVE_LIBPNG
-    extern int png_screenshots;
+    extern INSTANCE int png_screenshots;
     if (png_screenshots)
     {
         ext = "png";
@@ -962,7 +962,7 @@ static void DrawAcceleratingBox(int speed)
 // Highest seen mouse turn speed. We scale the range of the thermometer
 // according to this value, so that it never exceeds the range. Initially
 // this is set to a 1:1 setting where 1 pixel = 1 unit of speed.
-static int max_seen_speed = MOUSE_SPEED_BOX_WIDTH - 1;
+static INSTANCE int max_seen_speed = MOUSE_SPEED_BOX_WIDTH - 1;
 
 static void DrawNonAcceleratingBox(int speed)
 {
@@ -986,7 +986,7 @@ static void DrawNonAcceleratingBox(int speed)
 
 void V_DrawMouseSpeedBox(int speed)
 {
-    extern int usemouse;
+    extern INSTANCE int usemouse;
     int bgcolor, bordercolor, black;
 
     // If the mouse is turned off, don't draw the box at all.
@@ -34,9 +34,9 @@
 #define CENTERY			(SCREENHEIGHT/2)
 
 
-extern int dirtybox[4];
+extern INSTANCE int dirtybox[4];
 
-extern byte *tinttable;
+extern INSTANCE byte *tinttable;
 
 // haleyjd 08/28/10: implemented for Strife support
 // haleyjd 08/28/10: Patch clipping callback, implemented to support Choco
@@ -55,13 +55,17 @@ wad_file_t *W_OpenFile(const char *path)
     // @category obscure
     //
     // Use the OS's virtual memory subsystem to map WAD files
-    // directly into memory.
+    // directly into memory.  This is the default for the server
+    // build, so that several servers on one machine share the same
+    // copy of the IWAD.
     //
 
+#ifndef SERVER
     if (!M_CheckParm("-mmap"))
     {
         return stdc_wad_file.OpenFile(path);
     }
+#endif
 
     // Try all classes in order until we find one that works
 
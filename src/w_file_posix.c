@@ -60,6 +60,11 @@ static void MapFile(posix_wad_file_t *wad, const char *filename)
                   protection, flags, 
                   wad->handle, 0);
 
+    if (result == MAP_FAILED)
+    {
+        result = NULL;
+    }
+
     wad->wad.mapped = result;
 
     if (result == NULL)
@@ -109,6 +114,11 @@ static void W_POSIX_CloseFile(wad_file_t *wad)
 
     // If mapped, unmap it.
 
+    if (posix_wad->wad.mapped != NULL)
+    {
+        munmap(posix_wad->wad.mapped, posix_wad->wad.length);
+    }
+
     // Close the file
   
     close(posix_wad->handle);
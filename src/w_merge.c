@@ -50,18 +50,18 @@ typedef struct
     lumpinfo_t *angle_lumps[8];
 } sprite_frame_t;
 
-static searchlist_t iwad;
-static searchlist_t iwad_sprites;
-static searchlist_t pwad;
+static INSTANCE searchlist_t iwad;
+static INSTANCE searchlist_t iwad_sprites;
+static INSTANCE searchlist_t pwad;
 
-static searchlist_t iwad_flats;
-static searchlist_t pwad_sprites;
-static searchlist_t pwad_flats;
+static INSTANCE searchlist_t iwad_flats;
+static INSTANCE searchlist_t pwad_sprites;
+static INSTANCE searchlist_t pwad_flats;
 
 // lumps with these sprites must be replaced in the IWAD
-static sprite_frame_t *sprite_frames;
-static int num_sprite_frames;
-static int sprite_frames_alloced;
+static INSTANCE sprite_frame_t *sprite_frames;
+static INSTANCE int num_sprite_frames;
+static INSTANCE int sprite_frames_alloced;
 
 // Search in a list to find a lump with a particular name
 // Linear search (slow!)
@@ -56,19 +56,19 @@ typedef PACKED_STRUCT (
 //
 
 // Location of each lump on disk.
-lumpinfo_t **lumpinfo;
-unsigned int numlumps = 0;
+INSTANCE lumpinfo_t **lumpinfo;
+INSTANCE unsigned int numlumps = 0;
 
 // Hash table for fast lookups
-static lumpindex_t *lumphash;
+static INSTANCE lumpindex_t *lumphash;
 
 // Variables for the reload hack: filename of the PWAD to reload, and the
 // lumps from WADs before the reload file, so we can resent numlumps and
 // load the file again.
-static wad_file_t *reloadhandle = NULL;
-static lumpinfo_t *reloadlumps = NULL;
-static char *reloadname = NULL;
-static int reloadlump = -1;
+static INSTANCE wad_file_t *reloadhandle = NULL;
+static INSTANCE lumpinfo_t *reloadlumps = NULL;
+static INSTANCE char *reloadname = NULL;
+static INSTANCE int reloadlump = -1;
 
 // Hash function used for lump names.
 unsigned int W_LumpNameHash(const char *s)
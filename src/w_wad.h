@@ -50,8 +50,8 @@ struct lumpinfo_s
 };
 
 
-extern lumpinfo_t **lumpinfo;
-extern unsigned int numlumps;
+extern INSTANCE lumpinfo_t **lumpinfo;
+extern INSTANCE unsigned int numlumps;
 
 wad_file_t *W_AddFile(const char *filename);
 void W_Reload(void);
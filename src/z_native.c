@@ -45,6 +45,10 @@ struct memblock_s
  
 static memblock_t *allocated_blocks[PU_NUM_TAGS];
 
+// Called before any purgable block is thrown out.
+
+static void (*purge_hook)(void) = NULL;
+
 #ifdef TESTING
 
 static int test_malloced = 0;
@@ -190,6 +194,11 @@ static boolean ClearCache(int size)
 
     //printf("out of memory; cleaning out the cache: %i\n", test_malloced);
 
+    if (purge_hook != NULL)
+    {
+        purge_hook();
+    }
+
     // Search backwards through the list freeing blocks until we have
     // freed the amount of memory required.
 
@@ -496,3 +505,8 @@ unsigned int Z_ZoneSize(void)
     return 0;
 }
 
+void Z_SetPurgeHook(void (*hook)(void))
+{
+    purge_hook = hook;
+}
+
@@ -64,9 +64,13 @@ typedef struct
 
 
 
-static memzone_t *mainzone;
-static boolean zero_on_free;
-static boolean scan_on_free;
+static INSTANCE memzone_t *mainzone;
+static INSTANCE boolean zero_on_free;
+static INSTANCE boolean scan_on_free;
+
+// Called before any purgable block is thrown out.
+
+static INSTANCE void (*purge_hook)(void) = NULL;
 
 
 //
@@ -296,6 +300,11 @@ Z_Malloc
             }
             else
             {
+                if (purge_hook != NULL)
+                {
+                    purge_hook();
+                }
+
                 // free the rover block (adding the size to base)
 
                 // the rover can be the base block
@@ -550,3 +559,14 @@ unsigned int Z_ZoneSize(void)
     return mainzone->size;
 }
 
+//
+// Z_SetPurgeHook
+// Sets a function to be called before a purgable block is
+// thrown out to make room, for code that may still be reading
+// cached data it no longer holds as PU_STATIC.
+//
+void Z_SetPurgeHook(void (*hook)(void))
+{
+    purge_hook = hook;
+}
+